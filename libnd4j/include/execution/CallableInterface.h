@@ -65,6 +65,10 @@ namespace samediff {
 
         std::mutex _ms;
         std::mutex _mf;
+
+        // per-worker statistics
+        std::atomic<int64_t> _busyTime;
+        std::atomic<int64_t> _tasks;
     public:
         CallableInterface();
         ~CallableInterface() = default;
@@ -87,6 +91,10 @@ namespace samediff {
         void finish();
 
         void execute();
+
+        int64_t busyTime();
+        int64_t tasksExecuted();
+        void resetStatistics();
     };
 }
 
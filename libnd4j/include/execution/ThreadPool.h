@@ -42,6 +42,9 @@ namespace samediff {
         std::mutex _lock;
         std::atomic<int> _available;
         std::queue<Ticket*> _tickets;
+
+        // this method expects _lock to be acquired already
+        Ticket* acquire_(int num_threads);
     protected:
         ThreadPool();
         ~ThreadPool();
@@ -55,6 +58,14 @@ namespace samediff {
          */
         Ticket* tryAcquire(int num_threads);
 
+        /**
+         * This method returns ticket with up to max_threads threads, whatever is available at the moment, or nullptr if there are no threads available
+         * Used for nested parallelism: inner loops just take spare threads instead of oversubscribing
+         * @param max_threads
+         * @return
+         */
+        Ticket* tryAcquireAvailable(int max_threads);
+
         /**
          * This method marks specified number of threads as released, and available for use
          * @param num_threads
@@ -62,6 +73,24 @@ namespace samediff {
         void release(int num_threads = 1);
 
         void release(Ticket *ticket);
+
+        /**
+         * This method returns total number of threads in this pool
+         */
+        int numberOfThreads();
+
+        /**
+         * These methods return per-worker statistics: time spent executing tasks (in nanoseconds) and number of tasks executed
+         * @param thread_id
+         * @return
+         */
+        int64_t busyTime(int thread_id);
+        int64_t tasksExecuted(int thread_id);
+
+        /**
+         * This method resets per-worker statistics
+         */
+        void resetStatistics();
     };
 }
 
@@ -166,6 +166,57 @@ namespace samediff {
 
         static double parallel_double(FUNC_RD function, FUNC_AD aggregator, int64_t start, int64_t stop, int64_t increment = 1, uint64_t numThreads = sd::Environment::getInstance().maxMasterThreads());
 
+        /**
+         * This function executes 1 dimensional loop with work stealing: each thread gets its own span of the loop, and
+         * threads that are done with their spans steal upper halves of spans still in progress. Suited for loops with skewed per-iteration work.
+         * PLEASE NOTE: function can be called multiple times per thread, with different sub-ranges, so it must accumulate per-thread state instead of overwriting it
+         * PLEASE NOTE: this function can use smaller number of threads than requested.
+         *
+         * @param function
+         * @param start
+         * @param stop
+         * @param increment
+         * @param numThreads
+         * @param grain - number of iterations picked at once, 0 means auto
+         * @return
+         */
+        static int parallel_stealing(FUNC_1D function, int64_t start, int64_t stop, int64_t increment = 1, uint32_t numThreads = sd::Environment::getInstance().maxMasterThreads(), int64_t grain = 0);
+
+        /**
+         * This function executes 2 nested loops with work stealing along the outer loop. Inner loop is always passed as is
+         *
+         * @param function
+         * @param start_x
+         * @param stop_x
+         * @param inc_x
+         * @param start_y
+         * @param stop_y
+         * @param inc_y
+         * @param numThreads
+         * @param grain - number of outer iterations picked at once, 0 means auto
+         * @return
+         */
+        static int parallel_stealing(FUNC_2D function, int64_t start_x, int64_t stop_x, int64_t inc_x, int64_t start_y, int64_t stop_y, int64_t inc_y, uint32_t numThreads = sd::Environment::getInstance().maxMasterThreads(), int64_t grain = 0);
+
+        /**
+         * This function executes 3 nested loops with work stealing along the outer loop. Inner loops are always passed as is
+         *
+         * @param function
+         * @param start_x
+         * @param stop_x
+         * @param inc_x
+         * @param start_y
+         * @param stop_y
+         * @param inc_y
+         * @param start_z
+         * @param stop_z
+         * @param inc_z
+         * @param numThreads
+         * @param grain - number of outer iterations picked at once, 0 means auto
+         * @return
+         */
+        static int parallel_stealing(FUNC_3D function, int64_t start_x, int64_t stop_x, int64_t inc_x, int64_t start_y, int64_t stop_y, int64_t inc_y, int64_t start_z, int64_t stop_z, int64_t inc_z, uint32_t numThreads = sd::Environment::getInstance().maxMasterThreads(), int64_t grain = 0);
+
         /**
          * This method will execute function in parallel preserving the parts to be aligned increment size
          * PLEASE NOTE: this function can use smaller number of threads than requested.
@@ -46,6 +46,8 @@ namespace samediff {
 
         void acquiredThreads(uint32_t threads);
 
+        uint32_t numberOfThreads();
+
         void attach(uint32_t thread_id, CallableInterface *interface);
 
         // deprecated one
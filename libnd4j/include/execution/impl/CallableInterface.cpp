@@ -20,6 +20,7 @@
 
 #include <execution/CallableInterface.h>
 #include <helpers/logger.h>
+#include <chrono>
 
 namespace samediff {
     CallableInterface::CallableInterface() {
@@ -27,6 +28,9 @@ namespace samediff {
         _available = true;
         _filled = false;
         _finished = false;
+
+        _busyTime = 0;
+        _tasks = 0;
     }
 
     bool CallableInterface::available() {
@@ -185,6 +189,8 @@ namespace samediff {
         // mark it as consumed
         _filled = false;
 
+        auto timeStart = std::chrono::steady_clock::now();
+
         // actually executing op
         switch (_branch) {
             case 0:
@@ -207,7 +213,24 @@ namespace samediff {
                 break;
         }
 
+        auto timeEnd = std::chrono::steady_clock::now();
+        _busyTime += std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count();
+        _tasks++;
+
         // notify that thread finished the job
         this->finish();
     }
+
+    int64_t CallableInterface::busyTime() {
+        return _busyTime.load();
+    }
+
+    int64_t CallableInterface::tasksExecuted() {
+        return _tasks.load();
+    }
+
+    void CallableInterface::resetStatistics() {
+        _busyTime = 0;
+        _tasks = 0;
+    }
 }
\ No newline at end of file
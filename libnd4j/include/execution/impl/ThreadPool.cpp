@@ -147,43 +147,61 @@ namespace samediff {
         _available += numThreads;
     }
 
-    Ticket* ThreadPool::tryAcquire(int numThreads) {
-        //std::vector<BlockingQueue<CallableWithArguments*>*> queues;
-
-        Ticket *t = nullptr;
-        // we check for threads availability first
-        bool threaded = false;
-        {
-            // we lock before checking availability
-            std::unique_lock<std::mutex> lock(_lock);
-            if (_available >= numThreads) {
-                threaded = true;
-                _available -= numThreads;
-
-                // getting a ticket from the queue
-                t = _tickets.front();
-                _tickets.pop();
-
-                // ticket must contain information about number of threads for the current session
-                t->acquiredThreads(numThreads);
-
-                // filling ticket with executable interfaces
-                for (int e = 0, i = 0; e < _queues.size() && i < numThreads; e++) {
-                    if (_interfaces[e]->available()) {
-                        t->attach(i++, _interfaces[e]);
-                        _interfaces[e]->markUnavailable();
-                    }
-                }
+    Ticket* ThreadPool::acquire_(int numThreads) {
+        _available -= numThreads;
+
+        // getting a ticket from the queue
+        auto t = _tickets.front();
+        _tickets.pop();
+
+        // ticket must contain information about number of threads for the current session
+        t->acquiredThreads(numThreads);
+
+        // filling ticket with executable interfaces
+        for (int e = 0, i = 0; e < _queues.size() && i < numThreads; e++) {
+            if (_interfaces[e]->available()) {
+                t->attach(i++, _interfaces[e]);
+                _interfaces[e]->markUnavailable();
             }
         }
 
-        // we either dispatch tasks to threads, or run single-threaded
-        if (threaded) {
-            return t;
-        } else {
-            // if there's no threads available - return nullptr
-            return nullptr;
-        }
+        return t;
+    }
+
+    Ticket* ThreadPool::tryAcquire(int numThreads) {
+        // we lock before checking availability
+        std::unique_lock<std::mutex> lock(_lock);
+        if (_available >= numThreads)
+            return acquire_(numThreads);
+
+        // if there's no threads available - return nullptr
+        return nullptr;
+    }
+
+    Ticket* ThreadPool::tryAcquireAvailable(int maxThreads) {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto numThreads = _available < maxThreads ? _available.load() : maxThreads;
+        if (numThreads > 0)
+            return acquire_(numThreads);
+
+        return nullptr;
+    }
+
+    int ThreadPool::numberOfThreads() {
+        return static_cast<int>(_interfaces.size());
+    }
+
+    int64_t ThreadPool::busyTime(int threadId) {
+        return _interfaces.at(threadId)->busyTime();
+    }
+
+    int64_t ThreadPool::tasksExecuted(int threadId) {
+        return _interfaces.at(threadId)->tasksExecuted();
+    }
+
+    void ThreadPool::resetStatistics() {
+        for (auto i: _interfaces)
+            i->resetStatistics();
     }
 
     void ThreadPool::release(samediff::Ticket *ticket) {
@@ -24,6 +24,7 @@
 #include <helpers/logger.h>
 #include <math/templatemath.h>
 #include <helpers/shape.h>
+#include <mutex>
 
 
 namespace samediff {
@@ -719,5 +720,168 @@ namespace samediff {
         }
     }
 
+    /**
+     * This class holds range of loop iterations owned by one thread.
+     * Owner takes iterations from the head of the range, other threads steal upper half of the remaining iterations
+     */
+    class StealableSpan {
+    private:
+        std::mutex _lock;
+        int64_t _start = 0;
+        int64_t _stop = 0;
+    public:
+        StealableSpan() = default;
+        ~StealableSpan() = default;
+
+        void assign(int64_t start, int64_t stop) {
+            std::lock_guard<std::mutex> lock(_lock);
+            _start = start;
+            _stop = stop;
+        }
+
+        int64_t remaining() {
+            std::lock_guard<std::mutex> lock(_lock);
+            return _stop - _start;
+        }
+
+        bool pop(int64_t grain, int64_t &start, int64_t &stop) {
+            std::lock_guard<std::mutex> lock(_lock);
+            if (_start >= _stop)
+                return false;
+
+            start = _start;
+            stop = sd::math::nd4j_min<int64_t>(_start + grain, _stop);
+            _start = stop;
+            return true;
+        }
+
+        bool steal(int64_t grain, int64_t &start, int64_t &stop) {
+            std::lock_guard<std::mutex> lock(_lock);
+            auto left = _stop - _start;
+            if (left <= 0)
+                return false;
+
+            // we don't split spans smaller than grain
+            auto stolen = left > grain ? left / 2 : left;
+            start = _stop - stolen;
+            stop = _stop;
+            _stop = start;
+            return true;
+        }
+    };
+
+    /**
+     * This function executes body over iterations [0, iterations) with work stealing.
+     * Body gets thread_id and range of iterations, conversion into actual loop indices is up to caller
+     */
+    static int stealing_(const std::function<void(uint64_t, int64_t, int64_t)> &body, int64_t iterations, int64_t grain, uint32_t numThreads) {
+        if (iterations <= 0)
+            return 0;
+
+        if (numThreads > iterations)
+            numThreads = iterations;
+
+        if (numThreads <= 1) {
+            body(0, 0, iterations);
+            return 1;
+        }
+
+        // we take only threads that are available right now, so nested calls don't oversubscribe
+        auto ticket = ThreadPool::getInstance().tryAcquireAvailable(numThreads - 1);
+        if (ticket == nullptr) {
+            body(0, 0, iterations);
+            return 1;
+        }
+
+        // current thread participates as well
+        numThreads = ticket->numberOfThreads() + 1;
+
+        if (grain <= 0)
+            grain = sd::math::nd4j_max<int64_t>(1, iterations / (numThreads * 16));
+
+        std::vector<StealableSpan> spans(numThreads);
+        for (uint32_t e = 0; e < numThreads; e++) {
+            auto span = Span::build(e, numThreads, 0, iterations, 1);
+            spans[e].assign(span.startX(), span.stopX());
+        }
+
+        auto worker = PRAGMA_THREADS_DO {
+            int64_t s, e;
+            while (true) {
+                while (spans[thread_id].pop(grain, s, e))
+                    body(thread_id, s, e);
+
+                // own span is exhausted, looking for the most loaded victim
+                int victim = -1;
+                int64_t maxLeft = 0;
+                for (uint64_t t = 1; t < numThreads; t++) {
+                    auto v = (thread_id + t) % numThreads;
+                    auto left = spans[v].remaining();
+                    if (left > maxLeft) {
+                        maxLeft = left;
+                        victim = v;
+                    }
+                }
+
+                // nothing left anywhere: we're done
+                if (victim < 0)
+                    break;
+
+                // stolen iterations become our own span, so they can be stolen again
+                if (spans[victim].steal(grain, s, e))
+                    spans[thread_id].assign(s, e);
+            }
+        };
 
-}
\ No newline at end of file
+        for (uint32_t e = 0; e < numThreads - 1; e++)
+            ticket->enqueue(e, numThreads, worker);
+
+        worker(numThreads - 1, numThreads);
+
+        ticket->waitAndRelease();
+
+        return numThreads;
+    }
+
+    int Threads::parallel_stealing(FUNC_1D function, int64_t start, int64_t stop, int64_t increment, uint32_t numThreads, int64_t grain) {
+        if (start > stop)
+            throw std::runtime_error("Threads::parallel_stealing got start > stop");
+
+        auto iterations = (stop - start + increment - 1) / increment;
+
+        return stealing_([&](uint64_t thread_id, int64_t s, int64_t e) {
+            function(thread_id, start + s * increment, sd::math::nd4j_min<int64_t>(start + e * increment, stop), increment);
+        }, iterations, grain, numThreads);
+    }
+
+    int Threads::parallel_stealing(FUNC_2D function, int64_t startX, int64_t stopX, int64_t incX, int64_t startY, int64_t stopY, int64_t incY, uint32_t numThreads, int64_t grain) {
+        if (startX > stopX)
+            throw std::runtime_error("Threads::parallel_stealing got startX > stopX");
+
+        if (startY > stopY)
+            throw std::runtime_error("Threads::parallel_stealing got startY > stopY");
+
+        auto iterations = (stopX - startX + incX - 1) / incX;
+
+        return stealing_([&](uint64_t thread_id, int64_t s, int64_t e) {
+            function(thread_id, startX + s * incX, sd::math::nd4j_min<int64_t>(startX + e * incX, stopX), incX, startY, stopY, incY);
+        }, iterations, grain, numThreads);
+    }
+
+    int Threads::parallel_stealing(FUNC_3D function, int64_t startX, int64_t stopX, int64_t incX, int64_t startY, int64_t stopY, int64_t incY, int64_t startZ, int64_t stopZ, int64_t incZ, uint32_t numThreads, int64_t grain) {
+        if (startX > stopX)
+            throw std::runtime_error("Threads::parallel_stealing got startX > stopX");
+
+        if (startY > stopY)
+            throw std::runtime_error("Threads::parallel_stealing got startY > stopY");
+
+        if (startZ > stopZ)
+            throw std::runtime_error("Threads::parallel_stealing got startZ > stopZ");
+
+        auto iterations = (stopX - startX + incX - 1) / incX;
+
+        return stealing_([&](uint64_t thread_id, int64_t s, int64_t e) {
+            function(thread_id, startX + s * incX, sd::math::nd4j_min<int64_t>(startX + e * incX, stopX), incX, startY, stopY, incY, startZ, stopZ, incZ);
+        }, iterations, grain, numThreads);
+    }
+}
@@ -71,6 +71,10 @@ namespace samediff {
         _acquiredThreads = threads;
     }
 
+    uint32_t Ticket::numberOfThreads() {
+        return _acquiredThreads;
+    }
+
     void Ticket::waitAndRelease() {
         for (uint32_t e = 0; e < this->_acquiredThreads; e++) {
             // block until finished
@@ -30,6 +30,9 @@
 #include <ops/declarable/OpDescriptor.h>
 #include <execution/Engine.h>
 #include <execution/ExecutionMode.h>
+#include <graph/ShapeMemo.h>
+#include <mutex>
+#include <memory>
 
 #ifndef __STANDALONE_BUILD__
 #include <config.h>
@@ -67,6 +70,11 @@ namespace sd {
             samediff::Engine _engine = DEFAULT_ENGINE;
 
             samediff::ExecutionMode _execMode = samediff::ExecutionMode::MODE_UNDEFINED;
+
+            // memoized shape function result, shared with Contexts created out of this prototype.
+            // concurrently executed Contexts of the same node may be the first to ask for it, hence once_flag
+            std::shared_ptr<ShapeMemo> _shapeMemo;
+            std::once_flag _shapeMemoFlag;
         public:
             explicit ContextPrototype(sd::ops::OpDescriptor* opDescriptor = nullptr, int nodeId = 1, bool inPlace = false);
             ~ContextPrototype() = default;
@@ -123,6 +131,13 @@ namespace sd {
             // just a clone
             ContextPrototype* clone();
 
+#ifndef __JAVACPP_HACK__
+            /**
+             * This method returns shape function memo of this prototype, it's created on first use. Thread-safe
+             */
+            std::shared_ptr<ShapeMemo> shapeMemo();
+#endif
+
             template <typename N>
             ContextPrototype* asT();
 
@@ -37,6 +37,13 @@ namespace sd {
             Nd4jLong _footprintBackward = 0L;
             Direction _direction = Direction_FORWARD_ONLY;
 
+            // max number of nodes executed concurrently within one layer in ExecutionMode_AUTO. 0 means Environment::maxMasterThreads()
+            int _interOpThreads = 0;
+
+            // if true, GraphHolder folds fake quantization into quantized ops on registration. Off by default,
+            // since results of folded graph may differ from the original one within quantization error
+            bool _foldFakeQuantization = false;
+
             explicit ExecutorConfiguration(const sd::graph::FlatConfiguration *conf = nullptr);
             ~ExecutorConfiguration() = default;
             
@@ -37,6 +37,12 @@ namespace sd {
 
             static NDArray* fromFlatArray(const sd::graph::FlatArray* flatArray);
 
+            /**
+             * This method serializes array buffer into given builder.
+             * Dense non-view arrays are copied directly from host buffer, so no intermediate byte vector is created
+             */
+            static flatbuffers::Offset<flatbuffers::Vector<int8_t>> toFlatBuffer(flatbuffers::FlatBufferBuilder &builder, NDArray &array);
+
             static flatbuffers::Offset<FlatArray> toFlatArray(flatbuffers::FlatBufferBuilder &builder, NDArray &array);
         };
     }
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <unordered_map>
 #include <map>
+#include <memory>
 //#include <NDArray.h>
 #include <graph/Node.h>
 #include <graph/Stash.h>
@@ -35,6 +36,7 @@
 #include <graph/generated/graph_generated.h>
 #include <graph/generated/config_generated.h>
 #include <graph/ExecutorConfiguration.h>
+#include <graph/MemoryPlan.h>
 #include <ops/declarable/OpDescriptor.h>
 
 namespace sd {
@@ -67,6 +69,12 @@ namespace sd {
             MAP_IMPL<int, Scope*> _mappedScopes;
             std::vector<Scope*> _scopes;
 
+            // optional static memory plan, see planMemory()
+            MemoryPlan* _memoryPlan = nullptr;
+
+            // ops created by fuseElementwise(), shared with clones of this graph
+            std::vector<std::shared_ptr<sd::ops::DeclarableOp>> _fusedOps;
+
 ////////////////////////////////////////
             Nd4jStatus validateNode(sd::graph::Node *node);
 
@@ -193,6 +201,51 @@ namespace sd {
              */
             Graph* cloneWithProxy();
 
+            /**
+             * This method builds static memory plan for this graph: lifetimes of node outputs are calculated over onion layers,
+             * and all outputs are placed into one preallocated arena, reusing memory of outputs that are dead already.
+             * Inplace nodes share memory with their inputs.
+             *
+             * PLEASE NOTE: graphs with logic ops can't be planned. Nodes of ops with data-dependent output shapes
+             * (see DeclarableOp::hasPureShapeFunction()), and nodes fed by them, stay unplanned and allocate outputs
+             * as usual, unless graph was executed before planning, so actual output shapes are known.
+             * GraphHolder plans every graph it registers, and executions with inputs of other shapes
+             * just skip the plan
+             *
+             * @return Status::OK() if plan was built and applied
+             */
+            Nd4jStatus planMemory();
+
+            /**
+             * This method returns memory plan of this graph, or nullptr if graph wasn't planned
+             */
+            MemoryPlan* memoryPlan();
+
+            /**
+             * This method replaces chains of elementwise nodes (legacy transform, scalar and pairwise ops, and broadcastables)
+             * with single nodes, each executing its whole chain in one pass over memory. Intermediate results of a chain
+             * must have single consumer and must not be graph outputs. Fused node keeps id of the last node of its chain.
+             *
+             * PLEASE NOTE: this method must be called before planMemory()
+             *
+             * @return number of fused chains
+             */
+            int fuseElementwise();
+
+            /**
+             * This method folds fake quantization into int8 execution: matmul, xw_plus_b and conv2d nodes fed by
+             * fake_quant_with_min_max_vars (or its per-channel version) nodes on both activations and weights are
+             * replaced with quantized_matmul, quantized_xw_plus_b and quantized_conv2d, and fake_quant nodes are
+             * replaced with quantize_with_min_max_vars nodes providing int8 values together with scale and zero point.
+             * Activations must be quantized per tensor, weights may be quantized per output channel. Fake quant nodes
+             * must have single consumer, must not be graph outputs and must use at most 8 bits.
+             *
+             * PLEASE NOTE: this method must be called before planMemory()
+             *
+             * @return number of folded nodes
+             */
+            int foldFakeQuantization();
+
             /**
              * This method removes reference to VariableSpace from this Graph
              */
@@ -252,6 +305,9 @@ namespace sd {
                 for (int e = 0; e < other->autos()->size(); e++)
                     this->_autos.emplace_back(other->autos()->at(e));
 
+                for (auto &v: other->_fusedOps)
+                    this->_fusedOps.emplace_back(v);
+
                 for (auto &v: *other->scopes()) {
                     auto scp = v.second->clone();
                     this->_mappedScopes[v.first] = scp;
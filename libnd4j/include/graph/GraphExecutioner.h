@@ -42,7 +42,22 @@ namespace sd {
 
     class ND4J_EXPORT GraphExecutioner {
     protected:
+        /**
+         * This method checks if all nodes within given onion layer can be executed concurrently:
+         * no logic ops, no embedded graphs, no divergence points, no inplace ops and fixed number of outputs
+         */
+        static bool isParallelLayer(Graph *graph, int layer);
 
+        /**
+         * This method executes all active nodes of given onion layer concurrently via samediff::Threads
+         *
+         * @param graph - Graph instance pointer
+         * @param layer - index of onion layer
+         * @param variableSpace - VariableSpace instance pointer
+         * @param numThreads - max number of nodes executed at the same time
+         * @return
+         */
+        static Nd4jStatus executeLayerParallel(Graph *graph, int layer, VariableSpace *variableSpace, int numThreads);
 
     public:
         //static Nd4jStatus executeFlatNode(sd::graph::Graph *graph, sd::graph::Node *node, sd::graph::VariableSpace<float> *variableSpace);
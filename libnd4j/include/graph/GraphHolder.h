@@ -23,6 +23,7 @@
 #include <unordered_map>
 #include <map>
 #include <graph/Graph.h>
+#include <graph/GraphPool.h>
 #include <helpers/SimpleReadWriteLock.h>
 #include <exceptions/unknown_graph_exception.h>
 
@@ -34,15 +35,35 @@ namespace sd {
 
             MAP_IMPL<Nd4jLong, SimpleReadWriteLock> _locks;
 
+            // pools of proxy clones, used by execute()
+            MAP_IMPL<Nd4jLong, GraphPool *> _pools;
+
             GraphHolder() = default;
             ~GraphHolder() = default;
+
+            // applies inference-time transformations to graph being registered
+            static void prepareGraph(Graph *graph);
         public:
             static GraphHolder& getInstance();
 
+            /**
+             * This method stores given graph under given id. Fake quantization of the graph is folded into
+             * quantized ops here if ExecutorConfiguration::_foldFakeQuantization is set, elementwise chains are fused,
+             * and graph gets static memory plan, if it can be planned, so all pooled clones know their footprint
+             * upfront and execute without allocations
+             */
             void registerGraph(Nd4jLong graphId, Graph *graph);
             
             Graph* cloneGraph(Nd4jLong graphId);
 
+            /**
+             * This method returns pooled proxy clone of the given graph, with clean per-request state.
+             * Clone must be returned back via releaseGraph()
+             */
+            Graph* acquireGraph(Nd4jLong graphId);
+
+            void releaseGraph(Nd4jLong graphId, Graph *graph);
+
             Graph* pullGraph(Nd4jLong graphId);
 
             void forgetGraph(Nd4jLong graphId);
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_GRAPHPOOL_H
+#define SD_GRAPHPOOL_H
+
+#include <graph/Graph.h>
+#include <atomic>
+#include <memory>
+
+namespace sd {
+    namespace graph {
+        /**
+         * This class holds a set of Graph::cloneWithProxy() instances of one Graph, so concurrent requests
+         * to the same Graph can be executed in parallel without cloning the whole Graph for each request.
+         *
+         * Clones are handed out lock-free: each slot is an atomic pointer, acquire takes any non-empty slot,
+         * release puts the clone back into any empty slot. If all slots are empty - new clone is created,
+         * if all slots are taken on release - clone is deleted.
+         */
+        class ND4J_EXPORT GraphPool {
+        private:
+            Graph* _origin;
+            std::vector<int> _nodes;
+
+            int _size;
+            std::unique_ptr<std::atomic<Graph*>[]> _slots;
+
+            Graph* create();
+            void reset(Graph* graph);
+        public:
+            /**
+             * @param origin - Graph to be cloned. Pool doesn't own it
+             * @param size - max number of idle clones kept in pool. 0 means Environment::maxMasterThreads()
+             */
+            explicit GraphPool(Graph* origin, int size = 0);
+            ~GraphPool();
+
+            GraphPool(const GraphPool& other) = delete;
+            GraphPool& operator=(const GraphPool& other) = delete;
+
+            /**
+             * This method returns clone of origin Graph, with clean per-request state
+             */
+            Graph* acquire();
+
+            /**
+             * This method returns clone back to the pool. Clone must not be used after this call
+             */
+            void release(Graph* graph);
+
+            /**
+             * This method returns max number of idle clones kept in pool
+             */
+            int size() const;
+
+            /**
+             * This method returns number of idle clones available right now
+             */
+            int available() const;
+        };
+    }
+}
+
+#endif //SD_GRAPHPOOL_H
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_MEMORYPLAN_H
+#define SD_MEMORYPLAN_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <array/NDArray.h>
+#include <memory/Workspace.h>
+#include <graph/VariableSpace.h>
+#include <vector>
+
+namespace sd {
+    namespace graph {
+        /**
+         * This class holds static memory plan for Graph: every planned node output gets fixed offset within
+         * one arena, and outputs with non-overlapping lifetimes share the same memory.
+         *
+         * Lifetimes are measured in onion layers, and both ends are inclusive. So two tensors never share memory
+         * if they might be accessed within the same layer, which keeps plan valid for parallel layer execution as well.
+         */
+        class ND4J_EXPORT MemoryPlan {
+        public:
+            struct Tensor {
+                std::pair<int, int> variable;
+
+                // constant shapeInfo, provided by ConstantShapeHelper
+                Nd4jLong const* shapeInfo = nullptr;
+
+                Nd4jLong bytes = 0;
+                Nd4jLong offset = 0;
+
+                int firstLayer = 0;
+                int lastLayer = 0;
+            };
+
+            // alignment of every tensor within arena, in bytes
+            static const Nd4jLong ALIGNMENT = 64;
+        private:
+            std::vector<Tensor> _tensors;
+
+            // external arrays plan was built for, only variable and shapeInfo fields are used
+            std::vector<Tensor> _inputs;
+
+            Nd4jLong _peak = 0;
+            Nd4jLong _naive = 0;
+
+            // arena and arrays are created on first bind() call, and reused afterwards
+            sd::memory::Workspace *_arena = nullptr;
+            std::vector<NDArray*> _arrays;
+
+            // true if arena arrays are attached to VariableSpace by bind(), and not detached by unbind() yet
+            bool _bound = false;
+
+            void assignOffsets();
+        public:
+            /**
+             * @param tensors - tensors with lifetimes defined. Offsets are calculated here
+             * @param inputs - external arrays, which shapes were used for planning
+             */
+            explicit MemoryPlan(const std::vector<Tensor> &tensors, const std::vector<Tensor> &inputs = std::vector<Tensor>());
+            ~MemoryPlan();
+
+            MemoryPlan(const MemoryPlan& other) = delete;
+            MemoryPlan& operator=(const MemoryPlan& other) = delete;
+
+            /**
+             * This method returns size of arena required for this plan, in bytes
+             */
+            Nd4jLong peakMemory() const;
+
+            /**
+             * This method returns number of bytes that would be used without memory reuse
+             */
+            Nd4jLong naiveMemory() const;
+
+            const std::vector<Tensor>& tensors() const;
+
+            bool hasTensor(const std::pair<int, int> &variable) const;
+
+            /**
+             * This method puts arena-backed arrays into given VariableSpace, so ops will write their outputs there.
+             * Arena is allocated only once, so subsequent calls are allocation-free
+             *
+             * @param variableSpace
+             */
+            void bind(VariableSpace *variableSpace);
+
+            /**
+             * This method returns true if external arrays in given VariableSpace have the same shapes and data types
+             * as arrays this plan was built for
+             */
+            bool matches(VariableSpace *variableSpace) const;
+
+            /**
+             * This method detaches arena-backed arrays from given VariableSpace, so ops allocate their outputs as usual.
+             * Next bind() call attaches them back
+             */
+            void unbind(VariableSpace *variableSpace);
+
+            /**
+             * This method returns true if arena-backed arrays are attached to VariableSpace
+             */
+            bool isBound() const;
+
+            /**
+             * This method returns copy of this plan, without arena attached
+             */
+            MemoryPlan* clone() const;
+        };
+    }
+}
+
+#endif //SD_MEMORYPLAN_H
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_REQUESTBATCHER_H
+#define SD_REQUESTBATCHER_H
+
+#include <graph/Graph.h>
+#include <graph/Variable.h>
+#include <graph/generated/request_generated.h>
+#include <graph/generated/result_generated.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sd {
+    namespace graph {
+        /**
+         * This class coalesces concurrent inference requests to the same Graph along batch dimension (dimension 0),
+         * executes merged request once via GraphHolder, and scatters outputs back to callers.
+         *
+         * First request to arrive opens a batch and waits for up to maxWait microseconds, or until maxBatchSize
+         * examples are collected. Requests join open batch only if their inputs have the same ids, data types and
+         * non-batch dimensions. Requests that can't be merged, and outputs without matching batch dimension fall back
+         * to per-request execution. Merged requests have other input shapes than graph was planned for, so they're
+         * executed without static memory plan, and plan is attached back for requests with planned shapes.
+         *
+         * Merging is only valid for graphs where each row of output depends on the same row of inputs only.
+         * Graphs with reductions over batch dimension or whole array (including moments, i.e. batchnorm in training
+         * form) are detected and always executed per request. Other cross-row ops (i.e. custom ops mixing examples)
+         * can't be detected, so such graphs must not be served with batching enabled.
+         */
+        class ND4J_EXPORT RequestBatcher {
+        private:
+            struct Entry;
+            struct Batch;
+
+            int _maxBatchSize;
+            Nd4jLong _maxWait;
+
+            std::mutex _mutex;
+            MAP_IMPL<Nd4jLong, std::shared_ptr<Batch>> _open;
+
+            std::atomic<Nd4jLong> _requests{0};
+            std::atomic<Nd4jLong> _batches{0};
+
+            static bool compatible(const Entry &first, const Entry &other);
+
+            // returns false if given graph has reductions over batch dimension, so rows of merged request would mix
+            static bool rowIndependent(Graph *graph);
+
+            // executes given inputs on pooled clone, outputs are detached from the clone
+            static void executeOnce(Nd4jLong graphId, const std::vector<Variable*> &inputs, std::vector<Variable*> &outputs);
+
+            void executeBatch(Nd4jLong graphId, Batch &batch);
+        public:
+            /**
+             * @param maxBatchSize - max total size of batch dimension of merged request
+             * @param maxWait - max time in microseconds first request waits for others
+             */
+            explicit RequestBatcher(int maxBatchSize = 32, Nd4jLong maxWait = 500);
+            ~RequestBatcher() = default;
+
+            RequestBatcher(const RequestBatcher& other) = delete;
+            RequestBatcher& operator=(const RequestBatcher& other) = delete;
+
+            /**
+             * This method has the same semantics as GraphHolder::execute(), but may execute request merged with others
+             */
+            flatbuffers::Offset<FlatResult> execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request);
+
+            int maxBatchSize() const;
+            Nd4jLong maxWait() const;
+
+            /**
+             * This method returns number of requests served so far
+             */
+            Nd4jLong requests() const;
+
+            /**
+             * This method returns number of graph executions so far, merged batch counts as one
+             */
+            Nd4jLong batches() const;
+        };
+    }
+}
+
+#endif //SD_REQUESTBATCHER_H
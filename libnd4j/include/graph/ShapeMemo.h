@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_SHAPEMEMO_H
+#define SD_SHAPEMEMO_H
+
+#include <array/ShapeList.h>
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <mutex>
+#include <vector>
+
+namespace sd {
+    namespace graph {
+        class ContextPrototype;
+
+        /**
+         * This class memoizes result of the last shape function call for one Context/Node.
+         *
+         * Key is built out of op hash, all input shape infos and all op arguments. Output shapes are stored as
+         * constant shape infos, so on hit DeclarableOp::prepareOutputs() can skip calculateOutputShape() completely.
+         * Only ops with output shapes fully defined by input shapes and arguments may use this class.
+         */
+        class ND4J_EXPORT ShapeMemo {
+        private:
+            std::vector<Nd4jLong> _key;
+            std::vector<const Nd4jLong*> _shapes;
+
+            Nd4jLong _hits = 0;
+            Nd4jLong _misses = 0;
+
+            std::mutex _mutex;
+        public:
+            ShapeMemo() = default;
+            ~ShapeMemo() = default;
+
+            /**
+             * This method builds memo key for given op hash, input shapes and arguments
+             */
+            static void buildKey(std::vector<Nd4jLong> &key, Nd4jLong opHash, ShapeList &inputShapes, ContextPrototype &block);
+
+            /**
+             * This method fills shapes with memoized output shapes, if key matches the last stored one
+             * @return true on hit
+             */
+            bool lookup(const std::vector<Nd4jLong> &key, ShapeList &shapes);
+
+            /**
+             * This method replaces memoized entry with given key and output shapes
+             */
+            void store(const std::vector<Nd4jLong> &key, ShapeList &shapes);
+
+            void reset();
+
+            Nd4jLong hits();
+            Nd4jLong misses();
+        };
+    }
+}
+
+#endif //SD_SHAPEMEMO_H
@@ -25,6 +25,7 @@ namespace sd {
         class ND4J_EXPORT VariableProxy: public VariableSpace {
         protected:
             VariableSpace* _backed = nullptr;
+            // local VariableSpace is replaced in reset(), so access to it is guarded by _varmap
             VariableSpace* _current = nullptr;
         public:
             explicit VariableProxy(VariableSpace* reference);
@@ -32,6 +33,15 @@ namespace sd {
 
             virtual VariableSpace& operator=(const VariableSpace& other);
 
+            /**
+             * This method drops all variables stored in this proxy, so it can be reused for another request.
+             * Outputs of given nodes that are still empty in backing VariableSpace are shadowed locally,
+             * so execution never writes into backing VariableSpace
+             *
+             * @param nodes - ids of nodes which outputs should be shadowed
+             */
+            void reset(const std::vector<int> &nodes);
+
             virtual int numberOfPlaceholders();
             virtual std::vector<Variable*>* getPlaceholders();
 
@@ -46,6 +56,11 @@ namespace sd {
             virtual bool hasVariable(std::pair<int,int>& pair);
             virtual bool hasVariable(std::string *symbol);
 
+            /**
+             * This method returns true if variable is stored in this proxy itself, and not in backing VariableSpace
+             */
+            bool hasLocalVariable(std::pair<int,int>& pair);
+
             virtual sd::graph::Variable *getVariable(int id);
             virtual sd::graph::Variable *getVariable(int id, int idx);
             virtual sd::graph::Variable *getVariable(std::pair<int,int>& pair);
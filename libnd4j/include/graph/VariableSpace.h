@@ -59,7 +59,8 @@ namespace sd {
 
             int _auto_counter = -1;
 
-            std::mutex _varmap;
+            // guards lookups and inserts, since independent nodes may be executed concurrently. put methods call each other, hence recursive
+            std::recursive_mutex _varmap;
 
             MAP_IMPL<int, sd::graph::Variable*> _temporary;
 
@@ -55,6 +55,9 @@ namespace sd {
                 this->_isInplace = prototype->isInplace();
                 this->_nodeId = prototype->nodeId();
                 this->_useMKLDNN = prototype->isUseMKLDNN();
+
+                // memo outlives this Context, so shape function results are reused across executions of the same node
+                this->_shapeMemo = prototype->shapeMemo();
             }
 
 
@@ -174,6 +174,12 @@ namespace sd {
             return clone;
         }
 
+        std::shared_ptr<ShapeMemo> ContextPrototype::shapeMemo() {
+            std::call_once(_shapeMemoFlag, [this] { _shapeMemo = std::make_shared<ShapeMemo>(); });
+
+            return _shapeMemo;
+        }
+
         std::vector<sd::DataType> *ContextPrototype::getDArguments() {
             return &_dArgs;
         }
@@ -48,6 +48,8 @@ namespace sd {
             clone->_direction = _direction;
             clone->_footprintForward = _footprintForward;
             clone->_footprintBackward = _footprintBackward;
+            clone->_interOpThreads = _interOpThreads;
+            clone->_foldFakeQuantization = _foldFakeQuantization;
 
             return clone;
         };
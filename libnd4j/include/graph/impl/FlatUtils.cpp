@@ -102,10 +102,24 @@ namespace sd {
             return array;
         }
 
+        flatbuffers::Offset<flatbuffers::Vector<int8_t>> FlatUtils::toFlatBuffer(flatbuffers::FlatBufferBuilder &builder, NDArray &array) {
+            // strings and views still need repacking
+            if (array.isS() || array.isView() || array.isEmpty())
+                return builder.CreateVector(array.asByteVector());
+
+            array.syncToHost();
+
+            return builder.CreateVector(reinterpret_cast<const int8_t *>(array.buffer()), array.lengthOf() * array.sizeOfT());
+        }
+
         flatbuffers::Offset<FlatArray> FlatUtils::toFlatArray(flatbuffers::FlatBufferBuilder &builder, NDArray &array) {
-            auto byteVector = array.asByteVector();
+            // views are packed together with their shape, so strides always match serialized buffer
+            if (array.isView() && !array.isS()) {
+                auto packed = array.dup(array.ordering());
+                return toFlatArray(builder, packed);
+            }
 
-            auto fBuffer = builder.CreateVector(byteVector);
+            auto fBuffer = toFlatBuffer(builder, array);
             auto fShape = builder.CreateVector(array.getShapeInfoAsFlatVector());
 
             auto bo = static_cast<sd::graph::ByteOrder>(BitwiseUtils::asByteOrder());
@@ -30,6 +30,9 @@
 #include <exceptions/graph_exception.h>
 #include <graph/exceptions/unresolved_input_exception.h>
 #include <graph/exceptions/unresolved_output_exception.h>
+#include <ops/declarable/FusedElementwiseOp.h>
+#include <ops/BroadcastOpsTuple.h>
+#include <set>
 
 namespace sd {
     namespace graph {
@@ -304,6 +307,7 @@ namespace sd {
             delete _variableSpace;
             delete _onion;
             delete _configuration;
+            delete _memoryPlan;
         }
 
         void Graph::addNode(Node *node) {
@@ -705,6 +709,527 @@ namespace sd {
             return sd::Status::OK();
         }
 
+        MemoryPlan* Graph::memoryPlan() {
+            return _memoryPlan;
+        }
+
+        Nd4jStatus Graph::planMemory() {
+            if (!_built.load()) {
+                auto status = buildGraph();
+                if (status != Status::OK())
+                    return status;
+            }
+
+            delete _memoryPlan;
+            _memoryPlan = nullptr;
+
+            std::vector<MemoryPlan::Tensor> tensors;
+            std::vector<MemoryPlan::Tensor> inputs;
+
+            // node output -> index of tensor holding it. inplace outputs point to tensor of their input
+            std::map<std::pair<int, int>, int> index;
+            std::map<std::pair<int, int>, Nd4jLong const*> shapes;
+
+            const int numLayers = (int) _onion->size();
+            for (int l = 0; l < numLayers; l++) {
+                int layerSize = _onion->count(l) == 1 ? _onion->at(l)->size() : 0;
+
+                for (int n = 0; n < layerSize; n++) {
+                    auto node = _onion->at(l)->at(n);
+
+                    // graphs are planned on registration whenever possible, so failures here aren't errors
+                    if (node->opType() == OpType_LOGIC || node->hasGraphEmbedded() || !node->hasCustomOp()) {
+                        nd4j_debug("Graph::planMemory - only graphs without logic ops can be planned\n", "");
+                        return ND4J_STATUS_BAD_GRAPH;
+                    }
+
+                    // nodes with unknown input shapes stay unplanned, and allocate their outputs as usual
+                    bool resolved = true;
+                    std::vector<Nd4jLong const*> inputShapes;
+                    for (auto &v: *node->input()) {
+                        // planned input stays alive till this layer at least
+                        if (index.count(v) > 0) {
+                            auto &t = tensors[index.at(v)];
+                            t.lastLayer = sd::math::nd4j_max<int>(t.lastLayer, l);
+                        }
+
+                        if (shapes.count(v) > 0) {
+                            inputShapes.emplace_back(shapes.at(v));
+                        } else if (_variableSpace->hasVariable(v) && _variableSpace->getVariable(v)->hasNDArray()) {
+                            auto shape = ConstantShapeHelper::getInstance().bufferForShapeInfo(_variableSpace->getVariable(v)->getNDArray()->shapeInfo()).primary();
+                            inputShapes.emplace_back(shape);
+
+                            // plan stays valid only as long as external arrays keep their shapes
+                            MemoryPlan::Tensor t;
+                            t.variable = v;
+                            t.shapeInfo = shape;
+                            inputs.emplace_back(t);
+                        } else {
+                            resolved = false;
+                        }
+                    }
+
+                    if (!resolved) {
+                        nd4j_debug("Graph::planMemory - unable to resolve input shapes of node [%i], node isn't planned\n", node->id());
+                        continue;
+                    }
+
+                    auto block = node->getContextPrototype();
+                    if (node->isInplace() || (block != nullptr && block->isInplace())) {
+                        // inplace outputs are aliases of inputs, see DeclarableOp::prepareOutputs()
+                        for (int e = 0; e < (int) inputShapes.size(); e++) {
+                            std::pair<int, int> out(node->id(), e);
+                            auto in = node->input()->at(e);
+
+                            shapes[out] = inputShapes[e];
+                            if (index.count(in) > 0)
+                                index[out] = index.at(in);
+                        }
+
+                        continue;
+                    }
+
+                    // if graph was executed already - we just use actual output shapes
+                    std::vector<Nd4jLong const*> outputShapes;
+                    for (int e = 0; _variableSpace->hasVariable(node->id(), e) && _variableSpace->getVariable(node->id(), e)->hasNDArray(); e++)
+                        outputShapes.emplace_back(_variableSpace->getVariable(node->id(), e)->getNDArray()->shapeInfo());
+
+                    if (outputShapes.empty()) {
+                        // shape functions reading input values can't be called without actual inputs
+                        if (!node->getCustomOp()->hasPureShapeFunction()) {
+                            nd4j_debug("Graph::planMemory - output shapes of node [%i] depend on input values, node isn't planned\n", node->id());
+                            continue;
+                        }
+
+                        Context ctx(block, _variableSpace);
+                        ShapeList inSha(inputShapes);
+
+                        try {
+                            auto outSha = node->getCustomOp()->calculateOutputShape(&inSha, ctx);
+                            for (auto v: *outSha->asVector())
+                                outputShapes.emplace_back(ConstantShapeHelper::getInstance().bufferForShapeInfo(v).primary());
+
+                            delete outSha;
+                        } catch (std::exception &e) {
+                            nd4j_debug("Graph::planMemory - shape function failed for node [%i], node isn't planned: %s\n", node->id(), e.what());
+                            continue;
+                        }
+                    }
+
+                    for (int e = 0; e < (int) outputShapes.size(); e++) {
+                        std::pair<int, int> out(node->id(), e);
+                        auto shape = ConstantShapeHelper::getInstance().bufferForShapeInfo(outputShapes[e]).primary();
+
+                        shapes[out] = shape;
+
+                        // empty arrays have no buffer, nothing to plan
+                        if (shape::isEmpty(shape))
+                            continue;
+
+                        MemoryPlan::Tensor t;
+                        t.variable = out;
+                        t.shapeInfo = shape;
+                        t.bytes = shape::length(shape) * DataTypeUtils::sizeOfElement(ArrayOptions::dataType(shape));
+                        t.firstLayer = l;
+                        t.lastLayer = l;
+
+                        index[out] = (int) tensors.size();
+                        tensors.emplace_back(t);
+                    }
+                }
+            }
+
+            // graph outputs must survive whole execution
+            for (auto &v: index)
+                if (std::find(_output.begin(), _output.end(), v.first.first) != _output.end())
+                    tensors[v.second].lastLayer = numLayers;
+
+            if (tensors.empty()) {
+                nd4j_debug("Graph::planMemory - graph has no nodes to plan\n", "");
+                return ND4J_STATUS_BAD_GRAPH;
+            }
+
+            _memoryPlan = new MemoryPlan(tensors, inputs);
+            _memoryPlan->bind(_variableSpace);
+
+            nd4j_debug("Graph::planMemory - %lld bytes planned, %lld bytes without reuse\n", _memoryPlan->peakMemory(), _memoryPlan->naiveMemory());
+
+            return Status::OK();
+        }
+
+        /**
+         * This function describes given node as step of fused elementwise chain
+         * @return false if node can't be fused
+         */
+        static bool elementwiseStep(Node *node, sd::ops::helpers::FusedStep &step) {
+            if (node->isScoped() || node->hasGraphEmbedded() || !node->hasCustomOp() || node->isDivergencePoint())
+                return false;
+
+            auto block = node->getContextPrototype();
+            auto tArgs = block->getTArguments();
+            const auto numInputs = node->input()->size();
+
+            step.opNum = (int) node->opNum();
+            step.extras = *tArgs;
+
+            switch (node->opType()) {
+                case OpType_TRANSFORM_SAME:
+                    step.type = sd::ops::helpers::FusedStepType::TRANSFORM_SAME;
+                    return numInputs == 1;
+                case OpType_TRANSFORM_FLOAT:
+                    step.type = sd::ops::helpers::FusedStepType::TRANSFORM_FLOAT;
+                    return numInputs == 1;
+                case OpType_TRANSFORM_STRICT:
+                    step.type = sd::ops::helpers::FusedStepType::TRANSFORM_STRICT;
+                    return numInputs == 1;
+                case OpType_SCALAR: {
+                    step.type = sd::ops::helpers::FusedStepType::SCALAR;
+                    if (numInputs == 1) {
+                        // same order of scalar sources as in LegacyScalarOp
+                        if (!tArgs->empty()) {
+                            step.scalar = tArgs->at(0);
+                            step.extras.clear();
+                        } else
+                            step.scalar = node->scalar();
+                    }
+
+                    return numInputs == 1 || numInputs == 2;
+                }
+                case OpType_PAIRWISE:
+                    step.type = sd::ops::helpers::FusedStepType::PAIRWISE;
+                    return numInputs == 2;
+                case OpType_CUSTOM: {
+                    auto name = *node->getCustomOp()->getOpName();
+                    step.extras.clear();
+
+                    if (name == "relu") {
+                        step.type = sd::ops::helpers::FusedStepType::SCALAR;
+                        step.opNum = (int) sd::scalar::RELU;
+                        step.scalar = tArgs->empty() ? 0.0 : tArgs->at(0);
+                        return numInputs == 1;
+                    }
+
+                    BroadcastOpsTuple tuple;
+                    if (name == "add")
+                        tuple = BroadcastOpsTuple::Add();
+                    else if (name == "subtract")
+                        tuple = BroadcastOpsTuple::Subtract();
+                    else if (name == "multiply")
+                        tuple = BroadcastOpsTuple::Multiply();
+                    else if (name == "divide" || name == "realdiv")
+                        tuple = BroadcastOpsTuple::Divide();
+                    else if (name == "biasadd") {
+                        // NCHW bias isn't broadcastable along last dimension
+                        auto bArgs = block->getBArguments();
+                        if (!bArgs->empty() && bArgs->at(0))
+                            return false;
+
+                        tuple = BroadcastOpsTuple::Add();
+                        step.operandType = true;
+                    } else
+                        return false;
+
+                    step.type = sd::ops::helpers::FusedStepType::BROADCASTABLE;
+                    step.opNum = (int) tuple.p;
+                    step.scalarOp = (int) tuple.s;
+                    step.broadcastOp = (int) tuple.b;
+                    return numInputs == 2;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        int Graph::fuseElementwise() {
+            if (!_built.load()) {
+                auto status = buildGraph();
+                if (status != Status::OK())
+                    return 0;
+            }
+
+            if (_memoryPlan != nullptr) {
+                nd4j_printf("Graph::fuseElementwise - graph was planned already, fusion must be applied before planMemory()\n", "");
+                return 0;
+            }
+
+            // consumers of each node, node used twice by the same consumer is listed twice
+            std::map<int, std::vector<int>> consumers;
+            for (auto &v: *_mapped)
+                for (auto &in: *v.second->input())
+                    if (_mapped->count(in.first) > 0)
+                        consumers[in.first].emplace_back(v.first);
+
+            // intermediate result of a chain can't be observed from outside of it
+            auto isHidden = [&] (Node *node) -> bool {
+                return consumers[node->id()].size() == 1 && !node->hasExternalOutputs() && std::find(_output.begin(), _output.end(), node->id()) == _output.end();
+            };
+
+            // collecting chains first, going layer by layer, so each chain starts from its earliest node
+            std::set<int> absorbed;
+            std::vector<std::vector<Node*>> chains;
+            const int numLayers = (int) _onion->size();
+            for (int l = 0; l < numLayers; l++) {
+                if (_onion->count(l) == 0)
+                    continue;
+
+                for (auto node: *_onion->at(l)) {
+                    sd::ops::helpers::FusedStep step;
+                    if (absorbed.count(node->id()) > 0 || node->hasExternalOutputs() || !elementwiseStep(node, step))
+                        continue;
+
+                    std::vector<Node*> chain = {node};
+                    auto current = node;
+                    while (isHidden(current)) {
+                        auto next = _mapped->at(consumers[current->id()].front());
+
+                        // chain value must be X operand of the next op
+                        std::pair<int, int> value(current->id(), 0);
+                        if (next->input()->at(0) != value || next->hasExternalOutputs() || !elementwiseStep(next, step))
+                            break;
+
+                        chain.emplace_back(next);
+                        current = next;
+                    }
+
+                    if (chain.size() < 2)
+                        continue;
+
+                    for (auto n: chain)
+                        absorbed.insert(n->id());
+
+                    chains.emplace_back(chain);
+                }
+            }
+
+            for (auto &chain: chains) {
+                auto head = chain.front();
+                auto tail = chain.back();
+
+                // inputs of fused node: X of the chain, followed by Y operands of all steps
+                std::vector<std::pair<int, int>> inputs;
+                auto indexOf = [&] (const std::pair<int, int> &input) -> int {
+                    auto it = std::find(inputs.begin(), inputs.end(), input);
+                    if (it != inputs.end())
+                        return (int) (it - inputs.begin());
+
+                    inputs.emplace_back(input);
+                    return (int) inputs.size() - 1;
+                };
+
+                std::vector<sd::ops::helpers::FusedStep> steps;
+                for (auto node: chain) {
+                    sd::ops::helpers::FusedStep step;
+                    elementwiseStep(node, step);
+
+                    if (node == head)
+                        indexOf(node->input()->at(0));
+
+                    if (node->input()->size() > 1)
+                        step.operand = indexOf(node->input()->at(1));
+
+                    steps.emplace_back(step);
+                }
+
+                auto op = std::make_shared<sd::ops::FusedElementwiseOp>(steps, (int) inputs.size());
+                _fusedOps.emplace_back(op);
+
+                auto fused = new Node(op.get(), tail->id());
+                fused->setName(*tail->getName());
+                fused->setLayer(tail->getLayer());
+
+                for (auto &v: inputs)
+                    fused->pickInput(v.first, v.second);
+
+                for (auto &v: *tail->output())
+                    fused->pickOutput(v.first, v.second);
+
+                // inplace head means chain was writing into its input all the way
+                fused->markInplace(head->isInplace());
+                if (head->isInplace())
+                    _variableSpace->getVariable(tail->id())->markRemovable(false);
+
+                for (auto node: chain) {
+                    auto layer = _onion->at(node->getLayer());
+                    auto it = std::find(layer->begin(), layer->end(), node);
+                    if (node == tail)
+                        *it = fused;
+                    else {
+                        layer->erase(it);
+                        _mapped->erase(node->id());
+                        _nodes->erase(std::remove(_nodes->begin(), _nodes->end(), node->id()), _nodes->end());
+                    }
+
+                    _handles.erase(std::remove(_handles.begin(), _handles.end(), node), _handles.end());
+                    delete node;
+                }
+
+                (*_mapped)[fused->id()] = fused;
+                _handles.emplace_back(fused);
+            }
+
+            nd4j_debug("Graph::fuseElementwise - %i chains fused\n", (int) chains.size());
+
+            return (int) chains.size();
+        }
+
+        int Graph::foldFakeQuantization() {
+            if (!_built.load()) {
+                auto status = buildGraph();
+                if (status != Status::OK())
+                    return 0;
+            }
+
+            if (_memoryPlan != nullptr) {
+                nd4j_printf("Graph::foldFakeQuantization - graph was planned already, folding must be applied before planMemory()\n", "");
+                return 0;
+            }
+
+            auto &registrator = sd::ops::OpRegistrator::getInstance();
+            auto quantize = registrator.getOperation("quantize_with_min_max_vars");
+            if (quantize == nullptr)
+                return 0;
+
+            std::map<int, std::vector<int>> consumers;
+            for (auto &v: *_mapped)
+                for (auto &in: *v.second->input())
+                    if (_mapped->count(in.first) > 0)
+                        consumers[in.first].emplace_back(v.first);
+
+            auto isHidden = [&] (Node *node) -> bool {
+                return consumers[node->id()].size() == 1 && !node->hasExternalOutputs() && std::find(_output.begin(), _output.end(), node->id()) == _output.end();
+            };
+
+            // returns fake quant node producing given input, if it can be turned into real quantization
+            auto fakeQuant = [&] (const std::pair<int, int> &input, bool perTensor) -> Node* {
+                if (input.second != 0 || _mapped->count(input.first) == 0)
+                    return nullptr;
+
+                auto node = _mapped->at(input.first);
+                if (!node->hasCustomOp() || node->isScoped() || !isHidden(node))
+                    return nullptr;
+
+                auto name = *node->getCustomOp()->getOpName();
+                if (name != "fake_quant_with_min_max_vars" && (perTensor || name != "fake_quant_with_min_max_vars_per_channel"))
+                    return nullptr;
+
+                auto iArgs = node->getContextPrototype()->getIArguments();
+                if (!iArgs->empty() && iArgs->at(0) > 8)
+                    return nullptr;
+
+                return node;
+            };
+
+            auto replace = [&] (Node *node, sd::ops::DeclarableOp *op, const std::vector<std::pair<int, int>> &inputs, bool keepTArgs) {
+                auto folded = new Node(op, node->id());
+                folded->setName(*node->getName());
+                folded->setLayer(node->getLayer());
+
+                for (auto &v: inputs)
+                    folded->pickInput(v.first, v.second);
+
+                for (auto &v: *node->output())
+                    folded->pickOutput(v.first, v.second);
+
+                // data types change, so nothing can be done inplace anymore
+                folded->markInplace(false);
+
+                auto original = node->getContextPrototype();
+                auto prototype = folded->getContextPrototype();
+                for (auto v: *original->getIArguments())
+                    prototype->getIArguments()->emplace_back(v);
+
+                for (auto v: *original->getBArguments())
+                    prototype->getBArguments()->emplace_back(v);
+
+                if (keepTArgs)
+                    for (auto v: *original->getTArguments())
+                        prototype->getTArguments()->emplace_back(v);
+
+                auto layer = _onion->at(node->getLayer());
+                *std::find(layer->begin(), layer->end(), node) = folded;
+
+                _handles.erase(std::remove(_handles.begin(), _handles.end(), node), _handles.end());
+                _handles.emplace_back(folded);
+                (*_mapped)[folded->id()] = folded;
+
+                delete node;
+            };
+
+            // candidates are collected first, since replacement invalidates iteration over _mapped
+            std::vector<int> ids;
+            for (auto &v: *_mapped)
+                ids.emplace_back(v.first);
+
+            std::sort(ids.begin(), ids.end());
+
+            int folded = 0;
+            for (auto id: ids) {
+                if (_mapped->count(id) == 0)
+                    continue;
+
+                auto node = _mapped->at(id);
+                if (!node->hasCustomOp() || node->isScoped() || node->input()->size() < 2)
+                    continue;
+
+                auto name = *node->getCustomOp()->getOpName();
+                auto iArgs = node->getContextPrototype()->getIArguments();
+                auto tArgs = node->getContextPrototype()->getTArguments();
+
+                // per-channel weights are supported only if channels are the last dimension of weights
+                std::string target;
+                bool channelsLast = false;
+                if (name == "matmul") {
+                    if ((iArgs->size() > 2 && iArgs->at(2) != 0) || (tArgs->size() > 0 && tArgs->at(0) != 1.0) || (tArgs->size() > 1 && tArgs->at(1) != 0.0) || node->input()->size() != 2)
+                        continue;
+
+                    target = "quantized_matmul";
+                    channelsLast = iArgs->size() < 2 || iArgs->at(1) == 0;
+                } else if (name == "xw_plus_b") {
+                    if (node->input()->size() != 3)
+                        continue;
+
+                    target = "quantized_xw_plus_b";
+                    channelsLast = iArgs->empty() || iArgs->at(0) != 1;
+                } else if (name == "conv2d") {
+                    if (node->input()->size() > 3)
+                        continue;
+
+                    target = "quantized_conv2d";
+                    channelsLast = iArgs->size() < 11 || iArgs->at(10) == 0;
+                } else
+                    continue;
+
+                auto op = registrator.getOperation(target);
+                if (op == nullptr)
+                    continue;
+
+                auto x = fakeQuant(node->input()->at(0), true);
+                auto w = fakeQuant(node->input()->at(1), !channelsLast);
+                if (x == nullptr || w == nullptr || x == w)
+                    continue;
+
+                const int xId = x->id();
+                const int wId = w->id();
+
+                std::vector<std::pair<int, int>> inputs = {{xId, 0}, {xId, 1}, {xId, 2}, {wId, 0}, {wId, 1}, {wId, 2}};
+                for (int e = 2; e < (int) node->input()->size(); e++)
+                    inputs.emplace_back(node->input()->at(e));
+
+                // copies of inputs, since nodes are deleted on replacement
+                std::vector<std::pair<int, int>> xInputs(*x->input());
+                std::vector<std::pair<int, int>> wInputs(*w->input());
+                replace(x, quantize, xInputs, true);
+                replace(w, quantize, wInputs, true);
+                replace(node, op, inputs, false);
+
+                folded++;
+            }
+
+            nd4j_debug("Graph::foldFakeQuantization - %i nodes folded\n", folded);
+
+            return folded;
+        }
+
         void Graph::tagInplaceNodes() {
             // just calling, in case it wasn't built before
             if (!_built.load())
@@ -1326,7 +1851,7 @@ namespace sd {
                 for (auto x: *(ovec)) {
                     auto n = x->clone();
                     vec->emplace_back(n);
-                    _handles.emplace_back(n);
+                    clone->_handles.emplace_back(n);
                     (*clone->_mapped)[n->id()] = n;
                 }
 
@@ -1340,6 +1865,15 @@ namespace sd {
 
             clone->_built.store(_built.load());
 
+            // fused ops are stateless, so clones share them
+            clone->_fusedOps = _fusedOps;
+
+            // clone gets its own arena, so it never writes into arena of this graph
+            if (_memoryPlan != nullptr) {
+                clone->_memoryPlan = _memoryPlan->clone();
+                clone->_memoryPlan->bind(clone->_variableSpace);
+            }
+
             return clone;
         }
 
@@ -1377,7 +1911,7 @@ namespace sd {
                 for (auto x: *(ovec)) {
                     auto n = x->clone();
                     vec->emplace_back(n);
-                    _handles.emplace_back(n);
+                    clone->_handles.emplace_back(n);
                     (*clone->_mapped)[n->id()] = n;
                 }
 
@@ -1391,6 +1925,8 @@ namespace sd {
 
             clone->_built.store(_built.load());
 
+            clone->_fusedOps = _fusedOps;
+
             return clone;
         }
 
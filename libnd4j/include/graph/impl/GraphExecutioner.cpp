@@ -55,6 +55,9 @@
 #include <exceptions/graph_execution_exception.h>
 #include <exceptions/no_results_exception.h>
 #include <graph/FlatUtils.h>
+#include <execution/Threads.h>
+#include <exception>
+#include <atomic>
 
 namespace sd{
 namespace graph {
@@ -199,6 +202,122 @@ namespace graph {
 }
 
 
+/**
+ * This function checks input nodes of given Node, and marks Node as inactive if any of inputs is disabled or belongs to other divergent branch
+ *
+ * @return true if Node should be skipped
+ */
+static bool hasInactiveInputs(Graph *graph, Node *node, FlowPath *flowPath) {
+    for (int e = 0; e < node->input()->size(); e++) {
+        auto inputId = node->input()->at(e);
+
+        // not a node. skipping checks
+        if (graph->getMapped()->count(inputId.first) == 0)
+            continue;
+
+        /**
+         * We can skip current node, in two cases:
+         * 1) If previous node was disabled
+         * 2) If previous node was divergent node (i.e. IF op) and code went other way
+         */
+        Node *prevNode = graph->getMapped()->at(inputId.first);
+        if (!flowPath->isNodeActive(inputId.first)) {
+            flowPath->markNodeActive(node->id(), false);
+
+            nd4j_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
+            return true;
+        } else if (prevNode->isDivergencePoint()) { // literally checking for switch here
+            if (flowPath->branch(inputId.first) != inputId.second) {
+                flowPath->markNodeActive(node->id(), false);
+
+                nd4j_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(), inputId.first);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool GraphExecutioner::isParallelLayer(Graph *graph, int layer) {
+    for (auto node: *graph->getOnion()->at(layer)) {
+        if (node->opType() == OpType_LOGIC || node->hasGraphEmbedded() || !node->hasCustomOp())
+            return false;
+
+        if (node->isDivergencePoint() || node->isInplace())
+            return false;
+
+        // outputs of such nodes are assigned to external Variables, which may be shared by other nodes of the layer
+        if (node->hasExternalOutputs())
+            return false;
+
+        // output Variables for such nodes are created in Graph::addNode, so VariableSpace isn't modified during execution
+        if (node->getCustomOp()->getOpDescriptor()->getNumberOfOutputs() < 1)
+            return false;
+    }
+
+    return true;
+}
+
+Nd4jStatus GraphExecutioner::executeLayerParallel(Graph *graph, int layer, VariableSpace *variableSpace, int numThreads) {
+    auto flowPath = variableSpace->flowPath();
+
+    // FlowPath isn't thread-safe, so activity checks are done before dispatch
+    std::vector<Node*> nodes;
+    for (auto node: *graph->getOnion()->at(layer)) {
+        if (hasInactiveInputs(graph, node, flowPath))
+            continue;
+
+        flowPath->markNodeActive(node->id(), true);
+        nodes.emplace_back(node);
+    }
+
+    auto numNodes = static_cast<int>(nodes.size());
+    std::vector<Nd4jStatus> statuses(numNodes, Status::OK());
+    std::vector<Nd4jLong> timings(numNodes, 0L);
+    std::vector<std::exception_ptr> exceptions(numNodes);
+    std::atomic<int> next(0);
+
+    // nodes are picked one by one, so a single heavy node doesn't hold back the rest of the layer.
+    // ops executed here use whatever is left in ThreadPool for their own parallelism
+    auto func = PRAGMA_THREADS_DO {
+        for (int e = next++; e < numNodes; e = next++) {
+            auto timeStart = std::chrono::system_clock::now();
+
+            try {
+                statuses[e] = executeFlatNode(graph, nodes[e], variableSpace);
+            } catch (...) {
+                exceptions[e] = std::current_exception();
+                statuses[e] = ND4J_STATUS_KERNEL_FAILURE;
+            }
+
+            auto timeEnd = std::chrono::system_clock::now();
+            timings[e] = std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count();
+        }
+    };
+
+    numThreads = sd::math::nd4j_min<int>(numThreads, numNodes);
+    if (numThreads > 1)
+        samediff::Threads::parallel_do(func, numThreads);
+    else
+        func(0, 1);
+
+    // results are propagated in the same order as sequential execution would do
+    for (int e = 0; e < numNodes; e++) {
+        if (exceptions[e])
+            std::rethrow_exception(exceptions[e]);
+
+        flowPath->setOuterTime(nodes[e]->id(), timings[e]);
+
+        if (statuses[e] != ND4J_STATUS_OK)
+            return statuses[e];
+
+        flowPath->markExecuted(nodes[e]->id(), true);
+    }
+
+    return Status::OK();
+}
+
 /**
  * This method executes given Graph instance, and returns error code.
  *
@@ -218,6 +337,18 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
     Nd4jLong tb0 = Environment::getInstance().isProfiling() ? GraphProfile::currentTime() : 0L;
     graph->buildGraph();
 
+    // arena-backed arrays have planned shapes, so inputs of other shapes are executed without plan,
+    // and plan gets attached back as soon as inputs have planned shapes again
+    auto memoryPlan = graph->memoryPlan();
+    if (memoryPlan != nullptr) {
+        if (!memoryPlan->matches(__variableSpace)) {
+            if (memoryPlan->isBound())
+                memoryPlan->unbind(__variableSpace);
+        } else if (!memoryPlan->isBound()) {
+            memoryPlan->bind(__variableSpace);
+        }
+    }
+
     auto footprintForward = sd::memory::MemoryRegistrator::getInstance().getGraphMemoryFootprint(graph->hashCode());
     if (footprintForward > 0) {
         if (__variableSpace->launchContext()->getWorkspace() != nullptr) {
@@ -234,6 +365,7 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
     Nd4jLong timeStart = Environment::getInstance().isProfiling() ? GraphProfile::currentTime() : 0L;
 
     bool pe = graph->getExecutorConfiguration()->_executionMode == ExecutionMode_AUTO;
+    int interOpThreads = graph->getExecutorConfiguration()->_interOpThreads > 0 ? graph->getExecutorConfiguration()->_interOpThreads : Environment::getInstance().maxMasterThreads();
 
 
     // basically if at some point code diverges, code branch might be _DISABLED_, and all nodes within that branch will be disabled as well
@@ -249,8 +381,20 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
     for (int l = 0; l < (int) graph->getOnion()->size(); l++) {
         int layerSize = graph->getOnion()->count(l) == 1 ? graph->getOnion()->at(l)->size() : 0;
 
+        // nodes within the same layer do not depend on each other, so in AUTO mode we execute them concurrently
+        if (pe && layerSize > 1 && frames.empty() && !leftFrame && !Environment::getInstance().isProfiling() && !Environment::getInstance().isDebugAndVerbose() && isParallelLayer(graph, l)) {
+            exec_counter += layerSize;
+            if (exec_counter > 10000)
+                return Status::THROW("Early termination hit");
+
+            auto status = executeLayerParallel(graph, l, __variableSpace, interOpThreads);
+            if (status != Status::OK())
+                return status;
+
+            continue;
+        }
+
         int n = 0;
-// this omp block will probably never be the case
         for (; n < layerSize; n++) {
             if (++exec_counter > 10000) {
                 l = graph->getOnion()->size();
@@ -301,36 +445,7 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
 
                 } else {
                     // let's check for input nodes, if they are disabled or contain divergents
-                    for (int e = 0; e < node->input()->size(); e++) {
-                        auto inputId = node->input()->at(e);
-
-                        // not a node. skipping checks
-                        if (graph->getMapped()->count(inputId.first) == 0)
-                            continue;
-
-                        /**
-                         * We can skip current node, in two cases:
-                         * 1) If previous node was disabled
-                         * 2) If previous node was divergent node (i.e. IF op) and code went other way
-                         */
-                        Node *prevNode = graph->getMapped()->at(inputId.first);
-                        if (!flowPath->isNodeActive(inputId.first)) {
-                            shouldSkip = true;
-                            flowPath->markNodeActive(node->id(), false);
-
-                            nd4j_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
-                            break;
-
-                        } else if (prevNode->isDivergencePoint()) { // literally checking for switch here
-                            if (flowPath->branch(inputId.first) != inputId.second) {
-                                shouldSkip = true;
-                                flowPath->markNodeActive(node->id(), false);
-                                nd4j_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(),
-                                           inputId.first);
-                                break;
-                            }
-                        }
-                    }
+                    shouldSkip = hasInactiveInputs(graph, node, flowPath);
                 }
 
                 if (shouldSkip)
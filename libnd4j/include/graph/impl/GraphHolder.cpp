@@ -30,14 +30,34 @@ namespace sd {
           return instance;
         };
 
+        void GraphHolder::prepareGraph(Graph *graph) {
+#ifndef __CUDABLAS__
+            // folding and fusion go first, so planner sees final nodes only. folding is opt-in
+            if (graph->getExecutorConfiguration()->_foldFakeQuantization)
+                graph->foldFakeQuantization();
+
+            graph->fuseElementwise();
+
+            // graphs with logic ops or unknown input shapes just stay unplanned
+            if (graph->planMemory() == Status::OK())
+                nd4j_debug("GraphHolder: graph planned with %lld bytes footprint\n", graph->memoryPlan()->peakMemory());
+#endif
+        }
+
         void GraphHolder::registerGraph(Nd4jLong graphId, Graph* graph) {
             if (hasGraphAny(graphId))
                 throw graph_exists_exception(graphId);
 
+            prepareGraph(graph);
+
             _graphF[graphId] = graph;
+            _pools[graphId] = new GraphPool(graph);
 
-            sd::SimpleReadWriteLock lock;
-            _locks[graphId] = lock;
+            // lock outlives dropped graph, so requests holding it aren't affected by registration under the same id
+            if (_locks.count(graphId) == 0) {
+                sd::SimpleReadWriteLock lock;
+                _locks[graphId] = lock;
+            }
         }
 
         Graph* GraphHolder::cloneGraph(Nd4jLong graphId) {
@@ -51,6 +71,25 @@ namespace sd {
             return graph;
         }
 
+        Graph* GraphHolder::acquireGraph(Nd4jLong graphId) {
+            auto pool = _pools.find(graphId);
+            if (pool == _pools.end())
+                throw unknown_graph_exception(graphId);
+
+            return pool->second->acquire();
+        }
+
+        void GraphHolder::releaseGraph(Nd4jLong graphId, Graph *graph) {
+            // if graph was dropped meanwhile - clone just goes away
+            auto pool = _pools.find(graphId);
+            if (pool == _pools.end()) {
+                delete graph;
+                return;
+            }
+
+            pool->second->release(graph);
+        }
+
         Graph* GraphHolder::pullGraph(Nd4jLong graphId) {
             if (!this->hasGraph(graphId)) {
                 nd4j_printf("GraphHolder doesn't have graph stored for [%lld]\n", graphId);
@@ -63,8 +102,12 @@ namespace sd {
         }
 
         void GraphHolder::forgetGraph(Nd4jLong graphId) {
-            if (this->hasGraph(graphId))
+            if (this->hasGraph(graphId)) {
                 _graphF.erase(graphId);
+
+                delete _pools[graphId];
+                _pools.erase(graphId);
+            }
         }
 
         void GraphHolder::dropGraph(Nd4jLong graphId) {
@@ -100,10 +143,16 @@ namespace sd {
                 return;
             }
 
+            prepareGraph(graph);
+
             this->lockWrite(graphId);
 
             _graphF[graphId] = graph;
 
+            // clones of previous graph aren't valid anymore
+            delete _pools[graphId];
+            _pools[graphId] = new GraphPool(graph);
+
             this->unlockWrite(graphId);
         }
 
@@ -111,16 +160,30 @@ namespace sd {
 
 
         flatbuffers::Offset<FlatResult> GraphHolder::execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request) {
-            if (!hasGraph(graphId))
+            auto lock = _locks.find(graphId);
+            if (lock == _locks.end())
                 throw unknown_graph_exception(graphId);
 
-            lockRead(graphId);
+            // read lock only guards against concurrent drop/replace, requests are executed in parallel on pooled clones
+            ReadLockGuard guard(lock->second);
+
+            // graph might be dropped before read lock was obtained
+            auto pool = _pools.find(graphId);
+            if (pool == _pools.end())
+                throw unknown_graph_exception(graphId);
 
-            auto graph = cloneGraph(graphId);
-            auto res = GraphExecutioner::execute(graph, builder, request);
-            delete graph;
+            auto graph = pool->second->acquire();
+
+            flatbuffers::Offset<FlatResult> res;
+            try {
+                res = GraphExecutioner::execute(graph, builder, request);
+            } catch (...) {
+                // state of this clone is unknown, so it's not going back to the pool
+                delete graph;
+                throw;
+            }
 
-            unlockRead(graphId);
+            pool->second->release(graph);
 
             return res;
         }
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <graph/GraphPool.h>
+#include <graph/VariableProxy.h>
+#include <system/Environment.h>
+#include <math/templatemath.h>
+
+namespace sd {
+    namespace graph {
+        GraphPool::GraphPool(Graph* origin, int size) {
+            _origin = origin;
+            _size = size > 0 ? size : sd::math::nd4j_max<int>(1, Environment::getInstance().maxMasterThreads());
+            _slots.reset(new std::atomic<Graph*>[_size]);
+
+            for (int e = 0; e < _size; e++)
+                _slots[e].store(nullptr);
+
+            // first clone is built eagerly: we need it to know which node outputs should be shadowed
+            auto graph = _origin->cloneWithProxy();
+            for (const auto &v: *graph->getMapped())
+                _nodes.emplace_back(v.first);
+
+            reset(graph);
+            _slots[0].store(graph);
+        }
+
+        GraphPool::~GraphPool() {
+            for (int e = 0; e < _size; e++)
+                delete _slots[e].exchange(nullptr);
+        }
+
+        Graph* GraphPool::create() {
+            auto graph = _origin->cloneWithProxy();
+            reset(graph);
+
+            return graph;
+        }
+
+        void GraphPool::reset(Graph* graph) {
+            auto proxy = dynamic_cast<VariableProxy*>(graph->getVariableSpace());
+            if (proxy == nullptr)
+                throw std::runtime_error("GraphPool: only Graph::cloneWithProxy() instances can be pooled");
+
+            proxy->reset(_nodes);
+
+            // each clone has its own arena, allocated once
+            if (graph->memoryPlan() != nullptr)
+                graph->memoryPlan()->bind(proxy);
+        }
+
+        Graph* GraphPool::acquire() {
+            for (int e = 0; e < _size; e++) {
+                // cheap check first, to avoid exchanges on empty slots
+                if (_slots[e].load(std::memory_order_relaxed) == nullptr)
+                    continue;
+
+                auto graph = _slots[e].exchange(nullptr, std::memory_order_acquire);
+                if (graph != nullptr)
+                    return graph;
+            }
+
+            return create();
+        }
+
+        void GraphPool::release(Graph* graph) {
+            if (graph == nullptr)
+                return;
+
+            reset(graph);
+
+            for (int e = 0; e < _size; e++) {
+                Graph* expected = nullptr;
+                if (_slots[e].compare_exchange_strong(expected, graph, std::memory_order_release, std::memory_order_relaxed))
+                    return;
+            }
+
+            // pool is full already
+            delete graph;
+        }
+
+        int GraphPool::size() const {
+            return _size;
+        }
+
+        int GraphPool::available() const {
+            int cnt = 0;
+            for (int e = 0; e < _size; e++)
+                if (_slots[e].load() != nullptr)
+                    cnt++;
+
+            return cnt;
+        }
+    }
+}
@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <graph/MemoryPlan.h>
+#include <graph/VariableProxy.h>
+#include <algorithm>
+
+namespace sd {
+    namespace graph {
+        MemoryPlan::MemoryPlan(const std::vector<Tensor> &tensors, const std::vector<Tensor> &inputs) {
+            _tensors = tensors;
+            _inputs = inputs;
+
+            for (auto &t: _tensors) {
+                t.bytes = ((t.bytes + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+                _naive += t.bytes;
+            }
+
+            assignOffsets();
+        }
+
+        MemoryPlan::~MemoryPlan() {
+            for (auto v: _arrays)
+                delete v;
+
+            delete _arena;
+        }
+
+        void MemoryPlan::assignOffsets() {
+            // greedy by size: biggest tensors are placed first, each one at the lowest offset
+            // that doesn't intersect with already placed tensors alive at the same time
+            std::vector<int> order(_tensors.size());
+            for (int e = 0; e < (int) order.size(); e++)
+                order[e] = e;
+
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) -> bool {
+                return _tensors[a].bytes > _tensors[b].bytes;
+            });
+
+            std::vector<int> placed;
+            std::vector<const Tensor*> conflicts;
+
+            for (auto i: order) {
+                auto &t = _tensors[i];
+
+                conflicts.clear();
+                for (auto p: placed) {
+                    auto &o = _tensors[p];
+                    if (o.firstLayer <= t.lastLayer && t.firstLayer <= o.lastLayer)
+                        conflicts.emplace_back(&o);
+                }
+
+                std::sort(conflicts.begin(), conflicts.end(), [](const Tensor* a, const Tensor* b) -> bool {
+                    return a->offset < b->offset;
+                });
+
+                Nd4jLong offset = 0;
+                for (auto c: conflicts) {
+                    if (offset + t.bytes <= c->offset)
+                        break;
+
+                    offset = sd::math::nd4j_max<Nd4jLong>(offset, c->offset + c->bytes);
+                }
+
+                t.offset = offset;
+                _peak = sd::math::nd4j_max<Nd4jLong>(_peak, offset + t.bytes);
+
+                placed.emplace_back(i);
+            }
+        }
+
+        Nd4jLong MemoryPlan::peakMemory() const {
+            return _peak;
+        }
+
+        Nd4jLong MemoryPlan::naiveMemory() const {
+            return _naive;
+        }
+
+        const std::vector<MemoryPlan::Tensor>& MemoryPlan::tensors() const {
+            return _tensors;
+        }
+
+        bool MemoryPlan::hasTensor(const std::pair<int, int> &variable) const {
+            for (const auto &t: _tensors)
+                if (t.variable == variable)
+                    return true;
+
+            return false;
+        }
+
+        void MemoryPlan::bind(VariableSpace *variableSpace) {
+#ifdef __CUDABLAS__
+            throw std::runtime_error("MemoryPlan: static memory planning isn't supported on CUDA yet");
+#else
+            if (_arena == nullptr && _peak > 0) {
+                _arena = new sd::memory::Workspace(_peak);
+                auto base = reinterpret_cast<int8_t*>(_arena->allocateBytes(_peak));
+
+                for (const auto &t: _tensors)
+                    _arrays.emplace_back(new NDArray(base + t.offset, t.shapeInfo, sd::LaunchContext::defaultContext(), false));
+            }
+
+            // proxy must never touch variables of backing VariableSpace, so planned arrays always go to proxy itself
+            auto proxy = dynamic_cast<VariableProxy*>(variableSpace);
+
+            for (int e = 0; e < (int) _arrays.size(); e++) {
+                auto pair = _tensors[e].variable;
+                auto array = _arrays[e];
+
+                if (proxy != nullptr ? proxy->hasLocalVariable(pair) : variableSpace->hasVariable(pair)) {
+                    auto var = variableSpace->getVariable(pair);
+                    if (var->hasNDArray() && var->getNDArray() != array && var->isRemovable())
+                        delete var->getNDArray();
+
+                    var->setNDArray(array);
+                    var->markRemovable(false);
+                } else {
+                    auto var = variableSpace->putVariable(pair.first, pair.second, array);
+                    var->markRemovable(false);
+                }
+            }
+
+            _bound = true;
+#endif
+        }
+
+        bool MemoryPlan::matches(VariableSpace *variableSpace) const {
+            for (const auto &t: _inputs) {
+                auto pair = t.variable;
+                if (!variableSpace->hasVariable(pair))
+                    return false;
+
+                auto var = variableSpace->getVariable(pair);
+                if (!var->hasNDArray())
+                    return false;
+
+                auto shape = var->getNDArray()->shapeInfo();
+                if (!shape::equalsSoft(shape, t.shapeInfo) || ArrayOptions::dataType(shape) != ArrayOptions::dataType(t.shapeInfo))
+                    return false;
+            }
+
+            return true;
+        }
+
+        void MemoryPlan::unbind(VariableSpace *variableSpace) {
+            for (int e = 0; e < (int) _arrays.size(); e++) {
+                auto pair = _tensors[e].variable;
+                if (!variableSpace->hasVariable(pair))
+                    continue;
+
+                auto var = variableSpace->getVariable(pair);
+                if (var->getNDArray() == _arrays[e]) {
+                    var->setNDArray(nullptr);
+                    var->markRemovable(true);
+                }
+            }
+
+            _bound = false;
+        }
+
+        bool MemoryPlan::isBound() const {
+            return _bound;
+        }
+
+        MemoryPlan* MemoryPlan::clone() const {
+            auto clone = new MemoryPlan(std::vector<Tensor>());
+            clone->_tensors = _tensors;
+            clone->_inputs = _inputs;
+            clone->_peak = _peak;
+            clone->_naive = _naive;
+
+            return clone;
+        }
+    }
+}
@@ -0,0 +1,404 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <graph/RequestBatcher.h>
+#include <graph/GraphHolder.h>
+#include <graph/GraphExecutioner.h>
+#include <graph/ExecutionResult.h>
+#include <exceptions/graph_execution_exception.h>
+#include <exceptions/no_results_exception.h>
+#include <chrono>
+
+namespace sd {
+    namespace graph {
+        struct RequestBatcher::Entry {
+            std::vector<Variable*> inputs;
+            std::vector<Variable*> outputs;
+            Nd4jLong size = 0;
+
+            std::exception_ptr error;
+            bool done = false;
+
+            ~Entry() {
+                for (auto v: inputs)
+                    delete v;
+            }
+        };
+
+        struct RequestBatcher::Batch {
+            std::vector<Entry*> entries;
+            Nd4jLong size = 0;
+            bool closed = false;
+
+            std::condition_variable condition;
+        };
+
+        RequestBatcher::RequestBatcher(int maxBatchSize, Nd4jLong maxWait) {
+            _maxBatchSize = maxBatchSize;
+            _maxWait = maxWait;
+        }
+
+        int RequestBatcher::maxBatchSize() const {
+            return _maxBatchSize;
+        }
+
+        Nd4jLong RequestBatcher::maxWait() const {
+            return _maxWait;
+        }
+
+        Nd4jLong RequestBatcher::requests() const {
+            return _requests.load();
+        }
+
+        Nd4jLong RequestBatcher::batches() const {
+            return _batches.load();
+        }
+
+        bool RequestBatcher::compatible(const Entry &first, const Entry &other) {
+            if (first.inputs.size() != other.inputs.size())
+                return false;
+
+            for (size_t e = 0; e < first.inputs.size(); e++) {
+                auto a = first.inputs[e];
+                auto b = other.inputs[e];
+
+                if (a->id() != b->id() || a->index() != b->index())
+                    return false;
+
+                auto x = a->getNDArray();
+                auto y = b->getNDArray();
+                if (x->dataType() != y->dataType() || x->rankOf() != y->rankOf())
+                    return false;
+
+                for (int d = 1; d < x->rankOf(); d++)
+                    if (x->sizeAt(d) != y->sizeAt(d))
+                        return false;
+            }
+
+            return true;
+        }
+
+        bool RequestBatcher::rowIndependent(Graph *graph) {
+            for (auto &v: *graph->getMapped()) {
+                auto node = v.second;
+
+                std::vector<int> dims;
+                switch (node->opType()) {
+                    case OpType_REDUCE_FLOAT:
+                    case OpType_REDUCE_SAME:
+                    case OpType_REDUCE_BOOL:
+                    case OpType_REDUCE_LONG:
+                    case OpType_REDUCE_3:
+                    case OpType_INDEX_REDUCE:
+                    case OpType_SUMMARYSTATS: {
+                            // dimensions given as input aren't known before execution
+                            if (node->input()->size() > 1)
+                                return false;
+
+                            dims = *node->getDimensions();
+                            for (auto d: *node->getContextPrototype()->getAxis())
+                                dims.emplace_back(d);
+                        }
+                        break;
+                    case OpType_CUSTOM: {
+                            auto name = node->getCustomOp()->getOpName();
+                            if (name->compare(0, 7, "reduce_") != 0 && *name != "moments" && *name != "sufficient_statistics")
+                                continue;
+
+                            if (node->input()->size() > 1)
+                                return false;
+
+                            dims = *node->getContextPrototype()->getIArguments();
+                        }
+                        break;
+                    default:
+                        continue;
+                }
+
+                // empty dimensions mean reduction over whole array. negative ones can't be resolved without rank
+                if (dims.empty())
+                    return false;
+
+                for (auto d: dims)
+                    if (d <= 0)
+                        return false;
+            }
+
+            return true;
+        }
+
+        void RequestBatcher::executeOnce(Nd4jLong graphId, const std::vector<Variable*> &inputs, std::vector<Variable*> &outputs) {
+            auto &holder = GraphHolder::getInstance();
+            if (!holder.hasGraph(graphId))
+                throw unknown_graph_exception(graphId);
+
+            holder.lockRead(graphId);
+            auto graph = holder.acquireGraph(graphId);
+
+            try {
+                auto varSpace = graph->getVariableSpace();
+                for (auto v: inputs) {
+                    // inputs stay owned by caller
+                    auto name = v->getName();
+                    auto wrapper = new Variable(v->getNDArray(), name != nullptr ? name->c_str() : nullptr, v->id(), v->index());
+                    wrapper->markRemovable(false);
+                    varSpace->replaceVariable(wrapper);
+                }
+
+                auto status = GraphExecutioner::execute(graph);
+                if (status != sd::Status::OK())
+                    throw graph_execution_exception(graphId);
+
+                std::unique_ptr<std::vector<Variable*>> result(graph->fetchOutputs());
+                if (result->empty())
+                    throw no_results_exception(graphId);
+
+                // clone goes back to the pool, so outputs are detached from it
+                for (auto v: *result) {
+                    auto name = v->getName();
+                    auto array = v->hasNDArray() ? new NDArray(v->getNDArray()->dup()) : nullptr;
+                    outputs.emplace_back(new Variable(array, name != nullptr ? name->c_str() : nullptr, v->id(), v->index()));
+                }
+
+                holder.releaseGraph(graphId, graph);
+                holder.unlockRead(graphId);
+            } catch (...) {
+                delete graph;
+                holder.unlockRead(graphId);
+
+                for (auto v: outputs)
+                    delete v;
+
+                outputs.clear();
+                throw;
+            }
+        }
+
+        void RequestBatcher::executeBatch(Nd4jLong graphId, Batch &batch) {
+            _batches++;
+
+            auto &entries = batch.entries;
+            if (entries.size() == 1) {
+                executeOnce(graphId, entries[0]->inputs, entries[0]->outputs);
+                return;
+            }
+
+            // merging inputs along batch dimension
+            std::vector<Variable*> merged;
+            for (size_t i = 0; i < entries[0]->inputs.size(); i++) {
+                auto first = entries[0]->inputs[i];
+                auto shape = first->getNDArray()->getShapeAsVector();
+                shape[0] = batch.size;
+
+                auto array = new NDArray('c', shape, first->getNDArray()->dataType());
+                std::vector<Nd4jLong> indices(2 * shape.size(), 0);
+
+                Nd4jLong offset = 0;
+                for (auto entry: entries) {
+                    indices[0] = offset;
+                    indices[1] = offset + entry->size;
+                    (*array)(indices, true).assign(entry->inputs[i]->getNDArray());
+
+                    offset += entry->size;
+                }
+
+                auto name = first->getName();
+                merged.emplace_back(new Variable(array, name != nullptr ? name->c_str() : nullptr, first->id(), first->index()));
+            }
+
+            std::vector<Variable*> outputs;
+            try {
+                executeOnce(graphId, merged, outputs);
+            } catch (...) {
+                for (auto v: merged)
+                    delete v;
+
+                throw;
+            }
+
+            for (auto v: merged)
+                delete v;
+
+            // outputs can be scattered back only if all of them have batch dimension
+            bool scatterable = true;
+            for (auto v: outputs)
+                if (!v->hasNDArray() || v->getNDArray()->rankOf() == 0 || v->getNDArray()->sizeAt(0) != batch.size)
+                    scatterable = false;
+
+            if (scatterable) {
+                Nd4jLong offset = 0;
+                for (auto entry: entries) {
+                    for (auto v: outputs) {
+                        auto array = v->getNDArray();
+                        std::vector<Nd4jLong> indices(2 * array->rankOf(), 0);
+                        indices[0] = offset;
+                        indices[1] = offset + entry->size;
+
+                        auto name = v->getName();
+                        auto slice = new NDArray((*array)(indices, true).dup());
+                        entry->outputs.emplace_back(new Variable(slice, name != nullptr ? name->c_str() : nullptr, v->id(), v->index()));
+                    }
+
+                    offset += entry->size;
+                }
+            }
+
+            for (auto v: outputs)
+                delete v;
+
+            // each request fails on its own here, so one bad request doesn't fail its neighbours
+            if (!scatterable) {
+                for (auto entry: entries) {
+                    _batches++;
+
+                    try {
+                        executeOnce(graphId, entry->inputs, entry->outputs);
+                    } catch (...) {
+                        entry->error = std::current_exception();
+                    }
+                }
+            }
+        }
+
+        flatbuffers::Offset<FlatResult> RequestBatcher::execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request) {
+            _requests++;
+
+            Entry entry;
+            bool batchable = _maxBatchSize > 1;
+
+            if (request != nullptr && request->variables() != nullptr) {
+                auto vars = request->variables();
+                for (int e = 0; e < (int) vars->size(); e++) {
+                    auto v = new Variable(vars->Get(e));
+                    entry.inputs.emplace_back(v);
+
+                    // only arrays with batch dimension can be merged, and all of them must agree on its size
+                    if (!v->hasNDArray() || v->getNDArray()->rankOf() == 0) {
+                        batchable = false;
+                        continue;
+                    }
+
+                    auto size = v->getNDArray()->sizeAt(0);
+                    if (entry.size == 0)
+                        entry.size = size;
+                    else if (entry.size != size)
+                        batchable = false;
+                }
+            }
+
+            if (entry.size == 0 || entry.size >= _maxBatchSize)
+                batchable = false;
+
+            if (batchable) {
+                auto &holder = GraphHolder::getInstance();
+                if (!holder.hasGraph(graphId))
+                    throw unknown_graph_exception(graphId);
+
+                holder.lockRead(graphId);
+                try {
+                    batchable = rowIndependent(holder.pullGraph(graphId));
+                } catch (...) {
+                    holder.unlockRead(graphId);
+                    throw;
+                }
+                holder.unlockRead(graphId);
+            }
+
+            if (!batchable) {
+                _batches++;
+                executeOnce(graphId, entry.inputs, entry.outputs);
+            } else {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                auto it = _open.find(graphId);
+                std::shared_ptr<Batch> batch = it != _open.end() ? it->second : nullptr;
+
+                if (batch != nullptr && !batch->closed && batch->size + entry.size <= _maxBatchSize && compatible(*batch->entries[0], entry)) {
+                    // joining open batch, leader does the rest
+                    batch->entries.emplace_back(&entry);
+                    batch->size += entry.size;
+
+                    if (batch->size >= _maxBatchSize)
+                        batch->condition.notify_all();
+
+                    batch->condition.wait(lock, [&] { return entry.done; });
+                } else if (batch != nullptr && !batch->closed) {
+                    // incompatible with open batch, this request goes on its own
+                    lock.unlock();
+
+                    _batches++;
+                    executeOnce(graphId, entry.inputs, entry.outputs);
+                } else {
+                    // opening new batch, this thread becomes its leader
+                    batch = std::make_shared<Batch>();
+                    batch->entries.emplace_back(&entry);
+                    batch->size = entry.size;
+                    _open[graphId] = batch;
+
+                    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(_maxWait);
+                    batch->condition.wait_until(lock, deadline, [&] { return batch->size >= _maxBatchSize; });
+
+                    batch->closed = true;
+                    _open.erase(graphId);
+                    lock.unlock();
+
+                    std::exception_ptr error;
+                    try {
+                        executeBatch(graphId, *batch);
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+
+                    // every request of the batch must be woken up, whatever happened above
+                    lock.lock();
+                    for (auto e: batch->entries) {
+                        if (error)
+                            e->error = error;
+
+                        if (e->error) {
+                            for (auto v: e->outputs)
+                                delete v;
+
+                            e->outputs.clear();
+                        }
+
+                        e->done = true;
+                    }
+
+                    batch->condition.notify_all();
+                }
+            }
+
+            if (entry.error)
+                std::rethrow_exception(entry.error);
+
+            ExecutionResult result;
+            for (auto v: entry.outputs)
+                result.emplace_back(v);
+
+            auto offset = result.asFlatResult(builder);
+
+            for (auto v: entry.outputs)
+                delete v;
+
+            return offset;
+        }
+    }
+}
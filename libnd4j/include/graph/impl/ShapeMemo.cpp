@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <graph/ShapeMemo.h>
+#include <graph/ContextPrototype.h>
+#include <helpers/ConstantShapeHelper.h>
+#include <array/ShapeDescriptor.h>
+#include <cstring>
+
+namespace sd {
+    namespace graph {
+        void ShapeMemo::buildKey(std::vector<Nd4jLong> &key, Nd4jLong opHash, ShapeList &inputShapes, ContextPrototype &block) {
+            key.clear();
+            key.emplace_back(opHash);
+            key.emplace_back(static_cast<Nd4jLong>(block.dataType()));
+
+            // sections are prefixed with their length, so different splits can't produce equal keys
+            key.emplace_back(inputShapes.size());
+            for (int e = 0; e < inputShapes.size(); e++) {
+                auto shapeInfo = inputShapes.at(e);
+                if (shapeInfo == nullptr) {
+                    key.emplace_back(-1);
+                    continue;
+                }
+
+                auto length = shape::shapeInfoLength(shapeInfo);
+                key.insert(key.end(), shapeInfo, shapeInfo + length);
+            }
+
+            auto iArgs = block.getIArguments();
+            key.emplace_back(iArgs->size());
+            key.insert(key.end(), iArgs->begin(), iArgs->end());
+
+            auto tArgs = block.getTArguments();
+            key.emplace_back(tArgs->size());
+            for (auto v: *tArgs) {
+                Nd4jLong bits;
+                std::memcpy(&bits, &v, sizeof(bits));
+                key.emplace_back(bits);
+            }
+
+            auto bArgs = block.getBArguments();
+            key.emplace_back(bArgs->size());
+            for (auto v: *bArgs)
+                key.emplace_back(v ? 1 : 0);
+
+            auto dArgs = block.getDArguments();
+            key.emplace_back(dArgs->size());
+            for (auto v: *dArgs)
+                key.emplace_back(static_cast<Nd4jLong>(v));
+
+            auto axis = block.getAxis();
+            key.emplace_back(axis->size());
+            key.insert(key.end(), axis->begin(), axis->end());
+        }
+
+        bool ShapeMemo::lookup(const std::vector<Nd4jLong> &key, ShapeList &shapes) {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (_key.empty() || _key != key) {
+                _misses++;
+                return false;
+            }
+
+            _hits++;
+            for (auto s: _shapes)
+                shapes.push_back(s);
+
+            return true;
+        }
+
+        void ShapeMemo::store(const std::vector<Nd4jLong> &key, ShapeList &shapes) {
+            // shape functions may return workspace-allocated shapes, so we keep constant copies only
+            std::vector<const Nd4jLong*> constants;
+            for (int e = 0; e < shapes.size(); e++)
+                constants.emplace_back(ConstantShapeHelper::getInstance().createShapeInfo(ShapeDescriptor(shapes.at(e))));
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _key = key;
+            _shapes = constants;
+        }
+
+        void ShapeMemo::reset() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _key.clear();
+            _shapes.clear();
+        }
+
+        Nd4jLong ShapeMemo::hits() {
+            return _hits;
+        }
+
+        Nd4jLong ShapeMemo::misses() {
+            return _misses;
+        }
+    }
+}
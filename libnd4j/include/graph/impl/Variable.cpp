@@ -320,7 +320,7 @@ namespace sd {
                 auto array = this->getNDArray();
                 auto fShape = builder.CreateVector(array->getShapeInfoAsFlatVector());
 
-                auto fBuffer = builder.CreateVector(array->asByteVector());
+                auto fBuffer = FlatUtils::toFlatBuffer(builder, *array);
 
                 // packing array
                 auto fArray = CreateFlatArray(builder, fShape, fBuffer, (sd::graph::DType) array->dataType());
@@ -37,6 +37,28 @@ namespace sd {
             delete _current;
         }
 
+        void VariableProxy::reset(const std::vector<int> &nodes) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
+            delete _current;
+            _current = new VariableSpace();
+
+            for (auto id: nodes) {
+                for (int idx = 0; _backed->hasVariable(id, idx); idx++) {
+                    auto origin = _backed->getVariable(id, idx);
+                    if (origin->hasNDArray() || origin->hasNDArrayList())
+                        continue;
+
+                    auto name = origin->getName() != nullptr && !origin->getName()->empty() ? origin->getName()->c_str() : nullptr;
+                    auto shadow = new Variable(nullptr, name, id, idx);
+                    shadow->markRemovable(origin->isRemovable());
+
+                    std::pair<int, int> pair(id, idx);
+                    _current->putVariable(pair, shadow);
+                }
+            }
+        }
+
         
         int VariableProxy::numberOfPlaceholders() {
             return _backed->numberOfPlaceholders();
@@ -63,19 +85,31 @@ namespace sd {
 
         
         bool VariableProxy::hasVariable(int id) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->hasVariable(id) || _backed->hasVariable(id);
         }
         
         
         bool VariableProxy::hasVariable(int id, int idx) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->hasVariable(id, idx) || _backed->hasVariable(id, idx);
         }
         
         
         bool VariableProxy::hasVariable(std::pair<int,int>& pair) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->hasVariable(pair) || _backed->hasVariable(pair);
         }
 
+        bool VariableProxy::hasLocalVariable(std::pair<int,int>& pair) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
+            return _current->hasVariable(pair);
+        }
+
         
         void VariableProxy::dropVariable(std::pair<int,int> &pair) {
             dropVariable(pair.first, pair.second);
@@ -83,6 +117,8 @@ namespace sd {
 
         
         void VariableProxy::dropVariable(int id, int idx) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             assert(_current->hasVariable(id, idx));
 
             _current->dropVariable(id, idx);
@@ -90,6 +126,8 @@ namespace sd {
 
         
         std::vector<Variable*> VariableProxy::getVariables() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             std::vector<Variable*> result;
 
             auto b = _backed->getVariables();
@@ -106,11 +144,15 @@ namespace sd {
 
         
         bool VariableProxy::hasVariable(std::string *symbol) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->hasVariable(symbol) || _backed->hasVariable(symbol);
         }
 
         
         sd::graph::Variable *VariableProxy::getVariable(int id) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             if (_current->hasVariable(id))
                 return _current->getVariable(id);
             
@@ -123,6 +165,8 @@ namespace sd {
 
         
         sd::graph::Variable *VariableProxy::getVariable(int id, int idx) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             if (_current->hasVariable(id, idx))
                 return _current->getVariable(id, idx);
             
@@ -135,6 +179,8 @@ namespace sd {
 
         
         sd::graph::Variable *VariableProxy::getVariable(std::pair<int,int>& pair) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             if (_current->hasVariable(pair))
                 return _current->getVariable(pair);
             
@@ -147,6 +193,8 @@ namespace sd {
 
         
         sd::graph::Variable *VariableProxy::getVariable(std::string *symbol) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             if (_current->hasVariable(symbol))
                 return _current->getVariable(symbol);
             
@@ -159,6 +207,8 @@ namespace sd {
 
         
         void VariableProxy::replaceVariable(Variable *variable) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             if (variable->getName() != nullptr && !variable->getName()->empty()) {
                 // if variable has name defined - we should resolve it via backing var space
                 if (_backed->hasVariable(variable->getName())) {
@@ -173,94 +223,132 @@ namespace sd {
 
         
         Variable* VariableProxy::putVariable(std::pair<int,int>& pair, NDArray *array) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->putVariable(pair, array);
         }
 
         
         void VariableProxy::putVariable(std::pair<int,int>& pair, Variable *variable) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->putVariable(pair, variable);
         }
 
         
         void VariableProxy::putVariable(int id, Variable *variable) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->putVariable(id, variable);
         }
 
         
         void VariableProxy::putVariable(int id, NDArray *array) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->putVariable(id, array);
         }
 
         void sd::graph::VariableProxy::putVariable(int id, int idx, NDArray &array) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->putVariable(id, idx, array);
         }
         
         Variable* VariableProxy::putVariable(int id, int idx, NDArray *array) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->putVariable(id, idx, array);
         }
 
         
         void VariableProxy::putVariable(int id, int idx, Variable *array) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->putVariable(id, idx, array);
         }
 
         
         void VariableProxy::trackList(sd::NDArrayList* list) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->trackList(list);
         }
 
         
         sd::graph::Stash* VariableProxy::getStash() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->getStash();
         }
 
         
         void VariableProxy::setFlowPath(FlowPath* timers) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->setFlowPath(timers);
         }
 
         
         FlowPath* VariableProxy::flowPath() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _current->flowPath();
         }
 
         
         void VariableProxy::putOutputVariable(Variable *variable) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _current->putOutputVariable(variable);
         }
 
         
         Nd4jLong VariableProxy::externalMemory() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _backed->externalMemory() + _current->externalMemory();
         }
 
         
         Nd4jLong VariableProxy::internalMemory() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _backed->internalMemory() + _current->internalMemory();
         }
 
         
         Nd4jLong VariableProxy::totalMemory() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _backed->totalMemory() + _current->totalMemory();
         }
 
         
         int VariableProxy::externalEntries() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _backed->externalEntries() + _current->externalEntries();
         }
 
         
         int VariableProxy::internalEntries() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _backed->internalEntries() + _current->internalEntries();
         }
 
         
         int VariableProxy::totalEntries() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _backed->totalEntries() + _current->totalEntries();
         }
 
         
         sd::graph::VariableSpace* VariableProxy::clone() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             auto clone = new VariableProxy(_backed);
 
             delete clone->_current;
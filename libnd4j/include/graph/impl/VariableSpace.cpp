@@ -90,10 +90,14 @@ namespace sd {
         }
 
         bool sd::graph::VariableSpace::hasVariable(std::string *symbol) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _symbolic.count(*symbol) == 1;
         }
 
         sd::graph::Variable * sd::graph::VariableSpace::getVariable(std::string *symbol) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _symbolic.at(*symbol);
         }
 
@@ -132,6 +136,8 @@ namespace sd {
         }
 
         sd::graph::Variable * sd::graph::VariableSpace::getVariable(std::pair<int, int>& pair) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             if (pair.first < 0)
                 return getVariable(pair.first);
             else
@@ -142,10 +148,14 @@ namespace sd {
         }
 
         bool sd::graph::VariableSpace::hasVariable(int id) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _variables.count(id) == 1 || _temporary.count(id) == 1;
         }
 
         bool sd::graph::VariableSpace::hasVariable(std::pair<int,int>& id) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             return _paired.count(id) > 0;
         }
 
@@ -176,6 +186,8 @@ namespace sd {
         }
 
         std::vector<Variable*> VariableSpace::getVariables() {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             std::vector<Variable*> result;
 
             for (auto v: _internal)
@@ -217,15 +229,15 @@ namespace sd {
         }
 
         void sd::graph::VariableSpace::silentPutVariable(std::pair<int,int>& pair, Variable *variable) {
-            _varmap.lock();
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
 
             //std::pair<std::pair<int, int>, sd::graph::Variable *> p(pair, variable);
             _paired[pair] = variable;
-
-            _varmap.unlock();
         }
 
         void sd::graph::VariableSpace::putVariable(std::pair<int,int>& pair, Variable *variable) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             silentPutVariable(pair, variable);
 
             if (variable->isPlaceholder())
@@ -239,19 +251,19 @@ namespace sd {
                     _symbolic[*(variable->getName())] = variable;
                 }
 
-                _varmap.lock();
-
                 _handles->push_back(variable);
-
-                _varmap.unlock();
             }
         }
 
         void VariableSpace::trackList(sd::NDArrayList* list) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             _lists.emplace_back(list);
         }
 
         void sd::graph::VariableSpace::putVariable(int id, Variable *variable) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             // we don't want to add variables more then once
             if (_variables.count(id) > 0 || _temporary.count(id) > 0) {
                 auto local = id < 0 ? _variables.at(id) : _temporary.at(id);
@@ -267,8 +279,6 @@ namespace sd {
                 return;
             }
 
-            _varmap.lock();
-
             _handles->emplace_back(variable);
 
             if (_auto_counter >= id)
@@ -294,8 +304,6 @@ namespace sd {
                 _temporary[id] = variable;
             }
 
-            _varmap.unlock();
-
             std::pair<int,int> pair(id, 0);
             if (!hasVariable(pair)) {
                 this->silentPutVariable(pair, variable);
@@ -326,6 +334,8 @@ namespace sd {
         }
 
         sd::graph::Variable * sd::graph::VariableSpace::getVariable(int id) {
+            std::lock_guard<std::recursive_mutex> lock(_varmap);
+
             if (id < 0) {
                 return _variables.at(id);
             } else {
@@ -0,0 +1,395 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_BARNESHUTTREE_H
+#define SD_BARNESHUTTREE_H
+
+#include <helpers/SortEngine.h>
+#include <system/Environment.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace sd {
+
+    /**
+     * This class implements space-partitioning tree used for Barnes-Hut approximation of t-SNE repulsive forces:
+     * quadtree for 2D embeddings, octree for 3D ones, and 2^D-ary tree in general.
+     *
+     * Root cell is centered at the mean of points and its half width along each dimension is the largest distance
+     * to the mean plus 1e-5. Points are quantized to the grid of the deepest level,
+     * their coordinates are interleaved into Morton keys and sorted, so every node covers contiguous range of
+     * sorted points. Nodes are created level by level in parallel and stored in flat array, children of each node
+     * are stored next to each other, and empty children aren't stored at all.
+     */
+    template <typename T>
+    class BarnesHutTree {
+    public:
+        struct Node {
+            Nd4jLong begin;         // range of sorted points covered by this node
+            Nd4jLong end;
+            Nd4jLong firstChild;    // -1 for leaves
+            int numChildren;
+            int level;
+        };
+
+    private:
+        // quantization bits per dimension, the same as maximal depth of the tree
+        static const int MAX_BITS = 21;
+
+        // nodes with at most this number of points aren't split
+        static const Nd4jLong LEAF_SIZE = 1;
+
+        // points are processed in blocks, partial sums are added in block order, so results don't depend on number of threads
+        static const Nd4jLong BLOCK = 1024;
+
+        Nd4jLong _numPoints = 0;
+        int _dims = 0;
+        int _bits = 0;
+
+        std::vector<Node> _nodes;
+        std::vector<Nd4jLong> _levels;      // offsets of levels in _nodes
+        std::vector<double> _centers;       // center of mass of each node
+        std::vector<double> _points;        // coordinates in sorted order
+        std::vector<Nd4jLong> _order;       // original index of each sorted point
+        std::vector<double> _widths;        // squared max half width of cells at each level
+
+        static FORCEINLINE void run(const FUNC_1D &func, Nd4jLong numChunks, int numThreads) {
+            if (numThreads > 1 && numChunks > 1)
+                samediff::Threads::parallel_tad(func, 0, numChunks, 1, numThreads);
+            else if (numChunks > 0)
+                func(0, 0, numChunks, 1);
+        }
+
+        /**
+         * Children of node at given level are runs of keys with the same prefix, so their bounds are found via binary search
+         */
+        template <typename F>
+        void forEachChild(const std::vector<uint64_t> &keys, const Node &node, F f) const {
+            const int shift = (_bits - 1 - node.level) * _dims;
+            auto cmp = [shift](uint64_t a, uint64_t b) { return (a >> shift) < (b >> shift); };
+
+            auto first = node.begin;
+            while (first < node.end) {
+                auto last = std::upper_bound(keys.begin() + first, keys.begin() + node.end, keys[first], cmp) - keys.begin();
+                f(first, static_cast<Nd4jLong>(last));
+                first = last;
+            }
+        }
+
+        void bounds(const T *data, int numThreads, std::vector<double> &mean, std::vector<double> &width) const {
+            const Nd4jLong chunk = 65536;
+            const Nd4jLong numChunks = (_numPoints + chunk - 1) / chunk;
+            std::vector<double> partial(numChunks * 3 * _dims);
+
+            auto func = PRAGMA_THREADS_FOR {
+                for (auto c = start; c < stop; c++) {
+                    double *sum = partial.data() + c * 3 * _dims;
+                    double *min = sum + _dims;
+                    double *max = min + _dims;
+                    for (int d = 0; d < _dims; d++) {
+                        sum[d] = 0.;
+                        min[d] = max[d] = static_cast<double>(data[c * chunk * _dims + d]);
+                    }
+
+                    auto last = sd::math::nd4j_min<Nd4jLong>(_numPoints, (c + 1) * chunk);
+                    for (Nd4jLong i = c * chunk; i < last; i++) {
+                        for (int d = 0; d < _dims; d++) {
+                            auto v = static_cast<double>(data[i * _dims + d]);
+                            sum[d] += v;
+                            min[d] = sd::math::nd4j_min<double>(min[d], v);
+                            max[d] = sd::math::nd4j_max<double>(max[d], v);
+                        }
+                    }
+                }
+            };
+            run(func, numChunks, numThreads);
+
+            mean.assign(_dims, 0.);
+            width.assign(_dims, 0.);
+            std::vector<double> min(partial.begin() + _dims, partial.begin() + 2 * _dims);
+            std::vector<double> max(partial.begin() + 2 * _dims, partial.begin() + 3 * _dims);
+            for (Nd4jLong c = 0; c < numChunks; c++) {
+                const double *p = partial.data() + c * 3 * _dims;
+                for (int d = 0; d < _dims; d++) {
+                    mean[d] += p[d];
+                    min[d] = sd::math::nd4j_min<double>(min[d], p[_dims + d]);
+                    max[d] = sd::math::nd4j_max<double>(max[d], p[2 * _dims + d]);
+                }
+            }
+
+            for (int d = 0; d < _dims; d++) {
+                mean[d] /= static_cast<double>(_numPoints);
+                width[d] = sd::math::nd4j_max<double>(max[d] - mean[d], mean[d] - min[d]) + 1e-5;
+            }
+        }
+
+        void sortPoints(const T *data, int numThreads, std::vector<uint64_t> &keys) {
+            std::vector<double> mean, width;
+            bounds(data, numThreads, mean, width);
+
+            const Nd4jLong cells = static_cast<Nd4jLong>(1) << _bits;
+            auto func = PRAGMA_THREADS_FOR {
+                std::vector<Nd4jLong> q(_dims);
+                for (auto i = start; i < stop; i++) {
+                    for (int d = 0; d < _dims; d++) {
+                        auto v = (static_cast<double>(data[i * _dims + d]) - mean[d] + width[d]) / (2. * width[d]);
+                        q[d] = sd::math::nd4j_min<Nd4jLong>(cells - 1, sd::math::nd4j_max<Nd4jLong>(0, static_cast<Nd4jLong>(v * cells)));
+                    }
+
+                    // interleaved bits, the most significant ones first: D bits per level
+                    uint64_t key = 0;
+                    for (int b = _bits - 1; b >= 0; b--)
+                        for (int d = 0; d < _dims; d++)
+                            key = (key << 1) | static_cast<uint64_t>((q[d] >> b) & 1);
+
+                    keys[i] = key;
+                    _order[i] = i;
+                }
+            };
+            samediff::Threads::parallel_for(func, 0, _numPoints, 1, numThreads);
+
+            SortEngine::radixSort(keys.data(), _order.data(), _numPoints, false, numThreads);
+
+            auto gather = PRAGMA_THREADS_FOR {
+                for (auto i = start; i < stop; i++)
+                    for (int d = 0; d < _dims; d++)
+                        _points[i * _dims + d] = static_cast<double>(data[_order[i] * _dims + d]);
+            };
+            samediff::Threads::parallel_for(gather, 0, _numPoints, 1, numThreads);
+
+            const double maxWidth = *std::max_element(width.begin(), width.end());
+            _widths.resize(_bits + 1);
+            for (int l = 0; l <= _bits; l++) {
+                auto w = maxWidth / static_cast<double>(static_cast<Nd4jLong>(1) << l);
+                _widths[l] = w * w;
+            }
+        }
+
+        FORCEINLINE bool isLeaf(const Node &node) const {
+            return node.end - node.begin <= LEAF_SIZE || node.level == _bits;
+        }
+
+        void buildNodes(const std::vector<uint64_t> &keys, int numThreads) {
+            _nodes.push_back({0, _numPoints, -1, 0, 0});
+            _levels = {0, 1};
+
+            std::vector<Nd4jLong> offsets;
+            while (true) {
+                const auto from = _levels[_levels.size() - 2];
+                const auto to = _levels.back();
+
+                offsets.assign(to - from + 1, 0);
+                auto count = PRAGMA_THREADS_FOR {
+                    for (auto i = start; i < stop; i++) {
+                        auto &node = _nodes[from + i];
+                        if (!isLeaf(node))
+                            forEachChild(keys, node, [&](Nd4jLong, Nd4jLong) { node.numChildren++; });
+
+                        offsets[i + 1] = node.numChildren;
+                    }
+                };
+                run(count, to - from, numThreads);
+
+                for (Nd4jLong i = 0; i < to - from; i++)
+                    offsets[i + 1] += offsets[i];
+
+                if (offsets.back() == 0)
+                    break;
+
+                _nodes.resize(to + offsets.back());
+
+                auto fill = PRAGMA_THREADS_FOR {
+                    for (auto i = start; i < stop; i++) {
+                        auto &node = _nodes[from + i];
+                        if (node.numChildren == 0)
+                            continue;
+
+                        node.firstChild = to + offsets[i];
+                        auto child = node.firstChild;
+                        forEachChild(keys, node, [&](Nd4jLong first, Nd4jLong last) {
+                            _nodes[child++] = {first, last, -1, 0, node.level + 1};
+                        });
+                    }
+                };
+                run(fill, to - from, numThreads);
+
+                _levels.push_back(to + offsets.back());
+            }
+        }
+
+        void buildCenters(int numThreads) {
+            _centers.resize(_nodes.size() * _dims);
+
+            // children are always on the next level, so levels are processed bottom-up
+            for (auto l = static_cast<Nd4jLong>(_levels.size()) - 2; l >= 0; l--) {
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto i = start; i < stop; i++) {
+                        const auto &node = _nodes[i];
+                        double *center = _centers.data() + i * _dims;
+                        for (int d = 0; d < _dims; d++)
+                            center[d] = 0.;
+
+                        if (node.numChildren == 0) {
+                            for (auto p = node.begin; p < node.end; p++)
+                                for (int d = 0; d < _dims; d++)
+                                    center[d] += _points[p * _dims + d];
+                        } else {
+                            for (auto c = node.firstChild; c < node.firstChild + node.numChildren; c++) {
+                                const auto size = static_cast<double>(_nodes[c].end - _nodes[c].begin);
+                                for (int d = 0; d < _dims; d++)
+                                    center[d] += size * _centers[c * _dims + d];
+                            }
+                        }
+
+                        const auto size = static_cast<double>(node.end - node.begin);
+                        for (int d = 0; d < _dims; d++)
+                            center[d] /= size;
+                    }
+                };
+                samediff::Threads::parallel_tad(func, _levels[l], _levels[l + 1], 1, numThreads);
+            }
+        }
+
+    public:
+        /**
+         * Builds the tree over rows of c-ordered numPoints x dims matrix
+         */
+        BarnesHutTree(const T *data, Nd4jLong numPoints, int dims, int numThreads = sd::Environment::getInstance().maxMasterThreads()) {
+            if (numPoints < 1 || dims < 1 || dims > 64)
+                throw std::invalid_argument("BarnesHutTree: there must be at least one point, and number of dimensions must be in range [1, 64]");
+
+            _numPoints = numPoints;
+            _dims = dims;
+            _bits = sd::math::nd4j_min<int>(MAX_BITS, 64 / dims);
+
+            std::vector<uint64_t> keys(numPoints);
+            _order.resize(numPoints);
+            _points.resize(numPoints * dims);
+
+            sortPoints(data, numThreads, keys);
+            buildNodes(keys, numThreads);
+            buildCenters(numThreads);
+        }
+
+        Nd4jLong numNodes() const {
+            return static_cast<Nd4jLong>(_nodes.size());
+        }
+
+        int depth() const {
+            return static_cast<int>(_levels.size()) - 1;
+        }
+
+        const std::vector<Node>& nodes() const {
+            return _nodes;
+        }
+
+        /**
+         * Computes unnormalized repulsive t-SNE forces for every point, i.e. sum of q_ij^2 * (y_i - y_j) over j != i,
+         * and returns sum of q_ij over all pairs, where q_ij = 1 / (1 + |y_i - y_j|^2).
+         * Cells with max half width / distance to their center of mass below theta are used as a single point,
+         * so theta = 0 gives exact values. Forces are written in original order of points
+         */
+        double repulsiveForces(double theta, T *forces, int numThreads = sd::Environment::getInstance().maxMasterThreads()) const {
+            const double theta2 = theta * theta;
+            const Nd4jLong numBlocks = (_numPoints + BLOCK - 1) / BLOCK;
+            std::vector<double> sums(numBlocks);
+
+            auto func = PRAGMA_THREADS_FOR {
+                std::vector<Nd4jLong> stack;
+                std::vector<double> force(_dims);
+                std::vector<double> diff(_dims);
+
+                for (auto b = start; b < stop; b++) {
+                    double blockSum = 0.;
+                    const auto last = sd::math::nd4j_min<Nd4jLong>(_numPoints, (b + 1) * BLOCK);
+
+                    // points are visited in sorted order, so neighbouring points walk through the same nodes
+                    for (Nd4jLong s = b * BLOCK; s < last; s++) {
+                        const double *point = _points.data() + s * _dims;
+                        std::fill(force.begin(), force.end(), 0.);
+
+                        stack.clear();
+                        stack.push_back(0);
+                        while (!stack.empty()) {
+                            const auto &node = _nodes[stack.back()];
+                            const auto index = stack.back();
+                            stack.pop_back();
+
+                            if (node.numChildren == 0) {
+                                // leaves are small, so their points are taken one by one
+                                for (auto p = node.begin; p < node.end; p++) {
+                                    if (p == s)
+                                        continue;
+
+                                    double dist = 0.;
+                                    for (int d = 0; d < _dims; d++) {
+                                        diff[d] = point[d] - _points[p * _dims + d];
+                                        dist += diff[d] * diff[d];
+                                    }
+
+                                    const double q = 1. / (1. + dist);
+                                    blockSum += q;
+                                    for (int d = 0; d < _dims; d++)
+                                        force[d] += q * q * diff[d];
+                                }
+                                continue;
+                            }
+
+                            const double *center = _centers.data() + index * _dims;
+                            double dist = 0.;
+                            for (int d = 0; d < _dims; d++) {
+                                diff[d] = point[d] - center[d];
+                                dist += diff[d] * diff[d];
+                            }
+
+                            // max width / sqrt(dist) < theta
+                            if (_widths[node.level] < theta2 * dist) {
+                                const double q = 1. / (1. + dist);
+                                const double mult = static_cast<double>(node.end - node.begin) * q;
+                                blockSum += mult;
+                                for (int d = 0; d < _dims; d++)
+                                    force[d] += mult * q * diff[d];
+                            } else {
+                                for (auto c = node.firstChild; c < node.firstChild + node.numChildren; c++)
+                                    stack.push_back(c);
+                            }
+                        }
+
+                        T *z = forces + _order[s] * _dims;
+                        for (int d = 0; d < _dims; d++)
+                            z[d] = static_cast<T>(force[d]);
+                    }
+
+                    sums[b] = blockSum;
+                }
+            };
+            run(func, numBlocks, numThreads);
+
+            double sumQ = 0.;
+            for (auto v : sums)
+                sumQ += v;
+
+            return sumQ;
+        }
+    };
+}
+
+#endif //SD_BARNESHUTTREE_H
@@ -26,6 +26,7 @@
 #include <map>
 #include <mutex>
 #include <vector>
+#include <array>
 #include <array/ShapeDescriptor.h>
 #include <array/ConstantShapeBuffer.h>
 #include <memory/Workspace.h>
@@ -35,9 +36,20 @@ namespace sd {
 
     class ND4J_EXPORT ConstantShapeHelper {
     private:
+#ifdef __CUDABLAS__
         std::mutex _mutex;
         std::vector<MAP_IMPL<ShapeDescriptor, ConstantShapeBuffer>> _cache;
+#else
+        static const int NUM_SHARDS = 16;
 
+        // cache is split into shards, each with its own lock. cached shape infos are never evicted, since NDArray keeps raw pointers to them
+        struct CacheShard {
+            std::mutex mutex;
+            MAP_IMPL<ShapeDescriptor, ConstantShapeBuffer> cache;
+        };
+
+        std::array<CacheShard, NUM_SHARDS> _shards;
+#endif
 
         ConstantShapeHelper();
     public:
@@ -70,28 +82,16 @@ namespace sd {
 
 
         /**
-         * This method returns number of cached TAD shapes/offsets on specific device
+         * This method returns number of cached shapes on specific device
          * @return
          */
-        FORCEINLINE int cachedEntriesForDevice(int deviceId) {
-            if (deviceId > _cache.size())
-                throw std::runtime_error("deviceId > number of actual devices");
-
-            return _cache[deviceId].size();
-        }
+        int cachedEntriesForDevice(int deviceId);
 
         /**
-         * This method returns total number of cached TAD shapes/offsets on all devices
+         * This method returns total number of cached shapes on all devices
          * @return
          */
-        FORCEINLINE int totalCachedEntries() {
-            int total = 0;
-
-            for (int e = 0; e < _cache.size(); e++)
-                total += _cache[e].size();
-
-            return total;
-        }
+        int totalCachedEntries();
     };
 }
 
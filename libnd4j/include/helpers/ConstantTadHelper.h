@@ -28,6 +28,9 @@
 #include <map>
 #include <vector>
 #include <mutex>
+#include <array>
+#include <list>
+#include <atomic>
 #include <array/ShapeDescriptor.h>
 #include <array/TadDescriptor.h>
 #include <array/TadPack.h>
@@ -35,8 +38,29 @@
 namespace sd {
     class ND4J_EXPORT ConstantTadHelper {
     private:
+#ifdef __CUDABLAS__
         std::mutex _mutex;
         std::vector<MAP_IMPL<TadDescriptor, TadPack>> _cache;
+#else
+        static const int NUM_SHARDS = 16;
+
+        struct CacheEntry {
+            TadPack pack;
+            std::list<const TadDescriptor*>::iterator position;
+        };
+
+        // cache is split into shards, each with its own lock and LRU list
+        struct CacheShard {
+            std::mutex mutex;
+            MAP_IMPL<TadDescriptor, CacheEntry> cache;
+            std::list<const TadDescriptor*> lru;
+        };
+
+        std::array<CacheShard, NUM_SHARDS> _shards;
+
+        // max number of cached TadPacks, 0 means unlimited
+        std::atomic<Nd4jLong> _limit;
+#endif
 
         ConstantTadHelper();
     public:
@@ -62,25 +86,25 @@ namespace sd {
          * This method returns number of cached TAD shapes/offsets on specific device
          * @return
          */
-        FORCEINLINE int cachedEntriesForDevice(int deviceId) {
-            if (deviceId > _cache.size())
-                throw std::runtime_error("deviceId > number of actual devices");
-
-            return _cache[deviceId].size();
-        }
+        int cachedEntriesForDevice(int deviceId);
 
         /**
          * This method returns total number of cached TAD shapes/offsets on all devices
          * @return
          */
-        FORCEINLINE int totalCachedEntries() {
-            int total = 0;
-
-            for (int e = 0; e < _cache.size(); e++)
-                total += _cache[e].size();
+        int totalCachedEntries();
 
-            return total;
-        }
+#ifndef __CUDABLAS__
+        /**
+         * This method sets max number of cached TadPacks. Cache is split into min(limit, 16) shards, each holding
+         * limit / shards TadPacks, and least recently used TadPack of a shard is evicted once that shard is full.
+         * So eviction is per shard: a TadPack may be evicted before total number of cached TadPacks reaches the limit.
+         * PLEASE NOTE: evicted TadPacks stay valid as long as somebody holds a copy of them
+         * @param numberOfEntries - 0 means unlimited
+         */
+        void setCacheLimit(Nd4jLong numberOfEntries);
+        Nd4jLong cacheLimit();
+#endif
     };
 }
 
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_KNNINDEX_H
+#define SD_KNNINDEX_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <array/DataType.h>
+
+namespace sd {
+
+    enum KnnDistance {
+        KNN_EUCLIDEAN = 0,
+        KNN_COSINE = 1,
+        KNN_MANHATTAN = 2,
+    };
+
+    /**
+     * This class is nearest neighbours index over rows of a matrix. Index keeps its own copy of the points,
+     * so source buffer can be released once index is built.
+     *
+     * Queries are c-ordered numQueries x dims matrices of the same data type as the index, and are answered in parallel.
+     * Results of each query are sorted by distance, ties are resolved in favour of lower index.
+     * Cosine distance is 1 - cos(a, b), zero vectors are kept as is.
+     */
+    class ND4J_EXPORT KnnIndex {
+    protected:
+        sd::DataType _dataType;
+        Nd4jLong _numPoints;
+        int _dims;
+        KnnDistance _distance;
+
+        KnnIndex(sd::DataType dataType, Nd4jLong numPoints, int dims, KnnDistance distance) : _dataType(dataType), _numPoints(numPoints), _dims(dims), _distance(distance) { };
+
+    public:
+        virtual ~KnnIndex() = default;
+
+        /**
+         * Builds VP-tree over rows of c-ordered numPoints x dims matrix
+         */
+        static KnnIndex* build(const void *data, sd::DataType dataType, Nd4jLong numPoints, int dims, KnnDistance distance);
+
+        sd::DataType dataType() const { return _dataType; }
+        Nd4jLong numPoints() const { return _numPoints; }
+        int dims() const { return _dims; }
+        KnnDistance distance() const { return _distance; }
+
+        /**
+         * Finds k nearest points for each query. Results are written as numQueries x k matrices,
+         * if there are less than k points, remaining slots get -1 indices and infinite distances
+         */
+        virtual void search(const void *queries, Nd4jLong numQueries, Nd4jLong k, Nd4jLong *indices, void *distances) const = 0;
+
+        /**
+         * Finds points within given radius of each query, maxResults nearest of them are kept.
+         * Results are written as numQueries x maxResults matrices padded the same way as above,
+         * counts gets number of results of each query
+         */
+        virtual void searchRadius(const void *queries, Nd4jLong numQueries, double radius, Nd4jLong maxResults, Nd4jLong *indices, void *distances, Nd4jLong *counts) const = 0;
+    };
+}
+
+#endif //SD_KNNINDEX_H
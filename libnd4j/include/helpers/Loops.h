@@ -32,6 +32,7 @@
 #include <helpers/ConstantTadHelper.h>
 #include <system/openmp_pragmas.h>
 #include <execution/Threads.h>
+#include <helpers/SimdKernels.h>
 
 namespace sd {
 
@@ -757,6 +758,9 @@ void sd::ReductionLoops<X, Z, E>::loopReduce(sd::memory::Workspace* workspace, c
             auto span = samediff::Span::build(threadId, numThreads, 0, len, 1);
             int64_t start = span.startX(), stop = span.stopX();
 
+            if (sd::simd::execTransform<X, Z, OpType>(x, z, start, stop))
+                break;
+
             for (auto i = start; i < stop; i++)
                 z[i] = OpType::op(x[i], extraParams);
         }
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#ifndef SD_PACKEDGEMM_H
+#define SD_PACKEDGEMM_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <array/DataType.h>
+#include <types/float16.h>
+#include <types/bfloat16.h>
+
+namespace sd {
+    /**
+     * Type used for packed panels and accumulation of type T: half types are multiplied as float,
+     * small integers as int32, so int8 products don't overflow until they're stored
+     */
+    template <typename T> struct GemmAccumulator { typedef T type; };
+    template <> struct GemmAccumulator<float16> { typedef float type; };
+    template <> struct GemmAccumulator<bfloat16> { typedef float type; };
+    template <> struct GemmAccumulator<int8_t> { typedef int32_t type; };
+    template <> struct GemmAccumulator<uint8_t> { typedef int32_t type; };
+    template <> struct GemmAccumulator<int16_t> { typedef int32_t type; };
+    template <> struct GemmAccumulator<uint16_t> { typedef int32_t type; };
+
+    /**
+     * This class implements GEMM used when there's no BLAS for given data type.
+     * It follows BLIS approach: blocks of B (KC x NC) and A (MC x KC) are packed into contiguous panels of
+     * accumulator type, and register-blocked MR x NR micro-kernel runs over them. Macro-tiles of C are split between threads.
+     */
+    class ND4J_EXPORT PackedGemm {
+    private:
+        template <typename T>
+        static void gemm_(Nd4jLong M, Nd4jLong N, Nd4jLong K, double alpha,
+                          const void *A, Nd4jLong aRowStride, Nd4jLong aColStride,
+                          const void *B, Nd4jLong bRowStride, Nd4jLong bColStride,
+                          double beta, void *C, Nd4jLong cRowStride, Nd4jLong cColStride);
+
+        template <typename TA, typename TB>
+        static void gemmQuantized_(Nd4jLong M, Nd4jLong N, Nd4jLong K,
+                                   const void *A, Nd4jLong aRowStride, Nd4jLong aColStride, int aZeroPoint,
+                                   const void *B, Nd4jLong bRowStride, Nd4jLong bColStride, const int32_t *bZeroPoints, Nd4jLong bZeroPointStride,
+                                   int32_t *C, Nd4jLong cRowStride, Nd4jLong cColStride);
+
+        template <typename T>
+        static void gemmBatched_(Nd4jLong batch, Nd4jLong M, Nd4jLong N, Nd4jLong K, const double *alphas,
+                                 const void * const *A, Nd4jLong aRowStride, Nd4jLong aColStride,
+                                 const void * const *B, Nd4jLong bRowStride, Nd4jLong bColStride,
+                                 const double *betas, void * const *C, Nd4jLong cRowStride, Nd4jLong cColStride);
+
+    public:
+        /**
+         * C = alpha * A * B + beta * C, where A is M x K, B is K x N and C is M x N, all of the same numeric data type
+         * Arrays are addressed via strides of rows and columns, so any order and transposition is supported
+         */
+        static void gemm(sd::DataType dataType, Nd4jLong M, Nd4jLong N, Nd4jLong K, double alpha,
+                         const void *A, Nd4jLong aRowStride, Nd4jLong aColStride,
+                         const void *B, Nd4jLong bRowStride, Nd4jLong bColStride,
+                         double beta, void *C, Nd4jLong cRowStride, Nd4jLong cColStride);
+
+        /**
+         * C = (A - aZeroPoint) * (B - bZeroPoints), where A and B are INT8 or UINT8 and C is INT32.
+         * Zero points are subtracted while panels are packed, so no correction terms are needed afterwards.
+         * Column j of B uses bZeroPoints[j * bZeroPointStride]: stride 0 means single zero point for whole B
+         */
+        static void gemmQuantized(sd::DataType aType, sd::DataType bType, Nd4jLong M, Nd4jLong N, Nd4jLong K,
+                                  const void *A, Nd4jLong aRowStride, Nd4jLong aColStride, int aZeroPoint,
+                                  const void *B, Nd4jLong bRowStride, Nd4jLong bColStride, const int32_t *bZeroPoints, Nd4jLong bZeroPointStride,
+                                  int32_t *C, Nd4jLong cRowStride, Nd4jLong cColStride);
+
+        /**
+         * This method returns true if M x K by K x N product is small enough for gemmBatched()
+         */
+        static bool isBatchable(Nd4jLong M, Nd4jLong N, Nd4jLong K);
+
+        /**
+         * C[e] = alphas[e] * A[e] * B[e] + betas[e] * C[e] for each of batch products, all matrices of the same shapes and strides.
+         * Meant for many small matrices: each product is computed by single thread without splitting K, threads split the batch
+         */
+        static void gemmBatched(sd::DataType dataType, Nd4jLong batch, Nd4jLong M, Nd4jLong N, Nd4jLong K, const double *alphas,
+                                const void * const *A, Nd4jLong aRowStride, Nd4jLong aColStride,
+                                const void * const *B, Nd4jLong bRowStride, Nd4jLong bColStride,
+                                const double *betas, void * const *C, Nd4jLong cRowStride, Nd4jLong cColStride);
+    };
+}
+
+#endif //SD_PACKEDGEMM_H
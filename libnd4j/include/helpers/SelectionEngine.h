@@ -0,0 +1,269 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_SELECTIONENGINE_H
+#define SD_SELECTIONENGINE_H
+
+#include <helpers/SortEngine.h>
+#include <system/Environment.h>
+#include <algorithm>
+#include <vector>
+
+namespace sd {
+
+    /**
+     * This class selects k best elements of strided array, it's used by top_k, in_top_k and nth_element.
+     * Elements are compared via RadixKey, so all types (including NaNs and half types) get total order of unsigned integers,
+     * and ties are resolved in favour of lower index. Depending on k and length one of engines is used:
+     * - bounded heap of k elements: blocks without elements above heap top are skipped after vectorized compare
+     * - threshold selection: threshold is estimated from sample, elements above it are gathered and selected from
+     * - introselect over all elements, when k is comparable to length
+     *
+     * Long arrays are split between threads, so both heap and threshold engines need O(k) extra memory per chunk.
+     */
+    template <typename T>
+    class SelectionEngine {
+    public:
+        typedef typename RadixKey<T>::Bits Bits;
+
+        struct Item {
+            Bits key;
+            Nd4jLong index;
+        };
+
+        /**
+         * Returns true if a goes before b: greater key, or the same key and lower index
+         */
+        static FORCEINLINE bool better(const Item &a, const Item &b) {
+            return a.key > b.key || (a.key == b.key && a.index < b.index);
+        }
+
+        static FORCEINLINE bool lowerIndex(const Item &a, const Item &b) {
+            return a.index < b.index;
+        }
+
+    private:
+        // elements checked against heap top at once
+        static const Nd4jLong BLOCK = 256;
+
+        // heap replacements cost log(k), so larger k goes to threshold selection
+        static const Nd4jLong HEAP_LIMIT = 512;
+
+        // each thread gets at least this number of elements
+        static const Nd4jLong MIN_CHUNK = 32768;
+
+        static const Nd4jLong SAMPLE = 4096;
+
+        static FORCEINLINE Bits key(const T *x, Nd4jLong i, Nd4jLong stride, Bits flip) {
+            return static_cast<Bits>(RadixKey<T>::encode(x[i * stride]) ^ flip);
+        }
+
+        static FORCEINLINE void run(const FUNC_1D &func, Nd4jLong numChunks, int numThreads) {
+            if (numThreads > 1 && numChunks > 1)
+                samediff::Threads::parallel_tad(func, 0, numChunks, 1, numThreads);
+            else
+                func(0, 0, numChunks, 1);
+        }
+
+        /**
+         * Keeps k best elements of [from, to) in a heap with the worst of them on top
+         */
+        static void heapSelect(const T *x, Nd4jLong stride, Bits flip, Nd4jLong from, Nd4jLong to, Nd4jLong k, Item *heap) {
+            Nd4jLong size = 0;
+            Nd4jLong i = from;
+            for (; i < to && size < k; i++, size++)
+                heap[size] = {key(x, i, stride, flip), i};
+
+            std::make_heap(heap, heap + size, better);
+
+            while (i < to) {
+                const auto last = sd::math::nd4j_min<Nd4jLong>(to, i + BLOCK);
+                const auto threshold = heap[0].key;
+
+                // elements are visited in order of indices, so ties never replace anything
+                Nd4jLong above = 0;
+                if (stride == 1) {
+                    for (Nd4jLong j = i; j < last; j++)
+                        above += static_cast<Bits>(RadixKey<T>::encode(x[j]) ^ flip) > threshold ? 1 : 0;
+                } else {
+                    for (Nd4jLong j = i; j < last; j++)
+                        above += key(x, j, stride, flip) > threshold ? 1 : 0;
+                }
+
+                if (above > 0) {
+                    for (Nd4jLong j = i; j < last; j++) {
+                        auto v = key(x, j, stride, flip);
+                        if (v > heap[0].key) {
+                            std::pop_heap(heap, heap + size, better);
+                            heap[size - 1] = {v, j};
+                            std::push_heap(heap, heap + size, better);
+                        }
+                    }
+                }
+
+                i = last;
+            }
+        }
+
+        static void introSelect(const T *x, Nd4jLong stride, Bits flip, Nd4jLong length, Nd4jLong k, std::vector<Item> &result) {
+            result.resize(length);
+            for (Nd4jLong i = 0; i < length; i++)
+                result[i] = {key(x, i, stride, flip), i};
+
+            if (k < length)
+                std::nth_element(result.begin(), result.begin() + k, result.end(), better);
+
+            result.resize(k);
+        }
+
+        /**
+         * Picks threshold from sample so that about 1.5k elements are above it, and gathers these elements.
+         * Returns false if no good threshold was found, i.e. on heavy ties
+         */
+        static bool thresholdSelect(const T *x, Nd4jLong stride, Bits flip, Nd4jLong length, Nd4jLong k, int numThreads, std::vector<Item> &result) {
+            const Nd4jLong numSamples = sd::math::nd4j_min<Nd4jLong>(length, sd::math::nd4j_max<Nd4jLong>(SAMPLE, 4 * k));
+            const Nd4jLong limit = 4 * k + BLOCK;
+
+            std::vector<Bits> sample(numSamples);
+            for (Nd4jLong s = 0; s < numSamples; s++)
+                sample[s] = key(x, static_cast<Nd4jLong>(static_cast<double>(s) * length / numSamples), stride, flip);
+
+            const Nd4jLong numChunks = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(numThreads, length / MIN_CHUNK));
+            const Nd4jLong chunk = (length + numChunks - 1) / numChunks;
+            std::vector<Nd4jLong> counts(numChunks + 1);
+
+            auto rank = sd::math::nd4j_min<Nd4jLong>(numSamples - 1, static_cast<Nd4jLong>(1.5 * k * numSamples / length));
+            for (int attempt = 0; attempt < 4; attempt++) {
+                std::nth_element(sample.begin(), sample.begin() + rank, sample.end(), std::greater<Bits>());
+                const auto threshold = sample[rank];
+
+                auto count = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++) {
+                        auto last = sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk);
+                        Nd4jLong cnt = 0;
+                        for (Nd4jLong i = c * chunk; i < last; i++)
+                            cnt += key(x, i, stride, flip) >= threshold ? 1 : 0;
+
+                        counts[c + 1] = cnt;
+                    }
+                };
+                run(count, numChunks, numThreads);
+
+                counts[0] = 0;
+                for (Nd4jLong c = 0; c < numChunks; c++)
+                    counts[c + 1] += counts[c];
+
+                const auto total = counts[numChunks];
+                if (total < k) {
+                    if (rank == numSamples - 1)
+                        return false;
+
+                    rank = sd::math::nd4j_min<Nd4jLong>(numSamples - 1, 2 * rank + 1);
+                    continue;
+                }
+
+                if (total > limit) {
+                    if (rank == 0)
+                        return false;
+
+                    rank /= 2;
+                    continue;
+                }
+
+                // every element that didn't pass is worse than every element that did
+                result.resize(total);
+                auto gather = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++) {
+                        auto last = sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk);
+                        auto pos = counts[c];
+                        for (Nd4jLong i = c * chunk; i < last; i++) {
+                            auto v = key(x, i, stride, flip);
+                            if (v >= threshold)
+                                result[pos++] = {v, i};
+                        }
+                    }
+                };
+                run(gather, numChunks, numThreads);
+
+                std::nth_element(result.begin(), result.begin() + k, result.end(), better);
+                result.resize(k);
+                return true;
+            }
+
+            return false;
+        }
+
+    public:
+        /**
+         * Selects k best elements of x: largest ones if largest is true, smallest otherwise.
+         * Selected elements are returned in arbitrary order
+         */
+        static void select(const T *x, Nd4jLong length, Nd4jLong stride, Nd4jLong k, bool largest, int numThreads, std::vector<Item> &result) {
+            const Bits flip = largest ? static_cast<Bits>(0) : static_cast<Bits>(~static_cast<Bits>(0));
+            numThreads = sd::math::nd4j_max<int>(1, sd::math::nd4j_min<Nd4jLong>(numThreads, length / MIN_CHUNK));
+
+            if (k >= length || 8 * k >= length) {
+                introSelect(x, stride, flip, length, sd::math::nd4j_min<Nd4jLong>(k, length), result);
+            }
+            else if (k <= HEAP_LIMIT) {
+                if (numThreads == 1) {
+                    result.resize(k);
+                    heapSelect(x, stride, flip, 0, length, k, result.data());
+                    return;
+                }
+
+                // each chunk keeps its own k candidates, best k of them are selected afterwards
+                const Nd4jLong numChunks = numThreads;
+                const Nd4jLong chunk = (length + numChunks - 1) / numChunks;
+                result.resize(numChunks * k);
+
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++)
+                        heapSelect(x, stride, flip, c * chunk, sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk), k, result.data() + c * k);
+                };
+                run(func, numChunks, numThreads);
+
+                std::nth_element(result.begin(), result.begin() + k, result.end(), better);
+                result.resize(k);
+            }
+            else if (!thresholdSelect(x, stride, flip, length, k, numThreads, result)) {
+                introSelect(x, stride, flip, length, k, result);
+            }
+        }
+
+        /**
+         * Returns n-th element of x sorted in ascending order, or descending one if reverse is true
+         */
+        static T nth(const T *x, Nd4jLong length, Nd4jLong stride, Nd4jLong n, bool reverse, int numThreads) {
+            std::vector<Item> items;
+
+            // n-th element is the worst of n + 1 best ones, or the worst of (length - n) best ones in opposite order
+            if (n < length - n)
+                select(x, length, stride, n + 1, reverse, numThreads, items);
+            else
+                select(x, length, stride, length - n, !reverse, numThreads, items);
+
+            auto worst = std::max_element(items.begin(), items.end(), better);
+            return x[worst->index * stride];
+        }
+    };
+}
+
+#endif //SD_SELECTIONENGINE_H
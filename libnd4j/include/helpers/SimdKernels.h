@@ -0,0 +1,249 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_SIMDKERNELS_H
+#define SD_SIMDKERNELS_H
+
+#include <system/op_boilerplate.h>
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <atomic>
+#include <type_traits>
+
+namespace simdOps {
+    template <typename X, typename Y, typename Z> class Add;
+    template <typename X, typename Y, typename Z> class Subtract;
+    template <typename X, typename Y, typename Z> class Multiply;
+    template <typename X, typename Y, typename Z> class Divide;
+    template <typename X, typename Y, typename Z> class ReverseSubtract;
+    template <typename X, typename Y, typename Z> class ReverseDivide;
+    template <typename X, typename Y, typename Z> class MaxPairwise;
+    template <typename X, typename Y, typename Z> class MinPairwise;
+    template <typename X, typename Y, typename Z> class RELU;
+    template <typename X> class Abs;
+    template <typename X> class Neg;
+    template <typename X> class Square;
+    template <typename X, typename Z> class Sqrt;
+    template <typename X> class Sum;
+    template <typename X, typename Z> class Mean;
+    template <typename X, typename Z> class Norm2;
+    template <typename X, typename Z> class SquaredNorm;
+}
+
+namespace sd {
+    namespace simd {
+        enum SimdLevel {
+            SIMD_GENERIC = 0,
+            SIMD_SSE4 = 1,
+            SIMD_AVX2 = 2,
+            SIMD_AVX512 = 3,
+            SIMD_NEON = 4,
+            SIMD_LEVELS = 5,
+        };
+
+        // binary kernels are shared by pairwise and scalar loops: for scalar ones Y is the scalar
+        enum BinaryKernel {
+            BINARY_ADD = 0,
+            BINARY_SUBTRACT,
+            BINARY_MULTIPLY,
+            BINARY_DIVIDE,
+            BINARY_REVERSE_SUBTRACT,
+            BINARY_REVERSE_DIVIDE,
+            BINARY_MAX,
+            BINARY_MIN,
+            BINARY_RELU,
+            BINARY_KERNELS,
+        };
+
+        enum UnaryKernel {
+            UNARY_ABS = 0,
+            UNARY_NEG,
+            UNARY_SQUARE,
+            UNARY_SQRT,
+            UNARY_KERNELS,
+        };
+
+        enum ReduceKernel {
+            REDUCE_SUM = 0,
+            REDUCE_SUM_SQUARES,
+            REDUCE_KERNELS,
+        };
+
+        /**
+         * Kernels of one instruction set for one data type. All kernels take contiguous buffers,
+         * null pointer means there's no kernel for this op and compiler-generated loop should be used
+         */
+        template <typename T>
+        struct KernelTable {
+            void (*pairwise[BINARY_KERNELS])(const T *x, const T *y, T *z, Nd4jLong length);
+            void (*scalar[BINARY_KERNELS])(const T *x, T y, T *z, Nd4jLong length);
+            void (*transform[UNARY_KERNELS])(const T *x, T *z, Nd4jLong length);
+            T (*reduce[REDUCE_KERNELS])(const T *x, Nd4jLong length);
+
+            // z[c * zStride + r] = x[r * xStride + c] for rows x cols block. Pure data movement, so it's valid for any type of the same size
+            void (*transpose)(const T *x, Nd4jLong xStride, T *z, Nd4jLong zStride, Nd4jLong rows, Nd4jLong cols);
+        };
+
+        /**
+         * This class holds explicitly vectorized kernels for EWS1 paths of legacy loops.
+         * Instruction set is picked once, on first use, out of the ones supported by current CPU,
+         * so the same binary uses AVX-512 kernels where available and SSE4 ones elsewhere.
+         *
+         * PLEASE NOTE: reductions accumulate in vector lanes, so their results may differ from sequential loops in last bits
+         */
+        class ND4J_EXPORT SimdKernels {
+        private:
+            KernelTable<float> _floats[SIMD_LEVELS];
+            KernelTable<double> _doubles[SIMD_LEVELS];
+            bool _available[SIMD_LEVELS];
+
+            SimdLevel _detected = SIMD_GENERIC;
+            std::atomic<int> _level;
+
+            SimdKernels();
+        public:
+            ~SimdKernels() = default;
+
+            static SimdKernels& getInstance();
+
+            /**
+             * Best instruction set supported by both this CPU and this binary
+             */
+            SimdLevel detectedLevel() const;
+
+            /**
+             * Instruction set in use. Can be lowered via SD_SIMD_LEVEL env var: generic, sse4, avx2, avx512, neon
+             */
+            SimdLevel level() const;
+
+            /**
+             * This method switches kernels to given instruction set, i.e. for benchmarks and tests
+             * @return false if instruction set isn't available, level isn't changed then
+             */
+            bool setLevel(SimdLevel level);
+
+            bool isAvailable(SimdLevel level) const;
+
+            /**
+             * @return kernels for current instruction set, or nullptr if there are none for data type T
+             */
+            template <typename T>
+            const KernelTable<T>* table() const {
+                return nullptr;
+            }
+        };
+
+        template <>
+        const KernelTable<float>* SimdKernels::table<float>() const;
+
+        template <>
+        const KernelTable<double>* SimdKernels::table<double>() const;
+
+        // mapping of legacy ops to kernels, -1 means op has no explicit kernel
+        template <typename OpType> struct BinaryKernelOf { static const int value = -1; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::Add<X, Y, Z>> { static const int value = BINARY_ADD; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::Subtract<X, Y, Z>> { static const int value = BINARY_SUBTRACT; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::Multiply<X, Y, Z>> { static const int value = BINARY_MULTIPLY; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::Divide<X, Y, Z>> { static const int value = BINARY_DIVIDE; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::ReverseSubtract<X, Y, Z>> { static const int value = BINARY_REVERSE_SUBTRACT; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::ReverseDivide<X, Y, Z>> { static const int value = BINARY_REVERSE_DIVIDE; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::MaxPairwise<X, Y, Z>> { static const int value = BINARY_MAX; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::MinPairwise<X, Y, Z>> { static const int value = BINARY_MIN; };
+        template <typename X, typename Y, typename Z> struct BinaryKernelOf<simdOps::RELU<X, Y, Z>> { static const int value = BINARY_RELU; };
+
+        template <typename OpType> struct UnaryKernelOf { static const int value = -1; };
+        template <typename X> struct UnaryKernelOf<simdOps::Abs<X>> { static const int value = UNARY_ABS; };
+        template <typename X> struct UnaryKernelOf<simdOps::Neg<X>> { static const int value = UNARY_NEG; };
+        template <typename X> struct UnaryKernelOf<simdOps::Square<X>> { static const int value = UNARY_SQUARE; };
+        template <typename X, typename Z> struct UnaryKernelOf<simdOps::Sqrt<X, Z>> { static const int value = UNARY_SQRT; };
+
+        // only reductions that sum op(x) and don't use extra params are here
+        template <typename OpType> struct ReduceKernelOf { static const int value = -1; };
+        template <typename X> struct ReduceKernelOf<simdOps::Sum<X>> { static const int value = REDUCE_SUM; };
+        template <typename X, typename Z> struct ReduceKernelOf<simdOps::Mean<X, Z>> { static const int value = REDUCE_SUM; };
+        template <typename X, typename Z> struct ReduceKernelOf<simdOps::Norm2<X, Z>> { static const int value = REDUCE_SUM_SQUARES; };
+        template <typename X, typename Z> struct ReduceKernelOf<simdOps::SquaredNorm<X, Z>> { static const int value = REDUCE_SUM_SQUARES; };
+
+        /**
+         * These methods apply OpType to [start, stop) range of contiguous buffers with explicit kernel
+         * @return false if there's no kernel for OpType and data types, nothing is done then
+         */
+        template <typename X, typename Y, typename Z, typename OpType>
+        FORCEINLINE bool execPairwise(const X *x, const Y *y, Z *z, Nd4jLong start, Nd4jLong stop) {
+            const int kernel = BinaryKernelOf<OpType>::value;
+            if (kernel < 0 || !std::is_same<X, Y>::value || !std::is_same<X, Z>::value)
+                return false;
+
+            auto table = SimdKernels::getInstance().template table<X>();
+            if (table == nullptr || table->pairwise[kernel] == nullptr)
+                return false;
+
+            table->pairwise[kernel](x + start, reinterpret_cast<const X*>(y) + start, reinterpret_cast<X*>(z) + start, stop - start);
+            return true;
+        }
+
+        template <typename X, typename Y, typename Z, typename OpType>
+        FORCEINLINE bool execScalar(const X *x, Y scalar, Z *z, Nd4jLong start, Nd4jLong stop) {
+            const int kernel = BinaryKernelOf<OpType>::value;
+            if (kernel < 0 || !std::is_same<X, Y>::value || !std::is_same<X, Z>::value)
+                return false;
+
+            auto table = SimdKernels::getInstance().template table<X>();
+            if (table == nullptr || table->scalar[kernel] == nullptr)
+                return false;
+
+            table->scalar[kernel](x + start, static_cast<X>(scalar), reinterpret_cast<X*>(z) + start, stop - start);
+            return true;
+        }
+
+        template <typename X, typename Z, typename OpType>
+        FORCEINLINE bool execTransform(const X *x, Z *z, Nd4jLong start, Nd4jLong stop) {
+            const int kernel = UnaryKernelOf<OpType>::value;
+            if (kernel < 0 || !std::is_same<X, Z>::value)
+                return false;
+
+            auto table = SimdKernels::getInstance().template table<X>();
+            if (table == nullptr || table->transform[kernel] == nullptr)
+                return false;
+
+            table->transform[kernel](x + start, reinterpret_cast<X*>(z) + start, stop - start);
+            return true;
+        }
+
+        /**
+         * This method returns sum of op(x) over [start, stop), i.e. partial result of reduction, before postProcess
+         */
+        template <typename X, typename Z, typename OpType>
+        FORCEINLINE bool execReduce(const X *x, Nd4jLong start, Nd4jLong stop, Z &result) {
+            const int kernel = ReduceKernelOf<OpType>::value;
+            if (kernel < 0 || !std::is_same<X, Z>::value)
+                return false;
+
+            auto table = SimdKernels::getInstance().template table<X>();
+            if (table == nullptr || table->reduce[kernel] == nullptr)
+                return false;
+
+            result = static_cast<Z>(table->reduce[kernel](x + start, stop - start));
+            return true;
+        }
+    }
+}
+
+#endif //SD_SIMDKERNELS_H
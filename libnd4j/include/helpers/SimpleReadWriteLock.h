@@ -54,6 +54,26 @@ namespace sd {
 
         SimpleReadWriteLock& operator= ( const SimpleReadWriteLock &other);
     };
+
+    /**
+     * This class holds read lock till the end of its scope, so lock is released on exceptions as well
+     */
+    class ReadLockGuard {
+    private:
+        SimpleReadWriteLock &_lock;
+
+    public:
+        explicit ReadLockGuard(SimpleReadWriteLock &lock) : _lock(lock) {
+            _lock.lockRead();
+        }
+
+        ~ReadLockGuard() {
+            _lock.unlockRead();
+        }
+
+        ReadLockGuard(const ReadLockGuard& other) = delete;
+        ReadLockGuard& operator=(const ReadLockGuard& other) = delete;
+    };
 }
 
 
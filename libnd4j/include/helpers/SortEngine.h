@@ -0,0 +1,358 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_SORTENGINE_H
+#define SD_SORTENGINE_H
+
+#include <system/op_boilerplate.h>
+#include <system/pointercast.h>
+#include <helpers/shape.h>
+#include <execution/Threads.h>
+#include <types/float16.h>
+#include <types/bfloat16.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace sd {
+    template <int size> struct RadixBits { };
+    template <> struct RadixBits<1> { typedef uint8_t type; };
+    template <> struct RadixBits<2> { typedef uint16_t type; };
+    template <> struct RadixBits<4> { typedef uint32_t type; };
+    template <> struct RadixBits<8> { typedef uint64_t type; };
+
+    /**
+     * Maps values to unsigned integers with the same order, so they can be sorted digit by digit.
+     * Integers get sign bit flipped, floats get sign bit flipped if positive and all bits flipped if negative
+     */
+    template <typename T>
+    struct RadixKey {
+        typedef typename RadixBits<sizeof(T)>::type Bits;
+
+        static FORCEINLINE Bits encode(T value) {
+            Bits bits;
+            std::memcpy(&bits, &value, sizeof(T));
+
+            if (std::is_signed<T>::value)
+                bits ^= static_cast<Bits>(static_cast<Bits>(1) << (sizeof(T) * 8 - 1));
+
+            return bits;
+        }
+    };
+
+    template <typename T>
+    struct RadixFloatKey {
+        typedef typename RadixBits<sizeof(T)>::type Bits;
+
+        static FORCEINLINE Bits encode(T value) {
+            Bits bits;
+            std::memcpy(&bits, &value, sizeof(T));
+
+            const auto sign = static_cast<Bits>(static_cast<Bits>(1) << (sizeof(T) * 8 - 1));
+            return (bits & sign) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | sign);
+        }
+    };
+
+    template <> struct RadixKey<float> : public RadixFloatKey<float> { };
+    template <> struct RadixKey<double> : public RadixFloatKey<double> { };
+    template <> struct RadixKey<float16> : public RadixFloatKey<float16> { };
+    template <> struct RadixKey<bfloat16> : public RadixFloatKey<bfloat16> { };
+
+    /**
+     * This class implements sorting of arrays and key/value pairs of arrays.
+     * Contiguous arrays are sorted with parallel LSD radix sort: one pass per byte of the key,
+     * and passes where all keys share the same byte are skipped. Strided arrays are gathered and
+     * sorted with parallel merge sort. Both sorts are stable.
+     *
+     * Elements are addressed the same way SpecialMethods::getPosition does: i * ews, or via shape for ews < 1
+     */
+    class SortEngine {
+    private:
+        // small arrays are sorted in place, histograms would cost more than sort itself
+        static const Nd4jLong INSERTION_THRESHOLD = 64;
+
+        // each chunk of radix sort gets at least this number of elements
+        static const Nd4jLong RADIX_CHUNK = 65536;
+
+        template <typename K>
+        static FORCEINLINE bool before(const K &a, const K &b, bool descending) {
+            return descending ? a > b : a < b;
+        }
+
+        static FORCEINLINE Nd4jLong position(const Nd4jLong *shapeInfo, Nd4jLong index) {
+            auto ews = shape::elementWiseStride(shapeInfo);
+            return ews >= 1 ? index * ews : shape::getIndexOffset(index, shapeInfo);
+        }
+
+        static FORCEINLINE void run(const FUNC_1D &func, Nd4jLong numChunks, int numThreads) {
+            if (numThreads > 1 && numChunks > 1)
+                samediff::Threads::parallel_tad(func, 0, numChunks, 1, numThreads);
+            else
+                func(0, 0, numChunks, 1);
+        }
+
+        template <typename K, typename V>
+        struct Item {
+            K key;
+            V value;
+        };
+
+    public:
+        /**
+         * Stable insertion sort of contiguous keys, and values if not null
+         */
+        template <typename K, typename V>
+        static void insertionSort(K *keys, V *values, Nd4jLong length, bool descending) {
+            for (Nd4jLong i = 1; i < length; i++) {
+                auto key = keys[i];
+                Nd4jLong j = i - 1;
+
+                if (values != nullptr) {
+                    auto value = values[i];
+                    for (; j >= 0 && before(key, keys[j], descending); j--) {
+                        keys[j + 1] = keys[j];
+                        values[j + 1] = values[j];
+                    }
+                    values[j + 1] = value;
+                } else {
+                    for (; j >= 0 && before(key, keys[j], descending); j--)
+                        keys[j + 1] = keys[j];
+                }
+
+                keys[j + 1] = key;
+            }
+        }
+
+        /**
+         * Stable LSD radix sort of contiguous keys. Values are optional, they're moved along with keys
+         */
+        template <typename K, typename V>
+        static void radixSort(K *keys, V *values, Nd4jLong length, bool descending, int numThreads = sd::Environment::getInstance().maxMasterThreads()) {
+            typedef typename RadixKey<K>::Bits Bits;
+            const int numBytes = sizeof(Bits);
+            const Bits flip = descending ? static_cast<Bits>(~static_cast<Bits>(0)) : static_cast<Bits>(0);
+
+            if (length <= INSERTION_THRESHOLD) {
+                insertionSort(keys, values, length, descending);
+                return;
+            }
+
+            numThreads = sd::math::nd4j_max<int>(1, numThreads);
+            const Nd4jLong numChunks = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(numThreads, length / RADIX_CHUNK));
+            const Nd4jLong chunk = (length + numChunks - 1) / numChunks;
+
+            // histograms of all bytes are built in one pass, they're valid for the first pass as is
+            std::vector<Nd4jLong> counts(numChunks * numBytes * 256, 0);
+            auto countAll = PRAGMA_THREADS_FOR {
+                for (auto c = start; c < stop; c++) {
+                    auto hist = counts.data() + c * numBytes * 256;
+                    auto last = sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk);
+                    for (Nd4jLong i = c * chunk; i < last; i++) {
+                        auto bits = static_cast<Bits>(RadixKey<K>::encode(keys[i]) ^ flip);
+                        for (int b = 0; b < numBytes; b++)
+                            hist[b * 256 + ((bits >> (b * 8)) & 0xFF)]++;
+                    }
+                }
+            };
+            run(countAll, numChunks, numThreads);
+
+            // not std::vector: bool arrays need plain buffers too
+            std::unique_ptr<K[]> keysBuffer(new K[length]);
+            std::unique_ptr<V[]> valuesBuffer(values != nullptr ? new V[length] : nullptr);
+
+            K *srcK = keys, *dstK = keysBuffer.get();
+            V *srcV = values, *dstV = valuesBuffer.get();
+
+            std::vector<Nd4jLong> offsets(numChunks * 256);
+            bool firstPass = true;
+            for (int b = 0; b < numBytes; b++) {
+                // byte shared by all keys doesn't change order
+                bool trivial = false;
+                for (int d = 0; d < 256 && !trivial; d++) {
+                    Nd4jLong total = 0;
+                    for (Nd4jLong c = 0; c < numChunks; c++)
+                        total += counts[(c * numBytes + b) * 256 + d];
+
+                    trivial = total == length;
+                }
+
+                if (trivial)
+                    continue;
+
+                // after first pass elements moved between chunks, so chunk histograms are rebuilt
+                if (!firstPass) {
+                    auto countByte = PRAGMA_THREADS_FOR {
+                        for (auto c = start; c < stop; c++) {
+                            auto hist = counts.data() + (c * numBytes + b) * 256;
+                            std::memset(hist, 0, 256 * sizeof(Nd4jLong));
+
+                            auto last = sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk);
+                            for (Nd4jLong i = c * chunk; i < last; i++)
+                                hist[((RadixKey<K>::encode(srcK[i]) ^ flip) >> (b * 8)) & 0xFF]++;
+                        }
+                    };
+                    run(countByte, numChunks, numThreads);
+                }
+
+                // chunks write each digit one after another, so the pass is stable
+                Nd4jLong running = 0;
+                for (int d = 0; d < 256; d++) {
+                    for (Nd4jLong c = 0; c < numChunks; c++) {
+                        offsets[c * 256 + d] = running;
+                        running += counts[(c * numBytes + b) * 256 + d];
+                    }
+                }
+
+                auto scatter = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++) {
+                        Nd4jLong local[256];
+                        std::memcpy(local, offsets.data() + c * 256, 256 * sizeof(Nd4jLong));
+
+                        auto last = sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk);
+                        for (Nd4jLong i = c * chunk; i < last; i++) {
+                            auto pos = local[((RadixKey<K>::encode(srcK[i]) ^ flip) >> (b * 8)) & 0xFF]++;
+                            dstK[pos] = srcK[i];
+                            if (srcV != nullptr)
+                                dstV[pos] = srcV[i];
+                        }
+                    }
+                };
+                run(scatter, numChunks, numThreads);
+
+                std::swap(srcK, dstK);
+                std::swap(srcV, dstV);
+                firstPass = false;
+            }
+
+            // odd number of passes leaves result in buffer
+            if (srcK != keys) {
+                auto copy = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++) {
+                        auto first = c * chunk;
+                        auto last = sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk);
+                        std::copy(srcK + first, srcK + last, keys + first);
+                        if (values != nullptr)
+                            std::copy(srcV + first, srcV + last, values + first);
+                    }
+                };
+                run(copy, numChunks, numThreads);
+            }
+        }
+
+        /**
+         * Stable parallel merge sort of arrays with any strides. Values are optional, their shape must have the same length
+         */
+        template <typename K, typename V>
+        static void mergeSort(K *keys, const Nd4jLong *keysShapeInfo, V *values, const Nd4jLong *valuesShapeInfo, bool descending, int numThreads = sd::Environment::getInstance().maxMasterThreads()) {
+            typedef Item<K, V> ItemType;
+            const Nd4jLong length = shape::length(keysShapeInfo);
+            if (length < 2)
+                return;
+
+            // number of chunks is power of 2, so merge rounds pair all of them
+            numThreads = sd::math::nd4j_max<int>(1, numThreads);
+            Nd4jLong numChunks = 1;
+            while (numChunks * 2 <= numThreads && length / (numChunks * 2) >= INSERTION_THRESHOLD * 16)
+                numChunks *= 2;
+
+            const Nd4jLong chunk = (length + numChunks - 1) / numChunks;
+
+            std::vector<ItemType> items(length);
+            std::vector<ItemType> buffer(numChunks > 1 ? length : 0);
+
+            auto compare = [descending](const ItemType &a, const ItemType &b) -> bool {
+                return before(a.key, b.key, descending);
+            };
+
+            auto sortChunks = PRAGMA_THREADS_FOR {
+                for (auto c = start; c < stop; c++) {
+                    auto first = c * chunk;
+                    auto last = sd::math::nd4j_min<Nd4jLong>(length, (c + 1) * chunk);
+                    for (auto i = first; i < last; i++) {
+                        items[i].key = keys[position(keysShapeInfo, i)];
+                        if (values != nullptr)
+                            items[i].value = values[position(valuesShapeInfo, i)];
+                    }
+
+                    std::stable_sort(items.begin() + first, items.begin() + last, compare);
+                }
+            };
+            run(sortChunks, numChunks, numThreads);
+
+            auto src = items.data();
+            auto dst = buffer.data();
+            for (Nd4jLong width = chunk; width < length; width *= 2) {
+                const Nd4jLong numPairs = (length + 2 * width - 1) / (2 * width);
+
+                auto merge = PRAGMA_THREADS_FOR {
+                    for (auto p = start; p < stop; p++) {
+                        auto left = p * 2 * width;
+                        auto middle = sd::math::nd4j_min<Nd4jLong>(left + width, length);
+                        auto right = sd::math::nd4j_min<Nd4jLong>(left + 2 * width, length);
+
+                        // std::merge takes equal elements from the first range first, so it's stable
+                        std::merge(src + left, src + middle, src + middle, src + right, dst + left, compare);
+                    }
+                };
+                run(merge, numPairs, numThreads);
+
+                std::swap(src, dst);
+            }
+
+            auto store = PRAGMA_THREADS_FOR {
+                for (auto i = start; i < stop; i++) {
+                    keys[position(keysShapeInfo, i)] = src[i].key;
+                    if (values != nullptr)
+                        values[position(valuesShapeInfo, i)] = src[i].value;
+                }
+            };
+
+            if (numThreads > 1)
+                samediff::Threads::parallel_for(store, 0, length, 1, numThreads);
+            else
+                store(0, 0, length, 1);
+        }
+
+        /**
+         * This method sorts keys and, if values aren't null, moves values along with keys.
+         * Radix sort is used if both arrays are contiguous, merge sort otherwise
+         */
+        template <typename K, typename V>
+        static void sort(K *keys, const Nd4jLong *keysShapeInfo, V *values, const Nd4jLong *valuesShapeInfo, bool descending, int numThreads = sd::Environment::getInstance().maxMasterThreads()) {
+            const auto length = shape::length(keysShapeInfo);
+            const bool contiguous = shape::elementWiseStride(keysShapeInfo) == 1 && (values == nullptr || shape::elementWiseStride(valuesShapeInfo) == 1);
+
+            if (contiguous)
+                radixSort(keys, values, length, descending, numThreads);
+            else
+                mergeSort(keys, keysShapeInfo, values, valuesShapeInfo, descending, numThreads);
+        }
+
+        template <typename K>
+        static void sort(K *keys, const Nd4jLong *keysShapeInfo, bool descending, int numThreads = sd::Environment::getInstance().maxMasterThreads()) {
+            sort<K, int8_t>(keys, keysShapeInfo, nullptr, nullptr, descending, numThreads);
+        }
+    };
+}
+
+#endif //SD_SORTENGINE_H
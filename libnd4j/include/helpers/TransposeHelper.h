@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#ifndef SD_TRANSPOSEHELPER_H
+#define SD_TRANSPOSEHELPER_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+
+namespace sd {
+    /**
+     * This class copies array into array of the same shape but different memory layout, i.e. materializes permuted views.
+     * Unit dimensions are dropped and dimensions contiguous in both arrays are merged first, so most permutes end up as
+     * rank-2 or rank-3 copies. If fastest dimensions of source and target differ, they're copied in cache-sized tiles
+     * with in-register transposes of SIMD kernels, instead of element-by-element offset calculation.
+     */
+    class ND4J_EXPORT TransposeHelper {
+    public:
+        // tiles side, in elements, for 1/2/4 byte elements. 8 byte elements use half of it
+        static const Nd4jLong TILE = 64;
+
+        // merged rank above this one goes to generic loops
+        static const int MAX_MERGED_RANK = 6;
+
+        /**
+         * This method copies x into z, which must have the same shape and data type
+         * @return false if arrays aren't supported here, nothing is copied then
+         */
+        static bool copy(const void *x, const Nd4jLong *xShapeInfo, void *z, const Nd4jLong *zShapeInfo, bool allowParallelism = true);
+    };
+}
+
+#endif //SD_TRANSPOSEHELPER_H
@@ -0,0 +1,359 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_VPTREE_H
+#define SD_VPTREE_H
+
+#include <helpers/KnnIndex.h>
+#include <array/DataTypeUtils.h>
+#include <execution/Threads.h>
+#include <system/Environment.h>
+#include <math/templatemath.h>
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sd {
+
+    /**
+     * Vantage point tree stored in flat array in pre-order: inside child of a node always follows the node,
+     * and points are stored in the order of nodes, so each subtree covers contiguous range of points.
+     * Node splits points into halves by distance to its vantage point, small subtrees are kept as leaves
+     * that are scanned linearly.
+     *
+     * Since halves sizes depend only on number of points, position of every subtree is known in advance:
+     * top levels are built one by one with distances computed in parallel, and the rest of subtrees are built in parallel.
+     * Cosine distance is computed as euclidean distance between normalized vectors, so triangle inequality holds.
+     */
+    template <typename T>
+    class VPTree : public KnnIndex {
+    public:
+        struct Node {
+            Nd4jLong begin;         // vantage point for internal nodes, first point for leaves
+            Nd4jLong end;
+            Nd4jLong outside;       // -1 for leaves
+            double threshold;       // points of inside child are not farther from vantage point than threshold
+        };
+
+    private:
+        static const Nd4jLong LEAF_SIZE = 16;
+
+        // minimal number of queries per thread
+        static const Nd4jLong MIN_QUERIES = 8;
+
+        typedef std::pair<double, Nd4jLong> Item;
+
+        struct Task {
+            Nd4jLong node;
+            Nd4jLong begin;
+            Nd4jLong end;
+        };
+
+        std::vector<Node> _nodes;
+        std::vector<T> _points;             // points in tree order, normalized for cosine distance
+        std::vector<Nd4jLong> _indices;     // original index of each point
+
+        FORCEINLINE double distance(const T *a, const T *b) const {
+            double sum = 0.;
+            if (_distance == KNN_MANHATTAN) {
+                for (int e = 0; e < _dims; e++)
+                    sum += sd::math::nd4j_abs<double>(static_cast<double>(a[e]) - static_cast<double>(b[e]));
+
+                return sum;
+            }
+
+            for (int e = 0; e < _dims; e++) {
+                auto diff = static_cast<double>(a[e]) - static_cast<double>(b[e]);
+                sum += diff * diff;
+            }
+
+            return sd::math::nd4j_sqrt<double, double>(sum);
+        }
+
+        /**
+         * Returns distance, or any value above bound once partial sum exceeds it
+         */
+        FORCEINLINE double boundedDistance(const T *a, const T *b, double bound) const {
+            const bool manhattan = _distance == KNN_MANHATTAN;
+            const double limit = manhattan ? bound : bound * bound;
+
+            double sum = 0.;
+            for (int f = 0; f < _dims; f += 8) {
+                const int last = sd::math::nd4j_min<int>(_dims, f + 8);
+                if (manhattan) {
+                    for (int e = f; e < last; e++)
+                        sum += sd::math::nd4j_abs<double>(static_cast<double>(a[e]) - static_cast<double>(b[e]));
+                } else {
+                    for (int e = f; e < last; e++) {
+                        auto diff = static_cast<double>(a[e]) - static_cast<double>(b[e]);
+                        sum += diff * diff;
+                    }
+                }
+
+                if (sum > limit)
+                    return DataTypeUtils::infOrMax<double>();
+            }
+
+            return manhattan ? sum : sd::math::nd4j_sqrt<double, double>(sum);
+        }
+
+        FORCEINLINE T reported(double d) const {
+            // for unit vectors 1 - cos(a, b) = |a - b|^2 / 2
+            return static_cast<T>(_distance == KNN_COSINE ? d * d / 2. : d);
+        }
+
+        void normalize(const T *x, T *z) const {
+            double norm = 0.;
+            for (int e = 0; e < _dims; e++)
+                norm += static_cast<double>(x[e]) * static_cast<double>(x[e]);
+
+            norm = sd::math::nd4j_sqrt<double, double>(norm);
+            for (int e = 0; e < _dims; e++)
+                z[e] = norm > 0. ? static_cast<T>(static_cast<double>(x[e]) / norm) : x[e];
+        }
+
+        static Nd4jLong subtreeSize(Nd4jLong numPoints, std::map<Nd4jLong, Nd4jLong> &cache) {
+            if (numPoints <= LEAF_SIZE)
+                return 1;
+
+            auto it = cache.find(numPoints);
+            if (it != cache.end())
+                return it->second;
+
+            const auto inside = (numPoints - 1) / 2;
+            auto size = 1 + subtreeSize(inside, cache) + subtreeSize(numPoints - 1 - inside, cache);
+            cache[numPoints] = size;
+            return size;
+        }
+
+        /**
+         * Splits points of the task around vantage point, and appends tasks for both children
+         */
+        void split(const Task &task, std::vector<Item> &items, const std::map<Nd4jLong, Nd4jLong> &sizes, int numThreads, std::vector<Task> &next) {
+            const auto numPoints = task.end - task.begin;
+            if (numPoints <= LEAF_SIZE) {
+                _nodes[task.node] = {task.begin, task.end, -1, 0.};
+                return;
+            }
+
+            // vantage point is picked pseudo-randomly, but doesn't depend on number of threads
+            auto seed = static_cast<uint64_t>(task.node) * 6364136223846793005ULL + 1442695040888963407ULL;
+            seed ^= seed >> 33;
+            std::swap(items[task.begin], items[task.begin + static_cast<Nd4jLong>(seed % static_cast<uint64_t>(numPoints))]);
+
+            const T *vantage = _points.data() + items[task.begin].second * _dims;
+            auto func = PRAGMA_THREADS_FOR {
+                for (auto e = start; e < stop; e++)
+                    items[e].first = distance(vantage, _points.data() + items[e].second * _dims);
+            };
+
+            if (numThreads > 1 && numPoints > 4096)
+                samediff::Threads::parallel_for(func, task.begin + 1, task.end, 1, numThreads);
+            else
+                func(0, task.begin + 1, task.end, 1);
+
+            const auto inside = (numPoints - 1) / 2;
+            const auto middle = task.begin + 1 + inside;
+            std::nth_element(items.begin() + task.begin + 1, items.begin() + middle, items.begin() + task.end);
+
+            const auto insideSize = inside <= LEAF_SIZE ? 1 : sizes.at(inside);
+            const auto outside = task.node + 1 + insideSize;
+            _nodes[task.node] = {task.begin, task.end, outside, items[middle].first};
+
+            next.push_back({task.node + 1, task.begin + 1, middle});
+            next.push_back({outside, middle, task.end});
+        }
+
+        /**
+         * Runs k nearest neighbours search for one query, results are sorted by distance
+         */
+        void query(const T *q, Nd4jLong k, double radius, std::vector<Item> &heap, std::vector<std::pair<Nd4jLong, double>> &stack) const {
+            heap.clear();
+            stack.clear();
+
+            double tau = radius;
+            auto consider = [&](Nd4jLong position, double d) {
+                if (d > tau)
+                    return;
+
+                Item item(d, _indices[position]);
+                if (static_cast<Nd4jLong>(heap.size()) < k) {
+                    heap.push_back(item);
+                    std::push_heap(heap.begin(), heap.end());
+                } else if (item < heap.front()) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = item;
+                    std::push_heap(heap.begin(), heap.end());
+                } else {
+                    return;
+                }
+
+                if (static_cast<Nd4jLong>(heap.size()) == k)
+                    tau = sd::math::nd4j_min<double>(radius, heap.front().first);
+            };
+
+            // every node is pushed with lower bound of distances to its points, so it's skipped if bound exceeds tau
+            stack.emplace_back(0, 0.);
+            while (!stack.empty()) {
+                const auto index = stack.back().first;
+                const auto bound = stack.back().second;
+                stack.pop_back();
+
+                if (bound > tau)
+                    continue;
+
+                const auto &node = _nodes[index];
+                if (node.outside < 0) {
+                    for (auto p = node.begin; p < node.end; p++)
+                        consider(p, boundedDistance(q, _points.data() + p * _dims, tau));
+
+                    continue;
+                }
+
+                const auto d = distance(q, _points.data() + node.begin * _dims);
+                consider(node.begin, d);
+
+                // nearer child goes on top of the stack
+                if (d < node.threshold) {
+                    stack.emplace_back(node.outside, node.threshold - d);
+                    stack.emplace_back(index + 1, 0.);
+                } else {
+                    stack.emplace_back(index + 1, d - node.threshold);
+                    stack.emplace_back(node.outside, 0.);
+                }
+            }
+
+            std::sort_heap(heap.begin(), heap.end());
+        }
+
+        void searchAll(const T *queries, Nd4jLong numQueries, Nd4jLong k, double radius, Nd4jLong *indices, T *distances, Nd4jLong *counts) const {
+            if (k < 1)
+                throw std::invalid_argument("VPTree: number of results must be positive");
+
+            auto func = PRAGMA_THREADS_FOR {
+                std::vector<Item> heap;
+                std::vector<std::pair<Nd4jLong, double>> stack;
+                std::vector<T> normalized(_dims);
+
+                for (auto e = start; e < stop; e++) {
+                    const T *q = queries + e * _dims;
+                    if (_distance == KNN_COSINE) {
+                        normalize(q, normalized.data());
+                        q = normalized.data();
+                    }
+
+                    query(q, k, radius, heap, stack);
+
+                    const auto found = static_cast<Nd4jLong>(heap.size());
+                    for (Nd4jLong r = 0; r < k; r++) {
+                        indices[e * k + r] = r < found ? heap[r].second : -1;
+                        distances[e * k + r] = r < found ? reported(heap[r].first) : DataTypeUtils::infOrMax<T>();
+                    }
+
+                    if (counts != nullptr)
+                        counts[e] = found;
+                }
+            };
+
+            samediff::Threads::parallel_tad(func, 0, numQueries, 1, sd::math::nd4j_max<int>(1, sd::math::nd4j_min<Nd4jLong>(sd::Environment::getInstance().maxMasterThreads(), numQueries / MIN_QUERIES)));
+        }
+
+    public:
+        VPTree(const T *data, Nd4jLong numPoints, int dims, KnnDistance distance, int numThreads = sd::Environment::getInstance().maxMasterThreads()) : KnnIndex(DataTypeUtils::fromT<T>(), numPoints, dims, distance) {
+            std::vector<T> points(data, data + numPoints * dims);
+            if (distance == KNN_COSINE) {
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto e = start; e < stop; e++)
+                        normalize(data + e * dims, points.data() + e * dims);
+                };
+                samediff::Threads::parallel_for(func, 0, numPoints, 1, numThreads);
+            }
+            _points.swap(points);
+
+            std::vector<Item> items(numPoints);
+            for (Nd4jLong e = 0; e < numPoints; e++)
+                items[e] = Item(0., e);
+
+            std::map<Nd4jLong, Nd4jLong> sizes;
+            _nodes.resize(subtreeSize(numPoints, sizes));
+
+            // top levels are split one by one, each of them in parallel
+            std::vector<Task> tasks = {{0, 0, numPoints}};
+            std::vector<Task> next;
+            while (!tasks.empty() && static_cast<int>(tasks.size()) < numThreads) {
+                next.clear();
+                for (const auto &task : tasks)
+                    split(task, items, sizes, numThreads, next);
+
+                tasks.swap(next);
+            }
+
+            // remaining subtrees don't overlap
+            auto func = PRAGMA_THREADS_FOR {
+                std::vector<Task> stack;
+                for (auto e = start; e < stop; e++) {
+                    stack.clear();
+                    stack.push_back(tasks[e]);
+                    while (!stack.empty()) {
+                        auto task = stack.back();
+                        stack.pop_back();
+                        split(task, items, sizes, 1, stack);
+                    }
+                }
+            };
+            if (!tasks.empty())
+                samediff::Threads::parallel_tad(func, 0, static_cast<Nd4jLong>(tasks.size()), 1, numThreads);
+
+            // points are stored in tree order, so leaves and subtrees are contiguous
+            std::vector<T> ordered(numPoints * dims);
+            _indices.resize(numPoints);
+            auto gather = PRAGMA_THREADS_FOR {
+                for (auto e = start; e < stop; e++) {
+                    _indices[e] = items[e].second;
+                    std::copy(_points.begin() + items[e].second * dims, _points.begin() + (items[e].second + 1) * dims, ordered.begin() + e * dims);
+                }
+            };
+            samediff::Threads::parallel_for(gather, 0, numPoints, 1, numThreads);
+            _points.swap(ordered);
+        }
+
+        ~VPTree() override = default;
+
+        const std::vector<Node>& nodes() const {
+            return _nodes;
+        }
+
+        void search(const void *queries, Nd4jLong numQueries, Nd4jLong k, Nd4jLong *indices, void *distances) const override {
+            searchAll(reinterpret_cast<const T*>(queries), numQueries, k, DataTypeUtils::infOrMax<double>(), indices, reinterpret_cast<T*>(distances), nullptr);
+        }
+
+        void searchRadius(const void *queries, Nd4jLong numQueries, double radius, Nd4jLong maxResults, Nd4jLong *indices, void *distances, Nd4jLong *counts) const override {
+            // radius is compared against internal distance, which is sqrt(2 * (1 - cos)) for cosine
+            if (_distance == KNN_COSINE)
+                radius = sd::math::nd4j_sqrt<double, double>(2. * sd::math::nd4j_max<double>(0., radius));
+
+            searchAll(reinterpret_cast<const T*>(queries), numQueries, maxResults, radius, indices, reinterpret_cast<T*>(distances), counts);
+        }
+    };
+}
+
+#endif //SD_VPTREE_H
@@ -27,12 +27,18 @@
 #include <array/PrimaryPointerDeallocator.h>
 
 namespace sd {
+    // per-thread front cache: hits are served from here without any locking.
+    // entries point into shards, that's safe because shape infos are never evicted
+    struct ShapeFrontEntry {
+        size_t hash;
+        const ShapeDescriptor *descriptor;
+        ConstantShapeBuffer *buffer;
+    };
+
+    static const int FRONT_CACHE_SIZE = 64;
+
     ConstantShapeHelper::ConstantShapeHelper() {
-        _cache.resize(32);
-        for (int e = 0; e < 32; e++) {
-            MAP_IMPL<ShapeDescriptor, ConstantShapeBuffer> cache;
-            _cache[e] = cache;
-        }
+        //
     }
 
     ConstantShapeHelper& ConstantShapeHelper::getInstance() {
@@ -52,19 +58,30 @@ ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const sd::DataType
 
 
 ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const ShapeDescriptor &descriptor) {
-  int deviceId = 0;
+  static thread_local ShapeFrontEntry frontCache[FRONT_CACHE_SIZE] = {};
+
+  const auto hash = std::hash<ShapeDescriptor>()(descriptor);
+  auto &front = frontCache[hash % FRONT_CACHE_SIZE];
 
-  std::lock_guard<std::mutex> lock(_mutex);
+  if (front.buffer != nullptr && front.hash == hash && *front.descriptor == descriptor)
+    return *front.buffer;
 
-  if (_cache[deviceId].count(descriptor) == 0) {
+  auto &shard = _shards[(hash / FRONT_CACHE_SIZE) % NUM_SHARDS];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto it = shard.cache.find(descriptor);
+  if (it == shard.cache.end()) {
     auto hPtr = std::make_shared<PointerWrapper>(descriptor.toShapeInfo(), std::make_shared<PrimaryPointerDeallocator>());
     ConstantShapeBuffer buffer(hPtr);
-    ShapeDescriptor descriptor1(descriptor);
-    _cache[deviceId][descriptor1] = buffer;
-    return _cache[deviceId][descriptor1];
-  } else {
-    return _cache[deviceId].at(descriptor);
+    it = shard.cache.emplace(descriptor, buffer).first;
   }
+
+  front.hash = hash;
+  front.descriptor = &it->first;
+  front.buffer = &it->second;
+
+  return it->second;
 }
 
 ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *shapeInfo) {
@@ -73,11 +90,28 @@ ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *sha
     }
 
     bool ConstantShapeHelper::checkBufferExistenceForShapeInfo(ShapeDescriptor &descriptor) {
-        bool result;
-        int deviceId = 0;
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto hash = std::hash<ShapeDescriptor>()(descriptor);
+        auto &shard = _shards[(hash / FRONT_CACHE_SIZE) % NUM_SHARDS];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        return shard.cache.count(descriptor) != 0;
+    }
+
+    int ConstantShapeHelper::cachedEntriesForDevice(int deviceId) {
+        // there's only one device on cpu
+        return deviceId == 0 ? totalCachedEntries() : 0;
+    }
+
+    int ConstantShapeHelper::totalCachedEntries() {
+        int total = 0;
+
+        for (auto &shard: _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.cache.size();
+        }
 
-        return _cache[deviceId].count(descriptor) != 0;
+        return total;
     }
 
     const Nd4jLong* ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const char order, const int rank, const Nd4jLong* shape) {
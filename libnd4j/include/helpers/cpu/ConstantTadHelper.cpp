@@ -23,15 +23,30 @@
 #include <helpers/ShapeUtils.h>
 #include <array/ConstantOffsetsBuffer.h>
 #include <array/PrimaryPointerDeallocator.h>
+#include <memory>
 
 #ifndef __CUDABLAS__
 
 
 namespace sd {
 
+    // per-thread front cache: hits are served from here without any locking.
+    // entries hold their own copies of TadPacks, so eviction from shards doesn't affect them
+    struct TadFrontEntry {
+        size_t hash = 0;
+        std::unique_ptr<TadDescriptor> descriptor;
+        TadPack pack;
+    };
+
+    static const int FRONT_CACHE_SIZE = 64;
+
+    // bounded caches smaller than NUM_SHARDS use fewer shards, so every used shard can hold at least one pack
+    static int usedShards(Nd4jLong limit, int numShards) {
+        return limit > 0 && limit < numShards ? static_cast<int>(limit) : numShards;
+    }
+
     ConstantTadHelper::ConstantTadHelper() {
-        MAP_IMPL<TadDescriptor, TadPack> pack;
-        _cache.emplace_back(pack);
+        _limit = 0;
     }
 
     ConstantTadHelper& ConstantTadHelper::getInstance() {
@@ -58,10 +73,22 @@ namespace sd {
     }
 
     TadPack ConstantTadHelper::tadForDimensions(TadDescriptor &descriptor) {
-        const int deviceId = 0;
+        static thread_local TadFrontEntry frontCache[FRONT_CACHE_SIZE];
+
+        const auto hash = std::hash<TadDescriptor>()(descriptor);
+        auto &front = frontCache[hash % FRONT_CACHE_SIZE];
+
+        if (front.descriptor != nullptr && front.hash == hash && *front.descriptor == descriptor)
+            return front.pack;
+
+        const auto limit = _limit.load();
+        const auto numShards = usedShards(limit, NUM_SHARDS);
+        auto &shard = _shards[(hash / FRONT_CACHE_SIZE) % numShards];
 
-        std::lock_guard<std::mutex> lock(_mutex);
-        if (_cache[deviceId].count(descriptor) == 0) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.cache.find(descriptor);
+        if (it == shard.cache.end()) {
           // if there's no TadPack matching this descriptor - create one
             const auto shapeInfo = descriptor.originalShape().toShapeInfo();
             const int rank = shape::rank(shapeInfo);
@@ -78,13 +105,69 @@ namespace sd {
             ConstantShapeBuffer shapeBuffer(sPtr);
             ConstantOffsetsBuffer offsetsBuffer(oPtr);
             TadPack t(shapeBuffer, offsetsBuffer, numOfSubArrs);
-            _cache[deviceId][descriptor] = t;
+
+            CacheEntry entry;
+            entry.pack = t;
+            it = shard.cache.emplace(descriptor, entry).first;
+
+            shard.lru.push_front(&it->first);
+            it->second.position = shard.lru.begin();
 
             delete[] shapeInfo;
+
+            // evicting least recently used packs of this shard, if cache is bounded
+            if (limit > 0) {
+                auto shardLimit = limit / numShards;
+                while (shard.cache.size() > shardLimit) {
+                    auto victim = shard.cache.find(*shard.lru.back());
+                    shard.lru.pop_back();
+                    shard.cache.erase(victim);
+                }
+            }
+        } else {
+            // marking this pack as the most recently used one
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.position);
         }
 
-        return _cache[deviceId][descriptor];
+        front.hash = hash;
+        front.descriptor.reset(new TadDescriptor(descriptor));
+        front.pack = it->second.pack;
+
+        return front.pack;
+    }
+
+    int ConstantTadHelper::cachedEntriesForDevice(int deviceId) {
+        // there's only one device on cpu
+        return deviceId == 0 ? totalCachedEntries() : 0;
+    }
+
+    int ConstantTadHelper::totalCachedEntries() {
+        int total = 0;
+
+        for (auto &shard: _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.cache.size();
+        }
+
+        return total;
+    }
+
+    void ConstantTadHelper::setCacheLimit(Nd4jLong numberOfEntries) {
+        auto previous = _limit.exchange(numberOfEntries);
+
+        // descriptors are mapped to other shards now, so packs cached before can't be found anymore
+        if (usedShards(previous, NUM_SHARDS) != usedShards(numberOfEntries, NUM_SHARDS)) {
+            for (auto &shard: _shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.cache.clear();
+                shard.lru.clear();
+            }
+        }
+    }
+
+    Nd4jLong ConstantTadHelper::cacheLimit() {
+        return _limit.load();
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -21,82 +21,15 @@
 #include "../MmulHelper.h"
 #include <array/NDArrayFactory.h>
 #include <helpers/BlasHelper.h>
+#include <helpers/PackedGemm.h>
 #include <helpers/ShapeUtils.h>
+#include <helpers/ConstantTadHelper.h>
 #include <exceptions/datatype_exception.h>
 #include <execution/Threads.h>
 
 
 namespace sd {
 
-//////////////////////////////////////////////////////////////////////////////
-// MXK x KxN = MxN              -> actual sequence of axes doesn't matter
-template <typename T1, typename T2, typename T3>
-static  void usualGemm(const NDArray* vA, const NDArray* vB, NDArray* vC,
-                                 const int aMaxis, const int aKaxis, const int bKaxis, const int bNaxis, const int cMaxis, const int cNaxis,
-                                 const double alpha, const double beta) {
-
-    const T1* A = vA->bufferAsT<T1>();
-    const T2* B = vB->bufferAsT<T2>();
-          T3* C = vC->bufferAsT<T3>();
-
-    const T3 alphaZ = alpha;
-    const T3 betaZ  = beta;
-
-    const bool betaPersent = beta;
-
-    const Nd4jLong* aShapeInfo = vA->shapeInfo();
-    const Nd4jLong* bShapeInfo = vB->shapeInfo();
-    const Nd4jLong* cShapeInfo = vC->shapeInfo();
-
-    const int aRank = vA->rankOf();
-    const int bRank = vB->rankOf();
-    const int cRank = vC->rankOf();
-
-    const Nd4jLong cLen = vC->lengthOf();
-
-    const int K = vA->sizeAt(aKaxis);
-
-    auto func = PRAGMA_THREADS_FOR {
-
-        std::vector<Nd4jLong> aCoords(2), bCoords(2), cCoords(2);
-
-        for (auto i = start; i < stop; ++i) {
-
-            // evaluate C coordinates
-            shape::index2coordsCPU(start, i, cShapeInfo, cCoords.data());
-
-            // evaluate A coordinates
-            aCoords[aMaxis] = cCoords[cMaxis];
-            aCoords[aKaxis] = 0;
-
-            // evaluate B coordinates
-            bCoords[bKaxis] = 0;
-            bCoords[bNaxis] = cCoords[cNaxis];
-
-            auto aOffset = shape::getOffset(aShapeInfo, aCoords.data());
-            auto bOffset = shape::getOffset(bShapeInfo, bCoords.data());
-
-            T3 val = A[aOffset] * B[bOffset];                       // first iteration
-
-            for (int j = 1; j < K; ++j) {                          // rest iterations
-                aOffset += shape::stride(aShapeInfo)[aKaxis];
-                bOffset += shape::stride(bShapeInfo)[bKaxis];
-                val = val + A[aOffset] * B[bOffset];
-            }
-
-            auto cOffset = shape::getOffset(cShapeInfo, cCoords.data());
-
-            if(betaPersent)
-                C[cOffset] = alphaZ * val + betaZ * C[cOffset];
-            else
-                C[cOffset] = alphaZ * val;
-        }
-    };
-
-    samediff::Threads::parallel_tad(func, 0, cLen);
-}
-
-
 //////////////////////////////////////////////////////////////////////////////
 // MXN x N = M  -> actual sequence of {M,N} axes doesn't matter
 template <typename T1, typename T2, typename T3>
@@ -216,8 +149,8 @@ NDArray* MmulHelper::mmulMxM(const NDArray* A, const NDArray* B, NDArray* C, con
     const bool typeFloat  = hasGemm && ABC &&  aType == DataType::FLOAT32;
 
     if(!typeFloat && !typeDouble) {
-        BUILD_SINGLE_SELECTOR_THRICE(aType, usualGemm, (A, B, C, 0, 1, 0, 1, 0, 1, alpha, beta), NUMERIC_TYPES);
-        // BUILD_TRIPLE_SELECTOR(aType, bType, cType, usualGemm, (A, B, C, 0, 1, 0, 1, 0, 1, alpha, beta), LIBND4J_TYPES, FLOAT_TYPES, FLOAT_TYPES);
+        // no BLAS for this data type, packed gemm works with strides of any array as is
+        PackedGemm::gemm(aType, M, N, K, alpha, A->buffer(), A->strideAt(0), A->strideAt(1), B->buffer(), B->strideAt(0), B->strideAt(1), beta, C->buffer(), C->strideAt(0), C->strideAt(1));
     }
     else {
 
@@ -533,6 +466,62 @@ NDArray* MmulHelper::mmulNxN(const NDArray* A, const NDArray* B, NDArray* C, con
     if(cRank > 2)
         cBatchDims = ShapeUtils::evalDimsToExclude(cRank, {cMaxis, cNaxis});
 
+    const Nd4jLong M = A->sizeAt(aMaxis);
+    const Nd4jLong K = A->sizeAt(aKaxis);
+    const Nd4jLong N = B->sizeAt(bNaxis);
+
+    const bool sameTypes = A->dataType() == B->dataType() && A->dataType() == C->dataType();
+    const Nd4jLong numOfBatches = C->lengthOf() / (M * N);
+
+    if (sameTypes && PackedGemm::isBatchable(M, N, K)) {
+        // small matrices: each product is done by single thread, batch is split between threads
+
+        auto pointers = [&] (const NDArray *arr, const int rowAxis, const int colAxis) -> std::vector<void*> {
+            std::vector<void*> result(numOfBatches, const_cast<void*>(arr->buffer()));
+            if (arr->rankOf() > 2) {
+                auto pack = ConstantTadHelper::getInstance().tadForDimensions(arr->shapeInfo(), {rowAxis, colAxis});
+                for (Nd4jLong e = 0; e < numOfBatches; e++)
+                    result[e] = const_cast<void*>(arr->bufferWithOffset(pack.primaryOffsets()[e]));
+            }
+            return result;
+        };
+
+        auto aBuffers = pointers(A, aMaxis, aKaxis);
+        auto bBuffers = pointers(B, bKaxis, bNaxis);
+        auto cBuffers = pointers(C, cMaxis, cNaxis);
+
+        std::vector<double> alphas(numOfBatches, alpha);
+        std::vector<double> betas(numOfBatches, beta);
+
+        PackedGemm::gemmBatched(C->dataType(), numOfBatches, M, N, K, alphas.data(),
+                                aBuffers.data(), A->strideAt(aMaxis), A->strideAt(aKaxis),
+                                bBuffers.data(), B->strideAt(bKaxis), B->strideAt(bNaxis),
+                                betas.data(), cBuffers.data(), C->strideAt(cMaxis), C->strideAt(cNaxis));
+
+        return C;
+    }
+
+    if (sameTypes) {
+        // large matrices: products go one by one, each of them is parallel on its own
+        for (Nd4jLong e = 0; e < numOfBatches; e++) {
+            NDArray aSubArr, bSubArr;
+            const NDArray *pA = A, *pB = B;
+            if (aRank > 2) {
+                aSubArr = (*A)(e, aBatchDims);
+                pA = &aSubArr;
+            }
+            if (bRank > 2) {
+                bSubArr = (*B)(e, bBatchDims);
+                pB = &bSubArr;
+            }
+
+            NDArray cSubArr = (*C)(e, cBatchDims);
+            mmulMxM(pA, pB, &cSubArr, alpha, beta, outOrder);
+        }
+
+        return C;
+    }
+
     // BUILD_TRIPLE_SELECTOR(A->dataType(), B->dataType(), C->dataType(), batchedGemm, (A, B, C, aBatchDims.data(), bBatchDims.data(), cBatchDims.data(), aMaxis, aKaxis, bKaxis, bNaxis, cMaxis, cNaxis, alpha, beta), LIBND4J_TYPES, FLOAT_TYPES, FLOAT_TYPES);
     BUILD_SINGLE_SELECTOR_THRICE(A->dataType(), batchedGemm, (A, B, C, aBatchDims.data(), bBatchDims.data(), cBatchDims.data(), aMaxis, aKaxis, bKaxis, bNaxis, cMaxis, cNaxis, alpha, beta), NUMERIC_TYPES);
 
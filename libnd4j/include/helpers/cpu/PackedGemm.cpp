@@ -0,0 +1,359 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#include <helpers/PackedGemm.h>
+#include <execution/Threads.h>
+#include <system/Environment.h>
+#include <system/op_boilerplate.h>
+#include <math/templatemath.h>
+#include <types/types.h>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sd {
+    // MR x NR accumulators must fit into vector registers, KC x NR sliver of B into L1, MC x KC block of A into L2
+    template <int size> struct GemmBlocking { };
+    template <> struct GemmBlocking<4> {
+        static const int MR = 6;
+        static const int NR = 16;
+        static const Nd4jLong MC = 72;
+        static const Nd4jLong KC = 256;
+        static const Nd4jLong NC = 4096;
+    };
+    template <> struct GemmBlocking<8> {
+        static const int MR = 6;
+        static const int NR = 8;
+        static const Nd4jLong MC = 72;
+        static const Nd4jLong KC = 256;
+        static const Nd4jLong NC = 2048;
+    };
+
+    // if accumulator type differs from T, partial sums can't be stored to C between K blocks, so K isn't split.
+    // NC is limited instead, to keep packed B within this number of elements
+    static const Nd4jLong GEMM_UNSPLIT_BUDGET = 1 << 22;
+
+    // panels of single product in gemmBatched are limited to this number of elements
+    static const Nd4jLong GEMM_BATCHED_BUDGET = 1 << 18;
+
+    // sliver s of B block: kc rows of NR elements, columns past nc are zeros. Zero points of columns, if any, are subtracted here
+    template <typename T, typename A, int NR>
+    static void packB(const T *B, const Nd4jLong rowStride, const Nd4jLong colStride, const Nd4jLong kc, const Nd4jLong nc, A *packed, const Nd4jLong s,
+                      const int32_t *offsets, const Nd4jLong offsetStride) {
+        const auto j0 = s * NR;
+        const int cols = sd::math::nd4j_min<Nd4jLong>(NR, nc - j0);
+        auto dst = packed + s * kc * NR;
+
+        A shift[NR];
+        for (int j = 0; j < cols; j++)
+            shift[j] = offsets == nullptr ? static_cast<A>(0) : static_cast<A>(offsets[(j0 + j) * offsetStride]);
+
+        for (Nd4jLong k = 0; k < kc; k++, dst += NR) {
+            auto src = B + k * rowStride + j0 * colStride;
+            int j = 0;
+            for (; j < cols; j++)
+                dst[j] = static_cast<A>(src[j * colStride]) - shift[j];
+            for (; j < NR; j++)
+                dst[j] = static_cast<A>(0);
+        }
+    }
+
+    // block of A is packed as slivers of MR rows: kc columns of MR elements each
+    template <typename T, typename A, int MR>
+    static void packA(const T *Ablock, const Nd4jLong rowStride, const Nd4jLong colStride, const Nd4jLong mc, const Nd4jLong kc, A *packed, const A offset) {
+        for (Nd4jLong i0 = 0; i0 < mc; i0 += MR) {
+            const int rows = sd::math::nd4j_min<Nd4jLong>(MR, mc - i0);
+            auto dst = packed + i0 * kc;
+
+            for (Nd4jLong k = 0; k < kc; k++, dst += MR) {
+                auto src = Ablock + i0 * rowStride + k * colStride;
+                int i = 0;
+                for (; i < rows; i++)
+                    dst[i] = static_cast<A>(src[i * rowStride]) - offset;
+                for (; i < MR; i++)
+                    dst[i] = static_cast<A>(0);
+            }
+        }
+    }
+
+    // fixed MR and NR let compiler keep accumulators in registers and vectorize over NR
+    template <typename A, int MR, int NR>
+    static FORCEINLINE void microKernel(const Nd4jLong kc, const A *a, const A *b, A (&acc)[MR][NR]) {
+        for (int i = 0; i < MR; i++)
+            for (int j = 0; j < NR; j++)
+                acc[i][j] = static_cast<A>(0);
+
+        for (Nd4jLong k = 0; k < kc; k++, a += MR, b += NR) {
+            for (int i = 0; i < MR; i++) {
+                const auto ai = a[i];
+
+                PRAGMA_OMP_SIMD
+                for (int j = 0; j < NR; j++)
+                    acc[i][j] += ai * b[j];
+            }
+        }
+    }
+
+    // Z is type of C: it's either T, or accumulator type itself for quantized gemm
+    template <typename TA, typename TB, typename Acc, typename Z>
+    static void packedGemm(const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, const double alpha,
+                           const TA *A, const Nd4jLong aRowStride, const Nd4jLong aColStride, const Acc aOffset,
+                           const TB *B, const Nd4jLong bRowStride, const Nd4jLong bColStride, const int32_t *bOffsets, const Nd4jLong bOffsetStride,
+                           const double beta, Z *C, const Nd4jLong cRowStride, const Nd4jLong cColStride) {
+        typedef GemmBlocking<sizeof(Acc) <= 4 ? 4 : 8> Blocking;
+        const int MR = Blocking::MR;
+        const int NR = Blocking::NR;
+        const Nd4jLong MC = Blocking::MC;
+
+        if (M <= 0 || N <= 0)
+            return;
+
+        const Acc alphaA = static_cast<Acc>(alpha);
+        const Acc betaA = static_cast<Acc>(beta);
+
+        // C = beta * C if there's nothing to multiply
+        if (K <= 0) {
+            for (Nd4jLong i = 0; i < M; i++)
+                for (Nd4jLong j = 0; j < N; j++) {
+                    auto c = C + i * cRowStride + j * cColStride;
+                    *c = beta == 0.0 ? static_cast<Z>(0) : static_cast<Z>(betaA * static_cast<Acc>(*c));
+                }
+            return;
+        }
+
+        const bool splitK = std::is_same<Acc, Z>::value;
+        const Nd4jLong KC = splitK ? Blocking::KC : K;
+        const Nd4jLong NC = splitK ? Blocking::NC : sd::math::nd4j_max<Nd4jLong>(NR, (GEMM_UNSPLIT_BUDGET / K) / NR * NR);
+
+        const int maxThreads = sd::Environment::getInstance().maxMasterThreads();
+        const bool parallel = maxThreads > 1 && static_cast<double>(M) * N * K > 64. * 64. * 64.;
+
+        std::vector<Acc> packedB(sd::math::nd4j_min<Nd4jLong>(KC, K) * ((sd::math::nd4j_min<Nd4jLong>(NC, N) + NR - 1) / NR) * NR);
+
+        for (Nd4jLong jc = 0; jc < N; jc += NC) {
+            const auto nc = sd::math::nd4j_min<Nd4jLong>(NC, N - jc);
+            const Nd4jLong slivers = (nc + NR - 1) / NR;
+
+            for (Nd4jLong pc = 0; pc < K; pc += KC) {
+                const auto kc = sd::math::nd4j_min<Nd4jLong>(KC, K - pc);
+                const bool first = pc == 0;
+
+                auto packSlivers = PRAGMA_THREADS_FOR {
+                    for (auto s = start; s < stop; s++)
+                        packB<TB, Acc, NR>(B + pc * bRowStride + jc * bColStride, bRowStride, bColStride, kc, nc, packedB.data(), s,
+                                           bOffsets == nullptr ? nullptr : bOffsets + jc * bOffsetStride, bOffsetStride);
+                };
+
+                if (parallel)
+                    samediff::Threads::parallel_for(packSlivers, 0, slivers);
+                else
+                    packSlivers(0, 0, slivers, 1);
+
+                // macro-tiles: MC rows of C by a range of slivers, at least 2 slivers per range
+                const Nd4jLong mBlocks = (M + MC - 1) / MC;
+                Nd4jLong nChunks = 1;
+                while (parallel && mBlocks * nChunks < maxThreads && slivers >= nChunks * 4)
+                    nChunks *= 2;
+
+                auto macro = PRAGMA_THREADS_FOR {
+                    std::vector<Acc> packedA(MC * kc);
+                    Nd4jLong packedBlock = -1;
+                    Acc acc[MR][NR];
+
+                    for (auto u = start; u < stop; u++) {
+                        const auto block = u / nChunks;
+                        const auto chunk = u % nChunks;
+                        const auto ic = block * MC;
+                        const auto mc = sd::math::nd4j_min<Nd4jLong>(MC, M - ic);
+
+                        // consecutive units of the same rows block reuse packed A
+                        if (block != packedBlock) {
+                            packA<TA, Acc, MR>(A + ic * aRowStride + pc * aColStride, aRowStride, aColStride, mc, kc, packedA.data(), aOffset);
+                            packedBlock = block;
+                        }
+
+                        const auto sStart = chunk * slivers / nChunks;
+                        const auto sStop = (chunk + 1) * slivers / nChunks;
+
+                        for (auto s = sStart; s < sStop; s++) {
+                            const auto j0 = jc + s * NR;
+                            const int cols = sd::math::nd4j_min<Nd4jLong>(NR, N - j0);
+                            const auto b = packedB.data() + s * kc * NR;
+
+                            for (Nd4jLong i0 = 0; i0 < mc; i0 += MR) {
+                                const int rows = sd::math::nd4j_min<Nd4jLong>(MR, mc - i0);
+                                microKernel<Acc, MR, NR>(kc, packedA.data() + i0 * kc, b, acc);
+
+                                for (int i = 0; i < rows; i++) {
+                                    auto c = C + (ic + i0 + i) * cRowStride + j0 * cColStride;
+                                    for (int j = 0; j < cols; j++, c += cColStride) {
+                                        const Acc value = alphaA * acc[i][j];
+
+                                        // beta == 0 means C is overwritten, even if it contains NaNs
+                                        if (!first)
+                                            *c = static_cast<Z>(static_cast<Acc>(*c) + value);
+                                        else if (beta == 0.0)
+                                            *c = static_cast<Z>(value);
+                                        else
+                                            *c = static_cast<Z>(value + betaA * static_cast<Acc>(*c));
+                                    }
+                                }
+                            }
+                        }
+                    }
+                };
+
+                if (parallel)
+                    samediff::Threads::parallel_for(macro, 0, mBlocks * nChunks);
+                else
+                    macro(0, 0, mBlocks * nChunks, 1);
+            }
+        }
+    }
+
+    // whole product by one thread: panels of A and B are packed over full K once, so C is stored just once
+    template <typename T, typename Acc>
+    static void smallGemm(const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, const double alpha,
+                          const T *A, const Nd4jLong aRowStride, const Nd4jLong aColStride,
+                          const T *B, const Nd4jLong bRowStride, const Nd4jLong bColStride,
+                          const double beta, T *C, const Nd4jLong cRowStride, const Nd4jLong cColStride, Acc *packedA, Acc *packedB) {
+        typedef GemmBlocking<sizeof(Acc) <= 4 ? 4 : 8> Blocking;
+        const int MR = Blocking::MR;
+        const int NR = Blocking::NR;
+
+        const Acc alphaA = static_cast<Acc>(alpha);
+        const Acc betaA = static_cast<Acc>(beta);
+        const Nd4jLong slivers = (N + NR - 1) / NR;
+
+        for (Nd4jLong s = 0; s < slivers; s++)
+            packB<T, Acc, NR>(B, bRowStride, bColStride, K, N, packedB, s, nullptr, 0);
+
+        packA<T, Acc, MR>(A, aRowStride, aColStride, M, K, packedA, static_cast<Acc>(0));
+
+        Acc acc[MR][NR];
+        for (Nd4jLong i0 = 0; i0 < M; i0 += MR) {
+            const int rows = sd::math::nd4j_min<Nd4jLong>(MR, M - i0);
+
+            for (Nd4jLong s = 0; s < slivers; s++) {
+                const auto j0 = s * NR;
+                const int cols = sd::math::nd4j_min<Nd4jLong>(NR, N - j0);
+                microKernel<Acc, MR, NR>(K, packedA + i0 * K, packedB + s * K * NR, acc);
+
+                for (int i = 0; i < rows; i++) {
+                    auto c = C + (i0 + i) * cRowStride + j0 * cColStride;
+                    for (int j = 0; j < cols; j++, c += cColStride) {
+                        const Acc value = alphaA * acc[i][j];
+                        *c = beta == 0.0 ? static_cast<T>(value) : static_cast<T>(value + betaA * static_cast<Acc>(*c));
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void PackedGemm::gemmBatched_(const Nd4jLong batch, const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, const double *alphas,
+                                  const void * const *A, const Nd4jLong aRowStride, const Nd4jLong aColStride,
+                                  const void * const *B, const Nd4jLong bRowStride, const Nd4jLong bColStride,
+                                  const double *betas, void * const *C, const Nd4jLong cRowStride, const Nd4jLong cColStride) {
+        typedef typename GemmAccumulator<T>::type Acc;
+        typedef GemmBlocking<sizeof(Acc) <= 4 ? 4 : 8> Blocking;
+
+        if (batch <= 0 || M <= 0 || N <= 0)
+            return;
+
+        const Nd4jLong aSize = (M + Blocking::MR - 1) / Blocking::MR * Blocking::MR * K;
+        const Nd4jLong bSize = (N + Blocking::NR - 1) / Blocking::NR * Blocking::NR * K;
+
+        auto func = PRAGMA_THREADS_FOR {
+            // panels are allocated once per thread and reused by all of its products
+            std::vector<Acc> packed(aSize + bSize);
+
+            for (auto e = start; e < stop; e++)
+                smallGemm<T, Acc>(M, N, K, alphas[e], reinterpret_cast<const T*>(A[e]), aRowStride, aColStride,
+                                  reinterpret_cast<const T*>(B[e]), bRowStride, bColStride,
+                                  betas[e], reinterpret_cast<T*>(C[e]), cRowStride, cColStride, packed.data(), packed.data() + aSize);
+        };
+
+        // products smaller than this aren't worth waking up threads for one by one
+        if (static_cast<double>(batch) * M * N * K > 64. * 64. * 64.)
+            samediff::Threads::parallel_tad(func, 0, batch);
+        else
+            func(0, 0, batch, 1);
+    }
+
+    template <typename T>
+    void PackedGemm::gemm_(const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, const double alpha,
+                           const void *A, const Nd4jLong aRowStride, const Nd4jLong aColStride,
+                           const void *B, const Nd4jLong bRowStride, const Nd4jLong bColStride,
+                           const double beta, void *C, const Nd4jLong cRowStride, const Nd4jLong cColStride) {
+        typedef typename GemmAccumulator<T>::type Acc;
+
+        packedGemm<T, T, Acc, T>(M, N, K, alpha, reinterpret_cast<const T*>(A), aRowStride, aColStride, static_cast<Acc>(0),
+                                 reinterpret_cast<const T*>(B), bRowStride, bColStride, nullptr, 0,
+                                 beta, reinterpret_cast<T*>(C), cRowStride, cColStride);
+    }
+
+    template <typename TA, typename TB>
+    void PackedGemm::gemmQuantized_(const Nd4jLong M, const Nd4jLong N, const Nd4jLong K,
+                                    const void *A, const Nd4jLong aRowStride, const Nd4jLong aColStride, const int aZeroPoint,
+                                    const void *B, const Nd4jLong bRowStride, const Nd4jLong bColStride, const int32_t *bZeroPoints, const Nd4jLong bZeroPointStride,
+                                    int32_t *C, const Nd4jLong cRowStride, const Nd4jLong cColStride) {
+        packedGemm<TA, TB, int32_t, int32_t>(M, N, K, 1.0, reinterpret_cast<const TA*>(A), aRowStride, aColStride, aZeroPoint,
+                                             reinterpret_cast<const TB*>(B), bRowStride, bColStride, bZeroPoints, bZeroPointStride,
+                                             0.0, C, cRowStride, cColStride);
+    }
+
+    void PackedGemm::gemm(const sd::DataType dataType, const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, const double alpha,
+                          const void *A, const Nd4jLong aRowStride, const Nd4jLong aColStride,
+                          const void *B, const Nd4jLong bRowStride, const Nd4jLong bColStride,
+                          const double beta, void *C, const Nd4jLong cRowStride, const Nd4jLong cColStride) {
+        BUILD_SINGLE_SELECTOR(dataType, gemm_, (M, N, K, alpha, A, aRowStride, aColStride, B, bRowStride, bColStride, beta, C, cRowStride, cColStride), NUMERIC_TYPES);
+    }
+
+    void PackedGemm::gemmQuantized(const sd::DataType aType, const sd::DataType bType, const Nd4jLong M, const Nd4jLong N, const Nd4jLong K,
+                                   const void *A, const Nd4jLong aRowStride, const Nd4jLong aColStride, const int aZeroPoint,
+                                   const void *B, const Nd4jLong bRowStride, const Nd4jLong bColStride, const int32_t *bZeroPoints, const Nd4jLong bZeroPointStride,
+                                   int32_t *C, const Nd4jLong cRowStride, const Nd4jLong cColStride) {
+        if (aType == sd::DataType::UINT8 && bType == sd::DataType::UINT8)
+            gemmQuantized_<uint8_t, uint8_t>(M, N, K, A, aRowStride, aColStride, aZeroPoint, B, bRowStride, bColStride, bZeroPoints, bZeroPointStride, C, cRowStride, cColStride);
+        else if (aType == sd::DataType::UINT8 && bType == sd::DataType::INT8)
+            gemmQuantized_<uint8_t, int8_t>(M, N, K, A, aRowStride, aColStride, aZeroPoint, B, bRowStride, bColStride, bZeroPoints, bZeroPointStride, C, cRowStride, cColStride);
+        else if (aType == sd::DataType::INT8 && bType == sd::DataType::UINT8)
+            gemmQuantized_<int8_t, uint8_t>(M, N, K, A, aRowStride, aColStride, aZeroPoint, B, bRowStride, bColStride, bZeroPoints, bZeroPointStride, C, cRowStride, cColStride);
+        else if (aType == sd::DataType::INT8 && bType == sd::DataType::INT8)
+            gemmQuantized_<int8_t, int8_t>(M, N, K, A, aRowStride, aColStride, aZeroPoint, B, bRowStride, bColStride, bZeroPoints, bZeroPointStride, C, cRowStride, cColStride);
+        else
+            throw std::runtime_error("PackedGemm::gemmQuantized - only INT8 and UINT8 arrays are supported");
+    }
+
+    bool PackedGemm::isBatchable(const Nd4jLong M, const Nd4jLong N, const Nd4jLong K) {
+        // sizes are padded for the widest blocking
+        return (M + GemmBlocking<4>::MR) * K + (N + GemmBlocking<4>::NR) * K <= GEMM_BATCHED_BUDGET;
+    }
+
+    void PackedGemm::gemmBatched(const sd::DataType dataType, const Nd4jLong batch, const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, const double *alphas,
+                                 const void * const *A, const Nd4jLong aRowStride, const Nd4jLong aColStride,
+                                 const void * const *B, const Nd4jLong bRowStride, const Nd4jLong bColStride,
+                                 const double *betas, void * const *C, const Nd4jLong cRowStride, const Nd4jLong cColStride) {
+        BUILD_SINGLE_SELECTOR(dataType, gemmBatched_, (batch, M, N, K, alphas, A, aRowStride, aColStride, B, bRowStride, bColStride, betas, C, cRowStride, cColStride), NUMERIC_TYPES);
+    }
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <helpers/SimdKernels.h>
+#include <helpers/cpu/simd/kernels.h>
+#include <helpers/logger.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef CPU_FEATURES
+#include <cpuinfo_x86.h>
+#endif
+
+namespace sd {
+    namespace simd {
+        static const char* levelName(SimdLevel level) {
+            switch (level) {
+                case SIMD_SSE4: return "sse4";
+                case SIMD_AVX2: return "avx2";
+                case SIMD_AVX512: return "avx512";
+                case SIMD_NEON: return "neon";
+                default: return "generic";
+            }
+        }
+
+        SimdKernels::SimdKernels() {
+            std::memset(_floats, 0, sizeof(_floats));
+            std::memset(_doubles, 0, sizeof(_doubles));
+            for (int e = 0; e < SIMD_LEVELS; e++)
+                _available[e] = false;
+
+            _available[SIMD_GENERIC] = true;
+
+#ifdef CPU_FEATURES
+            auto features = cpu_features::GetX86Info().features;
+
+            if (features.sse4_1 && registerSse4Kernels(_floats[SIMD_SSE4], _doubles[SIMD_SSE4])) {
+                _available[SIMD_SSE4] = true;
+                _detected = SIMD_SSE4;
+            }
+
+            if (features.avx2 && features.fma3 && registerAvx2Kernels(_floats[SIMD_AVX2], _doubles[SIMD_AVX2])) {
+                _available[SIMD_AVX2] = true;
+                _detected = SIMD_AVX2;
+            }
+
+            if (features.avx512f && registerAvx512Kernels(_floats[SIMD_AVX512], _doubles[SIMD_AVX512])) {
+                _available[SIMD_AVX512] = true;
+                _detected = SIMD_AVX512;
+            }
+#else
+            if (registerNeonKernels(_floats[SIMD_NEON], _doubles[SIMD_NEON])) {
+                _available[SIMD_NEON] = true;
+                _detected = SIMD_NEON;
+            }
+#endif
+
+            _level.store(_detected);
+
+            // instruction set can be lowered, i.e. to compare results against generic loops
+            const char* level = std::getenv("SD_SIMD_LEVEL");
+            if (level != nullptr) {
+                std::string requested(level);
+                bool found = false;
+                for (int e = 0; e < SIMD_LEVELS; e++) {
+                    if (requested == levelName(static_cast<SimdLevel>(e))) {
+                        found = setLevel(static_cast<SimdLevel>(e));
+                        break;
+                    }
+                }
+
+                if (!found)
+                    nd4j_printf("SD_SIMD_LEVEL [%s] isn't available, using [%s]\n", level, levelName(_detected));
+            }
+        }
+
+        SimdKernels& SimdKernels::getInstance() {
+            static SimdKernels instance;
+            return instance;
+        }
+
+        SimdLevel SimdKernels::detectedLevel() const {
+            return _detected;
+        }
+
+        SimdLevel SimdKernels::level() const {
+            return static_cast<SimdLevel>(_level.load());
+        }
+
+        bool SimdKernels::isAvailable(SimdLevel level) const {
+            return level >= SIMD_GENERIC && level < SIMD_LEVELS && _available[level];
+        }
+
+        bool SimdKernels::setLevel(SimdLevel level) {
+            if (!isAvailable(level))
+                return false;
+
+            _level.store(level);
+            return true;
+        }
+
+        template <>
+        const KernelTable<float>* SimdKernels::table<float>() const {
+            auto level = _level.load(std::memory_order_relaxed);
+            return level == SIMD_GENERIC ? nullptr : &_floats[level];
+        }
+
+        template <>
+        const KernelTable<double>* SimdKernels::table<double>() const {
+            auto level = _level.load(std::memory_order_relaxed);
+            return level == SIMD_GENERIC ? nullptr : &_doubles[level];
+        }
+    }
+}
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#include <helpers/TransposeHelper.h>
+#include <helpers/SimdKernels.h>
+#include <helpers/shape.h>
+#include <array/DataTypeUtils.h>
+#include <execution/Threads.h>
+#include <system/Environment.h>
+#include <algorithm>
+
+namespace sd {
+    namespace {
+        struct TransposeDim {
+            Nd4jLong size;
+            Nd4jLong xStride;
+            Nd4jLong zStride;
+        };
+
+        // 4 and 8 byte elements are moved by float/double kernels, it's the same data movement. Others have no kernels
+        template <typename T> struct TransposeSimd { typedef T type; };
+        template <> struct TransposeSimd<uint32_t> { typedef float type; };
+        template <> struct TransposeSimd<uint64_t> { typedef double type; };
+
+        template <typename T, typename S>
+        static FORCEINLINE bool simdTranspose(const T *x, Nd4jLong xStride, T *z, Nd4jLong zStride, Nd4jLong rows, Nd4jLong cols, const simd::KernelTable<S> *table) {
+            if (table == nullptr || table->transpose == nullptr)
+                return false;
+
+            table->transpose(reinterpret_cast<const S*>(x), xStride, reinterpret_cast<S*>(z), zStride, rows, cols);
+            return true;
+        }
+
+        /**
+         * Copies dims[0..rank) from x to z, dimensions are sorted by z strides, so the last one is the fastest in z
+         */
+        template <typename T>
+        static void copyMerged(const T *x, T *z, const TransposeDim *dims, int rank, bool allowParallelism) {
+            typedef typename TransposeSimd<T>::type S;
+
+            // fastest dimension of x
+            int xi = rank - 1;
+            for (int e = 0; e < rank; e++) {
+                auto stride = sd::math::nd4j_abs<Nd4jLong>(dims[e].xStride);
+                if (stride != 0 && (dims[xi].xStride == 0 || stride < sd::math::nd4j_abs<Nd4jLong>(dims[xi].xStride)))
+                    xi = e;
+            }
+            const int zi = rank - 1;
+
+            // everything else is iterated by outer loop
+            TransposeDim outer[TransposeHelper::MAX_MERGED_RANK];
+            int outerRank = 0;
+            Nd4jLong outerLength = 1;
+            Nd4jLong length = 1;
+            for (int e = 0; e < rank; e++) {
+                length *= dims[e].size;
+                if (e != xi && e != zi) {
+                    outer[outerRank++] = dims[e];
+                    outerLength *= dims[e].size;
+                }
+            }
+
+            const auto &a = dims[xi];
+            const auto &b = dims[zi];
+            const Nd4jLong tile = sizeof(T) >= 8 ? TransposeHelper::TILE / 2 : TransposeHelper::TILE;
+            const Nd4jLong tilesA = xi == zi ? 1 : (a.size + tile - 1) / tile;
+            const Nd4jLong tilesB = xi == zi ? 1 : (b.size + tile - 1) / tile;
+
+            auto func = PRAGMA_THREADS_FOR {
+                auto table = simd::SimdKernels::getInstance().template table<S>();
+
+                for (auto u = start; u < stop; u++) {
+                    auto o = u / (tilesA * tilesB);
+                    auto tb = (u / tilesA) % tilesB;
+                    auto ta = u % tilesA;
+
+                    Nd4jLong xOffset = 0, zOffset = 0;
+                    for (int e = outerRank - 1; e >= 0; e--) {
+                        auto coord = o % outer[e].size;
+                        o /= outer[e].size;
+                        xOffset += coord * outer[e].xStride;
+                        zOffset += coord * outer[e].zStride;
+                    }
+
+                    // fastest dimensions are the same: plain row copy
+                    if (xi == zi) {
+                        if (b.xStride == 1 && b.zStride == 1) {
+                            std::copy(x + xOffset, x + xOffset + b.size, z + zOffset);
+                        } else {
+                            for (Nd4jLong i = 0; i < b.size; i++)
+                                z[zOffset + i * b.zStride] = x[xOffset + i * b.xStride];
+                        }
+                        continue;
+                    }
+
+                    // tile goes along dimension a (fastest in x) and dimension b (fastest in z)
+                    auto aStart = ta * tile;
+                    auto bStart = tb * tile;
+                    auto aLength = sd::math::nd4j_min<Nd4jLong>(tile, a.size - aStart);
+                    auto bLength = sd::math::nd4j_min<Nd4jLong>(tile, b.size - bStart);
+
+                    auto xTile = x + xOffset + aStart * a.xStride + bStart * b.xStride;
+                    auto zTile = z + zOffset + aStart * a.zStride + bStart * b.zStride;
+
+                    // rows of tile are contiguous in x, columns are contiguous in z
+                    if (a.xStride == 1 && b.zStride == 1 && simdTranspose(xTile, b.xStride, zTile, a.zStride, bLength, aLength, table))
+                        continue;
+
+                    for (Nd4jLong j = 0; j < bLength; j++)
+                        for (Nd4jLong i = 0; i < aLength; i++)
+                            zTile[i * a.zStride + j * b.zStride] = xTile[i * a.xStride + j * b.xStride];
+                }
+            };
+
+            const Nd4jLong units = outerLength * tilesA * tilesB;
+            const int numThreads = allowParallelism ? sd::math::nd4j_max<int>(1, sd::math::nd4j_min<int>(length / 1024, sd::Environment::getInstance().maxMasterThreads())) : 1;
+
+            if (numThreads > 1 && units > 1)
+                samediff::Threads::parallel_for(func, 0, units, 1, numThreads);
+            else
+                func(0, 0, units, 1);
+        }
+    }
+
+    bool TransposeHelper::copy(const void *x, const Nd4jLong *xShapeInfo, void *z, const Nd4jLong *zShapeInfo, bool allowParallelism) {
+        const auto dtype = ArrayOptions::dataType(xShapeInfo);
+        if (dtype != ArrayOptions::dataType(zShapeInfo) || DataTypeUtils::isS(dtype))
+            return false;
+
+        if (shape::isEmpty(xShapeInfo) || !shape::shapeEquals(xShapeInfo, zShapeInfo) || shape::length(xShapeInfo) < TILE)
+            return false;
+
+        // unit dimensions don't matter
+        TransposeDim dims[MAX_RANK];
+        int rank = 0;
+        for (int e = 0; e < shape::rank(xShapeInfo); e++) {
+            if (shape::sizeAt(xShapeInfo, e) == 1)
+                continue;
+
+            // z is always a new or a regular array, it can't have broadcasted or negative strides
+            if (shape::stride(zShapeInfo)[e] <= 0)
+                return false;
+
+            dims[rank++] = {shape::sizeAt(xShapeInfo, e), shape::stride(xShapeInfo)[e], shape::stride(zShapeInfo)[e]};
+        }
+
+        std::stable_sort(dims, dims + rank, [](const TransposeDim &l, const TransposeDim &r) -> bool {
+            return l.zStride > r.zStride;
+        });
+
+        // dimensions contiguous in both arrays are merged
+        int merged = 0;
+        for (int e = 1; e < rank; e++) {
+            auto &last = dims[merged];
+            if (last.zStride == dims[e].zStride * dims[e].size && last.xStride == dims[e].xStride * dims[e].size) {
+                last.size *= dims[e].size;
+                last.xStride = dims[e].xStride;
+                last.zStride = dims[e].zStride;
+            } else {
+                dims[++merged] = dims[e];
+            }
+        }
+        rank = rank > 0 ? merged + 1 : 0;
+
+        // linear copies are handled well by regular loops
+        if (rank < 2 || rank > MAX_MERGED_RANK)
+            return false;
+
+        switch (DataTypeUtils::sizeOfElement(dtype)) {
+            case 1:
+                copyMerged(reinterpret_cast<const uint8_t*>(x), reinterpret_cast<uint8_t*>(z), dims, rank, allowParallelism);
+                return true;
+            case 2:
+                copyMerged(reinterpret_cast<const uint16_t*>(x), reinterpret_cast<uint16_t*>(z), dims, rank, allowParallelism);
+                return true;
+            case 4:
+                copyMerged(reinterpret_cast<const uint32_t*>(x), reinterpret_cast<uint32_t*>(z), dims, rank, allowParallelism);
+                return true;
+            case 8:
+                copyMerged(reinterpret_cast<const uint64_t*>(x), reinterpret_cast<uint64_t*>(z), dims, rank, allowParallelism);
+                return true;
+            default:
+                return false;
+        }
+    }
+}
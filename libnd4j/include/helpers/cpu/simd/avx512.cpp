@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <helpers/cpu/simd/kernels.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SD_SIMD_TARGET __attribute__((target("avx512f")))
+#else
+#define SD_SIMD_TARGET
+#endif
+
+#include <helpers/cpu/simd/transpose_avx.hpp>
+
+namespace sd {
+    namespace simd {
+        namespace {
+            // bitwise ops on floating point vectors need AVX512DQ, so sign bit is flipped via integer ones
+            struct Avx512Float {
+                typedef float type;
+                typedef __m512 vec;
+                static const int width = 16;
+                static const int block = 8;
+
+                SD_SIMD_TARGET static inline vec load(const type *x) { return _mm512_loadu_ps(x); }
+                SD_SIMD_TARGET static inline void store(type *z, vec v) { _mm512_storeu_ps(z, v); }
+                SD_SIMD_TARGET static inline vec set1(type v) { return _mm512_set1_ps(v); }
+                SD_SIMD_TARGET static inline vec zero() { return _mm512_setzero_ps(); }
+                SD_SIMD_TARGET static inline vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+                SD_SIMD_TARGET static inline vec sub(vec a, vec b) { return _mm512_sub_ps(a, b); }
+                SD_SIMD_TARGET static inline vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+                SD_SIMD_TARGET static inline vec div(vec a, vec b) { return _mm512_div_ps(a, b); }
+                SD_SIMD_TARGET static inline vec max(vec a, vec b) { return _mm512_max_ps(a, b); }
+                SD_SIMD_TARGET static inline vec min(vec a, vec b) { return _mm512_min_ps(a, b); }
+                SD_SIMD_TARGET static inline vec sqrt(vec a) { return _mm512_sqrt_ps(a); }
+                SD_SIMD_TARGET static inline vec abs(vec a) { return _mm512_abs_ps(a); }
+                SD_SIMD_TARGET static inline vec neg(vec a) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_set1_epi32(static_cast<int>(0x80000000)))); }
+
+                SD_SIMD_TARGET static inline void transpose(const type *x, Nd4jLong xStride, type *z, Nd4jLong zStride) { transpose8x8(x, xStride, z, zStride); }
+            };
+
+            struct Avx512Double {
+                typedef double type;
+                typedef __m512d vec;
+                static const int width = 8;
+                static const int block = 4;
+
+                SD_SIMD_TARGET static inline vec load(const type *x) { return _mm512_loadu_pd(x); }
+                SD_SIMD_TARGET static inline void store(type *z, vec v) { _mm512_storeu_pd(z, v); }
+                SD_SIMD_TARGET static inline vec set1(type v) { return _mm512_set1_pd(v); }
+                SD_SIMD_TARGET static inline vec zero() { return _mm512_setzero_pd(); }
+                SD_SIMD_TARGET static inline vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+                SD_SIMD_TARGET static inline vec sub(vec a, vec b) { return _mm512_sub_pd(a, b); }
+                SD_SIMD_TARGET static inline vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+                SD_SIMD_TARGET static inline vec div(vec a, vec b) { return _mm512_div_pd(a, b); }
+                SD_SIMD_TARGET static inline vec max(vec a, vec b) { return _mm512_max_pd(a, b); }
+                SD_SIMD_TARGET static inline vec min(vec a, vec b) { return _mm512_min_pd(a, b); }
+                SD_SIMD_TARGET static inline vec sqrt(vec a) { return _mm512_sqrt_pd(a); }
+                SD_SIMD_TARGET static inline vec abs(vec a) { return _mm512_abs_pd(a); }
+                SD_SIMD_TARGET static inline vec neg(vec a) { return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL)))); }
+
+                SD_SIMD_TARGET static inline void transpose(const type *x, Nd4jLong xStride, type *z, Nd4jLong zStride) { transpose4x4(x, xStride, z, zStride); }
+            };
+        }
+    }
+}
+
+#include <helpers/cpu/simd/kernels.hpp>
+
+namespace sd {
+    namespace simd {
+        bool registerAvx512Kernels(KernelTable<float> &floats, KernelTable<double> &doubles) {
+            fillTable<Avx512Float>(floats);
+            fillTable<Avx512Double>(doubles);
+            return true;
+        }
+    }
+}
+
+#else
+
+namespace sd {
+    namespace simd {
+        bool registerAvx512Kernels(KernelTable<float> &floats, KernelTable<double> &doubles) {
+            return false;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_SIMD_KERNELS_H
+#define SD_SIMD_KERNELS_H
+
+#include <helpers/SimdKernels.h>
+
+namespace sd {
+    namespace simd {
+        /**
+         * Each of these functions fills kernel tables of one instruction set.
+         * They return false if instruction set can't be compiled for this platform/compiler.
+         *
+         * Kernels are compiled with function-level target attributes, so these functions can be called only after
+         * CPU support was checked.
+         */
+        bool registerSse4Kernels(KernelTable<float> &floats, KernelTable<double> &doubles);
+        bool registerAvx2Kernels(KernelTable<float> &floats, KernelTable<double> &doubles);
+        bool registerAvx512Kernels(KernelTable<float> &floats, KernelTable<double> &doubles);
+        bool registerNeonKernels(KernelTable<float> &floats, KernelTable<double> &doubles);
+    }
+}
+
+#endif //SD_SIMD_KERNELS_H
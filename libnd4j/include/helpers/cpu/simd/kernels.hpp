@@ -0,0 +1,218 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+// PLEASE NOTE: this file is included by instruction set specific translation units only.
+// Before inclusion SD_SIMD_TARGET must be defined, and vector traits must provide:
+// type, vec, width, load, store, set1, zero, add, sub, mul, div, max, min, sqrt, abs, neg
+// and block x block in-register transpose
+// max(a, b) and min(a, b) must follow nd4j_max/nd4j_min semantics: a > b ? a : b and a < b ? a : b
+// Everything here lives in anonymous namespace, so every translation unit gets its own copy built for its target
+
+#include <helpers/cpu/simd/kernels.h>
+#include <cmath>
+
+namespace sd {
+    namespace simd {
+        namespace {
+            template <typename V> struct AddKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::add(a, b); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return a + b; }
+            };
+
+            template <typename V> struct SubtractKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::sub(a, b); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return a - b; }
+            };
+
+            template <typename V> struct MultiplyKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::mul(a, b); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return a * b; }
+            };
+
+            template <typename V> struct DivideKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::div(a, b); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return a / b; }
+            };
+
+            template <typename V> struct ReverseSubtractKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::sub(b, a); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return b - a; }
+            };
+
+            template <typename V> struct ReverseDivideKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::div(b, a); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return b / a; }
+            };
+
+            template <typename V> struct MaxKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::max(a, b); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return a > b ? a : b; }
+            };
+
+            template <typename V> struct MinKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::min(a, b); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return a < b ? a : b; }
+            };
+
+            // RELU returns x unless threshold is greater, so NaNs in x are kept
+            template <typename V> struct ReluKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a, typename V::vec b) { return V::max(b, a); }
+                static inline typename V::type sop(typename V::type a, typename V::type b) { return a < b ? b : a; }
+            };
+
+            template <typename V> struct IdentityKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a) { return a; }
+                static inline typename V::type sop(typename V::type a) { return a; }
+            };
+
+            template <typename V> struct AbsKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a) { return V::abs(a); }
+                static inline typename V::type sop(typename V::type a) { return std::fabs(a); }
+            };
+
+            template <typename V> struct NegKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a) { return V::neg(a); }
+                static inline typename V::type sop(typename V::type a) { return -a; }
+            };
+
+            template <typename V> struct SquareKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a) { return V::mul(a, a); }
+                static inline typename V::type sop(typename V::type a) { return a * a; }
+            };
+
+            template <typename V> struct SqrtKernel {
+                SD_SIMD_TARGET static inline typename V::vec vop(typename V::vec a) { return V::sqrt(a); }
+                static inline typename V::type sop(typename V::type a) { return std::sqrt(a); }
+            };
+
+            template <typename V, template <typename> class K>
+            SD_SIMD_TARGET void pairwiseKernel(const typename V::type *x, const typename V::type *y, typename V::type *z, Nd4jLong length) {
+                Nd4jLong e = 0;
+                for (; e + V::width <= length; e += V::width)
+                    V::store(z + e, K<V>::vop(V::load(x + e), V::load(y + e)));
+
+                for (; e < length; e++)
+                    z[e] = K<V>::sop(x[e], y[e]);
+            }
+
+            template <typename V, template <typename> class K>
+            SD_SIMD_TARGET void scalarKernel(const typename V::type *x, typename V::type y, typename V::type *z, Nd4jLong length) {
+                const auto scalar = V::set1(y);
+
+                Nd4jLong e = 0;
+                for (; e + V::width <= length; e += V::width)
+                    V::store(z + e, K<V>::vop(V::load(x + e), scalar));
+
+                for (; e < length; e++)
+                    z[e] = K<V>::sop(x[e], y);
+            }
+
+            template <typename V, template <typename> class K>
+            SD_SIMD_TARGET void transformKernel(const typename V::type *x, typename V::type *z, Nd4jLong length) {
+                Nd4jLong e = 0;
+                for (; e + V::width <= length; e += V::width)
+                    V::store(z + e, K<V>::vop(V::load(x + e)));
+
+                for (; e < length; e++)
+                    z[e] = K<V>::sop(x[e]);
+            }
+
+            // two accumulators hide latency of vector add
+            template <typename V, template <typename> class K>
+            SD_SIMD_TARGET typename V::type reduceKernel(const typename V::type *x, Nd4jLong length) {
+                auto acc0 = V::zero();
+                auto acc1 = V::zero();
+
+                Nd4jLong e = 0;
+                for (; e + 2 * V::width <= length; e += 2 * V::width) {
+                    acc0 = V::add(acc0, K<V>::vop(V::load(x + e)));
+                    acc1 = V::add(acc1, K<V>::vop(V::load(x + e + V::width)));
+                }
+
+                for (; e + V::width <= length; e += V::width)
+                    acc0 = V::add(acc0, K<V>::vop(V::load(x + e)));
+
+                typename V::type lanes[V::width];
+                V::store(lanes, V::add(acc0, acc1));
+
+                typename V::type sum = 0;
+                for (int l = 0; l < V::width; l++)
+                    sum += lanes[l];
+
+                for (; e < length; e++)
+                    sum += K<V>::sop(x[e]);
+
+                return sum;
+            }
+
+            // full blocks are transposed in registers, ragged edges element by element
+            template <typename V>
+            SD_SIMD_TARGET void transposeKernel(const typename V::type *x, Nd4jLong xStride, typename V::type *z, Nd4jLong zStride, Nd4jLong rows, Nd4jLong cols) {
+                Nd4jLong r = 0;
+                for (; r + V::block <= rows; r += V::block) {
+                    Nd4jLong c = 0;
+                    for (; c + V::block <= cols; c += V::block)
+                        V::transpose(x + r * xStride + c, xStride, z + c * zStride + r, zStride);
+
+                    for (; c < cols; c++)
+                        for (Nd4jLong i = r; i < r + V::block; i++)
+                            z[c * zStride + i] = x[i * xStride + c];
+                }
+
+                for (; r < rows; r++)
+                    for (Nd4jLong c = 0; c < cols; c++)
+                        z[c * zStride + r] = x[r * xStride + c];
+            }
+
+            template <typename V>
+            void fillTable(KernelTable<typename V::type> &table) {
+                table.pairwise[BINARY_ADD] = pairwiseKernel<V, AddKernel>;
+                table.pairwise[BINARY_SUBTRACT] = pairwiseKernel<V, SubtractKernel>;
+                table.pairwise[BINARY_MULTIPLY] = pairwiseKernel<V, MultiplyKernel>;
+                table.pairwise[BINARY_DIVIDE] = pairwiseKernel<V, DivideKernel>;
+                table.pairwise[BINARY_REVERSE_SUBTRACT] = pairwiseKernel<V, ReverseSubtractKernel>;
+                table.pairwise[BINARY_REVERSE_DIVIDE] = pairwiseKernel<V, ReverseDivideKernel>;
+                table.pairwise[BINARY_MAX] = pairwiseKernel<V, MaxKernel>;
+                table.pairwise[BINARY_MIN] = pairwiseKernel<V, MinKernel>;
+                table.pairwise[BINARY_RELU] = pairwiseKernel<V, ReluKernel>;
+
+                table.scalar[BINARY_ADD] = scalarKernel<V, AddKernel>;
+                table.scalar[BINARY_SUBTRACT] = scalarKernel<V, SubtractKernel>;
+                table.scalar[BINARY_MULTIPLY] = scalarKernel<V, MultiplyKernel>;
+                table.scalar[BINARY_DIVIDE] = scalarKernel<V, DivideKernel>;
+                table.scalar[BINARY_REVERSE_SUBTRACT] = scalarKernel<V, ReverseSubtractKernel>;
+                table.scalar[BINARY_REVERSE_DIVIDE] = scalarKernel<V, ReverseDivideKernel>;
+                table.scalar[BINARY_MAX] = scalarKernel<V, MaxKernel>;
+                table.scalar[BINARY_MIN] = scalarKernel<V, MinKernel>;
+                table.scalar[BINARY_RELU] = scalarKernel<V, ReluKernel>;
+
+                table.transform[UNARY_ABS] = transformKernel<V, AbsKernel>;
+                table.transform[UNARY_NEG] = transformKernel<V, NegKernel>;
+                table.transform[UNARY_SQUARE] = transformKernel<V, SquareKernel>;
+                table.transform[UNARY_SQRT] = transformKernel<V, SqrtKernel>;
+
+                table.reduce[REDUCE_SUM] = reduceKernel<V, IdentityKernel>;
+                table.reduce[REDUCE_SUM_SQUARES] = reduceKernel<V, SquareKernel>;
+
+                table.transpose = transposeKernel<V>;
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <helpers/cpu/simd/kernels.h>
+
+// 32-bit ARM lacks vector division and double precision vectors, so it keeps compiler-generated loops
+#if defined(__aarch64__) && defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+// NEON is mandatory on AArch64, no target attributes needed
+#define SD_SIMD_TARGET
+
+namespace sd {
+    namespace simd {
+        namespace {
+            // vmaxq/vminq propagate NaNs, so max/min are built from comparisons to follow nd4j_max/nd4j_min
+            struct NeonFloat {
+                typedef float type;
+                typedef float32x4_t vec;
+                static const int width = 4;
+                static const int block = 4;
+
+                static inline vec load(const type *x) { return vld1q_f32(x); }
+                static inline void store(type *z, vec v) { vst1q_f32(z, v); }
+                static inline vec set1(type v) { return vdupq_n_f32(v); }
+                static inline vec zero() { return vdupq_n_f32(0.0f); }
+                static inline vec add(vec a, vec b) { return vaddq_f32(a, b); }
+                static inline vec sub(vec a, vec b) { return vsubq_f32(a, b); }
+                static inline vec mul(vec a, vec b) { return vmulq_f32(a, b); }
+                static inline vec div(vec a, vec b) { return vdivq_f32(a, b); }
+                static inline vec max(vec a, vec b) { return vbslq_f32(vcgtq_f32(a, b), a, b); }
+                static inline vec min(vec a, vec b) { return vbslq_f32(vcltq_f32(a, b), a, b); }
+                static inline vec sqrt(vec a) { return vsqrtq_f32(a); }
+                static inline vec abs(vec a) { return vabsq_f32(a); }
+                static inline vec neg(vec a) { return vnegq_f32(a); }
+
+                static inline void transpose(const type *x, Nd4jLong xStride, type *z, Nd4jLong zStride) {
+                    auto r0 = vld1q_f32(x);
+                    auto r1 = vld1q_f32(x + xStride);
+                    auto r2 = vld1q_f32(x + 2 * xStride);
+                    auto r3 = vld1q_f32(x + 3 * xStride);
+
+                    auto t0 = vreinterpretq_f64_f32(vtrn1q_f32(r0, r1));
+                    auto t1 = vreinterpretq_f64_f32(vtrn2q_f32(r0, r1));
+                    auto t2 = vreinterpretq_f64_f32(vtrn1q_f32(r2, r3));
+                    auto t3 = vreinterpretq_f64_f32(vtrn2q_f32(r2, r3));
+
+                    vst1q_f32(z, vreinterpretq_f32_f64(vtrn1q_f64(t0, t2)));
+                    vst1q_f32(z + zStride, vreinterpretq_f32_f64(vtrn1q_f64(t1, t3)));
+                    vst1q_f32(z + 2 * zStride, vreinterpretq_f32_f64(vtrn2q_f64(t0, t2)));
+                    vst1q_f32(z + 3 * zStride, vreinterpretq_f32_f64(vtrn2q_f64(t1, t3)));
+                }
+            };
+
+            struct NeonDouble {
+                typedef double type;
+                typedef float64x2_t vec;
+                static const int width = 2;
+                static const int block = 2;
+
+                static inline vec load(const type *x) { return vld1q_f64(x); }
+                static inline void store(type *z, vec v) { vst1q_f64(z, v); }
+                static inline vec set1(type v) { return vdupq_n_f64(v); }
+                static inline vec zero() { return vdupq_n_f64(0.0); }
+                static inline vec add(vec a, vec b) { return vaddq_f64(a, b); }
+                static inline vec sub(vec a, vec b) { return vsubq_f64(a, b); }
+                static inline vec mul(vec a, vec b) { return vmulq_f64(a, b); }
+                static inline vec div(vec a, vec b) { return vdivq_f64(a, b); }
+                static inline vec max(vec a, vec b) { return vbslq_f64(vcgtq_f64(a, b), a, b); }
+                static inline vec min(vec a, vec b) { return vbslq_f64(vcltq_f64(a, b), a, b); }
+                static inline vec sqrt(vec a) { return vsqrtq_f64(a); }
+                static inline vec abs(vec a) { return vabsq_f64(a); }
+                static inline vec neg(vec a) { return vnegq_f64(a); }
+
+                static inline void transpose(const type *x, Nd4jLong xStride, type *z, Nd4jLong zStride) {
+                    auto r0 = vld1q_f64(x);
+                    auto r1 = vld1q_f64(x + xStride);
+                    vst1q_f64(z, vzip1q_f64(r0, r1));
+                    vst1q_f64(z + zStride, vzip2q_f64(r0, r1));
+                }
+            };
+        }
+    }
+}
+
+#include <helpers/cpu/simd/kernels.hpp>
+
+namespace sd {
+    namespace simd {
+        bool registerNeonKernels(KernelTable<float> &floats, KernelTable<double> &doubles) {
+            fillTable<NeonFloat>(floats);
+            fillTable<NeonDouble>(doubles);
+            return true;
+        }
+    }
+}
+
+#else
+
+namespace sd {
+    namespace simd {
+        bool registerNeonKernels(KernelTable<float> &floats, KernelTable<double> &doubles) {
+            return false;
+        }
+    }
+}
+
+#endif
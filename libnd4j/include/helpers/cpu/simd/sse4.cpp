@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <helpers/cpu/simd/kernels.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SD_SIMD_TARGET __attribute__((target("sse4.1")))
+#else
+#define SD_SIMD_TARGET
+#endif
+
+namespace sd {
+    namespace simd {
+        namespace {
+            // max/min instructions return second operand if comparison is false, exactly as nd4j_max/nd4j_min do
+            struct Sse4Float {
+                typedef float type;
+                typedef __m128 vec;
+                static const int width = 4;
+                static const int block = 4;
+
+                SD_SIMD_TARGET static inline vec load(const type *x) { return _mm_loadu_ps(x); }
+                SD_SIMD_TARGET static inline void store(type *z, vec v) { _mm_storeu_ps(z, v); }
+                SD_SIMD_TARGET static inline vec set1(type v) { return _mm_set1_ps(v); }
+                SD_SIMD_TARGET static inline vec zero() { return _mm_setzero_ps(); }
+                SD_SIMD_TARGET static inline vec add(vec a, vec b) { return _mm_add_ps(a, b); }
+                SD_SIMD_TARGET static inline vec sub(vec a, vec b) { return _mm_sub_ps(a, b); }
+                SD_SIMD_TARGET static inline vec mul(vec a, vec b) { return _mm_mul_ps(a, b); }
+                SD_SIMD_TARGET static inline vec div(vec a, vec b) { return _mm_div_ps(a, b); }
+                SD_SIMD_TARGET static inline vec max(vec a, vec b) { return _mm_max_ps(a, b); }
+                SD_SIMD_TARGET static inline vec min(vec a, vec b) { return _mm_min_ps(a, b); }
+                SD_SIMD_TARGET static inline vec sqrt(vec a) { return _mm_sqrt_ps(a); }
+                SD_SIMD_TARGET static inline vec abs(vec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+                SD_SIMD_TARGET static inline vec neg(vec a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+
+                SD_SIMD_TARGET static inline void transpose(const type *x, Nd4jLong xStride, type *z, Nd4jLong zStride) {
+                    auto r0 = _mm_loadu_ps(x);
+                    auto r1 = _mm_loadu_ps(x + xStride);
+                    auto r2 = _mm_loadu_ps(x + 2 * xStride);
+                    auto r3 = _mm_loadu_ps(x + 3 * xStride);
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                    _mm_storeu_ps(z, r0);
+                    _mm_storeu_ps(z + zStride, r1);
+                    _mm_storeu_ps(z + 2 * zStride, r2);
+                    _mm_storeu_ps(z + 3 * zStride, r3);
+                }
+            };
+
+            struct Sse4Double {
+                typedef double type;
+                typedef __m128d vec;
+                static const int width = 2;
+                static const int block = 2;
+
+                SD_SIMD_TARGET static inline vec load(const type *x) { return _mm_loadu_pd(x); }
+                SD_SIMD_TARGET static inline void store(type *z, vec v) { _mm_storeu_pd(z, v); }
+                SD_SIMD_TARGET static inline vec set1(type v) { return _mm_set1_pd(v); }
+                SD_SIMD_TARGET static inline vec zero() { return _mm_setzero_pd(); }
+                SD_SIMD_TARGET static inline vec add(vec a, vec b) { return _mm_add_pd(a, b); }
+                SD_SIMD_TARGET static inline vec sub(vec a, vec b) { return _mm_sub_pd(a, b); }
+                SD_SIMD_TARGET static inline vec mul(vec a, vec b) { return _mm_mul_pd(a, b); }
+                SD_SIMD_TARGET static inline vec div(vec a, vec b) { return _mm_div_pd(a, b); }
+                SD_SIMD_TARGET static inline vec max(vec a, vec b) { return _mm_max_pd(a, b); }
+                SD_SIMD_TARGET static inline vec min(vec a, vec b) { return _mm_min_pd(a, b); }
+                SD_SIMD_TARGET static inline vec sqrt(vec a) { return _mm_sqrt_pd(a); }
+                SD_SIMD_TARGET static inline vec abs(vec a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+                SD_SIMD_TARGET static inline vec neg(vec a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+
+                SD_SIMD_TARGET static inline void transpose(const type *x, Nd4jLong xStride, type *z, Nd4jLong zStride) {
+                    auto r0 = _mm_loadu_pd(x);
+                    auto r1 = _mm_loadu_pd(x + xStride);
+                    _mm_storeu_pd(z, _mm_unpacklo_pd(r0, r1));
+                    _mm_storeu_pd(z + zStride, _mm_unpackhi_pd(r0, r1));
+                }
+            };
+        }
+    }
+}
+
+#include <helpers/cpu/simd/kernels.hpp>
+
+namespace sd {
+    namespace simd {
+        bool registerSse4Kernels(KernelTable<float> &floats, KernelTable<double> &doubles) {
+            fillTable<Sse4Float>(floats);
+            fillTable<Sse4Double>(doubles);
+            return true;
+        }
+    }
+}
+
+#else
+
+namespace sd {
+    namespace simd {
+        bool registerSse4Kernels(KernelTable<float> &floats, KernelTable<double> &doubles) {
+            return false;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+// PLEASE NOTE: this file is included by AVX2 and AVX-512 translation units after SD_SIMD_TARGET was defined.
+// AVX-512 ones use the same 256-bit transposes: 16x16 blocks need 64 registers worth of shuffles and don't pay off
+
+namespace sd {
+    namespace simd {
+        namespace {
+            // 8x8 block of rows with stride xStride goes to 8x8 block of rows with stride zStride, transposed
+            SD_SIMD_TARGET static inline void transpose8x8(const float *x, Nd4jLong xStride, float *z, Nd4jLong zStride) {
+                auto r0 = _mm256_loadu_ps(x);
+                auto r1 = _mm256_loadu_ps(x + xStride);
+                auto r2 = _mm256_loadu_ps(x + 2 * xStride);
+                auto r3 = _mm256_loadu_ps(x + 3 * xStride);
+                auto r4 = _mm256_loadu_ps(x + 4 * xStride);
+                auto r5 = _mm256_loadu_ps(x + 5 * xStride);
+                auto r6 = _mm256_loadu_ps(x + 6 * xStride);
+                auto r7 = _mm256_loadu_ps(x + 7 * xStride);
+
+                auto t0 = _mm256_unpacklo_ps(r0, r1);
+                auto t1 = _mm256_unpackhi_ps(r0, r1);
+                auto t2 = _mm256_unpacklo_ps(r2, r3);
+                auto t3 = _mm256_unpackhi_ps(r2, r3);
+                auto t4 = _mm256_unpacklo_ps(r4, r5);
+                auto t5 = _mm256_unpackhi_ps(r4, r5);
+                auto t6 = _mm256_unpacklo_ps(r6, r7);
+                auto t7 = _mm256_unpackhi_ps(r6, r7);
+
+                auto s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+                auto s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+                auto s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+                auto s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+                auto s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+                auto s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+                auto s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+                auto s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+                _mm256_storeu_ps(z, _mm256_permute2f128_ps(s0, s4, 0x20));
+                _mm256_storeu_ps(z + zStride, _mm256_permute2f128_ps(s1, s5, 0x20));
+                _mm256_storeu_ps(z + 2 * zStride, _mm256_permute2f128_ps(s2, s6, 0x20));
+                _mm256_storeu_ps(z + 3 * zStride, _mm256_permute2f128_ps(s3, s7, 0x20));
+                _mm256_storeu_ps(z + 4 * zStride, _mm256_permute2f128_ps(s0, s4, 0x31));
+                _mm256_storeu_ps(z + 5 * zStride, _mm256_permute2f128_ps(s1, s5, 0x31));
+                _mm256_storeu_ps(z + 6 * zStride, _mm256_permute2f128_ps(s2, s6, 0x31));
+                _mm256_storeu_ps(z + 7 * zStride, _mm256_permute2f128_ps(s3, s7, 0x31));
+            }
+
+            SD_SIMD_TARGET static inline void transpose4x4(const double *x, Nd4jLong xStride, double *z, Nd4jLong zStride) {
+                auto r0 = _mm256_loadu_pd(x);
+                auto r1 = _mm256_loadu_pd(x + xStride);
+                auto r2 = _mm256_loadu_pd(x + 2 * xStride);
+                auto r3 = _mm256_loadu_pd(x + 3 * xStride);
+
+                auto t0 = _mm256_unpacklo_pd(r0, r1);
+                auto t1 = _mm256_unpackhi_pd(r0, r1);
+                auto t2 = _mm256_unpacklo_pd(r2, r3);
+                auto t3 = _mm256_unpackhi_pd(r2, r3);
+
+                _mm256_storeu_pd(z, _mm256_permute2f128_pd(t0, t2, 0x20));
+                _mm256_storeu_pd(z + zStride, _mm256_permute2f128_pd(t1, t3, 0x20));
+                _mm256_storeu_pd(z + 2 * zStride, _mm256_permute2f128_pd(t0, t2, 0x31));
+                _mm256_storeu_pd(z + 3 * zStride, _mm256_permute2f128_pd(t1, t3, 0x31));
+            }
+        }
+    }
+}
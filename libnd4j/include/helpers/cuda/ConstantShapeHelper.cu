@@ -84,6 +84,24 @@ ConstantShapeBuffer&  ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *sh
         return _cache[deviceId].count(descriptor) != 0;
     }
 
+    int ConstantShapeHelper::cachedEntriesForDevice(int deviceId) {
+        if (deviceId > _cache.size())
+            throw std::runtime_error("deviceId > number of actual devices");
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache[deviceId].size();
+    }
+
+    int ConstantShapeHelper::totalCachedEntries() {
+        int total = 0;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (int e = 0; e < _cache.size(); e++)
+            total += _cache[e].size();
+
+        return total;
+    }
+
     Nd4jLong const* ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const char order, const int rank, const Nd4jLong* shape) {
         ShapeDescriptor descriptor(dataType, order, shape, rank);
         return bufferForShapeInfo(descriptor).primary();
@@ -110,4 +110,22 @@ namespace sd {
             return r;
         }
     }
+
+    int ConstantTadHelper::cachedEntriesForDevice(int deviceId) {
+        if (deviceId > _cache.size())
+            throw std::runtime_error("deviceId > number of actual devices");
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache[deviceId].size();
+    }
+
+    int ConstantTadHelper::totalCachedEntries() {
+        int total = 0;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (int e = 0; e < _cache.size(); e++)
+            total += _cache[e].size();
+
+        return total;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <helpers/KnnIndex.h>
+#include <helpers/VPTree.h>
+#include <system/op_boilerplate.h>
+#include <stdexcept>
+
+namespace sd {
+    template <typename T>
+    static KnnIndex* buildVPTree(const void *data, Nd4jLong numPoints, int dims, KnnDistance distance) {
+        return new VPTree<T>(reinterpret_cast<const T*>(data), numPoints, dims, distance);
+    }
+
+    KnnIndex* KnnIndex::build(const void *data, sd::DataType dataType, Nd4jLong numPoints, int dims, KnnDistance distance) {
+        if (numPoints < 1 || dims < 1)
+            throw std::invalid_argument("KnnIndex: there must be at least one point with at least one dimension");
+
+        if (distance != KNN_EUCLIDEAN && distance != KNN_COSINE && distance != KNN_MANHATTAN)
+            throw std::invalid_argument("KnnIndex: unknown distance");
+
+        if (!DataTypeUtils::isR(dataType))
+            throw std::invalid_argument("KnnIndex: only floating point data types are supported");
+
+        BUILD_SINGLE_SELECTOR(dataType, return buildVPTree, (data, numPoints, dims, distance), FLOAT_TYPES);
+    }
+}
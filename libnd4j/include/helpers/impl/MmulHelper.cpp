@@ -279,20 +279,27 @@ sd::NDArray* MmulHelper::mmul(const sd::NDArray* A, const sd::NDArray* B, sd::ND
             mmul(xT, yT, zT, alpha, beta);
         }
         else {  // rest cases -  batched mmul
-
-            const int batchRank = xRank - 2;
-            std::vector<int> dimsToExclude(batchRank);
-            for(int i = 0; i < batchRank; ++i)
-                dimsToExclude[i] = i;
-
-            const Nd4jLong numOfSubArrs = ShapeUtils::getNumOfSubArrs(xT->shapeInfo(), dimsToExclude);
-
-//PRAGMA_OMP_PARALLEL_FOR
-            for(Nd4jLong i = 0; i < numOfSubArrs; ++i) {
-                auto xSubArr = (*xT)(i, dimsToExclude);
-                auto ySubArr = (*yT)(i, dimsToExclude);
-                auto zSubArr = (*zT)(i, dimsToExclude);
-                mmul(&xSubArr, &ySubArr, &zSubArr, alpha, beta);
+#ifndef __CUDABLAS__
+            // whole batch at once, small matrices are multiplied by batched gemm
+            if (xT->dataType() == yT->dataType() && xT->dataType() == zT->dataType()) {
+                mmulNxN(xT, yT, zT, alpha, beta);
+            }
+            else
+#endif
+            {
+                const int batchRank = xRank - 2;
+                std::vector<int> dimsToExclude(batchRank);
+                for(int i = 0; i < batchRank; ++i)
+                    dimsToExclude[i] = i;
+
+                const Nd4jLong numOfSubArrs = ShapeUtils::getNumOfSubArrs(xT->shapeInfo(), dimsToExclude);
+
+                for(Nd4jLong i = 0; i < numOfSubArrs; ++i) {
+                    auto xSubArr = (*xT)(i, dimsToExclude);
+                    auto ySubArr = (*yT)(i, dimsToExclude);
+                    auto zSubArr = (*zT)(i, dimsToExclude);
+                    mmul(&xSubArr, &ySubArr, &zSubArr, alpha, beta);
+                }
             }
         }
 
@@ -77,6 +77,7 @@ bool verbose = false;
 #include <graph/ResultWrapper.h>
 #include <helpers/DebugInfo.h>
 #include <memory/MemoryCounter.h>
+#include <helpers/KnnIndex.h>
 
 typedef sd::InteropDataBuffer OpaqueDataBuffer;
 
@@ -1679,6 +1680,21 @@ ND4J_EXPORT void deleteDataBuffer(OpaqueDataBuffer *dataBuffer);
 ND4J_EXPORT void dbExpand(OpaqueDataBuffer *dataBuffer, Nd4jLong elements);
 
 
+typedef sd::KnnIndex OpaqueKnnIndex;
+
+/**
+ * These methods build nearest neighbours index (VP-tree) over rows of c-ordered host matrix, and run batched queries against it.
+ * Index keeps its own copy of data. Distance is 0 for euclidean, 1 for cosine, 2 for manhattan.
+ * Queries must be c-ordered host matrices of the same type and width as data.
+ * Results are [numQueries, k] matrices sorted by distance, missing results get -1 indices and infinite distances
+ */
+ND4J_EXPORT OpaqueKnnIndex* createKnnIndex(void *hX, Nd4jLong const* hXShapeInfo, int distance);
+ND4J_EXPORT void knnSearch(OpaqueKnnIndex* index, void *hQ, Nd4jLong const* hQShapeInfo, int k, Nd4jLong *hIndices, void *hDistances);
+ND4J_EXPORT void knnRadiusSearch(OpaqueKnnIndex* index, void *hQ, Nd4jLong const* hQShapeInfo, double radius, int maxResults, Nd4jLong *hIndices, void *hDistances, Nd4jLong *hCounts);
+ND4J_EXPORT Nd4jLong knnIndexSize(OpaqueKnnIndex* index);
+ND4J_EXPORT void deleteKnnIndex(OpaqueKnnIndex* index);
+
+
 ND4J_EXPORT int  binaryLevel();
 ND4J_EXPORT int optimalLevel();
 
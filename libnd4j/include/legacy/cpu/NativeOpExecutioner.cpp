@@ -54,6 +54,7 @@
 #include <exceptions/datatype_exception.h>
 #include <array/TadPack.h>
 #include <helpers/ConstantTadHelper.h>
+#include <helpers/TransposeHelper.h>
 
 
 #ifdef _OPENMP
@@ -1275,6 +1276,9 @@ void NativeOpExecutioner::execTransformAny(sd::LaunchContext  *lc,
 
         memcpy(hZ, hX, shape::length(hXShapeInfo) * sd::DataTypeUtils::sizeOfElement(xType));
     }
+    else if (opNum == sd::transform::Assign && xType == zType && sd::TransposeHelper::copy(hX, hXShapeInfo, hZ, hZShapeInfo, allowParallelism)) {
+        // permuted views are materialized by tiled copy
+    }
     else {
         auto func = PRAGMA_THREADS_DO {
 
@@ -2389,181 +2389,186 @@ void deleteResultWrapper(Nd4jPointer ptr) {
  *     void convertTypes(Nd4jPointer *extras, int srcType, Nd4jPointer hX, long N, int dstType, Nd4jPointer hZ);
  */
 void convertTypes(Nd4jPointer *extras, int srcType, Nd4jPointer hX, Nd4jLong N, int dstType, Nd4jPointer hZ) {
-    auto hx = reinterpret_cast<void *>(hX);
-    auto hz = reinterpret_cast<void *>(hZ);
-
-    if (srcType == ND4J_FLOAT8) {
-        if (dstType == ND4J_FLOAT8) {
-            // convertGeneric<double, sd::float8>(hx, N, hz);
-        } else if (dstType == ND4J_INT8) {
-            //sd::TypeCast::convertGeneric<sd::float8, sd::int8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT8) {
-            //sd::TypeCast::convertGeneric<sd::float8, sd::uint8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT16) {
-            //sd::TypeCast::convertGeneric<sd::float8, float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT16) {
-            //sd::TypeCast::convertGeneric<sd::float8, sd::int16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT16) {
-            //sd::TypeCast::convertGeneric<sd::float8, sd::uint16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT24) {
-
-        } else if (dstType == ND4J_FLOAT32) {
-            //sd::TypeCast::convertGeneric<sd::float8, float>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_DOUBLE) {
-            //sd::TypeCast::convertGeneric<sd::float8, double>(nullptr, hx, N, hz);
-        } else {
-            //nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
-        }
-    } else if (srcType == ND4J_INT8) {
-        if (dstType == ND4J_FLOAT8) {
-            //sd::TypeCast::convertGeneric<sd::int8, sd::float8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT8) {
-            //convertGeneric<sd::int8, sd::int8>(hx, N, hz);
-        } else if (dstType == ND4J_UINT8) {
-            sd::TypeCast::convertGeneric<int8_t, uint8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT16) {
-            sd::TypeCast::convertGeneric<int8_t, float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT16) {
-            sd::TypeCast::convertGeneric<int8_t, int16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT16) {
-            //sd::TypeCast::convertGeneric<int8_t, uint16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT24) {
-            // TODO: eventually we might want to add it
-        } else if (dstType == ND4J_FLOAT32) {
-            sd::TypeCast::convertGeneric<int8_t, float>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_DOUBLE) {
-            sd::TypeCast::convertGeneric<int8_t, double>(nullptr, hx, N, hz);
-        } else {
-            nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
-        }
-    } else if (srcType == ND4J_UINT8) {
-        if (dstType == ND4J_FLOAT8) {
-        //    sd::TypeCast::convertGeneric<uint8_t, sd::float8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT8) {
-            sd::TypeCast::convertGeneric<uint8_t, int8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT8) {
-            sd::TypeCast::convertGeneric<uint8_t, uint8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT16) {
-            sd::TypeCast::convertGeneric<uint8_t, float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT16) {
-            sd::TypeCast::convertGeneric<uint8_t, int16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT16) {
-     //       sd::TypeCast::convertGeneric<uint8_t, uint16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT24) {
-            // TODO: still might want to add
-        } else if (dstType == ND4J_FLOAT32) {
-            sd::TypeCast::convertGeneric<uint8_t, float>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_DOUBLE) {
-            sd::TypeCast::convertGeneric<uint8_t, double>(nullptr, hx, N, hz);
-        } else {
-            nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
-        }
-    } else if (srcType == ND4J_FLOAT16) {
-        if (dstType == ND4J_FLOAT8) {
-        //    sd::TypeCast::convertGeneric<float16, sd::float8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT8) {
-            sd::TypeCast::convertGeneric<float16, int8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT8) {
-            sd::TypeCast::convertGeneric<float16, uint8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT16) {
-            sd::TypeCast::convertGeneric<float16, float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT16) {
-            sd::TypeCast::convertGeneric<float16, int16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT16) {
-//            sd::TypeCast::convertGeneric<float16, uint16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT24) {
-            // TODO: .... ^^^
-        } else if (dstType == ND4J_FLOAT32) {
-            sd::TypeCast::convertGeneric<float16, float>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_DOUBLE) {
-            sd::TypeCast::convertGeneric<float16, double>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_THRESHOLD) {
-            sd::TypeCast::convertToThreshold<float16>(nullptr, hx, N, hz);
-        } else {
-            nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
-        }
-    } else if (srcType == ND4J_INT16) {
-        if (dstType == ND4J_FLOAT8) {
-         //   sd::TypeCast::convertGeneric<int16_t, sd::float8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT8) {
-            sd::TypeCast::convertGeneric<int16_t, int8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT8) {
-            sd::TypeCast::convertGeneric<int16_t, uint8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT16) {
-            sd::TypeCast::convertGeneric<int16_t, float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT16) {
-            //sd::TypeCast::convertGeneric<int16_t, int16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT16) {
-//            sd::TypeCast::convertGeneric<int16_t, uint16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT24) {
-            // TODO...
-        } else if (dstType == ND4J_FLOAT32) {
-            sd::TypeCast::convertGeneric<int16_t, float>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_DOUBLE) {
-            sd::TypeCast::convertGeneric<int16_t, double>(nullptr, hx, N, hz);
-        } else {
-            printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
-        }
-    } else if (srcType == ND4J_FLOAT24) {
-
-    } else if (srcType == ND4J_FLOAT32) {
-        if (dstType == ND4J_FLOAT8) {
-        //    sd::TypeCast::convertGeneric<float, sd::float8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT8) {
-            sd::TypeCast::convertGeneric<float, int8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT8) {
-            sd::TypeCast::convertGeneric<float, uint8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT16) {
-            sd::TypeCast::convertGeneric<float, float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT16) {
-            sd::TypeCast::convertGeneric<float, int16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT16) {
-//            sd::TypeCast::convertGeneric<float, uint16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT24) {
-
-        } else if (dstType == ND4J_DOUBLE) {
-            sd::TypeCast::convertGeneric<float, double>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_THRESHOLD) {
-            sd::TypeCast::convertToThreshold<float>(nullptr, hx, N, hz);
-        } else {
-            nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
-        }
-    } else if (srcType == ND4J_DOUBLE) {
-        if (dstType == ND4J_FLOAT8) {
-         //   sd::TypeCast::convertGeneric<double, sd::float8>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT8) {
-            sd::TypeCast::convertGeneric<double, int8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT8) {
-            sd::TypeCast::convertGeneric<double, uint8_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT16) {
-            sd::TypeCast::convertGeneric<double, float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_INT16) {
-            sd::TypeCast::convertGeneric<double, int16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_UINT16) {
-//            sd::TypeCast::convertGeneric<double, uint16_t>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT24) {
-
-        } else if (dstType == ND4J_FLOAT32) {
-            sd::TypeCast::convertGeneric<double, float>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_DOUBLE) {
-            //
-        } else if (dstType == ND4J_THRESHOLD) {
-            sd::TypeCast::convertToThreshold<double>(nullptr, hx, N, hz);
-        } else {
-            nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
-        }
-    } else if (srcType == ND4J_THRESHOLD) {
-        if (dstType == ND4J_FLOAT16) {
-            sd::TypeCast::convertFromThreshold<float16>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_FLOAT32) {
-            sd::TypeCast::convertFromThreshold<float>(nullptr, hx, N, hz);
-        } else if (dstType == ND4J_DOUBLE) {
-            sd::TypeCast::convertFromThreshold<double>(nullptr, hx, N, hz);
+    try {
+        auto hx = reinterpret_cast<void *>(hX);
+        auto hz = reinterpret_cast<void *>(hZ);
+
+        if (srcType == ND4J_FLOAT8) {
+            if (dstType == ND4J_FLOAT8) {
+                // convertGeneric<double, sd::float8>(hx, N, hz);
+            } else if (dstType == ND4J_INT8) {
+                //sd::TypeCast::convertGeneric<sd::float8, sd::int8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT8) {
+                //sd::TypeCast::convertGeneric<sd::float8, sd::uint8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT16) {
+                //sd::TypeCast::convertGeneric<sd::float8, float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT16) {
+                //sd::TypeCast::convertGeneric<sd::float8, sd::int16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT16) {
+                //sd::TypeCast::convertGeneric<sd::float8, sd::uint16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT24) {
+
+            } else if (dstType == ND4J_FLOAT32) {
+                //sd::TypeCast::convertGeneric<sd::float8, float>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_DOUBLE) {
+                //sd::TypeCast::convertGeneric<sd::float8, double>(nullptr, hx, N, hz);
+            } else {
+                //nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
+        } else if (srcType == ND4J_INT8) {
+            if (dstType == ND4J_FLOAT8) {
+                //sd::TypeCast::convertGeneric<sd::int8, sd::float8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT8) {
+                //convertGeneric<sd::int8, sd::int8>(hx, N, hz);
+            } else if (dstType == ND4J_UINT8) {
+                sd::TypeCast::convertGeneric<int8_t, uint8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT16) {
+                sd::TypeCast::convertGeneric<int8_t, float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT16) {
+                sd::TypeCast::convertGeneric<int8_t, int16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT16) {
+                //sd::TypeCast::convertGeneric<int8_t, uint16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT24) {
+                // TODO: eventually we might want to add it
+            } else if (dstType == ND4J_FLOAT32) {
+                sd::TypeCast::convertGeneric<int8_t, float>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_DOUBLE) {
+                sd::TypeCast::convertGeneric<int8_t, double>(nullptr, hx, N, hz);
+            } else {
+                nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
+        } else if (srcType == ND4J_UINT8) {
+            if (dstType == ND4J_FLOAT8) {
+            //    sd::TypeCast::convertGeneric<uint8_t, sd::float8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT8) {
+                sd::TypeCast::convertGeneric<uint8_t, int8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT8) {
+                sd::TypeCast::convertGeneric<uint8_t, uint8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT16) {
+                sd::TypeCast::convertGeneric<uint8_t, float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT16) {
+                sd::TypeCast::convertGeneric<uint8_t, int16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT16) {
+         //       sd::TypeCast::convertGeneric<uint8_t, uint16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT24) {
+                // TODO: still might want to add
+            } else if (dstType == ND4J_FLOAT32) {
+                sd::TypeCast::convertGeneric<uint8_t, float>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_DOUBLE) {
+                sd::TypeCast::convertGeneric<uint8_t, double>(nullptr, hx, N, hz);
+            } else {
+                nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
+        } else if (srcType == ND4J_FLOAT16) {
+            if (dstType == ND4J_FLOAT8) {
+            //    sd::TypeCast::convertGeneric<float16, sd::float8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT8) {
+                sd::TypeCast::convertGeneric<float16, int8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT8) {
+                sd::TypeCast::convertGeneric<float16, uint8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT16) {
+                sd::TypeCast::convertGeneric<float16, float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT16) {
+                sd::TypeCast::convertGeneric<float16, int16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT16) {
+    //            sd::TypeCast::convertGeneric<float16, uint16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT24) {
+                // TODO: .... ^^^
+            } else if (dstType == ND4J_FLOAT32) {
+                sd::TypeCast::convertGeneric<float16, float>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_DOUBLE) {
+                sd::TypeCast::convertGeneric<float16, double>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_THRESHOLD) {
+                sd::TypeCast::convertToThreshold<float16>(nullptr, hx, N, hz);
+            } else {
+                nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
+        } else if (srcType == ND4J_INT16) {
+            if (dstType == ND4J_FLOAT8) {
+             //   sd::TypeCast::convertGeneric<int16_t, sd::float8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT8) {
+                sd::TypeCast::convertGeneric<int16_t, int8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT8) {
+                sd::TypeCast::convertGeneric<int16_t, uint8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT16) {
+                sd::TypeCast::convertGeneric<int16_t, float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT16) {
+                //sd::TypeCast::convertGeneric<int16_t, int16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT16) {
+    //            sd::TypeCast::convertGeneric<int16_t, uint16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT24) {
+                // TODO...
+            } else if (dstType == ND4J_FLOAT32) {
+                sd::TypeCast::convertGeneric<int16_t, float>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_DOUBLE) {
+                sd::TypeCast::convertGeneric<int16_t, double>(nullptr, hx, N, hz);
+            } else {
+                printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
+        } else if (srcType == ND4J_FLOAT24) {
+
+        } else if (srcType == ND4J_FLOAT32) {
+            if (dstType == ND4J_FLOAT8) {
+            //    sd::TypeCast::convertGeneric<float, sd::float8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT8) {
+                sd::TypeCast::convertGeneric<float, int8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT8) {
+                sd::TypeCast::convertGeneric<float, uint8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT16) {
+                sd::TypeCast::convertGeneric<float, float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT16) {
+                sd::TypeCast::convertGeneric<float, int16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT16) {
+    //            sd::TypeCast::convertGeneric<float, uint16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT24) {
+
+            } else if (dstType == ND4J_DOUBLE) {
+                sd::TypeCast::convertGeneric<float, double>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_THRESHOLD) {
+                sd::TypeCast::convertToThreshold<float>(nullptr, hx, N, hz);
+            } else {
+                nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
+        } else if (srcType == ND4J_DOUBLE) {
+            if (dstType == ND4J_FLOAT8) {
+             //   sd::TypeCast::convertGeneric<double, sd::float8>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT8) {
+                sd::TypeCast::convertGeneric<double, int8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT8) {
+                sd::TypeCast::convertGeneric<double, uint8_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT16) {
+                sd::TypeCast::convertGeneric<double, float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_INT16) {
+                sd::TypeCast::convertGeneric<double, int16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_UINT16) {
+    //            sd::TypeCast::convertGeneric<double, uint16_t>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT24) {
+
+            } else if (dstType == ND4J_FLOAT32) {
+                sd::TypeCast::convertGeneric<double, float>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_DOUBLE) {
+                //
+            } else if (dstType == ND4J_THRESHOLD) {
+                sd::TypeCast::convertToThreshold<double>(nullptr, hx, N, hz);
+            } else {
+                nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
+        } else if (srcType == ND4J_THRESHOLD) {
+            if (dstType == ND4J_FLOAT16) {
+                sd::TypeCast::convertFromThreshold<float16>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_FLOAT32) {
+                sd::TypeCast::convertFromThreshold<float>(nullptr, hx, N, hz);
+            } else if (dstType == ND4J_DOUBLE) {
+                sd::TypeCast::convertFromThreshold<double>(nullptr, hx, N, hz);
+            } else {
+                nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+            }
         } else {
             nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
         }
-    } else {
-        nd4j_printf("Unsupported types conversion: [%i] -> [%i]\n", srcType, dstType);
+    } catch (std::exception &e) {
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
     }
 }
 
@@ -3238,6 +3243,57 @@ void dbClose(OpaqueDataBuffer *dataBuffer) {
     dataBuffer->getDataBuffer()->close();
 }
 
+static void checkKnnMatrix(Nd4jLong const* shapeInfo, const char *name) {
+    if (shape::rank(shapeInfo) != 2 || shape::order(shapeInfo) != 'c' || shape::elementWiseStride(shapeInfo) != 1)
+        throw std::invalid_argument(std::string(name) + ": array must be c-ordered contiguous matrix");
+}
+
+static void checkKnnQueries(OpaqueKnnIndex* index, Nd4jLong const* hQShapeInfo, const char *name) {
+    checkKnnMatrix(hQShapeInfo, name);
+
+    if (shape::sizeAt(hQShapeInfo, 1) != index->dims() || ArrayOptions::dataType(hQShapeInfo) != index->dataType())
+        throw std::invalid_argument(std::string(name) + ": queries must have the same number of columns and data type as index");
+}
+
+OpaqueKnnIndex* createKnnIndex(void *hX, Nd4jLong const* hXShapeInfo, int distance) {
+    try {
+        checkKnnMatrix(hXShapeInfo, "createKnnIndex");
+        return sd::KnnIndex::build(hX, ArrayOptions::dataType(hXShapeInfo), shape::sizeAt(hXShapeInfo, 0), static_cast<int>(shape::sizeAt(hXShapeInfo, 1)), static_cast<sd::KnnDistance>(distance));
+    } catch (std::exception &e) {
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+        return nullptr;
+    }
+}
+
+void knnSearch(OpaqueKnnIndex* index, void *hQ, Nd4jLong const* hQShapeInfo, int k, Nd4jLong *hIndices, void *hDistances) {
+    try {
+        checkKnnQueries(index, hQShapeInfo, "knnSearch");
+        index->search(hQ, shape::sizeAt(hQShapeInfo, 0), k, hIndices, hDistances);
+    } catch (std::exception &e) {
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+    }
+}
+
+void knnRadiusSearch(OpaqueKnnIndex* index, void *hQ, Nd4jLong const* hQShapeInfo, double radius, int maxResults, Nd4jLong *hIndices, void *hDistances, Nd4jLong *hCounts) {
+    try {
+        checkKnnQueries(index, hQShapeInfo, "knnRadiusSearch");
+        index->searchRadius(hQ, shape::sizeAt(hQShapeInfo, 0), radius, maxResults, hIndices, hDistances, hCounts);
+    } catch (std::exception &e) {
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+    }
+}
+
+Nd4jLong knnIndexSize(OpaqueKnnIndex* index) {
+    return index->numPoints();
+}
+
+void deleteKnnIndex(OpaqueKnnIndex* index) {
+    delete index;
+}
+
 BUILD_SINGLE_TEMPLATE(template void pullRowsGeneric, (void *, Nd4jLong const*, void*, Nd4jLong const*, const int, Nd4jLong const*, Nd4jLong const*, Nd4jLong const*, Nd4jLong const*, Nd4jLong const*), LIBND4J_TYPES);
 BUILD_SINGLE_TEMPLATE(template void tearGeneric, (void *, Nd4jLong const* , Nd4jPointer*, Nd4jLong const*, Nd4jLong const*, Nd4jLong const*), LIBND4J_TYPES);
 BUILD_SINGLE_TEMPLATE(template void shuffleGeneric, (void**, Nd4jLong* const*, void**, Nd4jLong* const*, int, int*, Nd4jLong* const*, Nd4jLong* const*), LIBND4J_TYPES);
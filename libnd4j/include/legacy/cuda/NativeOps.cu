@@ -3860,4 +3860,55 @@ int dbLocality(OpaqueDataBuffer *dataBuffer) {
         return -1;
     else
         return 1;
-}
\ No newline at end of file
+}
+
+static void checkKnnMatrix(Nd4jLong const* shapeInfo, const char *name) {
+    if (shape::rank(shapeInfo) != 2 || shape::order(shapeInfo) != 'c' || shape::elementWiseStride(shapeInfo) != 1)
+        throw std::invalid_argument(std::string(name) + ": array must be c-ordered contiguous matrix");
+}
+
+static void checkKnnQueries(OpaqueKnnIndex* index, Nd4jLong const* hQShapeInfo, const char *name) {
+    checkKnnMatrix(hQShapeInfo, name);
+
+    if (shape::sizeAt(hQShapeInfo, 1) != index->dims() || ArrayOptions::dataType(hQShapeInfo) != index->dataType())
+        throw std::invalid_argument(std::string(name) + ": queries must have the same number of columns and data type as index");
+}
+
+OpaqueKnnIndex* createKnnIndex(void *hX, Nd4jLong const* hXShapeInfo, int distance) {
+    try {
+        checkKnnMatrix(hXShapeInfo, "createKnnIndex");
+        return sd::KnnIndex::build(hX, ArrayOptions::dataType(hXShapeInfo), shape::sizeAt(hXShapeInfo, 0), static_cast<int>(shape::sizeAt(hXShapeInfo, 1)), static_cast<sd::KnnDistance>(distance));
+    } catch (std::exception &e) {
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+        return nullptr;
+    }
+}
+
+void knnSearch(OpaqueKnnIndex* index, void *hQ, Nd4jLong const* hQShapeInfo, int k, Nd4jLong *hIndices, void *hDistances) {
+    try {
+        checkKnnQueries(index, hQShapeInfo, "knnSearch");
+        index->search(hQ, shape::sizeAt(hQShapeInfo, 0), k, hIndices, hDistances);
+    } catch (std::exception &e) {
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+    }
+}
+
+void knnRadiusSearch(OpaqueKnnIndex* index, void *hQ, Nd4jLong const* hQShapeInfo, double radius, int maxResults, Nd4jLong *hIndices, void *hDistances, Nd4jLong *hCounts) {
+    try {
+        checkKnnQueries(index, hQShapeInfo, "knnRadiusSearch");
+        index->searchRadius(hQ, shape::sizeAt(hQShapeInfo, 0), radius, maxResults, hIndices, hDistances, hCounts);
+    } catch (std::exception &e) {
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+        sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+    }
+}
+
+Nd4jLong knnIndexSize(OpaqueKnnIndex* index) {
+    return index->numPoints();
+}
+
+void deleteKnnIndex(OpaqueKnnIndex* index) {
+    delete index;
+}
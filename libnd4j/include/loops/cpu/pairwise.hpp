@@ -27,6 +27,7 @@
 #include <system/op_boilerplate.h>
 #include <helpers/OmpLaunchHelper.h>
 #include <execution/Threads.h>
+#include <helpers/SimdKernels.h>
 
 using namespace simdOps;
 
@@ -69,6 +70,10 @@ namespace functions {
             auto extraParams = reinterpret_cast<Z *>(vextraParams);
 
             if (xEws == 1 && yEws == 1 && zEws == 1) {
+                // explicitly vectorized kernel, if there's one for this op and CPU
+                if (sd::simd::execPairwise<X, Y, Z, OpType>(x, y, z, start, stop))
+                    return;
+
                 PRAGMA_OMP_SIMD
                 for (auto i = start; i < stop; i++)
                         z[i] = OpType::op(x[i], y[i], extraParams);
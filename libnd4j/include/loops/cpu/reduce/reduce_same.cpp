@@ -154,6 +154,13 @@ namespace functions {
 
             auto func = PRAGMA_THREADS_FOR {
                 if (xEws == 1) {
+                    // sums of op(x) go to explicitly vectorized kernel, if there's one for this op and CPU
+                    X partial;
+                    if (sd::simd::execReduce<X, X, OpType>(x, start, stop, partial)) {
+                        intermediate[thread_id] = OpType::update(intermediate[thread_id], partial, extraParams);
+                        return;
+                    }
+
                     for (auto i = start; i < stop; i++)
                         intermediate[thread_id] = OpType::update(intermediate[thread_id], OpType::op(x[i], extraParams), extraParams);
                 } else {
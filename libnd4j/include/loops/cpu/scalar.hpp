@@ -23,6 +23,7 @@
 #include <types/types.h>
 #include <helpers/LoopKind.h>
 #include <execution/Threads.h>
+#include <helpers/SimdKernels.h>
 #include "../legacy_ops.h"
 
 using namespace simdOps;
@@ -72,6 +73,9 @@ void ScalarTransform<X, Y, Z>::transform(const void *vx, const Nd4jLong *xShapeI
             auto oZ = z + zTadOffsets[r];
             auto oX = x + xTadOffsets[r];
 
+            if (sd::simd::execScalar<X, Y, Z, OpType>(oX, scalars[r], oZ, 0, tadLength))
+                continue;
+
             PRAGMA_OMP_SIMD
             for (int f = 0; f < tadLength; f++)
                 oZ[f] = OpType::op(oX[f], scalars[r], extraParams);
@@ -193,6 +197,10 @@ void ScalarTransform<X, Y, Z>::transform(const void *vx, Nd4jLong xEws,
     auto extraParams = reinterpret_cast<Z *>(vextraParams);
 
     if (xEws == 1 && zEws == 1) {
+        // explicitly vectorized kernel, if there's one for this op and CPU
+        if (sd::simd::execScalar<X, Y, Z, OpType>(x, scalar, z, start, stop))
+            return;
+
         PRAGMA_OMP_SIMD
         for (auto i = start; i < stop; i++)
             z[i] = OpType::op(x[i], scalar, extraParams);
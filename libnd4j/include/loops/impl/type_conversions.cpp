@@ -23,6 +23,10 @@
 #include <loops/type_conversions.h>
 #include <helpers/OmpLaunchHelper.h>
 #include <execution/Threads.h>
+#include <system/Environment.h>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
 
 namespace sd {
 
@@ -89,84 +93,156 @@ namespace sd {
         samediff::Threads::parallel_for(func,  0, N);
     }
 
+    /**
+     * Writes signed 1-based indices of elements with |x| >= threshold into encoded, at most limit of them,
+     * and subtracts threshold from these elements. I is the type of encoded index: int or Nd4jLong
+     */
+    template <typename T, typename I>
+    static void encodeThreshold_(T *x, Nd4jLong N, I *encoded, Nd4jLong limit, float threshold) {
+        const T tt = static_cast<T>(threshold);
+        const T mtt = -tt;
+
+        // elements are split into chunks: first pass counts updates per chunk, second one writes each chunk into
+        // its own range of output, so output is ordered by index no matter how many threads were used
+        const Nd4jLong minChunk = 32768;
+        const Nd4jLong numChunks = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(sd::Environment::getInstance().maxMasterThreads(), N / minChunk));
+        const Nd4jLong chunk = (N + numChunks - 1) / numChunks;
+        std::vector<Nd4jLong> offsets(numChunks + 1, 0);
+
+        auto count = PRAGMA_THREADS_FOR {
+            for (auto c = start; c < stop; c++) {
+                auto last = sd::math::nd4j_min<Nd4jLong>(N, (c + 1) * chunk);
+                Nd4jLong cnt = 0;
+
+                for (Nd4jLong e = c * chunk; e < last; e++)
+                    cnt += (x[e] >= tt || x[e] <= mtt) ? 1 : 0;
+
+                offsets[c + 1] = cnt;
+            }
+        };
+
+        if (numChunks > 1)
+            samediff::Threads::parallel_tad(count, 0, numChunks);
+        else
+            count(0, 0, 1, 1);
+
+        for (Nd4jLong c = 0; c < numChunks; c++)
+            offsets[c + 1] += offsets[c];
+
+        auto scatter = PRAGMA_THREADS_FOR {
+            // updates are compressed block by block into local buffer: stores there don't depend on branches
+            const int blockSize = 256;
+            I buffer[blockSize];
+
+            for (auto c = start; c < stop; c++) {
+                auto pos = offsets[c];
+                if (pos >= limit || offsets[c + 1] == pos)
+                    continue;
+
+                auto first = c * chunk;
+                auto last = sd::math::nd4j_min<Nd4jLong>(N, (c + 1) * chunk);
+
+                // only one chunk can cross the limit, elements past it are left as they are
+                if (offsets[c + 1] > limit) {
+                    for (Nd4jLong e = first; e < last && pos < limit; e++) {
+                        T cUpd = x[e];
+                        if (cUpd >= tt) {
+                            encoded[pos++] = static_cast<I>(e + 1);
+                            x[e] -= tt;
+                        } else if (cUpd <= mtt) {
+                            encoded[pos++] = static_cast<I>(-e - 1);
+                            x[e] += tt;
+                        }
+                    }
+
+                    continue;
+                }
+
+                for (Nd4jLong b = first; b < last; b += blockSize) {
+                    auto bLast = sd::math::nd4j_min<Nd4jLong>(last, b + blockSize);
+                    int n = 0;
+
+                    for (Nd4jLong e = b; e < bLast; e++) {
+                        const T cUpd = x[e];
+                        const int positive = cUpd >= tt ? 1 : 0;
+                        const int negative = cUpd <= mtt ? 1 : 0;
+
+                        buffer[n] = positive ? static_cast<I>(e + 1) : static_cast<I>(-e - 1);
+                        n += positive | negative;
+                    }
+
+                    PRAGMA_OMP_SIMD
+                    for (Nd4jLong e = b; e < bLast; e++) {
+                        const T cUpd = x[e];
+                        x[e] = cUpd >= tt ? cUpd - tt : cUpd <= mtt ? cUpd + tt : cUpd;
+                    }
+
+                    std::memcpy(encoded + pos, buffer, n * sizeof(I));
+                    pos += n;
+                }
+            }
+        };
+
+        if (numChunks > 1)
+            samediff::Threads::parallel_tad(scatter, 0, numChunks);
+        else
+            scatter(0, 0, 1, 1);
+    }
+
+    template <typename T, typename I>
+    static void decodeThreshold_(const I *encoded, Nd4jLong limit, float threshold, T *z) {
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto e = start; e < stop; e++) {
+                Nd4jLong el = encoded[e];
+
+                // zero means encoder found less updates than there was space for
+                if (el == 0)
+                    continue;
+
+                Nd4jLong ael = sd::math::nd4j_abs<Nd4jLong>(el) - 1;
+                z[ael] += el > 0 ? static_cast<T>(threshold) : static_cast<T>(-threshold);
+            }
+        };
+
+        samediff::Threads::parallel_for(func,  0, limit);
+    }
+
+    /*
+     * Encoded array layout, header elements are int32:
+     *   [0] number of int32 elements after first 4 ones
+     *   [1] length of original array, if it fits into int32
+     *   [2] threshold bits
+     *   [3] flag: 0 for int32 indices, 3 for int64 ones
+     *
+     * With int32 indices signed 1-based indices of updates follow the header. Arrays longer than MAX_INT
+     * always get int64 indices: header is extended with [4..5] holding length of original array as int64,
+     * and indices take two int32 elements each. Caller may ask for int64 indices on smaller arrays
+     * by setting flag before encoding.
+     */
     template <typename T>
     void TypeCast::convertToThreshold(Nd4jPointer * extras, void *dx, Nd4jLong N, void *dz) {
-        // we suppose that first 4 bytes are integer, second 4 bytes are float
-        // integer: enc length
-        // integer: dec length
-        // float: threshold
         FloatBits fb;
         auto x = reinterpret_cast<T *>(dx);
         auto z = reinterpret_cast<int *>(dz);
-        int limit = z[0];
+        const Nd4jLong limit = z[0];
         fb.i_ = z[2];
         float threshold = fb.f_;
 
-        // TODO: int limit is sad thing here, 2B elements limitation
-        auto l = static_cast<int>(N);
-        z[1] = l;
-
-#ifdef _OPENMP
-        int threads = OmpLaunchHelper::betterThreads(N);
-        auto span = OmpLaunchHelper::betterSpan(N, threads);
-#else
-        int threads = 1;
-        auto span = N;
-#endif
-
-
-        T tt = static_cast<T>(threshold);
-        T mtt = -tt;
-
-        // we use 3 as offset, since first 12 bytes are occupied with header
-        int flimit = limit + 4;
-        volatile int cnt = 4;
-        volatile bool flag = false;
-        PRAGMA_OMP_PARALLEL_THREADS(threads)
-        {
-            int tid = omp_get_thread_num();
-            int start = span * tid;
-            int stop = span * (tid + 1);
-            if (stop > l)
-                stop = l;
-
-            for (int e = start; e < stop; e++) {
-                bool flag_load;
-PRAGMA_OMP_ATOMIC_ARGS(read)
-                flag_load = flag;
-                if (flag_load)
-                    break;
-
-                T cUpd = x[e];
-                if (cUpd >= tt) {
-                    int idx;
-PRAGMA_OMP_ATOMIC_ARGS(capture)
-                    idx = cnt++;
-
-                    if (idx >= flimit) {
-PRAGMA_OMP_ATOMIC_ARGS(write)
-                        flag = true;
-                        break;
-                    }
+        if (N > static_cast<Nd4jLong>(DataTypeUtils::max<int>()) || z[3] == THRESHOLD_LONG_FLAG) {
+            if (limit < THRESHOLD_LONG_HEADER - 4)
+                throw std::invalid_argument("convertToThreshold: encoded array is too small for int64 indices header");
 
-                    z[idx] = e + 1;
-                    x[e] -= tt;
-                } else if (cUpd <= mtt) {
-                    int idx;
-PRAGMA_OMP_ATOMIC_ARGS(capture)
-                    idx = cnt++;
-
-                    if (idx >= flimit) {
-PRAGMA_OMP_ATOMIC_ARGS(write)
-                        flag = true;
-                        break;
-                    }
+            z[1] = N > static_cast<Nd4jLong>(DataTypeUtils::max<int>()) ? 0 : static_cast<int>(N);
+            z[3] = THRESHOLD_LONG_FLAG;
+            std::memcpy(z + 4, &N, sizeof(Nd4jLong));
 
+            auto encoded = reinterpret_cast<Nd4jLong *>(z + THRESHOLD_LONG_HEADER);
+            encodeThreshold_<T, Nd4jLong>(x, N, encoded, (limit + 4 - THRESHOLD_LONG_HEADER) / 2, threshold);
+        } else {
+            z[1] = static_cast<int>(N);
 
-                    z[idx] = -e - 1;
-                    x[e] += tt;
-                }
-            }
+            // we use 4 as offset, since first 16 bytes are occupied with header
+            encodeThreshold_<T, int>(x, N, z + 4, limit, threshold);
         }
     }
 
@@ -175,22 +251,17 @@ PRAGMA_OMP_ATOMIC_ARGS(write)
         FloatBits fb;
         auto z = reinterpret_cast<T *>(dz);
         auto x = reinterpret_cast<const int *>(dx);
-        int limit = x[0];
+        const Nd4jLong limit = x[0];
         fb.i_ = x[2];
         float threshold = fb.f_;
 
-        // we use 3 as offset, since first 12 bytes are occupied with header
-        int flimit = limit + 4;
-
-        auto func = PRAGMA_THREADS_FOR {
-            for (auto e = start; e < stop; e++) {
-                int el = x[e];
-                int ael = sd::math::nd4j_abs<int>(el) - 1;
-                z[ael] += el > 0 ? static_cast<T>(threshold) : static_cast<T>(-threshold);
-            }
-        };
-
-        samediff::Threads::parallel_for(func,  4, flimit);
+        if (x[3] == THRESHOLD_LONG_FLAG) {
+            auto encoded = reinterpret_cast<const Nd4jLong *>(x + THRESHOLD_LONG_HEADER);
+            decodeThreshold_<T, Nd4jLong>(encoded, (limit + 4 - THRESHOLD_LONG_HEADER) / 2, threshold, z);
+        } else {
+            // we use 4 as offset, since first 16 bytes are occupied with header
+            decodeThreshold_<T, int>(x + 4, limit, threshold, z);
+        }
     }
 
     /**
@@ -35,6 +35,11 @@
 #define ND4J_THRESHOLD 8
 #define ND4J_FLOAT24 119 // not supported after all. might want to add support later.
 
+// flag element of threshold-encoded header: int32 indices, or int64 indices for arrays longer than MAX_INT
+#define THRESHOLD_FLEXIBLE_FLAG 0
+#define THRESHOLD_LONG_FLAG 3
+#define THRESHOLD_LONG_HEADER 6
+
 #include <ops/ops.h>
 #include <math/templatemath.h>
 #include <types/float16.h>
@@ -31,6 +31,12 @@ namespace sd {
             Nd4jLong _vm = 0;
             Nd4jLong _rss = 0;
 
+            // workspace statistics
+            Nd4jLong _spills = 0;
+            Nd4jLong _spilledBytes = 0;
+            Nd4jLong _reallocations = 0;
+            Nd4jLong _peak = 0;
+
         public:
             MemoryReport() = default;
             ~MemoryReport() = default;
@@ -47,6 +53,18 @@ namespace sd {
 
             Nd4jLong getRSS() const;
             void setRSS(Nd4jLong rss);
+
+            Nd4jLong getSpills() const;
+            void setSpills(Nd4jLong spills);
+
+            Nd4jLong getSpilledBytes() const;
+            void setSpilledBytes(Nd4jLong bytes);
+
+            Nd4jLong getReallocations() const;
+            void setReallocations(Nd4jLong reallocations);
+
+            Nd4jLong getPeak() const;
+            void setPeak(Nd4jLong peak);
         };
     }
 }
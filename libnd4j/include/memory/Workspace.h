@@ -32,6 +32,7 @@
 #include <types/float16.h>
 #include <memory/ExternalWorkspace.h>
 #include <memory/MemoryType.h>
+#include <memory/MemoryReport.h>
 
 namespace sd {
     namespace memory {
@@ -67,8 +68,35 @@ namespace sd {
             std::atomic<Nd4jLong> _spillsSizeSecondary;
             std::atomic<Nd4jLong> _cycleAllocationsSecondary;
 
+            // in adaptive mode workspace grows to the biggest cycle seen so far, as soon as cycle ends
+            bool _adaptive = false;
+
+            // high-water marks (arena + spills) of current cycle, and the biggest one seen so far
+            std::atomic<Nd4jLong> _cycleMaximum{0};
+            std::atomic<Nd4jLong> _cycleMaximumSecondary{0};
+            Nd4jLong _peak = 0L;
+            Nd4jLong _peakSecondary = 0L;
+
+            // statistics, accumulated over workspace lifetime
+            std::atomic<Nd4jLong> _spillsCount{0};
+            std::atomic<Nd4jLong> _spillsTotal{0};
+            std::atomic<Nd4jLong> _reallocations{0};
+
+            // state saved by pushScope(), restored by popScope()
+            struct NestedScope {
+                Nd4jLong offset;
+                Nd4jLong offsetSecondary;
+                Nd4jLong spillsSize;
+                Nd4jLong spillsSizeSecondary;
+                size_t spills;
+                size_t spillsSecondary;
+            };
+            std::vector<NestedScope> _scopes;
+
             void init(Nd4jLong primaryBytes, Nd4jLong secondaryBytes = 0L);
             void freeSpills();
+            void updateMaximum(std::atomic<Nd4jLong> &maximum, Nd4jLong value);
+            void finishCycle();
         public:
             explicit Workspace(ExternalWorkspace *external);
             Workspace(Nd4jLong initialSize = 0L, Nd4jLong secondaryBytes = 0L);
@@ -97,6 +125,31 @@ namespace sd {
             void scopeIn();
             void scopeOut();
 
+            /**
+             * These methods provide nested scopes within current cycle:
+             * popScope() releases everything allocated after matching pushScope() call, including spills
+             */
+            void pushScope();
+            void popScope();
+
+            /**
+             * In adaptive mode spills are released and arena is grown to the biggest cycle seen so far
+             * right at scopeOut(), so next cycle won't spill again
+             */
+            void setAdaptive(bool reallyAdaptive);
+            bool isAdaptive();
+
+            /**
+             * This method returns the biggest high-water mark (arena + spills) over finished cycles
+             */
+            Nd4jLong getPeakSize();
+            Nd4jLong getPeakSecondarySize();
+
+            /**
+             * This method returns spill statistics accumulated over lifetime of this workspace
+             */
+            MemoryReport getReport();
+
             /*
              * This method creates NEW workspace of the same memory size and returns pointer to it
              */
@@ -82,9 +82,15 @@ namespace sd {
                 memset(this->_ptrHost, 0, bytes);
                 this->_currentSize = bytes;
                 this->_allocatedHost = true;
+                this->_reallocations++;
             }
         }
 
+        void Workspace::updateMaximum(std::atomic<Nd4jLong> &maximum, Nd4jLong value) {
+            auto current = maximum.load();
+            while (current < value && !maximum.compare_exchange_weak(current, value));
+        }
+
         void Workspace::expandBy(Nd4jLong numBytes, Nd4jLong secondaryBytes) {
             this->init(_currentSize + numBytes, _currentSizeSecondary + secondaryBytes);
         }
@@ -148,12 +154,17 @@ namespace sd {
                 _mutexSpills.unlock();
 
                 _spillsSize += numBytes;
+                _spillsCount++;
+                _spillsTotal += numBytes;
+
+                updateMaximum(_cycleMaximum, _offset.load() + _spillsSize.load());
 
                 return p;
             }
 
             result = (void *)(_ptrHost + _offset.load());
             _offset += numBytes;
+            updateMaximum(_cycleMaximum, _offset.load() + _spillsSize.load());
             //memset(result, 0, (int) numBytes);
 
             nd4j_debug("Allocating %lld bytes from workspace; Current PTR: %p; Current offset: %lld\n", numBytes, result, _offset.load());
@@ -167,15 +178,96 @@ namespace sd {
             return getCurrentSize() + getSpilledSize();
         }
 
+        void Workspace::finishCycle() {
+            _peak = sd::math::nd4j_max<Nd4jLong>(_peak, _cycleMaximum.load());
+            _cycleMaximum = 0;
+            _scopes.clear();
+        }
+
         void Workspace::scopeIn() {
             freeSpills();
-            init(_cycleAllocations.load());
+            finishCycle();
+
+            init(_adaptive ? sd::math::nd4j_max<Nd4jLong>(_peak, _cycleAllocations.load()) : _cycleAllocations.load());
             _cycleAllocations = 0;
         }
 
         void Workspace::scopeOut() {
             _offset = 0;
             _offsetSecondary = 0;
+
+            if (_adaptive) {
+                finishCycle();
+
+                // nothing allocated within this cycle is alive anymore, so we can reallocate right away
+                if (_spillsSize.load() > 0 || _peak > _currentSize) {
+                    freeSpills();
+                    init(_peak);
+                }
+
+                _cycleAllocations = 0;
+            }
+        }
+
+        void Workspace::pushScope() {
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
+            std::lock_guard<std::mutex> lockSpills(_mutexSpills);
+
+            NestedScope scope;
+            scope.offset = _offset.load();
+            scope.offsetSecondary = _offsetSecondary.load();
+            scope.spillsSize = _spillsSize.load();
+            scope.spillsSizeSecondary = 0;
+            scope.spills = _spills.size();
+            scope.spillsSecondary = 0;
+
+            _scopes.emplace_back(scope);
+        }
+
+        void Workspace::popScope() {
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
+            std::lock_guard<std::mutex> lockSpills(_mutexSpills);
+
+            if (_scopes.empty())
+                throw std::runtime_error("Workspace: popScope() called without matching pushScope()");
+
+            auto scope = _scopes.back();
+            _scopes.pop_back();
+
+            for (size_t e = scope.spills; e < _spills.size(); e++)
+                free(_spills[e]);
+
+            _spills.resize(scope.spills);
+            _spillsSize = scope.spillsSize;
+
+            _offset = scope.offset;
+            _offsetSecondary = scope.offsetSecondary;
+        }
+
+        void Workspace::setAdaptive(bool reallyAdaptive) {
+            _adaptive = reallyAdaptive;
+        }
+
+        bool Workspace::isAdaptive() {
+            return _adaptive;
+        }
+
+        Nd4jLong Workspace::getPeakSize() {
+            return sd::math::nd4j_max<Nd4jLong>(_peak, _cycleMaximum.load());
+        }
+
+        Nd4jLong Workspace::getPeakSecondarySize() {
+            return 0L;
+        }
+
+        MemoryReport Workspace::getReport() {
+            MemoryReport report;
+            report.setSpills(_spillsCount.load());
+            report.setSpilledBytes(_spillsTotal.load());
+            report.setReallocations(_reallocations.load());
+            report.setPeak(getPeakSize());
+
+            return report;
         }
 
         Nd4jLong Workspace::getSpilledSize() {
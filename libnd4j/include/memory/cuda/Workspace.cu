@@ -92,13 +92,14 @@ namespace sd {
                 if (this->_allocatedDevice && !_externalized)
                     cudaFree((void *)this->_ptrDevice);
 
-                auto res = cudaMalloc(reinterpret_cast<void **>(&_ptrDevice), secondaryBytes);
+                auto res = cudaMalloc(reinterpret_cast<void **>(&_ptrDevice), primaryBytes);
                 if (res != 0)
                     throw cuda_exception::build("Can't allocate [DEVICE] memory", res);
 
                 cudaMemset(this->_ptrDevice, 0, primaryBytes);
                 this->_currentSize = primaryBytes;
                 this->_allocatedDevice = true;
+                this->_reallocations++;
             }
 
             if (this->_currentSizeSecondary < secondaryBytes) {
@@ -113,9 +114,15 @@ namespace sd {
                 cudaMemset(this->_ptrHost, 0, secondaryBytes);
                 this->_currentSizeSecondary = secondaryBytes;
                 this->_allocatedHost = true;
+                this->_reallocations++;
             }
         }
 
+        void Workspace::updateMaximum(std::atomic<Nd4jLong> &maximum, Nd4jLong value) {
+            auto current = maximum.load();
+            while (current < value && !maximum.compare_exchange_weak(current, value));
+        }
+
         void Workspace::expandBy(Nd4jLong numBytes, Nd4jLong secondaryBytes) {
             this->init(_currentSize + numBytes, _currentSizeSecondary + secondaryBytes);
         }
@@ -169,14 +176,109 @@ namespace sd {
             return getCurrentSize() + getSpilledSize();
         }
 
+        void Workspace::finishCycle() {
+            _peak = sd::math::nd4j_max<Nd4jLong>(_peak, _cycleMaximum.load());
+            _peakSecondary = sd::math::nd4j_max<Nd4jLong>(_peakSecondary, _cycleMaximumSecondary.load());
+            _cycleMaximum = 0;
+            _cycleMaximumSecondary = 0;
+            _scopes.clear();
+        }
+
         void Workspace::scopeIn() {
             freeSpills();
-            init(_cycleAllocations.load());
+            finishCycle();
+
+            if (_adaptive)
+                init(sd::math::nd4j_max<Nd4jLong>(_peak, _cycleAllocations.load()), sd::math::nd4j_max<Nd4jLong>(_peakSecondary, _cycleAllocationsSecondary.load()));
+            else
+                init(_cycleAllocations.load());
+
             _cycleAllocations = 0;
+            _cycleAllocationsSecondary = 0;
         }
 
         void Workspace::scopeOut() {
             _offset = 0;
+
+            if (_adaptive) {
+                _offsetSecondary = 0;
+                finishCycle();
+
+                // nothing allocated within this cycle is alive anymore, so we can reallocate right away
+                if (_spillsSize.load() > 0 || _spillsSizeSecondary.load() > 0 || _peak > _currentSize || _peakSecondary > _currentSizeSecondary) {
+                    freeSpills();
+                    init(_peak, _peakSecondary);
+                }
+
+                _cycleAllocations = 0;
+                _cycleAllocationsSecondary = 0;
+            }
+        }
+
+        void Workspace::pushScope() {
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
+            std::lock_guard<std::mutex> lockSpills(_mutexSpills);
+
+            NestedScope scope;
+            scope.offset = _offset.load();
+            scope.offsetSecondary = _offsetSecondary.load();
+            scope.spillsSize = _spillsSize.load();
+            scope.spillsSizeSecondary = _spillsSizeSecondary.load();
+            scope.spills = _spills.size();
+            scope.spillsSecondary = _spillsSecondary.size();
+
+            _scopes.emplace_back(scope);
+        }
+
+        void Workspace::popScope() {
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
+            std::lock_guard<std::mutex> lockSpills(_mutexSpills);
+
+            if (_scopes.empty())
+                throw std::runtime_error("Workspace: popScope() called without matching pushScope()");
+
+            auto scope = _scopes.back();
+            _scopes.pop_back();
+
+            for (size_t e = scope.spills; e < _spills.size(); e++)
+                cudaFree(_spills[e]);
+
+            for (size_t e = scope.spillsSecondary; e < _spillsSecondary.size(); e++)
+                cudaFreeHost(_spillsSecondary[e]);
+
+            _spills.resize(scope.spills);
+            _spillsSecondary.resize(scope.spillsSecondary);
+            _spillsSize = scope.spillsSize;
+            _spillsSizeSecondary = scope.spillsSizeSecondary;
+
+            _offset = scope.offset;
+            _offsetSecondary = scope.offsetSecondary;
+        }
+
+        void Workspace::setAdaptive(bool reallyAdaptive) {
+            _adaptive = reallyAdaptive;
+        }
+
+        bool Workspace::isAdaptive() {
+            return _adaptive;
+        }
+
+        Nd4jLong Workspace::getPeakSize() {
+            return sd::math::nd4j_max<Nd4jLong>(_peak, _cycleMaximum.load());
+        }
+
+        Nd4jLong Workspace::getPeakSecondarySize() {
+            return sd::math::nd4j_max<Nd4jLong>(_peakSecondary, _cycleMaximumSecondary.load());
+        }
+
+        MemoryReport Workspace::getReport() {
+            MemoryReport report;
+            report.setSpills(_spillsCount.load());
+            report.setSpilledBytes(_spillsTotal.load());
+            report.setReallocations(_reallocations.load());
+            report.setPeak(getPeakSize());
+
+            return report;
         }
 
         Nd4jLong Workspace::getSpilledSize() {
@@ -209,12 +311,17 @@ namespace sd {
                             _mutexSpills.unlock();
 
                             _spillsSizeSecondary += numBytes;
+                            _spillsCount++;
+                            _spillsTotal += numBytes;
+
+                            updateMaximum(_cycleMaximumSecondary, _offsetSecondary.load() + _spillsSizeSecondary.load());
 
                             return p;
                         }
 
                         result = (void *)(_ptrHost + _offsetSecondary.load());
                         _offsetSecondary += numBytes;
+                        updateMaximum(_cycleMaximumSecondary, _offsetSecondary.load() + _spillsSizeSecondary.load());
                         //memset(result, 0, (int) numBytes);
 
                         nd4j_debug("Allocating %lld bytes from [HOST] workspace; Current PTR: %p; Current offset: %lld\n", numBytes, result, _offset.load());
@@ -248,12 +355,17 @@ namespace sd {
                             _mutexSpills.unlock();
 
                             _spillsSize += numBytes;
+                            _spillsCount++;
+                            _spillsTotal += numBytes;
+
+                            updateMaximum(_cycleMaximum, _offset.load() + _spillsSize.load());
 
                             return p;
                         }
 
                         result = (void *)(_ptrDevice + _offset.load());
                         _offset += numBytes;
+                        updateMaximum(_cycleMaximum, _offset.load() + _spillsSize.load());
                         //memset(result, 0, (int) numBytes);
 
                         nd4j_debug("Allocating %lld bytes from [DEVICE] workspace; Current PTR: %p; Current offset: %lld\n", numBytes, result, _offset.load());
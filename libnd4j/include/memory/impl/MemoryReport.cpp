@@ -59,3 +59,35 @@ Nd4jLong sd::memory::MemoryReport::getRSS() const {
 void sd::memory::MemoryReport::setRSS(Nd4jLong _rss) {
     MemoryReport::_rss = _rss;
 }
+
+Nd4jLong sd::memory::MemoryReport::getSpills() const {
+    return _spills;
+}
+
+void sd::memory::MemoryReport::setSpills(Nd4jLong spills) {
+    MemoryReport::_spills = spills;
+}
+
+Nd4jLong sd::memory::MemoryReport::getSpilledBytes() const {
+    return _spilledBytes;
+}
+
+void sd::memory::MemoryReport::setSpilledBytes(Nd4jLong bytes) {
+    MemoryReport::_spilledBytes = bytes;
+}
+
+Nd4jLong sd::memory::MemoryReport::getReallocations() const {
+    return _reallocations;
+}
+
+void sd::memory::MemoryReport::setReallocations(Nd4jLong reallocations) {
+    MemoryReport::_reallocations = reallocations;
+}
+
+Nd4jLong sd::memory::MemoryReport::getPeak() const {
+    return _peak;
+}
+
+void sd::memory::MemoryReport::setPeak(Nd4jLong peak) {
+    MemoryReport::_peak = peak;
+}
\ No newline at end of file
@@ -35,6 +35,7 @@ namespace sd {
             BroadcastableOp(const char *name, int numTArgs, int numIArgs);
 
             ShapeList *calculateOutputShape(ShapeList *inputShape, sd::graph::Context& block) override;
+            bool hasPureShapeFunction() override;
         };
     }
 }
@@ -133,6 +133,12 @@ namespace sd {
             // this method returns OpDescriptor, describing this Op instance
             OpDescriptor *getOpDescriptor();
 
+            /**
+             * This method returns true if output shapes of this op depend only on input shapes and op arguments,
+             * so shape function results can be memoized. Ops reading input values in their shape function must return false
+             */
+            virtual bool hasPureShapeFunction();
+
             virtual Nd4jStatus validateDataTypes(Context& block);
 
             /**
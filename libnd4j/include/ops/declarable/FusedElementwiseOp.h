@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_FUSEDELEMENTWISEOP_H
+#define SD_FUSEDELEMENTWISEOP_H
+
+#include <ops/declarable/DeclarableOp.h>
+#include <ops/declarable/helpers/fused_elementwise.h>
+
+namespace sd {
+    namespace ops {
+        /**
+         * This class executes chain of elementwise ops (transform, scalar, pairwise and broadcastable ones) as single op.
+         * It's never registered in OpRegistrator: instances are created by Graph::fuseElementwise() only.
+         *
+         * Input 0 is X operand of the first step, all other inputs are Y operands referenced by steps.
+         * If arrays allow that, whole chain is applied tile by tile in one pass over memory,
+         * otherwise steps are executed one by one.
+         *
+         * PLEASE NOTE: single pass execution is CPU-only. CUDA builds always execute steps one by one,
+         * and GraphHolder doesn't fuse graphs there.
+         */
+        class ND4J_EXPORT FusedElementwiseOp : public DeclarableOp {
+        protected:
+            std::vector<helpers::FusedStep> _steps;
+
+            Nd4jStatus validateAndExecute(Context& block) override;
+
+            // shape of one step result, for given shape of its X and Y operands
+            const Nd4jLong* stepShapeInfo(const helpers::FusedStep &step, const Nd4jLong *xShapeInfo, const Nd4jLong *yShapeInfo, sd::memory::Workspace *workspace);
+        public:
+            FusedElementwiseOp(const std::vector<helpers::FusedStep> &steps, int numInputs);
+            ~FusedElementwiseOp() = default;
+
+            ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context& block) override;
+
+            void registerTypes() override;
+
+            bool hasPureShapeFunction() override;
+
+            const std::vector<helpers::FusedStep>& steps() const;
+        };
+    }
+}
+
+#endif //SD_FUSEDELEMENTWISEOP_H
@@ -36,6 +36,7 @@ namespace sd {
             LegacyPairwiseTransformBoolOp(int opNum);
 
             ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context& block) override;
+            bool hasPureShapeFunction() override;
             LegacyOp* clone() override;
         };
     }
@@ -38,6 +38,7 @@ namespace sd {
             LegacyScalarBoolOp(int opNum, NDArray &scalar);
 
             ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context& block) override;
+            bool hasPureShapeFunction() override;
             LegacyOp* clone() override;
         };
     }
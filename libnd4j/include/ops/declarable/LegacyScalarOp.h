@@ -38,6 +38,7 @@ namespace sd {
             LegacyScalarOp(int opNum, NDArray &scalar);
 
             ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context& block) override;
+            bool hasPureShapeFunction() override;
             LegacyOp* clone() override;
         };
     }
@@ -37,6 +37,7 @@ namespace sd {
             LegacyTransformFloatOp(int opNum);
 
             ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context &block) override;
+            bool hasPureShapeFunction() override;
             LegacyOp* clone() override;
         };
     }
@@ -38,6 +38,7 @@ namespace sd {
             LegacyTransformSameOp(int opNum);
 
             ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context &block) override;
+            bool hasPureShapeFunction() override;
             LegacyOp* clone() override;
         };
     }
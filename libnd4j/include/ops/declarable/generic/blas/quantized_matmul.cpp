@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_quantized_matmul)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+    namespace ops {
+        CUSTOM_OP_IMPL(quantized_matmul, 6, 1, false, 0, 0) {
+            auto a = INPUT_VARIABLE(0);
+            auto aScale = INPUT_VARIABLE(1);
+            auto aZeroPoint = INPUT_VARIABLE(2);
+            auto b = INPUT_VARIABLE(3);
+            auto bScale = INPUT_VARIABLE(4);
+            auto bZeroPoint = INPUT_VARIABLE(5);
+            auto z = OUTPUT_VARIABLE(0);
+
+            const int transA = block.getIArguments()->size() > 0 ? INT_ARG(0) : 0;
+            const int transB = block.getIArguments()->size() > 1 ? INT_ARG(1) : 0;
+
+            const int rank = a->rankOf();
+            REQUIRE_TRUE(rank >= 2 && b->rankOf() == rank, 0, "QUANTIZED_MATMUL OP: input arrays must have the same rank, at least 2, but got x rank = %i, y rank = %i !", rank, b->rankOf());
+            REQUIRE_TRUE(a->sizeAt(transA ? -2 : -1) == b->sizeAt(transB ? -1 : -2), 0, "QUANTIZED_MATMUL OP: input arrays have inconsistent shapes for matrix product: x %s, y %s !", ShapeUtils::shapeAsString(a).c_str(), ShapeUtils::shapeAsString(b).c_str());
+            REQUIRE_TRUE(aScale->lengthOf() == 1 && aZeroPoint->lengthOf() == 1, 0, "QUANTIZED_MATMUL OP: scale and zero point of x must be scalars !");
+
+            const auto N = z->sizeAt(-1);
+            REQUIRE_TRUE((bScale->lengthOf() == 1 || bScale->lengthOf() == N) && bZeroPoint->lengthOf() == bScale->lengthOf(), 0, "QUANTIZED_MATMUL OP: scale and zero point of y must be scalars or vectors of length %i !", (int) N);
+
+            // transposition is done via views, helper works with any strides
+            std::vector<int> permutation(rank);
+            for (int e = 0; e < rank; e++)
+                permutation[e] = e;
+            std::swap(permutation[rank - 2], permutation[rank - 1]);
+
+            NDArray aT, bT;
+            if (transA) {
+                aT = a->permute(permutation);
+                a = &aT;
+            }
+
+            if (transB) {
+                bT = b->permute(permutation);
+                b = &bT;
+            }
+
+            if (rank == 2) {
+                helpers::quantizedMatmul(block.launchContext(), *a, *aScale, *aZeroPoint, *b, *bScale, *bZeroPoint, nullptr, *z);
+                return Status::OK();
+            }
+
+            // leading dimensions are batch ones
+            auto aMatrices = a->allTensorsAlongDimension({rank - 2, rank - 1});
+            auto bMatrices = b->allTensorsAlongDimension({rank - 2, rank - 1});
+            auto zMatrices = z->allTensorsAlongDimension({rank - 2, rank - 1});
+            REQUIRE_TRUE(aMatrices.size() == bMatrices.size(), 0, "QUANTIZED_MATMUL OP: input arrays have different batch dimensions: x %s, y %s !", ShapeUtils::shapeAsString(a).c_str(), ShapeUtils::shapeAsString(b).c_str());
+
+            for (int e = 0; e < zMatrices.size(); e++)
+                helpers::quantizedMatmul(block.launchContext(), *aMatrices.at(e), *aScale, *aZeroPoint, *bMatrices.at(e), *bScale, *bZeroPoint, nullptr, *zMatrices.at(e));
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantized_matmul) {
+            const int transA = block.getIArguments()->size() > 0 ? INT_ARG(0) : 0;
+            const int transB = block.getIArguments()->size() > 1 ? INT_ARG(1) : 0;
+
+            auto shape = ShapeUtils::evalShapeForMatmul(inputShape->at(0), inputShape->at(3), transA, transB);
+
+            // output has data type of scales
+            return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(1)), 'c', shape));
+        }
+
+        DECLARE_TYPES(quantized_matmul) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+                    ->setAllowedInputTypes(3, {sd::DataType::INT8, sd::DataType::UINT8})
+                    ->setAllowedInputTypes(4, {ALL_FLOATS})
+                    ->setAllowedInputTypes(5, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+                    ->setAllowedOutputTypes({ALL_FLOATS});
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/compression.h>
+
+#if NOT_EXCLUDED(OP_encode_adaptive)
+namespace sd {
+    namespace ops {
+        CUSTOM_OP_IMPL(encode_adaptive, 1, 2, true, 1, 0) {
+            auto x = INPUT_VARIABLE(0);
+            auto updated = OUTPUT_VARIABLE(0);
+            auto encoded = OUTPUT_NULLIFIED(1);
+
+            float threshold = T_ARG(0);
+
+            REQUIRE_TRUE(x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_adaptive: gradients array must have length <= MAX_INT");
+            REQUIRE_TRUE(encoded->lengthOf() >= 6, 0, "encode_adaptive: array for encoded updates can't have less than 6 elements");
+
+            helpers::encodeAdaptive(block.launchContext(), x, encoded, threshold);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(encode_adaptive) {
+            auto x = INPUT_VARIABLE(0);
+            float threshold = T_ARG(0);
+
+            REQUIRE_TRUE(x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_adaptive: gradients array must have length <= MAX_INT");
+
+            // payload type of each chunk is picked here already, so the length is exact
+            auto length = helpers::adaptiveEncodedLength(block.launchContext(), x, threshold);
+
+            return SHAPELIST(x->shapeInfo(), sd::ConstantShapeHelper::getInstance().vectorShapeInfo(length, DataType::INT32));
+        }
+
+        DECLARE_TYPES(encode_adaptive) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {ALL_FLOATS})
+                    ->setAllowedOutputTypes(0, {ALL_FLOATS})
+                    ->setAllowedOutputTypes(1, DataType::INT32);
+        }
+    }
+}
+#endif
+
+#if NOT_EXCLUDED(OP_decode_adaptive)
+namespace sd {
+    namespace ops {
+        CUSTOM_OP_IMPL(decode_adaptive, 2, 1, true, 0, 0) {
+            auto weights = INPUT_VARIABLE(0);
+            auto encoded = INPUT_VARIABLE(1);
+            auto updates = OUTPUT_VARIABLE(0);
+
+            REQUIRE_TRUE(encoded->lengthOf() >= 6, 0, "decode_adaptive: encoded array can't have length < 6");
+            REQUIRE_TRUE(encoded->e<int>(3) == 2, 0, "decode_adaptive: encoded array doesn't look like adaptive-encoded");
+            REQUIRE_TRUE(updates->lengthOf() == encoded->e<int>(1), 0, "decode_adaptive: updates array must have length equal to [%i]", encoded->e<int>(1));
+
+            helpers::decodeAdaptive(block.launchContext(), encoded, updates);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(decode_adaptive) {
+            auto weights = inputShape->at(0);
+            return SHAPELIST(weights);
+        }
+
+        DECLARE_TYPES(decode_adaptive) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {ALL_FLOATS})
+                    ->setAllowedInputTypes(1, DataType::INT32)
+                    ->setAllowedOutputTypes(0, {ALL_FLOATS});
+        }
+    }
+}
+#endif
@@ -21,6 +21,8 @@
 #include <system/op_boilerplate.h>
 #include <ops/declarable/CustomOperations.h>
 #include <ops/declarable/helpers/threshold.h>
+#include <loops/type_conversions.h>
+#include <cstring>
 
 namespace sd {
     namespace ops {
@@ -31,15 +33,41 @@ namespace sd {
 
             float threshold = T_ARG(0);
 
-            REQUIRE_TRUE(x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_threshold: gradients array must have length <= MAX_INT");
-            REQUIRE_TRUE(encoded->lengthOf() >= 4, 0, "encode_threshold: array for encoded updates can't have less than 4 elements");
+            // encoded indices are int64 for arrays longer than MAX_INT, or if it was requested
+            const bool longIndices = x->lengthOf() > DataTypeUtils::max<int>() || (block.numB() > 0 && B_ARG(0));
 //            REQUIRE_TRUE(x->platformBuffer() == updated->platformBuffer(), 0, "encode_threshold: gradients array must be the same at input and output");
 
+            if (longIndices) {
+#ifdef __CUDABLAS__
+                REQUIRE_TRUE(false, 0, "encode_threshold: int64 indices aren't supported on CUDA yet");
+#endif
+                REQUIRE_TRUE(encoded->dataType() == DataType::INT64, 0, "encode_threshold: array for encoded updates must be INT64 for int64 indices");
+                REQUIRE_TRUE(encoded->lengthOf() >= THRESHOLD_LONG_HEADER / 2, 0, "encode_threshold: array for encoded updates can't have less than %i elements", THRESHOLD_LONG_HEADER / 2);
+
+                // header is made of int32 elements, length of original array goes to elements [4..5]
+                const Nd4jLong length = x->lengthOf();
+                auto header = encoded->bufferAsT<int>();
+                header[0] = static_cast<int>(encoded->lengthOf() * 2 - 4);
+                header[1] = length > DataTypeUtils::max<int>() ? 0 : static_cast<int>(length);
+                header[2] = reinterpret_cast<int *>(&threshold)[0];
+                header[3] = THRESHOLD_LONG_FLAG;
+                std::memcpy(header + 4, &length, sizeof(Nd4jLong));
+
+                if (encoded->lengthOf() == THRESHOLD_LONG_HEADER / 2)
+                    return Status::OK();
+
+                helpers::thresholdEncode(*x, *encoded, threshold);
+
+                return Status::OK();
+            }
+
+            REQUIRE_TRUE(encoded->lengthOf() >= 4, 0, "encode_threshold: array for encoded updates can't have less than 4 elements");
+
             // filling header bytes
             encoded->p(0, encoded->lengthOf() - 4);
             encoded->p(1, (int) x->lengthOf());
             encoded->p(2, reinterpret_cast<int *>(&threshold)[0]);
-            encoded->p(3, 0); // flag for FLEXIBLE_ENCODING
+            encoded->p(3, THRESHOLD_FLEXIBLE_FLAG);
 
             // if there's no updates to process - just skip execution
             if (encoded->lengthOf() == 4)
@@ -53,17 +81,25 @@ namespace sd {
         DECLARE_SHAPE_FN(encode_threshold) {
             auto x = INPUT_VARIABLE(0);
             // we have limit option here
-            int boundary = block.numI() > 0 ? I_ARG(0) : DataTypeUtils::max<int>();
+            Nd4jLong boundary = block.numI() > 0 ? I_ARG(0) : DataTypeUtils::max<int>();
             float threshold = T_ARG(0);
+            const bool longIndices = x->lengthOf() > DataTypeUtils::max<int>() || (block.numB() > 0 && B_ARG(0));
 
             REQUIRE_TRUE(boundary >= 0, 0, "encode_threshold: boundary must be positive");
-            REQUIRE_TRUE(x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_threshold: gradients array must have length <= MAX_INT");
 
             // we must calculate number of elements that >= threshold
-            auto elements = sd::math::nd4j_min<int>(helpers::thresholdEstimate(*x, threshold), boundary);
+            auto elements = sd::math::nd4j_min<Nd4jLong>(helpers::thresholdEstimate(*x, threshold), boundary);
             if (elements < 2)
                 elements = 0;
 
+            if (longIndices) {
+                // header[0] holds number of int32 elements after first 4 ones, so it must fit into int32 as well
+                elements = sd::math::nd4j_min<Nd4jLong>(elements, (DataTypeUtils::max<int>() - 2) / 2);
+
+                // result array must have 6 additional int32 elements for header, i.e. 3 int64 ones
+                return SHAPELIST(x->shapeInfo(), sd::ConstantShapeHelper::getInstance().vectorShapeInfo(elements + THRESHOLD_LONG_HEADER / 2, DataType::INT64));
+            }
+
             // result array must have 4 additional int elements for header
             return SHAPELIST(x->shapeInfo(), sd::ConstantShapeHelper::getInstance().vectorShapeInfo(elements + 4, DataType::INT32));
         }
@@ -72,7 +108,7 @@ namespace sd {
             getOpDescriptor()
                     ->setAllowedInputTypes(0, {ALL_FLOATS})
                     ->setAllowedOutputTypes(0, {ALL_FLOATS})
-                    ->setAllowedOutputTypes(1, DataType::INT32);
+                    ->setAllowedOutputTypes(1, {DataType::INT32, DataType::INT64});
         }
 
         CUSTOM_OP_IMPL(decode_threshold, 2, 1, true, 0, 0) {
@@ -80,9 +116,23 @@ namespace sd {
             auto encoded = INPUT_VARIABLE(1);
             auto updates = OUTPUT_VARIABLE(0);
 
-            REQUIRE_TRUE(encoded->lengthOf() >= 4, 0, "decode_threshold: encoded array can't have length < 4");
-            REQUIRE_TRUE(updates->lengthOf() == encoded->e<int>(1), 0, "decode_threshold: updates array must have length equal to [%i]", encoded->e<int>(1));
-            REQUIRE_TRUE(encoded->e<int>(3) == 0, 0, "decode_threshold: encoded array doesn't look like threshold-encoded");
+            if (encoded->dataType() == DataType::INT64) {
+#ifdef __CUDABLAS__
+                REQUIRE_TRUE(false, 0, "decode_threshold: int64 indices aren't supported on CUDA yet");
+#endif
+                REQUIRE_TRUE(encoded->lengthOf() >= THRESHOLD_LONG_HEADER / 2, 0, "decode_threshold: encoded array can't have length < %i", THRESHOLD_LONG_HEADER / 2);
+
+                auto header = encoded->bufferAsT<int>();
+                REQUIRE_TRUE(header[3] == THRESHOLD_LONG_FLAG, 0, "decode_threshold: encoded array doesn't look like threshold-encoded");
+
+                Nd4jLong length;
+                std::memcpy(&length, header + 4, sizeof(Nd4jLong));
+                REQUIRE_TRUE(updates->lengthOf() == length, 0, "decode_threshold: updates array must have length equal to [%lld]", length);
+            } else {
+                REQUIRE_TRUE(encoded->lengthOf() >= 4, 0, "decode_threshold: encoded array can't have length < 4");
+                REQUIRE_TRUE(updates->lengthOf() == encoded->e<int>(1), 0, "decode_threshold: updates array must have length equal to [%i]", encoded->e<int>(1));
+                REQUIRE_TRUE(encoded->e<int>(3) == THRESHOLD_FLEXIBLE_FLAG, 0, "decode_threshold: encoded array doesn't look like threshold-encoded");
+            }
 
             helpers::thresholdDecode(*encoded, *updates);
 
@@ -97,7 +147,7 @@ namespace sd {
         DECLARE_TYPES(decode_threshold) {
             getOpDescriptor()
                     ->setAllowedInputTypes(0, {ALL_FLOATS})
-                    ->setAllowedInputTypes(1, DataType::INT32)
+                    ->setAllowedInputTypes(1, {DataType::INT32, DataType::INT64})
                     ->setAllowedOutputTypes(0,{ALL_FLOATS});
         }
     }
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_knn_search)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/knn.h>
+
+namespace sd {
+    namespace ops {
+        CUSTOM_OP_IMPL(knn_search, 2, 2, false, 0, 1) {
+            auto data = INPUT_VARIABLE(0);
+            auto queries = INPUT_VARIABLE(1);
+
+            auto indices = OUTPUT_VARIABLE(0);
+            auto distances = OUTPUT_VARIABLE(1);
+
+            const int k = INT_ARG(0);
+            const int distance = block.getIArguments()->size() > 1 ? INT_ARG(1) : 0;
+
+            REQUIRE_TRUE(data->rankOf() == 2 && queries->rankOf() == 2, 0, "knn_search: data and queries must be matrices, but got ranks %i and %i instead !", data->rankOf(), queries->rankOf());
+            REQUIRE_TRUE(data->sizeAt(0) > 0, 0, "knn_search: data must have at least one row");
+            REQUIRE_TRUE(data->sizeAt(1) == queries->sizeAt(1), 0, "knn_search: data and queries must have the same number of columns, but got %i and %i instead !", (int) data->sizeAt(1), (int) queries->sizeAt(1));
+            REQUIRE_TRUE(data->dataType() == queries->dataType() && data->dataType() == distances->dataType(), 0, "knn_search: data, queries and distances must have the same data type");
+            REQUIRE_TRUE(k > 0, 0, "knn_search: number of neighbours must be positive, but got %i instead !", k);
+            REQUIRE_TRUE(distance >= 0 && distance <= 2, 0, "knn_search: distance must be 0 (euclidean), 1 (cosine) or 2 (manhattan), but got %i instead !", distance);
+
+            if (queries->sizeAt(0) > 0)
+                helpers::knn_search(*data, *queries, k, distance, *indices, *distances);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(knn_search) {
+            auto queries = inputShape->at(1);
+            const Nd4jLong k = INT_ARG(0);
+
+            auto indicesShape = ConstantShapeHelper::getInstance().createShapeInfo(DataType::INT64, 'c', {shape::sizeAt(queries, 0), k});
+            auto distancesShape = ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(0)), 'c', {shape::sizeAt(queries, 0), k});
+            return SHAPELIST(indicesShape, distancesShape);
+        }
+
+        DECLARE_TYPES(knn_search) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes({ALL_FLOATS})
+                    ->setAllowedOutputTypes(0, {DataType::INT64})
+                    ->setAllowedOutputTypes(1, {ALL_FLOATS});
+        }
+
+        CUSTOM_OP_IMPL(knn_radius_search, 2, 3, false, 1, 1) {
+            auto data = INPUT_VARIABLE(0);
+            auto queries = INPUT_VARIABLE(1);
+
+            auto indices = OUTPUT_VARIABLE(0);
+            auto distances = OUTPUT_VARIABLE(1);
+            auto counts = OUTPUT_VARIABLE(2);
+
+            const double radius = T_ARG(0);
+            const int maxResults = INT_ARG(0);
+            const int distance = block.getIArguments()->size() > 1 ? INT_ARG(1) : 0;
+
+            REQUIRE_TRUE(data->rankOf() == 2 && queries->rankOf() == 2, 0, "knn_radius_search: data and queries must be matrices, but got ranks %i and %i instead !", data->rankOf(), queries->rankOf());
+            REQUIRE_TRUE(data->sizeAt(0) > 0, 0, "knn_radius_search: data must have at least one row");
+            REQUIRE_TRUE(data->sizeAt(1) == queries->sizeAt(1), 0, "knn_radius_search: data and queries must have the same number of columns, but got %i and %i instead !", (int) data->sizeAt(1), (int) queries->sizeAt(1));
+            REQUIRE_TRUE(data->dataType() == queries->dataType() && data->dataType() == distances->dataType(), 0, "knn_radius_search: data, queries and distances must have the same data type");
+            REQUIRE_TRUE(radius >= 0., 0, "knn_radius_search: radius can't be negative, but got %f instead !", radius);
+            REQUIRE_TRUE(maxResults > 0, 0, "knn_radius_search: max number of results must be positive, but got %i instead !", maxResults);
+            REQUIRE_TRUE(distance >= 0 && distance <= 2, 0, "knn_radius_search: distance must be 0 (euclidean), 1 (cosine) or 2 (manhattan), but got %i instead !", distance);
+
+            if (queries->sizeAt(0) > 0)
+                helpers::knn_radius_search(*data, *queries, radius, maxResults, distance, *indices, *distances, *counts);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(knn_radius_search) {
+            auto queries = inputShape->at(1);
+            const Nd4jLong maxResults = INT_ARG(0);
+
+            auto indicesShape = ConstantShapeHelper::getInstance().createShapeInfo(DataType::INT64, 'c', {shape::sizeAt(queries, 0), maxResults});
+            auto distancesShape = ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(0)), 'c', {shape::sizeAt(queries, 0), maxResults});
+            auto countsShape = ConstantShapeHelper::getInstance().vectorShapeInfo(shape::sizeAt(queries, 0), DataType::INT64);
+            return SHAPELIST(indicesShape, distancesShape, countsShape);
+        }
+
+        DECLARE_TYPES(knn_radius_search) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes({ALL_FLOATS})
+                    ->setAllowedOutputTypes(0, {DataType::INT64})
+                    ->setAllowedOutputTypes(1, {ALL_FLOATS})
+                    ->setAllowedOutputTypes(2, {DataType::INT64});
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_quantized_conv2d)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/convolutions.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+namespace ops  {
+
+
+CUSTOM_OP_IMPL(quantized_conv2d, 6, 1, false, 0, 9) {
+
+    auto input      = INPUT_VARIABLE(0);                                    // [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW)
+    auto inScale    = INPUT_VARIABLE(1);                                    // scalar
+    auto inZero     = INPUT_VARIABLE(2);                                    // scalar
+    auto weights    = INPUT_VARIABLE(3);                                    // [kH, kW, iC, oC], [oC, iC, kH, kW], [oC, kH, kW, iC]
+    auto wScale     = INPUT_VARIABLE(4);                                    // scalar or [oC]
+    auto wZero      = INPUT_VARIABLE(5);                                    // scalar or [oC]
+    auto bias       = block.width() > 6 ? INPUT_VARIABLE(6) : nullptr;      // [oC]
+
+    auto output  = OUTPUT_VARIABLE(0);                                      // [bS, oH, oW, oC] (NHWC) or [bS, oC, oH, oW] (NCHW)
+
+    int sH = INT_ARG(2);                                                        // strides height
+    int sW = INT_ARG(3);                                                        // strides width
+    int pH = INT_ARG(4);                                                        // paddings height
+    int pW = INT_ARG(5);                                                        // paddings width
+    int dH = INT_ARG(6);                                                        // dilations height
+    int dW = INT_ARG(7);                                                        // dilations width
+    int paddingMode = INT_ARG(8);                                               // 0-VALID, 1-SAME, 2-CAUSAL
+    int isNCHW  = block.getIArguments()->size() > 9  ? !INT_ARG(9) : 1;         // INT_ARG(9): 0-NCHW,  1-NHWC
+    int wFormat = block.getIArguments()->size() > 10 ? INT_ARG(10) : 0;         // 0 - [kH, kW, iC, oC], 1 - [oC, iC, kH, kW], 2 - [oC, kH, kW, iC]
+
+    int kH = INT_ARG(0) > 0 ? INT_ARG(0) : static_cast<int>(weights->sizeAt(0)); // filter(kernel) height
+    int kW = INT_ARG(1) > 0 ? INT_ARG(1) : static_cast<int>(weights->sizeAt(1)); // filter(kernel) width
+
+    int bS, iC, iH, iW, oC, oH, oW;                             // batch size, input channels, input height/width, output channels, output height/width;
+    int indIOioC, indIiH, indWoC, indWiC, indWkH, indOoH;       // corresponding indexes
+    ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, *input, *output, bS, iC, iH, iW, oC, oH, oW, indIOioC, indIiH, indWiC, indWoC, indWkH, indOoH);
+
+    std::vector<Nd4jLong> expectedWeightsShape = ConvolutionUtils::expectWeightsShape(wFormat, kH, kW, iC, oC);
+    REQUIRE_TRUE(weights->isSameShape(expectedWeightsShape), 0, "CUSTOM QUANTIZED_CONV2D OP: wrong shape of weights array, expected is %s, but got %s instead !", ShapeUtils::shapeAsString(expectedWeightsShape).c_str(), ShapeUtils::shapeAsString(weights).c_str());
+    if (bias)
+        REQUIRE_TRUE(bias->rankOf() <= 2 && oC == bias->lengthOf(), 0, "CUSTOM QUANTIZED_CONV2D OP: wrong shape of array with biases, expected rank, length: <=2, %i, but got %i, %i instead !", oC, bias->rankOf(), bias->lengthOf());
+
+    REQUIRE_TRUE(inScale->lengthOf() == 1 && inZero->lengthOf() == 1, 0, "CUSTOM QUANTIZED_CONV2D OP: scale and zero point of input must be scalars !");
+    REQUIRE_TRUE((wScale->lengthOf() == 1 || wScale->lengthOf() == oC) && wZero->lengthOf() == wScale->lengthOf(), 0, "CUSTOM QUANTIZED_CONV2D OP: scale and zero point of weights must be scalars or vectors of length %i !", oC);
+
+    ConvolutionUtils::calcPadding2D(pH, pW, oH, oW, iH, iW, kH, kW, sH, sW, dH, dW, paddingMode);
+
+    // helper works with NHWC input/output and [kH, kW, iC, oC] weights, other layouts are passed as permuted views
+    NDArray inputNHWC, outputNHWC, weightsHWIO;
+    if (isNCHW) {
+        inputNHWC = input->permute({0, 2, 3, 1});
+        outputNHWC = output->permute({0, 2, 3, 1});
+        input = &inputNHWC;
+        output = &outputNHWC;
+    }
+
+    if (wFormat == 1) {
+        weightsHWIO = weights->permute({2, 3, 1, 0});
+        weights = &weightsHWIO;
+    } else if (wFormat == 2) {
+        weightsHWIO = weights->permute({1, 2, 3, 0});
+        weights = &weightsHWIO;
+    }
+
+    helpers::quantizedConv2d(block.launchContext(), *input, *inScale, *inZero, *weights, *wScale, *wZero, bias, *output, kH, kW, sH, sW, pH, pW, dH, dW);
+
+    return Status::OK();
+}
+
+
+DECLARE_SHAPE_FN(quantized_conv2d) {
+
+    auto inputShapeInfo   = inputShape->at(0);                                  // [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW)
+    auto weightsShapeInfo = inputShape->at(3);                                  // [kH, kW, iC, oC], [oC, iC, kH, kW], [oC, kH, kW, iC]
+
+    int sH = INT_ARG(2);                                                        // strides height
+    int sW = INT_ARG(3);                                                        // strides width
+    int pH = INT_ARG(4);                                                        // paddings height
+    int pW = INT_ARG(5);                                                        // paddings width
+    int dH = INT_ARG(6);                                                        // dilations height
+    int dW = INT_ARG(7);                                                        // dilations width
+    int paddingMode = INT_ARG(8);                                               // 0-VALID, 1-SAME, 2-CAUSAL
+    int isNCHW  = block.getIArguments()->size() > 9 ? !INT_ARG(9) : 1;          // INT_ARG(9): 0-NCHW, 1-NHWC
+    int wFormat = block.getIArguments()->size() > 10 ? INT_ARG(10) : 0;         // 0 - [kH, kW, iC, oC], 1 - [oC, iC, kH, kW], 2 - [oC, kH, kW, iC]
+
+    int kH = INT_ARG(0) > 0 ? INT_ARG(0) : static_cast<int>(shape::sizeAt(weightsShapeInfo, 0)); // filter(kernel) height
+    int kW = INT_ARG(1) > 0 ? INT_ARG(1) : static_cast<int>(shape::sizeAt(weightsShapeInfo, 1)); // filter(kernel) width
+
+    const int rank = 4;
+    REQUIRE_TRUE(inputShapeInfo[0]   == rank, 0, "CUSTOM QUANTIZED_CONV2D OP: rank of input array must be equal to %i, but got %i instead !", rank, inputShapeInfo[0]);
+    REQUIRE_TRUE(weightsShapeInfo[0] == rank, 0, "CUSTOM QUANTIZED_CONV2D OP: rank of weights array must be equal to %i, but got %i instead !", rank, weightsShapeInfo[0]);
+
+    const int indIOioC = isNCHW ? 1 : 3;
+    const int indIiH = isNCHW ? 2 : 1;
+    const int indWoC = 0 == wFormat ? 3 : 0;
+
+    const Nd4jLong bS = inputShapeInfo[1];                       // batch size
+    const int iH = inputShapeInfo[indIiH+1];                     // input height
+    const int iW = inputShapeInfo[indIiH+2];                     // input width
+    const Nd4jLong oC = weightsShapeInfo[indWoC+1];              // output channels
+
+    int oH, oW;                                                  // output height, width
+    ConvolutionUtils::calcOutSizePool2D(oH, oW, kH, kW, sH, sW, pH, pW, dH, dW, iH, iW, paddingMode);
+
+    std::vector<Nd4jLong> shape = isNCHW ? std::vector<Nd4jLong>({bS, oC, oH, oW}) : std::vector<Nd4jLong>({bS, oH, oW, oC});
+
+    // output has data type of scales
+    return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(1)), 'c', shape));
+}
+
+DECLARE_TYPES(quantized_conv2d) {
+    getOpDescriptor()
+            ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+            ->setAllowedInputTypes(1, {ALL_FLOATS})
+            ->setAllowedInputTypes(2, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+            ->setAllowedInputTypes(3, {sd::DataType::INT8, sd::DataType::UINT8})
+            ->setAllowedInputTypes(4, {ALL_FLOATS})
+            ->setAllowedInputTypes(5, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+            ->setAllowedInputTypes(6, {ALL_FLOATS})
+            ->setAllowedOutputTypes({ALL_FLOATS});
+}
+
+}
+}
+
+#endif
@@ -22,7 +22,7 @@
 #if NOT_EXCLUDED(OP_dot_product_attention)
 
 #include <ops/declarable/CustomOperations.h>
-#include <ops/declarable/helpers/reverse.h>
+#include <ops/declarable/helpers/attention.h>
 
 
 namespace sd {
@@ -35,15 +35,7 @@ namespace ops  {
         auto mask    = block.width() > 3 ? INPUT_VARIABLE(3) : nullptr;
 
         auto output = OUTPUT_VARIABLE(0);
-        NDArray* weights;
         bool outputWeights = INT_ARG(1);
-        if(outputWeights){
-            weights = OUTPUT_VARIABLE(1);
-        }else{
-            auto weightShape = ShapeUtils::evalShapeForMatmul(keys->shapeInfo(), queries->shapeInfo(), true, false);
-            weights = new NDArray('c', weightShape, values->dataType(), block.launchContext());
-        }
-
         int normalization = INT_ARG(0);
 
         REQUIRE_TRUE(queries->rankOf() == keys->rankOf() && keys->rankOf() == values->rankOf(), 0,
@@ -67,6 +59,20 @@ namespace ops  {
                 "dot_product_attention: Keys and Values must have the same timestep length. "
                 "But got keys = %i, values = %i", keys->sizeAt(-1), values->sizeAt(-1));
 
+        // fused kernel streams softmax over blocks of keys, so weights matrix is only built when it's requested
+        if (!outputWeights && queries->dataType() == output->dataType() && keys->dataType() == output->dataType() && values->dataType() == output->dataType()) {
+            helpers::dotProductAttention(block.launchContext(), *queries, *keys, *values, mask, normalization, *output);
+            return Status::OK();
+        }
+
+        NDArray* weights;
+        if(outputWeights){
+            weights = OUTPUT_VARIABLE(1);
+        }else{
+            auto weightShape = ShapeUtils::evalShapeForMatmul(keys->shapeInfo(), queries->shapeInfo(), true, false);
+            weights = new NDArray('c', weightShape, values->dataType(), block.launchContext());
+        }
+
         sd::ops::matmul mmul;
         mmul.execute({keys, queries}, {weights}, {}, {1}, {});
         if(normalization) {
@@ -159,6 +165,11 @@ namespace ops  {
                      "dot_product_attention: Keys and Values must have the same timestep length. "
                      "But got keys = %i, values = %i", keys->sizeAt(-1), values->sizeAt(-1));
 
+        if (queries->dataType() == dLdq->dataType() && keys->dataType() == dLdq->dataType() && values->dataType() == dLdq->dataType() && eps->dataType() == dLdq->dataType() &&
+            dLdk->dataType() == dLdq->dataType() && dLdv->dataType() == dLdq->dataType()) {
+            helpers::dotProductAttentionBp(block.launchContext(), *queries, *keys, *values, *eps, mask, normalization, *dLdq, *dLdk, *dLdv);
+            return Status::OK();
+        }
 
         double factor;
         if(normalization)
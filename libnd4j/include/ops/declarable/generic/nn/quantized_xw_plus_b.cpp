@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_quantized_xw_plus_b)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+    namespace ops {
+        CUSTOM_OP_IMPL(quantized_xw_plus_b, 7, 1, false, 0, 0) {
+            auto x = INPUT_VARIABLE(0);
+            auto xScale = INPUT_VARIABLE(1);
+            auto xZeroPoint = INPUT_VARIABLE(2);
+            auto wScale = INPUT_VARIABLE(4);
+            auto wZeroPoint = INPUT_VARIABLE(5);
+            auto b = INPUT_VARIABLE(6);
+            auto z = OUTPUT_VARIABLE(0);
+
+            if (x->isEmpty() || INPUT_VARIABLE(3)->isEmpty() || b->isEmpty())
+                return Status::OK();
+
+            const bool bTranspose = block.getIArguments()->size() > 0 ? INT_ARG(0) == 1 : false;
+            auto w = INPUT_VARIABLE(3);
+            NDArray transposed;
+            if (bTranspose) {
+                transposed = w->transpose();
+                w = &transposed;
+            }
+
+            REQUIRE_TRUE(x->rankOf() == 2, 0, "quantized_xw_plus_b: Input x array should have rank equal 2, but got instead %i!", x->rankOf());
+            REQUIRE_TRUE(w->rankOf() == 2, 0, "quantized_xw_plus_b: Input weights array should have rank equal 2, but got instead %i!", w->rankOf());
+            REQUIRE_TRUE(x->sizeAt(1) == w->sizeAt(0), 0, "quantized_xw_plus_b: Input arrays have inconsistent shapes: x %s, w %s", ShapeUtils::shapeAsString(x).c_str(), ShapeUtils::shapeAsString(w).c_str());
+
+            REQUIRE_TRUE(1 == b->rankOf() && b->lengthOf() == z->sizeAt(-1), 0, "quantized_xw_plus_b: Input bias vector should be 1D and have proper dimension 1x%i."
+                " But got rank %i, and got length %i instead %i.", z->sizeAt(-1), b->rankOf(), b->lengthOf(), z->sizeAt(-1));
+
+            REQUIRE_TRUE(xScale->lengthOf() == 1 && xZeroPoint->lengthOf() == 1, 0, "quantized_xw_plus_b: scale and zero point of x must be scalars");
+            REQUIRE_TRUE((wScale->lengthOf() == 1 || wScale->lengthOf() == z->sizeAt(-1)) && wZeroPoint->lengthOf() == wScale->lengthOf(), 0, "quantized_xw_plus_b: scale and zero point of weights must be scalars or vectors of length %i", (int) z->sizeAt(-1));
+
+            // bias is added while int32 accumulators are converted to output
+            helpers::quantizedMatmul(block.launchContext(), *x, *xScale, *xZeroPoint, *w, *wScale, *wZeroPoint, b, *z);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantized_xw_plus_b) {
+            auto xShapeInfo = inputShape->at(0);
+            auto wShapeInfo = inputShape->at(3);
+            const bool bTranspose = block.getIArguments()->size() > 0 ? INT_ARG(0) == 1 : false;
+
+            std::vector<Nd4jLong> shape = {shape::sizeAt(xShapeInfo, 0), shape::sizeAt(wShapeInfo, bTranspose ? 0 : 1)};
+
+            // output has data type of scales
+            return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(1)), 'c', shape));
+        }
+
+        DECLARE_TYPES(quantized_xw_plus_b) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+                    ->setAllowedInputTypes(3, {sd::DataType::INT8, sd::DataType::UINT8})
+                    ->setAllowedInputTypes(4, {ALL_FLOATS})
+                    ->setAllowedInputTypes(5, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+                    ->setAllowedInputTypes(6, {ALL_FLOATS})
+                    ->setAllowedOutputTypes({ALL_FLOATS});
+        }
+    }
+}
+
+#endif
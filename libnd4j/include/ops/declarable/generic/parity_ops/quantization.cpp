@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+#include <array/DataTypeUtils.h>
+
+namespace sd {
+    namespace ops {
+#if NOT_EXCLUDED(OP_quantize_linear)
+        CUSTOM_OP_IMPL(quantize_linear, 3, 1, false, 0, 0) {
+            auto input = INPUT_VARIABLE(0);
+            auto scale = INPUT_VARIABLE(1);
+            auto zeroPoint = INPUT_VARIABLE(2);
+            auto output = OUTPUT_VARIABLE(0);
+
+            REQUIRE_TRUE(scale->lengthOf() == 1 || scale->lengthOf() == input->sizeAt(-1), 0, "quantize_linear: scale must be scalar or have length of last dimension %i, but got %i", (int) input->sizeAt(-1), (int) scale->lengthOf());
+            REQUIRE_TRUE(zeroPoint->lengthOf() == scale->lengthOf(), 0, "quantize_linear: zero point must have the same length as scale, but got %i vs %i", (int) zeroPoint->lengthOf(), (int) scale->lengthOf());
+
+            const int quantMin = output->dataType() == sd::DataType::INT8 ? -128 : 0;
+            const int quantMax = output->dataType() == sd::DataType::INT8 ? 127 : 255;
+
+            helpers::quantizeLinear(block.launchContext(), *input, *scale, *zeroPoint, quantMin, quantMax, *output);
+
+            return Status::OK();
+        }
+
+        // output has data type of zero point
+        DECLARE_SHAPE_FN(quantize_linear) {
+            return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(2)), inputShape->at(0)));
+        }
+
+        DECLARE_TYPES(quantize_linear) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {ALL_FLOATS})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {sd::DataType::INT8, sd::DataType::UINT8})
+                    ->setAllowedOutputTypes({sd::DataType::INT8, sd::DataType::UINT8});
+        }
+#endif
+
+#if NOT_EXCLUDED(OP_dequantize_linear)
+        CUSTOM_OP_IMPL(dequantize_linear, 3, 1, false, 0, 0) {
+            auto input = INPUT_VARIABLE(0);
+            auto scale = INPUT_VARIABLE(1);
+            auto zeroPoint = INPUT_VARIABLE(2);
+            auto output = OUTPUT_VARIABLE(0);
+
+            REQUIRE_TRUE(scale->lengthOf() == 1 || scale->lengthOf() == input->sizeAt(-1), 0, "dequantize_linear: scale must be scalar or have length of last dimension %i, but got %i", (int) input->sizeAt(-1), (int) scale->lengthOf());
+            REQUIRE_TRUE(zeroPoint->lengthOf() == scale->lengthOf(), 0, "dequantize_linear: zero point must have the same length as scale, but got %i vs %i", (int) zeroPoint->lengthOf(), (int) scale->lengthOf());
+
+            helpers::dequantizeLinear(block.launchContext(), *input, *scale, *zeroPoint, *output);
+
+            return Status::OK();
+        }
+
+        // output has data type of scale
+        DECLARE_SHAPE_FN(dequantize_linear) {
+            return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(1)), inputShape->at(0)));
+        }
+
+        DECLARE_TYPES(dequantize_linear) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+                    ->setAllowedOutputTypes({ALL_FLOATS});
+        }
+#endif
+
+#if NOT_EXCLUDED(OP_quantize_with_min_max_vars)
+        CUSTOM_OP_IMPL(quantize_with_min_max_vars, 1, 3, false, 0, 0) {
+            auto x = INPUT_VARIABLE(0);
+
+            REQUIRE_TRUE(block.width() == 3 || block.getTArguments()->size() == 2, 0, "quantize_with_min_max_vars: No minimum/maximum values provided by either input arrays or TArgs");
+
+            auto output = OUTPUT_VARIABLE(0);
+            auto scale = OUTPUT_VARIABLE(1);
+            auto zeroPoint = OUTPUT_VARIABLE(2);
+
+            const int numBits = block.getIArguments()->size() > 0 ? INT_ARG(0) : 8;
+            const bool narrowed = block.getBArguments()->size() > 0 ? B_ARG(0) : false;
+            REQUIRE_TRUE(numBits > 1 && numBits < 9, 0, "quantize_with_min_max_vars: Number of bits for quantization should be in between 2 and 8, but %i was given.", numBits);
+
+            const Nd4jLong channels = block.width() == 3 ? INPUT_VARIABLE(1)->lengthOf() : 1;
+            REQUIRE_TRUE(channels == 1 || channels == x->sizeAt(-1), 0, "quantize_with_min_max_vars: min and max must be scalars or have length of last dimension %i, but got %i", (int) x->sizeAt(-1), (int) channels);
+
+            // scale and zero point are nudged exactly as fake_quant_with_min_max_vars does, so dequantized values match its output.
+            // narrow range is symmetric, so it's shifted into signed range: [1, 2^bits - 1] -> [-(2^(bits-1) - 1), 2^(bits-1) - 1]
+            const int quantMin = narrowed ? 1 : 0;
+            const int quantMax = (1 << numBits) - 1;
+            const int shift = narrowed ? 1 << (numBits - 1) : 0;
+            for (Nd4jLong c = 0; c < channels; c++) {
+                const double min = block.width() == 3 ? INPUT_VARIABLE(1)->e<double>(c) : T_ARG(0);
+                const double max = block.width() == 3 ? INPUT_VARIABLE(2)->e<double>(c) : T_ARG(1);
+                REQUIRE_TRUE(min < max, 0, "quantize_with_min_max_vars: min must be less than max, but got %f and %f", min, max);
+
+                const double s = (max - min) / (quantMax - quantMin);
+                const double zeroPointFromMin = quantMin - min / s;
+                const int zp = zeroPointFromMin < quantMin ? quantMin : zeroPointFromMin > quantMax ? quantMax : sd::math::nd4j_round<double, int>(zeroPointFromMin);
+
+                scale->p(c, s);
+                zeroPoint->p(c, zp - shift);
+            }
+
+            helpers::quantizeLinear(block.launchContext(), *x, *scale, *zeroPoint, quantMin - shift, quantMax - shift, *output);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantize_with_min_max_vars) {
+            auto dtype = ArrayOptions::dataType(inputShape->at(0));
+
+            // narrow range values are signed, see above
+            const bool narrowed = block.getBArguments()->size() > 0 ? B_ARG(0) : false;
+            auto qtype = narrowed ? sd::DataType::INT8 : sd::DataType::UINT8;
+            auto output = ConstantShapeHelper::getInstance().createShapeInfo(qtype, inputShape->at(0));
+
+            // per-channel parameters have shape of min, per-tensor ones are scalars
+            auto params = block.width() == 3 ? inputShape->at(1) : ConstantShapeHelper::getInstance().scalarShapeInfo(dtype);
+
+            return SHAPELIST(output, ConstantShapeHelper::getInstance().createShapeInfo(dtype, params), ConstantShapeHelper::getInstance().createShapeInfo(qtype, params));
+        }
+
+        DECLARE_TYPES(quantize_with_min_max_vars) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes({ALL_FLOATS})
+                    ->setAllowedOutputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+                    ->setAllowedOutputTypes(1, {ALL_FLOATS})
+                    ->setAllowedOutputTypes(2, {sd::DataType::INT8, sd::DataType::UINT8});
+        }
+#endif
+    }
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_barnes_repulsive_forces)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/BarnesHutTsne.h>
+
+namespace sd {
+namespace ops  {
+
+    CUSTOM_OP_IMPL(barnes_repulsive_forces, 1, 2, false, -1, 0) {
+        auto data = INPUT_VARIABLE(0);
+        auto theta = block.getTArguments()->size() > 0 ? T_ARG(0) : 0.5;
+
+        auto output = OUTPUT_VARIABLE(0);
+        auto sumQ = OUTPUT_VARIABLE(1);
+
+        REQUIRE_TRUE(data->rankOf() == 2, 0, "barnes_repulsive_forces: data must be a matrix, but its rank is %i instead !", data->rankOf());
+        REQUIRE_TRUE(data->sizeAt(0) > 0, 0, "barnes_repulsive_forces: data must have at least one row");
+        REQUIRE_TRUE(data->sizeAt(1) > 0 && data->sizeAt(1) <= 64, 0, "barnes_repulsive_forces: number of columns must be in range [1, 64], but got %i instead !", (int) data->sizeAt(1));
+        REQUIRE_TRUE(theta >= 0., 0, "barnes_repulsive_forces: theta can't be negative, but got %f instead !", theta);
+        REQUIRE_TRUE(output->dataType() == data->dataType() && sumQ->dataType() == data->dataType(), 0, "barnes_repulsive_forces: data type of outputs must be the same as data type of input");
+
+        helpers::barnes_repulsive_forces(*data, theta, *output, *sumQ);
+
+        return Status::OK();
+    }
+
+    DECLARE_TYPES(barnes_repulsive_forces) {
+        getOpDescriptor()
+        ->setAllowedInputTypes(0, {ALL_FLOATS})
+        ->setAllowedOutputTypes(0, {ALL_FLOATS})
+        ->setAllowedOutputTypes(1, {ALL_FLOATS})
+        ->setSameMode(true);
+    }
+
+    DECLARE_SHAPE_FN(barnes_repulsive_forces) {
+        auto dataShapeInfo = inputShape->at(0);
+        // helper writes forces row by row, so output is 'c' whatever order input has
+        auto outShapeInfo = ShapeBuilders::createShapeInfo(ArrayOptions::dataType(dataShapeInfo), 'c', {shape::sizeAt(dataShapeInfo, 0), shape::sizeAt(dataShapeInfo, 1)}, block.getWorkspace());
+        auto sumShapeInfo = ShapeBuilders::createScalarShapeInfo(ArrayOptions::dataType(dataShapeInfo), block.getWorkspace());
+        return SHAPELIST(CONSTANT(outShapeInfo), CONSTANT(sumShapeInfo));
+    }
+
+}
+}
+
+#endif
@@ -95,6 +95,26 @@ namespace sd {
         DECLARE_CUSTOM_OP(cell_contains, 3, 1, false, 0, 1);
         #endif
 
+        /**
+         * This operation computes repulsive t-SNE forces with Barnes-Hut approximation:
+         * quadtree (octree for 3D data) is built over the points, and cells that are small enough
+         * relative to their distance from the point are used as a single point.
+         * Gradient of t-SNE is then computed as edge forces minus these forces divided by sumQ
+         *
+         * Expected input:
+         * 0: 2D float-point matrix with points, one per row
+         *
+         * T args:
+         * 0: theta, optional - accuracy/speed trade-off, 0 means exact computation. Default value is 0.5
+         *
+         * Output:
+         * 0: 2D matrix with the same shape and type as input, unnormalized repulsive forces
+         * 1: scalar with sum of q_ij over all pairs of points
+         */
+        #if NOT_EXCLUDED(OP_barnes_repulsive_forces)
+        DECLARE_CUSTOM_OP(barnes_repulsive_forces, 1, 2, false, -1, 0);
+        #endif
+
     }
 }
 
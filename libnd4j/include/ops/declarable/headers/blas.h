@@ -46,6 +46,24 @@ namespace sd {
         DECLARE_CUSTOM_OP(matmul_bp, 3, 2, false, 0, -2);
         #endif
 
+        /**
+         * This op is matmul of quantized arrays: products are accumulated in int32 and scaled to floating point output
+         * Expected inputs:
+         * 0: INT8/UINT8 x, with rank 2 or more
+         * 1: scalar scale of x
+         * 2: scalar zero point of x
+         * 3: INT8/UINT8 y, with the same rank as x
+         * 4: scale of y, scalar or vector with one value per output column
+         * 5: zero point of y, same shape as its scale
+         *
+         * Optional Integer arguments:
+         * 0: transA
+         * 1: transB
+         */
+        #if NOT_EXCLUDED(OP_quantized_matmul)
+        DECLARE_CUSTOM_OP(quantized_matmul, 6, 1, false, 0, 0);
+        #endif
+
         /**
          * tensorMmul/tensorDot operation
          * takes 2 ndarrays, and 2 sets of axes
@@ -54,8 +54,62 @@ namespace sd {
         #endif
 
 
+        /**
+         * encode_threshold - encodes updates >= threshold by absolute value as list of their indices,
+         * and subtracts encoded part from input
+         *
+         * Input:
+         *      0 - float updates array
+         *
+         * T args:
+         *      0 - threshold
+         *
+         * I args:
+         *      0 - optional, max number of encoded updates
+         *
+         * B args:
+         *      0 - optional, use int64 indices even for arrays with length <= MAX_INT
+         *
+         * Output:
+         *      0 - residual updates (input is updated in place)
+         *      1 - INT32 vector with encoded updates, or INT64 vector if input length > MAX_INT or B arg is set.
+         *          In both cases header is made of int32 elements, see TypeCast::convertToThreshold()
+         */
         DECLARE_CUSTOM_OP(encode_threshold, 2, 1, true, 1, 0);
         DECLARE_CUSTOM_OP(decode_threshold, 2, 1, true, 0, 0);
+
+        /**
+         * encode_adaptive - encodes updates >= threshold by absolute value, and subtracts encoded part from input.
+         * Input is split into chunks, and each chunk is stored as bitmap, list of indices or delta+varint compressed
+         * list of indices, whichever is smaller for its density. Decoded result is the same for all of them.
+         *
+         * Input:
+         *      0 - float updates array, N <= MAX_INT
+         *
+         * T args:
+         *      0 - threshold
+         *
+         * Output:
+         *      0 - residual updates (input is updated in place)
+         *      1 - INT32 vector with encoded updates
+         */
+        #if NOT_EXCLUDED(OP_encode_adaptive)
+        DECLARE_CUSTOM_OP(encode_adaptive, 1, 2, true, 1, 0);
+        #endif
+
+        /**
+         * decode_adaptive - adds updates encoded by encode_adaptive to the array
+         *
+         * Input:
+         *      0 - float array to apply updates to
+         *      1 - INT32 vector with encoded updates
+         *
+         * Output:
+         *      0 - updated array
+         */
+        #if NOT_EXCLUDED(OP_decode_adaptive)
+        DECLARE_CUSTOM_OP(decode_adaptive, 2, 1, true, 0, 0);
+        #endif
     }
 }
 
@@ -68,6 +68,23 @@ namespace sd {
         DECLARE_CUSTOM_OP(conv2d_input_bp, 3, 1, false, 0, 9);
         #endif
 
+        /**
+         * 2D convolution of quantized input and weights, products are accumulated in int32
+         * Expected input:
+         * 0: INT8/UINT8 x, 4D array
+         * 1: scalar scale of x
+         * 2: scalar zero point of x
+         * 3: INT8/UINT8 weights, 4D array
+         * 4: scale of weights, scalar or vector of length outputChannels
+         * 5: zero point of weights, same shape as its scale
+         * 6: bias, optional vector of length outputChannels
+         *
+         * IntArgs are the same as for conv2d
+         */
+        #if NOT_EXCLUDED(OP_quantized_conv2d)
+        DECLARE_CUSTOM_OP(quantized_conv2d, 6, 1, false, 0, 9);
+        #endif
+
         /**
          * Depthwise convolution2d op:
          * Expected inputs:
@@ -28,6 +28,48 @@ namespace sd {
     #if NOT_EXCLUDED(OP_knn_mindistance)
         DECLARE_CUSTOM_OP(knn_mindistance, 3, 1, false, 0, 0);
     #endif
+
+    /**
+     * This operation builds VP-tree over rows of data, and finds k nearest rows for each query
+     *
+     * Expected input:
+     * 0: 2D float-point matrix with data points, one per row
+     * 1: 2D float-point matrix with queries, with the same number of columns and type as data
+     *
+     * Int args:
+     * 0: k - number of neighbours
+     * 1: distance, optional - 0 for euclidean (default), 1 for cosine, 2 for manhattan
+     *
+     * Output:
+     * 0: INT64 matrix [numQueries, k] with indices of neighbours, sorted by distance. Missing neighbours get -1
+     * 1: matrix [numQueries, k] with distances to neighbours. Missing neighbours get infinity
+     */
+    #if NOT_EXCLUDED(OP_knn_search)
+        DECLARE_CUSTOM_OP(knn_search, 2, 2, false, 0, 1);
+    #endif
+
+    /**
+     * This operation builds VP-tree over rows of data, and finds rows within given radius of each query
+     *
+     * Expected input:
+     * 0: 2D float-point matrix with data points, one per row
+     * 1: 2D float-point matrix with queries, with the same number of columns and type as data
+     *
+     * T args:
+     * 0: radius
+     *
+     * Int args:
+     * 0: max number of results per query, nearest ones are kept
+     * 1: distance, optional - 0 for euclidean (default), 1 for cosine, 2 for manhattan
+     *
+     * Output:
+     * 0: INT64 matrix [numQueries, maxResults] with indices of found rows, sorted by distance and padded with -1
+     * 1: matrix [numQueries, maxResults] with distances to found rows, padded with infinity
+     * 2: INT64 vector [numQueries] with number of rows found for each query
+     */
+    #if NOT_EXCLUDED(OP_knn_radius_search)
+        DECLARE_CUSTOM_OP(knn_radius_search, 2, 3, false, 1, 1);
+    #endif
     }
 }
 
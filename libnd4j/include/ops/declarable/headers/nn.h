@@ -200,6 +200,9 @@ namespace sd {
          * Note: keys and values usually is the same array. If you want to use it as the same array, simply pass it for
          * both.
          *
+         * Note: when weights aren't requested, fused kernel is used: keys are processed in blocks with online softmax,
+         * so weights matrix isn't allocated and memory use is linear in timesteps. Backprop op does the same.
+         *
          * Expected arguments:
          * q: input 3D array "queries" of shape [batchSize, featureKeys, queryCount] or 4D array of shape [batchSize, numHeads, featureKeys, queryCount]
          * k: input 3D array "keys" of shape [batchSize, featureKeys, timesteps] or 4D array of shape [batchSize, numHeads, featureKeys, timesteps]
@@ -901,6 +901,25 @@ namespace sd {
                 DECLARE_CUSTOM_OP(xw_plus_b_bp, 4, 3, false, 0, 0);
         #endif
 
+        /**
+         * quantized_xw_plus_b op - xw_plus_b over quantized x and weights, products are accumulated in int32
+         *
+         * input params:
+         *   0 - 2D INT8/UINT8 matrix x
+         *   1 - scalar scale of x
+         *   2 - scalar zero point of x
+         *   3 - 2D INT8/UINT8 matrix of weights
+         *   4 - scale of weights, scalar or vector with one value per output column
+         *   5 - zero point of weights, same shape as scale
+         *   6 - 1D floating point bias
+         * output value - 2D matrix of scale data type
+         * Int args:
+         *      0 - optional, if int arg == 1 weights are transposed
+         */
+        #if NOT_EXCLUDED(OP_quantized_xw_plus_b)
+                DECLARE_CUSTOM_OP(quantized_xw_plus_b, 7, 1, false, 0, 0);
+        #endif
+
         /**
          * This operation is missed due it simplicy.
          * Input and output params are the same after operation.
@@ -1904,6 +1923,60 @@ namespace sd {
                 DECLARE_CONFIGURABLE_OP(fake_quant_with_min_max_vars_per_channel, 3, 1, true, 0, -2);
         #endif
 
+        /**
+         * quantize_linear - q = clamp(floor(x / scale + 0.5) + zero_point), clamped to range of output data type
+         *
+         * input params:
+         *    0 - NDArray (input)
+         *    1 - scale, scalar or vector with one value per channel of last dimension
+         *    2 - INT8/UINT8 zero point, same shape as scale. Output has its data type
+         *
+         * output:
+         *    0 - INT8/UINT8 NDArray with the same shape as input
+         */
+        #if NOT_EXCLUDED(OP_quantize_linear)
+        DECLARE_CUSTOM_OP(quantize_linear, 3, 1, false, 0, 0);
+        #endif
+
+        /**
+         * dequantize_linear - x = (q - zero_point) * scale
+         *
+         * input params:
+         *    0 - INT8/UINT8 NDArray (input)
+         *    1 - scale, scalar or vector with one value per channel of last dimension
+         *    2 - zero point, same shape as scale
+         *
+         * output:
+         *    0 - NDArray of scale data type, with the same shape as input
+         */
+        #if NOT_EXCLUDED(OP_dequantize_linear)
+        DECLARE_CUSTOM_OP(dequantize_linear, 3, 1, false, 0, 0);
+        #endif
+
+        /**
+         * quantize_with_min_max_vars - real quantization counterpart of fake_quant_with_min_max_vars(_per_channel):
+         * dequantize_linear of its outputs equals output of fake quantization
+         *
+         * input params:
+         *    0 - NDArray (input)
+         *    1 - min value, scalar or vector with one value per channel of last dimension
+         *    2 - max value, same shape as min
+         *
+         * int params (optional):
+         *    0 - num_bits (allowed interval [2, 8], default 8)
+         * bool params (optional):
+         *    0 - narrow_range (default False)
+         *
+         * output:
+         *    0 - NDArray with the same shape as input: UINT8 in range [0, 2^num_bits - 1], or INT8 in symmetric
+         *        range [-(2^(num_bits-1) - 1), 2^(num_bits-1) - 1] if narrow_range is set
+         *    1 - scale, with shape of min
+         *    2 - zero point of output type, with shape of min
+         */
+        #if NOT_EXCLUDED(OP_quantize_with_min_max_vars)
+        DECLARE_CUSTOM_OP(quantize_with_min_max_vars, 1, 3, false, 0, 0);
+        #endif
+
         /**
          * compare_and_bitpack - compare with greater and pack result with uint8
          *
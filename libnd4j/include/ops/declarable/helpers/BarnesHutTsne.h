@@ -33,6 +33,12 @@ namespace helpers {
     void barnes_gains(NDArray* input, NDArray* gradX, NDArray* epsilon, NDArray* output);
     bool cell_contains(NDArray* corner, NDArray* width, NDArray* point, Nd4jLong dimension);
 
+    /**
+     * Builds space-partitioning tree over rows of data and computes Barnes-Hut approximation of repulsive forces,
+     * output gets unnormalized forces and sumQ gets normalization term
+     */
+    void barnes_repulsive_forces(const NDArray& data, double theta, NDArray& output, NDArray& sumQ);
+
 }
 }
 }
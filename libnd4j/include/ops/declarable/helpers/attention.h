@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#ifndef SD_ATTENTION_H
+#define SD_ATTENTION_H
+
+#include <ops/declarable/helpers/helpers.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+    /**
+     * Fused dot product attention: keys are processed in blocks and softmax is computed on the fly (online softmax),
+     * so [timesteps, queryCount] weights matrix is never materialized and memory is linear in sequence length.
+     *
+     * Arrays are laid out as dot_product_attention op expects them, with features first:
+     * @param queries - [bS, featureKeys, queryCount] or [bS, numHeads, featureKeys, queryCount]
+     * @param keys - [bS, featureKeys, timesteps] or [bS, numHeads, featureKeys, timesteps]
+     * @param values - [bS, featureValues, timesteps] or [bS, numHeads, featureValues, timesteps]
+     * @param mask - optional [bS, timesteps] array, scores of keys with zero mask get -1e9 added, same as unfused op does
+     * @param output - [bS, featureValues, queryCount] or [bS, numHeads, featureValues, queryCount]
+     */
+    void dotProductAttention(sd::LaunchContext *context, const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray *mask,
+                             bool normalization, NDArray &output);
+
+    /**
+     * Backprop of fused dot product attention. Softmax statistics are recomputed per query, then gradients of queries
+     * are accumulated over key blocks and gradients of keys and values over query blocks, without weights matrix either
+     */
+    void dotProductAttentionBp(sd::LaunchContext *context, const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray &eps, const NDArray *mask,
+                               bool normalization, NDArray &dLdq, NDArray &dLdk, NDArray &dLdv);
+}
+}
+}
+
+#endif //SD_ATTENTION_H
@@ -28,6 +28,16 @@ namespace helpers {
 
     void decodeBitmap(sd::LaunchContext* context, const NDArray* input, NDArray* output);
     Nd4jLong encodeBitmap(sd::LaunchContext* context, NDArray* input, NDArray* output, float threshold);
+
+    /**
+     * Adaptive encoding: input is split into chunks, and each chunk with updates is stored as bitmap, list of indices,
+     * or list of delta+varint compressed indices, whichever is smaller. Encoded elements are subtracted from input.
+     *
+     * Returns number of int32 elements required for encoding of given input
+     */
+    Nd4jLong adaptiveEncodedLength(sd::LaunchContext* context, const NDArray* input, float threshold);
+    void encodeAdaptive(sd::LaunchContext* context, NDArray* input, NDArray* output, float threshold);
+    void decodeAdaptive(sd::LaunchContext* context, const NDArray* input, NDArray* output);
 }
 }
 }
@@ -20,124 +20,190 @@
 
 #include <ops/declarable/helpers/BarnesHutTsne.h>
 #include <execution/Threads.h>
+#include <helpers/SortEngine.h>
+#include <algorithm>
+#include <vector>
 
 namespace sd {
 namespace ops {
 namespace helpers {
 
-    Nd4jLong barnes_row_count(const NDArray* rowP, const NDArray* colP, Nd4jLong N, NDArray& rowCounts) {
+    /**
+     * Sparsity pattern of P and its transpose. Entries of column r are sorted by their rows, and every entry
+     * knows position of its mirrored entry (c, n), or -1 if the mirrored entry is absent
+     */
+    struct SymmetricPattern {
+        std::vector<int> entryRows;     // row of each entry
+        std::vector<int> transposed;    // entry positions grouped by column
+        std::vector<int> colOffsets;    // N + 1 offsets into transposed
+        std::vector<int> partner;
+    };
+
+    static void buildPattern(int const* pRows, int const* pCols, Nd4jLong N, SymmetricPattern& pattern) {
+        const Nd4jLong numEntries = pRows[N];
+        pattern.entryRows.resize(numEntries);
+        pattern.transposed.resize(numEntries);
+        pattern.colOffsets.resize(N + 1);
+        pattern.partner.resize(numEntries);
+
+        auto fillRows = PRAGMA_THREADS_FOR {
+            for (auto n = start; n < stop; n++)
+                for (int i = pRows[n]; i < pRows[n + 1]; i++)
+                    pattern.entryRows[i] = static_cast<int>(n);
+        };
+        samediff::Threads::parallel_tad(fillRows, 0, N);
+
+        // stable sort by column keeps entries of each column in row order
+        std::vector<int> keys(pCols, pCols + numEntries);
+        for (Nd4jLong i = 0; i < numEntries; i++)
+            pattern.transposed[i] = static_cast<int>(i);
+
+        if (numEntries > 0)
+            SortEngine::radixSort(keys.data(), pattern.transposed.data(), numEntries, false);
+
+        auto offsets = PRAGMA_THREADS_FOR {
+            for (auto r = start; r < stop; r++)
+                pattern.colOffsets[r] = static_cast<int>(std::lower_bound(keys.begin(), keys.end(), static_cast<int>(r)) - keys.begin());
+        };
+        samediff::Threads::parallel_for(offsets, 0, N + 1);
+
+        // sorted columns of row r are merged with sorted rows of column r, matches are mirrored pairs
+        auto match = PRAGMA_THREADS_FOR {
+            std::vector<std::pair<int, int>> own;
+            for (auto r = start; r < stop; r++) {
+                own.clear();
+                for (int i = pRows[r]; i < pRows[r + 1]; i++)
+                    own.emplace_back(pCols[i], i);
+
+                std::sort(own.begin(), own.end());
+
+                size_t j = 0;
+                int k = pattern.colOffsets[r];
+                const int kEnd = pattern.colOffsets[r + 1];
+                while (j < own.size() && k < kEnd) {
+                    const int source = pattern.entryRows[pattern.transposed[k]];
+                    if (own[j].first < source)
+                        pattern.partner[own[j++].second] = -1;
+                    else if (own[j].first > source)
+                        k++;
+                    else
+                        pattern.partner[own[j++].second] = pattern.transposed[k++];
+                }
+
+                for (; j < own.size(); j++)
+                    pattern.partner[own[j].second] = -1;
+            }
+        };
+        samediff::Threads::parallel_tad(match, 0, N);
+    }
 
+    /**
+     * Row r of symmetrized matrix consists of mirrored entries (n, r) with n < r, own entries (r, c) unless they were
+     * mirrored already, and mirrored entries (n, r) with n > r that have no pair. That's the order the serial
+     * implementation used to produce them, so results didn't change
+     */
+    static int symmetrizedRowCount(int const* pRows, int const* pCols, const SymmetricPattern& pattern, int r) {
+        int count = 0;
+        for (int k = pattern.colOffsets[r]; k < pattern.colOffsets[r + 1]; k++) {
+            const int e = pattern.transposed[k];
+            const int n = pattern.entryRows[e];
+            if (n < r || (n > r && pattern.partner[e] < 0))
+                count++;
+        }
+
+        for (int i = pRows[r]; i < pRows[r + 1]; i++)
+            if (pCols[i] >= r || pattern.partner[i] < 0)
+                count++;
+
+        return count;
+    }
+
+    Nd4jLong barnes_row_count(const NDArray* rowP, const NDArray* colP, Nd4jLong N, NDArray& rowCounts) {
         int* pRowCounts = reinterpret_cast<int*>(rowCounts.buffer());
         int const* pRows = reinterpret_cast<int const*>(rowP->buffer());
         int const* pCols = reinterpret_cast<int const*>(colP->buffer());
-        for (Nd4jLong n = 0; n < N; n++) {
-            int begin = pRows[n];//->e<int>(n);
-            int end = pRows[n + 1];//rowP->e<int>(n + 1);
-            for (int i = begin; i < end; i++) {
-                bool present = false;
-                for (int m = pRows[pCols[i]]; m < pRows[pCols[i] + 1]; m++)
-                    if (pCols[m] == n) {
-                        present = true;
-                        break;
-                    }
 
-                ++pRowCounts[n];
+        SymmetricPattern pattern;
+        buildPattern(pRows, pCols, N, pattern);
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto r = start; r < stop; r++)
+                pRowCounts[r] = symmetrizedRowCount(pRows, pCols, pattern, static_cast<int>(r));
+        };
+        samediff::Threads::parallel_for(func, 0, N);
+
+        Nd4jLong numElements = 0;
+        for (Nd4jLong r = 0; r < N; r++)
+            numElements += pRowCounts[r];
 
-                if (!present)
-                    ++pRowCounts[pCols[i]];
-            }
-        }
-        NDArray numElementsArr = rowCounts.sumNumber(); //reduceAlongDimension(reduce::Sum, {});
-        //rowCounts.printBuffer("Row counts");
-        auto numElements = numElementsArr.e<Nd4jLong>(0);
         return numElements;
     }
-//    static
-//    void printVector(std::vector<int> const& v) {
-//        for (auto x: v) {
-//            printf("%d ", x);
-//        }
-//        printf("\n");
-//        fflush(stdout);
-//    }
 
     template <typename T>
     static void barnes_symmetrize_(const NDArray* rowP, const NDArray* colP, const NDArray* valP, Nd4jLong N, NDArray* outputRows, NDArray* outputCols, NDArray* outputVals, NDArray* rowCounts) {
-        //auto N = rowP->lengthOf() - 1; /// 2 + rowP->lengthOf() % 2;
-        //auto numElements = output->lengthOf();
-        //std::vector<int> symRowP = rowCounts->asVectorT<int>();//NDArrayFactory::create<int>('c', {numElements});
-        //NDArray symValP = NDArrayFactory::create<double>('c', {numElements});
-        //symRowP.insert(symRowP.begin(),0);
-        //symRowP(1, {0}) = *rowCounts;
         int const* pRows = reinterpret_cast<int const*>(rowP->buffer());
-        int* symRowP = reinterpret_cast<int*>(outputRows->buffer());
-        symRowP[0] = 0;
-        for (Nd4jLong n = 0; n < N; n++)
-            symRowP[n + 1] = symRowP[n] + rowCounts->e<int>(n);
-//        outputRows->printBuffer("output rows");
-
-        int* symColP = reinterpret_cast<int*>(outputCols->buffer());
-//            symRowP.p(n + 1, symRowP.e(n) + rowCounts.e(n))
-//        outputRows->printBuffer("SymRows are");
         int const* pCols = reinterpret_cast<int const*>(colP->buffer());
         T const* pVals = reinterpret_cast<T const*>(valP->buffer());
+        int* symRowP = reinterpret_cast<int*>(outputRows->buffer());
+        int* symColP = reinterpret_cast<int*>(outputCols->buffer());
         T* pOutput = reinterpret_cast<T*>(outputVals->buffer());
-        //std::vector<int> rowCountsV = rowCounts->getBufferAsVector<int>();
-        std::vector<int> offset(N);// = NDArrayFactory::create<int>('c', {N});
-
-//PRAGMA_OMP_PARALLEL_FOR_SIMD_ARGS(schedule(guided) shared(offset))
-        for (Nd4jLong n = 0; n < N; n++) {
-            int begin = pRows[n];
-            int bound = pRows[n + 1];
-
-            for (int i = begin; i < bound; i++) {
-                bool present = false;
-                int colPI = pCols[i];
-                int start = pRows[colPI];
-                int end = pRows[colPI + 1];
-
-                //PRAGMA_OMP_PARALLEL_FOR_ARGS(schedule(guided) firstprivate(offset))
-                for (int m = start; m < end; m++) {
-                    if (pCols[m] == n) {
-                        present = true;
-                        if (n <= colPI) {
-                            symColP[symRowP[n] + offset[n]]        = colPI;
-                            symColP[symRowP[colPI] + offset[colPI]] = n;
-                            pOutput[symRowP[n] + offset[n]] = pVals[i] + pVals[m];
-                            pOutput[symRowP[colPI] + offset[colPI]] = pVals[i] + pVals[m];
-                        }
-                    }
+
+        SymmetricPattern pattern;
+        buildPattern(pRows, pCols, N, pattern);
+
+        symRowP[0] = 0;
+        if (rowCounts != nullptr) {
+            int const* pRowCounts = reinterpret_cast<int const*>(rowCounts->buffer());
+            for (Nd4jLong r = 0; r < N; r++)
+                symRowP[r + 1] = symRowP[r] + pRowCounts[r];
+        } else {
+            for (Nd4jLong r = 0; r < N; r++)
+                symRowP[r + 1] = symRowP[r] + symmetrizedRowCount(pRows, pCols, pattern, static_cast<int>(r));
+        }
+
+        // mirrored values are added together, and everything is divided by two
+        auto value = [&](int e) -> T {
+            const int m = pattern.partner[e];
+            return m >= 0 ? static_cast<T>((pVals[e] + pVals[m]) / static_cast<T>(2)) : static_cast<T>(pVals[e] / static_cast<T>(2));
+        };
+
+        // every row is written by its own thread, no offsets are shared
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto r = start; r < stop; r++) {
+                int pos = symRowP[r];
+                int k = pattern.colOffsets[r];
+                const int kEnd = pattern.colOffsets[r + 1];
+
+                for (; k < kEnd && pattern.entryRows[pattern.transposed[k]] < r; k++, pos++) {
+                    const int e = pattern.transposed[k];
+                    symColP[pos] = pattern.entryRows[e];
+                    pOutput[pos] = value(e);
                 }
 
-                // If (colP[i], n) is not present, there is no addition involved
-                if (!present) {
-                    //int colPI = pCols[i];
-                    //if (n <= colPI) {
-                        symColP[symRowP[n] + offset[n]] = colPI;
-                        symColP[symRowP[pCols[i]] + offset[colPI]] = n;
-                        pOutput[symRowP[n] + offset[n]] = pVals[i];
-                        pOutput[symRowP[colPI] + offset[colPI]] = pVals[i];
-                    //}
+                for (int i = pRows[r]; i < pRows[r + 1]; i++) {
+                    if (pCols[i] < r && pattern.partner[i] >= 0)
+                        continue;
 
+                    symColP[pos] = pCols[i];
+                    pOutput[pos++] = value(i);
                 }
-                // Update offsets
-                if (!present || (present && n <= colPI)) {
-                    ++offset[n];
 
-                    if (colPI != n)
-                        ++offset[colPI];
+                for (; k < kEnd; k++) {
+                    const int e = pattern.transposed[k];
+                    const int n = pattern.entryRows[e];
+                    if (n == r || pattern.partner[e] >= 0)
+                        continue;
+
+                    symColP[pos] = n;
+                    pOutput[pos++] = value(e);
                 }
-//                printVector(offset);
             }
-        }
+        };
+        samediff::Threads::parallel_tad(func, 0, N);
     }
-    void barnes_symmetrize(const NDArray* rowP, const NDArray* colP, const NDArray* valP, Nd4jLong N, NDArray* outputRows, NDArray* outputCols, NDArray* outputVals, NDArray* rowCounts) {
 
-        // Divide the result by two
+    void barnes_symmetrize(const NDArray* rowP, const NDArray* colP, const NDArray* valP, Nd4jLong N, NDArray* outputRows, NDArray* outputCols, NDArray* outputVals, NDArray* rowCounts) {
         BUILD_SINGLE_SELECTOR(valP->dataType(), barnes_symmetrize_, (rowP, colP, valP, N, outputRows, outputCols, outputVals, rowCounts), NUMERIC_TYPES);
-
-        *outputVals /= 2.0;
-        //output->assign(symValP);
     }
     BUILD_SINGLE_TEMPLATE(template void barnes_symmetrize_, (const NDArray* rowP, const NDArray* colP, const NDArray* valP, Nd4jLong N, NDArray* outputRows, NDArray* outputCols, NDArray* outputVals, NDArray* rowCounts), NUMERIC_TYPES);
 
@@ -0,0 +1,406 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/attention.h>
+#include <helpers/ConstantTadHelper.h>
+#include <helpers/PackedGemm.h>
+#include <execution/Threads.h>
+#include <math/templatemath.h>
+#include <limits>
+#include <vector>
+
+namespace sd    {
+namespace ops     {
+namespace helpers {
+
+// queries per unit of work and keys per block, BLOCK_Q x BLOCK_K scores stay in L1
+static const Nd4jLong ATTENTION_BLOCK_Q = 32;
+static const Nd4jLong ATTENTION_BLOCK_K = 64;
+
+//////////////////////////////////////////////////////////////////////////
+// g-th [features, time] matrix of rank 3 or 4 array, element (f, t) is at offsets[g] + f * fStride + t * tStride
+template <typename T>
+struct AttentionOperand {
+    T *buffer;
+    std::vector<Nd4jLong> offsets;
+    Nd4jLong fStride;
+    Nd4jLong tStride;
+
+    explicit AttentionOperand(const NDArray &array) {
+        auto pack = ConstantTadHelper::getInstance().tadForDimensions(array.shapeInfo(), {array.rankOf() - 2, array.rankOf() - 1});
+        buffer = const_cast<T*>(array.bufferAsT<T>());
+        offsets.assign(pack.primaryOffsets(), pack.primaryOffsets() + pack.numberOfTads());
+        fStride = array.strideAt(-2);
+        tStride = array.strideAt(-1);
+    }
+
+    // time steps [t0, t0 + count) of matrix g, as rows of contiguous [count, features] block
+    template <typename Acc>
+    void pack(const Nd4jLong g, const Nd4jLong t0, const Nd4jLong count, const Nd4jLong features, Acc *packed) const {
+        const T *x = buffer + offsets[g] + t0 * tStride;
+        for (Nd4jLong t = 0; t < count; t++)
+            for (Nd4jLong f = 0; f < features; f++)
+                packed[t * features + f] = static_cast<Acc>(x[f * fStride + t * tStride]);
+    }
+
+    template <typename Acc>
+    void unpack(const Nd4jLong g, const Nd4jLong t0, const Nd4jLong count, const Nd4jLong features, const Acc *packed) {
+        T *x = buffer + offsets[g] + t0 * tStride;
+        for (Nd4jLong t = 0; t < count; t++)
+            for (Nd4jLong f = 0; f < features; f++)
+                x[f * fStride + t * tStride] = static_cast<T>(packed[t * features + f]);
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+class FusedAttention {
+    typedef typename GemmAccumulator<T>::type Acc;
+
+    AttentionOperand<T> _q, _k, _v;
+    Nd4jLong _numMatrices, _heads, _dK, _dV, _tq, _tk;
+    Acc _scale;
+
+    // additive mask term of each key, as unfused op has it: (mask - 1) * 1e9
+    std::vector<Acc> _bias;
+
+public:
+    FusedAttention(const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray *mask, const bool normalization) : _q(queries), _k(keys), _v(values) {
+        _numMatrices = _q.offsets.size();
+        _heads = queries.rankOf() == 4 ? queries.sizeAt(1) : 1;
+        _dK = queries.sizeAt(-2);
+        _dV = values.sizeAt(-2);
+        _tq = queries.sizeAt(-1);
+        _tk = keys.sizeAt(-1);
+        _scale = normalization ? static_cast<Acc>(1.0 / sd::math::nd4j_sqrt<double, double>(static_cast<double>(_dK))) : static_cast<Acc>(1);
+
+        if (mask != nullptr) {
+            const auto bS = mask->sizeAt(0);
+            _bias.resize(bS * _tk);
+            for (Nd4jLong b = 0; b < bS; b++)
+                for (Nd4jLong j = 0; j < _tk; j++)
+                    _bias[b * _tk + j] = static_cast<Acc>((mask->e<double>(b, j) - 1.0) * 1e9);
+        }
+    }
+
+    Nd4jLong numMatrices() const { return _numMatrices; }
+
+    Nd4jLong queries() const { return _tq; }
+
+    Nd4jLong timesteps() const { return _tk; }
+
+    Nd4jLong featureKeys() const { return _dK; }
+
+    Nd4jLong featureValues() const { return _dV; }
+
+    const AttentionOperand<T>& q() const { return _q; }
+
+    const AttentionOperand<T>& k() const { return _k; }
+
+    const AttentionOperand<T>& v() const { return _v; }
+
+    const Acc* bias(const Nd4jLong g, const Nd4jLong k0) const {
+        return _bias.empty() ? nullptr : _bias.data() + (g / _heads) * _tk + k0;
+    }
+
+    // S[i][j] = scale * (Q_i . K_j) + bias_j, for nq rows of packed Q and nk rows of packed K
+    void scores(const Acc *Q, const Nd4jLong nq, const Acc *K, const Nd4jLong nk, const Acc *bias, Acc *S) const {
+        for (Nd4jLong i = 0; i < nq; i++) {
+            const Acc *qi = Q + i * _dK;
+            for (Nd4jLong j = 0; j < nk; j++) {
+                const Acc *kj = K + j * _dK;
+                Acc sum = static_cast<Acc>(0);
+
+                PRAGMA_OMP_SIMD_ARGS(reduction(+:sum))
+                for (Nd4jLong f = 0; f < _dK; f++)
+                    sum += qi[f] * kj[f];
+
+                S[i * ATTENTION_BLOCK_K + j] = _scale * sum + (bias == nullptr ? static_cast<Acc>(0) : bias[j]);
+            }
+        }
+    }
+
+    // streaming softmax over all keys of matrix g: O gets unnormalized weighted sum of values, m running max and l sum of exponents
+    void attend(const Nd4jLong g, const Acc *Q, const Nd4jLong nq, const Acc *K, const Acc *V, Acc *O, Acc *m, Acc *l, Acc *S) const {
+        for (Nd4jLong i = 0; i < nq; i++) {
+            m[i] = -std::numeric_limits<Acc>::infinity();
+            l[i] = static_cast<Acc>(0);
+        }
+
+        for (Nd4jLong e = 0; e < nq * _dV; e++)
+            O[e] = static_cast<Acc>(0);
+
+        for (Nd4jLong k0 = 0; k0 < _tk; k0 += ATTENTION_BLOCK_K) {
+            const auto nk = sd::math::nd4j_min<Nd4jLong>(ATTENTION_BLOCK_K, _tk - k0);
+            scores(Q, nq, K + k0 * _dK, nk, bias(g, k0), S);
+
+            for (Nd4jLong i = 0; i < nq; i++) {
+                Acc *s = S + i * ATTENTION_BLOCK_K;
+                Acc mx = m[i];
+                for (Nd4jLong j = 0; j < nk; j++)
+                    mx = sd::math::nd4j_max<Acc>(mx, s[j]);
+
+                // previous partial results were scaled by exp(-m), rescale them to the new maximum
+                const Acc correction = sd::math::nd4j_exp<Acc, Acc>(m[i] - mx);
+                Acc sum = static_cast<Acc>(0);
+                for (Nd4jLong j = 0; j < nk; j++) {
+                    s[j] = sd::math::nd4j_exp<Acc, Acc>(s[j] - mx);
+                    sum += s[j];
+                }
+
+                l[i] = l[i] * correction + sum;
+                m[i] = mx;
+
+                Acc *o = O + i * _dV;
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong d = 0; d < _dV; d++)
+                    o[d] *= correction;
+
+                for (Nd4jLong j = 0; j < nk; j++) {
+                    const Acc p = s[j];
+                    const Acc *vj = V + (k0 + j) * _dV;
+
+                    PRAGMA_OMP_SIMD
+                    for (Nd4jLong d = 0; d < _dV; d++)
+                        o[d] += p * vj[d];
+                }
+            }
+        }
+    }
+
+    Acc scale() const { return _scale; }
+};
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void dotProductAttention_(const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray *mask, const bool normalization, NDArray &output) {
+    typedef typename GemmAccumulator<T>::type Acc;
+
+    FusedAttention<T> attention(queries, keys, values, mask, normalization);
+    AttentionOperand<T> out(output);
+
+    const auto dK = attention.featureKeys();
+    const auto dV = attention.featureValues();
+    const auto tq = attention.queries();
+    const auto tk = attention.timesteps();
+    const Nd4jLong qBlocks = (tq + ATTENTION_BLOCK_Q - 1) / ATTENTION_BLOCK_Q;
+
+    auto func = PRAGMA_THREADS_FOR {
+        // keys and values are packed once per matrix, consecutive units of the same matrix reuse them
+        std::vector<Acc> K(tk * dK), V(tk * dV), Q(ATTENTION_BLOCK_Q * dK), O(ATTENTION_BLOCK_Q * dV), S(ATTENTION_BLOCK_Q * ATTENTION_BLOCK_K);
+        Acc m[ATTENTION_BLOCK_Q], l[ATTENTION_BLOCK_Q];
+        Nd4jLong packed = -1;
+
+        for (auto u = start; u < stop; u++) {
+            const auto g = u / qBlocks;
+            const auto q0 = (u % qBlocks) * ATTENTION_BLOCK_Q;
+            const auto nq = sd::math::nd4j_min<Nd4jLong>(ATTENTION_BLOCK_Q, tq - q0);
+
+            if (g != packed) {
+                attention.k().pack(g, 0, tk, dK, K.data());
+                attention.v().pack(g, 0, tk, dV, V.data());
+                packed = g;
+            }
+
+            attention.q().pack(g, q0, nq, dK, Q.data());
+            attention.attend(g, Q.data(), nq, K.data(), V.data(), O.data(), m, l, S.data());
+
+            for (Nd4jLong i = 0; i < nq; i++)
+                for (Nd4jLong d = 0; d < dV; d++)
+                    O[i * dV + d] /= l[i];
+
+            out.unpack(g, q0, nq, dV, O.data());
+        }
+    };
+
+    samediff::Threads::parallel_for(func, 0, attention.numMatrices() * qBlocks);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void dotProductAttentionBp_(const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray &eps, const NDArray *mask, const bool normalization,
+                                   NDArray &dLdq, NDArray &dLdk, NDArray &dLdv) {
+    typedef typename GemmAccumulator<T>::type Acc;
+
+    FusedAttention<T> attention(queries, keys, values, mask, normalization);
+    AttentionOperand<T> gradOutput(eps), gradQueries(dLdq), gradKeys(dLdk), gradValues(dLdv);
+
+    const auto dK = attention.featureKeys();
+    const auto dV = attention.featureValues();
+    const auto tq = attention.queries();
+    const auto tk = attention.timesteps();
+    const auto scale = attention.scale();
+    const auto numMatrices = attention.numMatrices();
+    const Nd4jLong qBlocks = (tq + ATTENTION_BLOCK_Q - 1) / ATTENTION_BLOCK_Q;
+    const Nd4jLong kBlocks = (tk + ATTENTION_BLOCK_K - 1) / ATTENTION_BLOCK_K;
+
+    // per query: log of softmax denominator L, and D = dO . O, which is sum of weights times their gradients
+    std::vector<Acc> L(numMatrices * tq), D(numMatrices * tq);
+
+    // pass over query blocks: softmax statistics are recomputed, then gradients of queries are accumulated over key blocks
+    auto queriesPass = PRAGMA_THREADS_FOR {
+        std::vector<Acc> K(tk * dK), V(tk * dV), Q(ATTENTION_BLOCK_Q * dK), O(ATTENTION_BLOCK_Q * dV), gradO(ATTENTION_BLOCK_Q * dV), gradQ(ATTENTION_BLOCK_Q * dK), S(ATTENTION_BLOCK_Q * ATTENTION_BLOCK_K);
+        Acc m[ATTENTION_BLOCK_Q], l[ATTENTION_BLOCK_Q];
+        Nd4jLong packed = -1;
+
+        for (auto u = start; u < stop; u++) {
+            const auto g = u / qBlocks;
+            const auto q0 = (u % qBlocks) * ATTENTION_BLOCK_Q;
+            const auto nq = sd::math::nd4j_min<Nd4jLong>(ATTENTION_BLOCK_Q, tq - q0);
+
+            if (g != packed) {
+                attention.k().pack(g, 0, tk, dK, K.data());
+                attention.v().pack(g, 0, tk, dV, V.data());
+                packed = g;
+            }
+
+            attention.q().pack(g, q0, nq, dK, Q.data());
+            gradOutput.pack(g, q0, nq, dV, gradO.data());
+            attention.attend(g, Q.data(), nq, K.data(), V.data(), O.data(), m, l, S.data());
+
+            auto lq = L.data() + g * tq + q0;
+            auto dq = D.data() + g * tq + q0;
+            for (Nd4jLong i = 0; i < nq; i++) {
+                Acc sum = static_cast<Acc>(0);
+                for (Nd4jLong d = 0; d < dV; d++)
+                    sum += gradO[i * dV + d] * O[i * dV + d];
+
+                lq[i] = m[i] + sd::math::nd4j_log<Acc, Acc>(l[i]);
+                dq[i] = sum / l[i];
+            }
+
+            for (Nd4jLong e = 0; e < nq * dK; e++)
+                gradQ[e] = static_cast<Acc>(0);
+
+            for (Nd4jLong k0 = 0; k0 < tk; k0 += ATTENTION_BLOCK_K) {
+                const auto nk = sd::math::nd4j_min<Nd4jLong>(ATTENTION_BLOCK_K, tk - k0);
+                attention.scores(Q.data(), nq, K.data() + k0 * dK, nk, attention.bias(g, k0), S.data());
+
+                for (Nd4jLong i = 0; i < nq; i++) {
+                    const Acc *gi = gradO.data() + i * dV;
+                    Acc *dqi = gradQ.data() + i * dK;
+
+                    for (Nd4jLong j = 0; j < nk; j++) {
+                        const Acc *vj = V.data() + (k0 + j) * dV;
+                        const Acc *kj = K.data() + (k0 + j) * dK;
+
+                        Acc dP = static_cast<Acc>(0);
+                        PRAGMA_OMP_SIMD_ARGS(reduction(+:dP))
+                        for (Nd4jLong d = 0; d < dV; d++)
+                            dP += gi[d] * vj[d];
+
+                        const Acc p = sd::math::nd4j_exp<Acc, Acc>(S[i * ATTENTION_BLOCK_K + j] - lq[i]);
+                        const Acc dS = scale * p * (dP - dq[i]);
+
+                        PRAGMA_OMP_SIMD
+                        for (Nd4jLong f = 0; f < dK; f++)
+                            dqi[f] += dS * kj[f];
+                    }
+                }
+            }
+
+            gradQueries.unpack(g, q0, nq, dK, gradQ.data());
+        }
+    };
+
+    samediff::Threads::parallel_for(queriesPass, 0, numMatrices * qBlocks);
+
+    // pass over key blocks: gradients of keys and values are accumulated over all queries
+    auto keysPass = PRAGMA_THREADS_FOR {
+        std::vector<Acc> Q(tq * dK), gradO(tq * dV), K(ATTENTION_BLOCK_K * dK), V(ATTENTION_BLOCK_K * dV), gradK(ATTENTION_BLOCK_K * dK), gradV(ATTENTION_BLOCK_K * dV), S(ATTENTION_BLOCK_Q * ATTENTION_BLOCK_K);
+        Nd4jLong packed = -1;
+
+        for (auto u = start; u < stop; u++) {
+            const auto g = u / kBlocks;
+            const auto k0 = (u % kBlocks) * ATTENTION_BLOCK_K;
+            const auto nk = sd::math::nd4j_min<Nd4jLong>(ATTENTION_BLOCK_K, tk - k0);
+
+            if (g != packed) {
+                attention.q().pack(g, 0, tq, dK, Q.data());
+                gradOutput.pack(g, 0, tq, dV, gradO.data());
+                packed = g;
+            }
+
+            attention.k().pack(g, k0, nk, dK, K.data());
+            attention.v().pack(g, k0, nk, dV, V.data());
+
+            for (Nd4jLong e = 0; e < nk * dK; e++)
+                gradK[e] = static_cast<Acc>(0);
+
+            for (Nd4jLong e = 0; e < nk * dV; e++)
+                gradV[e] = static_cast<Acc>(0);
+
+            const auto lq = L.data() + g * tq;
+            const auto dq = D.data() + g * tq;
+            const auto bias = attention.bias(g, k0);
+
+            for (Nd4jLong q0 = 0; q0 < tq; q0 += ATTENTION_BLOCK_Q) {
+                const auto nq = sd::math::nd4j_min<Nd4jLong>(ATTENTION_BLOCK_Q, tq - q0);
+                attention.scores(Q.data() + q0 * dK, nq, K.data(), nk, bias, S.data());
+
+                for (Nd4jLong i = 0; i < nq; i++) {
+                    const Acc *qi = Q.data() + (q0 + i) * dK;
+                    const Acc *gi = gradO.data() + (q0 + i) * dV;
+
+                    for (Nd4jLong j = 0; j < nk; j++) {
+                        const Acc *vj = V.data() + j * dV;
+                        Acc *dvj = gradV.data() + j * dV;
+                        Acc *dkj = gradK.data() + j * dK;
+
+                        const Acc p = sd::math::nd4j_exp<Acc, Acc>(S[i * ATTENTION_BLOCK_K + j] - lq[q0 + i]);
+
+                        Acc dP = static_cast<Acc>(0);
+                        PRAGMA_OMP_SIMD_ARGS(reduction(+:dP))
+                        for (Nd4jLong d = 0; d < dV; d++) {
+                            dP += gi[d] * vj[d];
+                            dvj[d] += p * gi[d];
+                        }
+
+                        const Acc dS = scale * p * (dP - dq[q0 + i]);
+
+                        PRAGMA_OMP_SIMD
+                        for (Nd4jLong f = 0; f < dK; f++)
+                            dkj[f] += dS * qi[f];
+                    }
+                }
+            }
+
+            gradKeys.unpack(g, k0, nk, dK, gradK.data());
+            gradValues.unpack(g, k0, nk, dV, gradV.data());
+        }
+    };
+
+    samediff::Threads::parallel_for(keysPass, 0, numMatrices * kBlocks);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dotProductAttention(sd::LaunchContext *context, const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray *mask,
+                         bool normalization, NDArray &output) {
+    BUILD_SINGLE_SELECTOR(output.dataType(), dotProductAttention_, (queries, keys, values, mask, normalization, output), FLOAT_TYPES);
+}
+
+void dotProductAttentionBp(sd::LaunchContext *context, const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray &eps, const NDArray *mask,
+                           bool normalization, NDArray &dLdq, NDArray &dLdk, NDArray &dLdv) {
+    BUILD_SINGLE_SELECTOR(dLdq.dataType(), dotProductAttentionBp_, (queries, keys, values, eps, mask, normalization, dLdq, dLdk, dLdv), FLOAT_TYPES);
+}
+
+}
+}
+}
@@ -22,6 +22,8 @@
 #include <types/float16.h>
 #include <ops/declarable/helpers/batched_gemm.h>
 #include <helpers/BlasHelper.h>
+#include <helpers/PackedGemm.h>
+#include <array/DataTypeUtils.h>
 #include <execution/Threads.h>
 
 
@@ -87,6 +89,29 @@ void bgemm_(const std::vector<NDArray*>& vA, const std::vector<NDArray*>& vB, st
         RELEASE(tldB, arr->getContext()->getWorkspace());
         RELEASE(tldC, arr->getContext()->getWorkspace());
         RELEASE(tsize, arr->getContext()->getWorkspace());
+    } else if (PackedGemm::isBatchable(M, N, K)) {
+        // matrices are column-major with leading dimensions given
+        std::vector<const void*> buffersA(batchSize);
+        std::vector<const void*> buffersB(batchSize);
+        std::vector<void*> buffersC(batchSize);
+        std::vector<double> vAlphas(batchSize);
+        std::vector<double> vBetas(batchSize);
+
+        for (int e = 0; e < batchSize; e++) {
+            buffersA[e] = vA[e]->buffer();
+            buffersB[e] = vB[e]->buffer();
+            buffersC[e] = vC[e]->buffer();
+            vAlphas[e] = alphas->e<double>(alphas->lengthOf() == 1 ? 0 : e);
+            vBetas[e] = betas->e<double>(betas->lengthOf() == 1 ? 0 : e);
+        }
+
+        const bool nA = transA == CblasNoTrans;
+        const bool nB = transB == CblasNoTrans;
+
+        PackedGemm::gemmBatched(DataTypeUtils::fromT<T>(), batchSize, M, N, K, vAlphas.data(),
+                                buffersA.data(), nA ? 1 : lda, nA ? lda : 1,
+                                buffersB.data(), nB ? 1 : ldb, nB ? ldb : 1,
+                                vBetas.data(), buffersC.data(), 1, ldc);
     } else {
         CBLAS_TRANSPOSE tA = (CBLAS_TRANSPOSE) transA;
         CBLAS_TRANSPOSE tB = (CBLAS_TRANSPOSE) transB;
@@ -26,7 +26,7 @@ namespace sd {
     namespace ops {
         namespace helpers {
             template <typename T>
-            static int32_t thresholdEstimate_(const NDArray &updates, const float threshold) {
+            static Nd4jLong thresholdEstimate_(const NDArray &updates, const float threshold) {
                 auto N = updates.lengthOf();
                 const auto buffer = updates.bufferAsT<T>();
 
@@ -44,7 +44,7 @@ namespace sd {
                 return samediff::Threads::parallel_long(func, LAMBDA_AL { return _old + _new; }, 0, N);
             }
 
-            int32_t thresholdEstimate(const NDArray &updates, const float threshold) {
+            Nd4jLong thresholdEstimate(const NDArray &updates, const float threshold) {
                 BUILD_SINGLE_SELECTOR(updates.dataType(), return thresholdEstimate_, (updates, threshold), FLOAT_TYPES);
 
                 return 0;
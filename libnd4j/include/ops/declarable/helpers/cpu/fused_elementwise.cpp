@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/fused_elementwise.h>
+#include <helpers/ConstantShapeHelper.h>
+#include <system/Environment.h>
+#include <execution/Threads.h>
+#include <loops/transform_same.h>
+#include <loops/transform_float.h>
+#include <loops/transform_strict.h>
+#include <loops/scalar.h>
+#include <loops/pairwise_transform.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+    // how Y operand of the step is read
+    enum FusedOperandMode {
+        FUSED_OPERAND_NONE = 0,
+        FUSED_OPERAND_SCALAR = 1,
+        FUSED_OPERAND_SAME = 2,
+        FUSED_OPERAND_ROW = 3,
+    };
+
+    // 8K elements per tile: output tile and Y operand tile stay in L1/L2 during the whole chain
+    static const Nd4jLong FUSED_TILE_LENGTH = 8192;
+
+    static bool overlaps(const NDArray &a, const NDArray &b) {
+        auto aStart = reinterpret_cast<const int8_t*>(a.buffer());
+        auto bStart = reinterpret_cast<const int8_t*>(b.buffer());
+        auto aEnd = aStart + a.lengthOf() * a.sizeOfT();
+        auto bEnd = bStart + b.lengthOf() * b.sizeOfT();
+
+        return aStart < bEnd && bStart < aEnd;
+    }
+
+    template <typename T>
+    static void fusedElementwise_(const std::vector<FusedStep> &steps, const std::vector<int> &modes, const std::vector<NDArray*> &inputs, NDArray &output, const Nd4jLong tile) {
+        const auto length = output.lengthOf();
+        const auto rowLength = output.sizeAt(-1);
+        const auto numTiles = length / tile + (length % tile == 0 ? 0 : 1);
+
+        auto x = inputs[0]->bufferAsT<T>();
+        auto z = output.bufferAsT<T>();
+
+        // scalars and extra params are converted once per call
+        std::vector<std::vector<T>> extras(steps.size());
+        std::vector<T> scalars(steps.size());
+        for (size_t e = 0; e < steps.size(); e++) {
+            for (auto v: steps[e].extras)
+                extras[e].emplace_back(static_cast<T>(v));
+
+            scalars[e] = modes[e] == FUSED_OPERAND_SCALAR ? inputs[steps[e].operand]->e<T>(0) : static_cast<T>(steps[e].scalar);
+        }
+
+        // transform loops take shape info, so tile is described as vector
+        auto tileShape = ConstantShapeHelper::getInstance().vectorShapeInfo(tile, output.dataType());
+        auto lastShape = ConstantShapeHelper::getInstance().vectorShapeInfo(length - (numTiles - 1) * tile, output.dataType());
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto t = start; t < stop; t++) {
+                const Nd4jLong first = t * tile;
+                const Nd4jLong last = sd::math::nd4j_min<Nd4jLong>(first + tile, length);
+                auto shapeInfo = t == numTiles - 1 ? lastShape : tileShape;
+
+                // first step reads input, all next ones are applied in place to the same tile of output
+                const T *src = x;
+                for (size_t e = 0; e < steps.size(); e++) {
+                    auto &step = steps[e];
+                    auto params = extras[e].empty() ? nullptr : extras[e].data();
+                    auto y = step.operand >= 0 ? inputs[step.operand]->bufferAsT<T>() : nullptr;
+
+                    switch (step.type) {
+                        case FusedStepType::TRANSFORM_SAME:
+                            functions::transform::TransformSame<T>::exec(step.opNum, src + first, shapeInfo, z + first, shapeInfo, params, 0, 1);
+                            break;
+                        case FusedStepType::TRANSFORM_FLOAT:
+                            functions::transform::TransformFloat<T, T>::exec(step.opNum, src + first, shapeInfo, z + first, shapeInfo, params, 0, 1);
+                            break;
+                        case FusedStepType::TRANSFORM_STRICT:
+                            functions::transform::TransformStrict<T>::exec(step.opNum, src + first, shapeInfo, z + first, shapeInfo, params, 0, 1);
+                            break;
+                        default: {
+                            // broadcastables carry scalar and pairwise op numbers separately
+                            const int scalarOp = step.type == FusedStepType::BROADCASTABLE ? step.scalarOp : step.opNum;
+
+                            if (modes[e] == FUSED_OPERAND_NONE || modes[e] == FUSED_OPERAND_SCALAR) {
+                                functions::scalar::ScalarTransform<T, T, T>::transform(scalarOp, src, 1, z, 1, &scalars[e], params, length, first, last);
+                            } else if (modes[e] == FUSED_OPERAND_SAME) {
+                                functions::pairwise_transforms::PairWiseTransform<T, T, T>::exec(step.opNum, src, 1, y, 1, z, 1, params, length, first, last);
+                            } else {
+                                // tiles are aligned to rows, so each row meets the whole Y vector
+                                for (auto r = first; r < last; r += rowLength)
+                                    functions::pairwise_transforms::PairWiseTransform<T, T, T>::exec(step.opNum, src + r, 1, y, 1, z + r, 1, params, rowLength, 0, rowLength);
+                            }
+                        }
+                    }
+
+                    src = z;
+                }
+            }
+        };
+
+        samediff::Threads::parallel_tad(func, 0, numTiles);
+    }
+
+    bool fusedElementwise(sd::LaunchContext *context, const std::vector<FusedStep> &steps, const std::vector<NDArray*> &inputs, NDArray &output) {
+        if (steps.empty() || inputs.empty() || output.isEmpty() || !output.isR())
+            return false;
+
+        if (output.ordering() != 'c' || output.ews() != 1)
+            return false;
+
+        for (auto array: inputs)
+            if (array == nullptr || array->isEmpty() || array->dataType() != output.dataType())
+                return false;
+
+        auto x = inputs[0];
+        if (x->ordering() != 'c' || x->ews() != 1 || !x->isSameShape(output))
+            return false;
+
+        bool rows = false;
+        std::vector<int> modes(steps.size(), FUSED_OPERAND_NONE);
+        for (size_t e = 0; e < steps.size(); e++) {
+            auto &step = steps[e];
+            if (step.operand < 0)
+                continue;
+
+            auto y = inputs[step.operand];
+
+            // Y is read after output tile was overwritten by previous steps
+            if (overlaps(*y, output))
+                return false;
+
+            if (y->lengthOf() == 1 && step.type != FusedStepType::PAIRWISE) {
+                modes[e] = FUSED_OPERAND_SCALAR;
+            } else if (y->ordering() == 'c' && y->ews() == 1 && y->isSameShape(output) && step.type != FusedStepType::SCALAR) {
+                modes[e] = FUSED_OPERAND_SAME;
+            } else if (step.type == FusedStepType::BROADCASTABLE && y->ews() == 1 && y->lengthOf() == output.sizeAt(-1) && y->lengthOf() == y->sizeAt(-1)) {
+                // vector along last dimension, i.e. bias
+                modes[e] = FUSED_OPERAND_ROW;
+                rows = true;
+            } else
+                return false;
+        }
+
+        // smaller arrays are split into smaller tiles, so all threads get work
+        const Nd4jLong numThreads = sd::Environment::getInstance().maxMasterThreads();
+        auto tile = sd::math::nd4j_min<Nd4jLong>(FUSED_TILE_LENGTH, sd::math::nd4j_max<Nd4jLong>(1024, output.lengthOf() / numThreads));
+        if (rows) {
+            auto rowLength = output.sizeAt(-1);
+            tile = sd::math::nd4j_max<Nd4jLong>(1, tile / rowLength) * rowLength;
+        }
+
+        std::vector<const NDArray*> readList(inputs.begin(), inputs.end());
+        NDArray::preparePrimaryUse({&output}, readList);
+
+        BUILD_SINGLE_SELECTOR(output.dataType(), fusedElementwise_, (steps, modes, inputs, output, tile), FLOAT_TYPES);
+
+        NDArray::registerPrimaryUse({&output}, readList);
+
+        return true;
+    }
+
+}
+}
+}
@@ -22,6 +22,7 @@
 #include <helpers/TAD.h>
 #include <helpers/ShapeUtils.h>
 #include <helpers/ConstantTadHelper.h>
+#include <helpers/SelectionEngine.h>
 #include <execution/Threads.h>
 
 namespace sd {
@@ -30,38 +31,28 @@ namespace helpers {
 
     template <typename T>
     void nthElementFunctor_(NDArray* input, Nd4jLong n, NDArray* output, bool reverse) {
+        const Nd4jLong width = input->sizeAt(-1);
+        std::vector<int> lastDims({input->rankOf() - 1});
 
-        NDArray sortedVals(*input);
-        if (input->isVector()) {
-            //std::vector<float> data(input->lengthOf());
-            //memcpy(&data[0], input->buffer(), sizeof(T) * data.size());
-            //size_t l = 0;
-            //for (size_t l = 0; l < data.size(); ++l)
-            //    data[l] = input->e<float>(l);
-            //auto nthPos = data.begin();
-            //nthPos += n;
-            //std::nth_element(data.begin(), nthPos, data.end());
-            SpecialMethods<T>::sortGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), reverse);
-            output->p(0, sortedVals.e<T>(n));
-        }
-        else { // rank greater than 1
-            std::vector<int> lastDims({input->rankOf() - 1});// = ShapeUtils::evalDimsToExclude(input->rankOf(), {input->rankOf() - 1});
-
-            auto pack = sd::ConstantTadHelper::getInstance().tadForDimensions(sortedVals.shapeInfo(), lastDims);
-
-            SpecialMethods<T>::sortTadGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), lastDims.data(), lastDims.size(), pack.primaryShapeInfo(), pack.primaryOffsets(), reverse);
+        auto pack = sd::ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), lastDims);
+        const Nd4jLong numOfSubArrs = pack.numberOfTads();
+        const Nd4jLong xStride = input->strideAt(-1);
 
-            ResultSet rows = sortedVals.allTensorsAlongDimension(lastDims);
-            Nd4jLong oL = output->lengthOf();
+        auto x = input->bufferAsT<T>();
+        auto z = output->bufferAsT<T>();
 
+        // input isn't sorted anymore: n-th element is selected, so rows are split between threads, or a single long row is
+        const int maxThreads = sd::Environment::getInstance().maxMasterThreads();
+        if (numOfSubArrs >= maxThreads) {
             auto func = PRAGMA_THREADS_FOR {
-                for (auto e = start; e < stop; e++) {
-                    auto row = rows.at(e);
-                    output->p(e, row->e<T>(n));
-                }
+                for (auto e = start; e < stop; e++)
+                    z[shape::getIndexOffset(e, output->shapeInfo())] = SelectionEngine<T>::nth(x + pack.primaryOffsets()[e], width, xStride, n, reverse, 1);
             };
 
-            samediff::Threads::parallel_for(func, 0, oL);
+            samediff::Threads::parallel_tad(func, 0, numOfSubArrs);
+        } else {
+            for (Nd4jLong e = 0; e < numOfSubArrs; e++)
+                z[shape::getIndexOffset(e, output->shapeInfo())] = SelectionEngine<T>::nth(x + pack.primaryOffsets()[e], width, xStride, n, reverse, maxThreads);
         }
     }
 
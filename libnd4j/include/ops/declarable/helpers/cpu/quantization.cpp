@@ -0,0 +1,264 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/quantization.h>
+#include <helpers/PackedGemm.h>
+#include <execution/Threads.h>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+    // patches of conv2d are gathered in chunks of rows, so columns buffer stays within this number of bytes
+    static const Nd4jLong QUANTIZED_COLUMNS_BUDGET = 1 << 24;
+
+    // per-tensor values are repeated for all channels, so kernels don't have to check
+    static std::vector<float> channelScales(const NDArray &scale, const Nd4jLong channels) {
+        std::vector<float> result(channels);
+        for (Nd4jLong c = 0; c < channels; c++)
+            result[c] = scale.e<float>(scale.lengthOf() == 1 ? 0 : c);
+
+        return result;
+    }
+
+    static std::vector<int32_t> channelZeroPoints(const NDArray &zeroPoint, const Nd4jLong channels) {
+        std::vector<int32_t> result(channels);
+        for (Nd4jLong c = 0; c < channels; c++)
+            result[c] = zeroPoint.e<int32_t>(zeroPoint.lengthOf() == 1 ? 0 : c);
+
+        return result;
+    }
+
+    template <typename X, typename Q>
+    static void quantizeLinear_(const NDArray &input, const std::vector<float> &scales, const std::vector<int32_t> &zeroPoints, const int quantMin, const int quantMax, NDArray &output) {
+        auto x = input.bufferAsT<X>();
+        auto z = output.bufferAsT<Q>();
+        const auto channels = static_cast<Nd4jLong>(scales.size());
+        const bool contiguous = input.ews() == 1 && output.ews() == 1 && input.ordering() == 'c' && output.ordering() == 'c';
+        const float low = static_cast<float>(quantMin);
+        const float high = static_cast<float>(quantMax);
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto i = start; i < stop; i++) {
+                const auto c = i % channels;
+                const auto xOffset = contiguous ? i : shape::getIndexOffset(i, input.shapeInfo());
+                const auto zOffset = contiguous ? i : shape::getIndexOffset(i, output.shapeInfo());
+
+                // clamping is done before conversion, so huge values and NaNs don't overflow
+                auto value = sd::math::nd4j_floor<float, float>(static_cast<float>(x[xOffset]) / scales[c] + 0.5f) + static_cast<float>(zeroPoints[c]);
+                if (!(value >= low))
+                    value = low;
+                else if (value > high)
+                    value = high;
+
+                z[zOffset] = static_cast<Q>(static_cast<int>(value));
+            }
+        };
+
+        samediff::Threads::parallel_for(func, 0, input.lengthOf());
+    }
+
+    template <typename Q, typename Z>
+    static void dequantizeLinear_(const NDArray &input, const std::vector<float> &scales, const std::vector<int32_t> &zeroPoints, NDArray &output) {
+        auto x = input.bufferAsT<Q>();
+        auto z = output.bufferAsT<Z>();
+        const auto channels = static_cast<Nd4jLong>(scales.size());
+        const bool contiguous = input.ews() == 1 && output.ews() == 1 && input.ordering() == 'c' && output.ordering() == 'c';
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto i = start; i < stop; i++) {
+                const auto c = i % channels;
+                const auto xOffset = contiguous ? i : shape::getIndexOffset(i, input.shapeInfo());
+                const auto zOffset = contiguous ? i : shape::getIndexOffset(i, output.shapeInfo());
+
+                z[zOffset] = static_cast<Z>(static_cast<float>(static_cast<int32_t>(x[xOffset]) - zeroPoints[c]) * scales[c]);
+            }
+        };
+
+        samediff::Threads::parallel_for(func, 0, input.lengthOf());
+    }
+
+    // z = multipliers[n] * acc + biases[n] for rows of int32 accumulators, row r of output starts at rowOffsets[r]
+    template <typename Z>
+    static void rescale_(const int32_t *acc, const Nd4jLong rows, const Nd4jLong cols, const std::vector<float> &multipliers, const std::vector<float> &biases,
+                         NDArray &output, const std::vector<Nd4jLong> &rowOffsets, const Nd4jLong colStride) {
+        auto z = output.bufferAsT<Z>();
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto r = start; r < stop; r++) {
+                auto row = acc + r * cols;
+                auto zRow = z + rowOffsets[r];
+                for (Nd4jLong n = 0; n < cols; n++)
+                    zRow[n * colStride] = static_cast<Z>(multipliers[n] * static_cast<float>(row[n]) + biases[n]);
+            }
+        };
+
+        samediff::Threads::parallel_for(func, 0, rows);
+    }
+
+    template <typename Q>
+    static void gatherPatches_(const NDArray &input, const Q zeroPoint, Q *columns, const Nd4jLong rowStart, const Nd4jLong rows,
+                               const int oH, const int oW, const int kH, const int kW, const int sH, const int sW, const int pH, const int pW, const int dH, const int dW) {
+        auto x = input.bufferAsT<Q>();
+        const int iH = input.sizeAt(1);
+        const int iW = input.sizeAt(2);
+        const int iC = input.sizeAt(3);
+        const Nd4jLong s0 = input.strideAt(0), s1 = input.strideAt(1), s2 = input.strideAt(2), s3 = input.strideAt(3);
+        const Nd4jLong cols = static_cast<Nd4jLong>(kH) * kW * iC;
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto r = start; r < stop; r++) {
+                const auto row = rowStart + r;
+                const auto b = row / (static_cast<Nd4jLong>(oH) * oW);
+                const int oh = (row / oW) % oH;
+                const int ow = row % oW;
+
+                auto dst = columns + r * cols;
+                for (int kh = 0; kh < kH; kh++) {
+                    const int ih = oh * sH - pH + kh * dH;
+                    for (int kw = 0; kw < kW; kw++, dst += iC) {
+                        const int iw = ow * sW - pW + kw * dW;
+                        if (ih < 0 || ih >= iH || iw < 0 || iw >= iW) {
+                            std::memset(dst, static_cast<int>(zeroPoint), iC * sizeof(Q));
+                            continue;
+                        }
+
+                        auto src = x + b * s0 + ih * s1 + iw * s2;
+                        if (s3 == 1)
+                            std::memcpy(dst, src, iC * sizeof(Q));
+                        else
+                            for (int c = 0; c < iC; c++)
+                                dst[c] = src[c * s3];
+                    }
+                }
+            }
+        };
+
+        samediff::Threads::parallel_for(func, 0, rows);
+    }
+
+    void quantizeLinear(sd::LaunchContext *context, const NDArray &input, const NDArray &scale, const NDArray &zeroPoint, int quantMin, int quantMax, NDArray &output) {
+        const auto channels = scale.lengthOf() == 1 ? 1 : input.sizeAt(-1);
+        auto scales = channelScales(scale, channels);
+        auto zeroPoints = channelZeroPoints(zeroPoint, channels);
+
+        BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), quantizeLinear_, (input, scales, zeroPoints, quantMin, quantMax, output), FLOAT_TYPES, QUANTIZED_TYPES);
+    }
+
+    void dequantizeLinear(sd::LaunchContext *context, const NDArray &input, const NDArray &scale, const NDArray &zeroPoint, NDArray &output) {
+        const auto channels = scale.lengthOf() == 1 ? 1 : input.sizeAt(-1);
+        auto scales = channelScales(scale, channels);
+        auto zeroPoints = channelZeroPoints(zeroPoint, channels);
+
+        BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), dequantizeLinear_, (input, scales, zeroPoints, output), QUANTIZED_TYPES, FLOAT_TYPES);
+    }
+
+    void quantizedMatmul(sd::LaunchContext *context, const NDArray &a, const NDArray &aScale, const NDArray &aZeroPoint,
+                         const NDArray &b, const NDArray &bScale, const NDArray &bZeroPoint, const NDArray *bias, NDArray &output) {
+        const Nd4jLong M = a.sizeAt(0);
+        const Nd4jLong K = a.sizeAt(1);
+        const Nd4jLong N = b.sizeAt(1);
+
+        auto bZeroPoints = channelZeroPoints(bZeroPoint, bZeroPoint.lengthOf() == 1 ? 1 : N);
+        auto multipliers = channelScales(bScale, N);
+        const auto scaleA = aScale.e<float>(0);
+        for (auto &v: multipliers)
+            v *= scaleA;
+
+        std::vector<float> biases(N, 0.f);
+        if (bias != nullptr)
+            biases = channelScales(*bias, N);
+
+        std::vector<int32_t> acc(M * N);
+        PackedGemm::gemmQuantized(a.dataType(), b.dataType(), M, N, K,
+                                  a.buffer(), a.strideAt(0), a.strideAt(1), aZeroPoint.e<int>(0),
+                                  b.buffer(), b.strideAt(0), b.strideAt(1), bZeroPoints.data(), bZeroPoints.size() > 1 ? 1 : 0,
+                                  acc.data(), N, 1);
+
+        std::vector<Nd4jLong> rowOffsets(M);
+        for (Nd4jLong m = 0; m < M; m++)
+            rowOffsets[m] = m * output.strideAt(0);
+
+        BUILD_SINGLE_SELECTOR(output.dataType(), rescale_, (acc.data(), M, N, multipliers, biases, output, rowOffsets, output.strideAt(1)), FLOAT_TYPES);
+    }
+
+    void quantizedConv2d(sd::LaunchContext *context, const NDArray &input, const NDArray &inScale, const NDArray &inZeroPoint,
+                         const NDArray &weights, const NDArray &wScale, const NDArray &wZeroPoint, const NDArray *bias, NDArray &output,
+                         int kH, int kW, int sH, int sW, int pH, int pW, int dH, int dW) {
+        const Nd4jLong bS = input.sizeAt(0);
+        const Nd4jLong iC = input.sizeAt(3);
+        const int oH = output.sizeAt(1);
+        const int oW = output.sizeAt(2);
+        const Nd4jLong oC = output.sizeAt(3);
+        const Nd4jLong K = kH * kW * iC;
+        const Nd4jLong rows = bS * oH * oW;
+
+        // weights are used as [kH * kW * iC, oC] matrix, so first three dimensions must be mergeable
+        std::unique_ptr<NDArray> weightsCopy;
+        auto w = &weights;
+        if (weights.strideAt(1) != iC * weights.strideAt(2) || weights.strideAt(0) != kW * weights.strideAt(1)) {
+            weightsCopy.reset(new NDArray(weights.dup('c')));
+            w = weightsCopy.get();
+        }
+
+        auto wZeroPoints = channelZeroPoints(wZeroPoint, wZeroPoint.lengthOf() == 1 ? 1 : oC);
+        auto multipliers = channelScales(wScale, oC);
+        const auto scaleIn = inScale.e<float>(0);
+        for (auto &v: multipliers)
+            v *= scaleIn;
+
+        std::vector<float> biases(oC, 0.f);
+        if (bias != nullptr)
+            biases = channelScales(*bias, oC);
+
+        const auto zeroPoint = inZeroPoint.e<int>(0);
+        const Nd4jLong chunk = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(rows, QUANTIZED_COLUMNS_BUDGET / K));
+
+        std::vector<int8_t> columns(chunk * K);
+        std::vector<int32_t> acc(chunk * oC);
+        std::vector<Nd4jLong> rowOffsets(chunk);
+
+        for (Nd4jLong rowStart = 0; rowStart < rows; rowStart += chunk) {
+            const auto length = sd::math::nd4j_min<Nd4jLong>(chunk, rows - rowStart);
+
+            if (input.dataType() == sd::DataType::UINT8)
+                gatherPatches_<uint8_t>(input, static_cast<uint8_t>(zeroPoint), reinterpret_cast<uint8_t*>(columns.data()), rowStart, length, oH, oW, kH, kW, sH, sW, pH, pW, dH, dW);
+            else
+                gatherPatches_<int8_t>(input, static_cast<int8_t>(zeroPoint), columns.data(), rowStart, length, oH, oW, kH, kW, sH, sW, pH, pW, dH, dW);
+
+            PackedGemm::gemmQuantized(input.dataType(), w->dataType(), length, oC, K,
+                                      columns.data(), K, 1, zeroPoint,
+                                      w->buffer(), w->strideAt(2), w->strideAt(3), wZeroPoints.data(), wZeroPoints.size() > 1 ? 1 : 0,
+                                      acc.data(), oC, 1);
+
+            for (Nd4jLong r = 0; r < length; r++) {
+                const auto row = rowStart + r;
+                rowOffsets[r] = (row / (oH * oW)) * output.strideAt(0) + ((row / oW) % oH) * output.strideAt(1) + (row % oW) * output.strideAt(2);
+            }
+
+            BUILD_SINGLE_SELECTOR(output.dataType(), rescale_, (acc.data(), length, oC, multipliers, biases, output, rowOffsets, output.strideAt(3)), FLOAT_TYPES);
+        }
+    }
+}
+}
+}
@@ -21,6 +21,8 @@
 #include <ops/declarable/helpers/sg_cb.h>
 #include <ops/specials.h>
 #include <execution/Threads.h>
+#include <algorithm>
+#include <vector>
 
 #define HS_MAX_EXP 6.0f
 
@@ -290,142 +292,363 @@ namespace sd {
                 return (haystack[halfIndex] == needle) ? halfIndex : -1;
             }
 
+            /**
+             * Batched engine for skipgram and cbow batch modes.
+             *
+             * Targets are processed in windows of fixed size. Consecutive targets with the same output rows (same positive word
+             * and Huffman path, i.e. context words of the same center word) form a group sharing negative samples, so group inputs
+             * H [G x V] and outputs O [R x V] give dot products and gradients as small GEMMs:
+             *   S = H * O^T,  g = (label - sigmoid(S)) * alpha,  dH = g * O,  dO = g^T * H
+             *
+             * All groups of a window read weights as they were before the window, and write their deltas into own buffers.
+             * Deltas are applied afterwards: updates are sorted by destination row, rows are sharded between threads, and deltas
+             * of each row are added in order of targets. So results don't depend on number of threads, and rows are never raced for.
+             */
             template <typename T>
-            static void do_update(const int target, const int rowIndex, const int count, T *syn0, T *neu1t, const int vectorLength) {
+            class Word2VecBatch {
+            private:
+                // number of targets read from the same snapshot of weights
+                static const int WINDOW = 256;
+
+                // group size is limited, so that its buffers stay in cache
+                static const int GROUP_LIMIT = 64;
+
+                struct Output {
+                    T *row;
+                    T label;
+                    int hs;
+                };
 
-                auto syn0row = syn0 + (target * vectorLength);
-                auto neu1e = neu1t + (rowIndex * vectorLength);
-                for (int e = 0; e< vectorLength; e++)
-                    syn0row[e] += neu1e[e] / count;
-            }
+                struct Group {
+                    Nd4jLong first;
+                    Nd4jLong size;
+                    Nd4jLong outputs;
+                    Nd4jLong numOutputs;
+                };
 
-            template <typename T>
-            static void do_positive(const int target, const int postive, T* syn0, T* syn1Neg, T* expTable, T* neu1e, const double alpha, const int vectorLength, const int expLength) {
-                //nd4j_printf("Target: [%i]; Positive: [%i]; TID: [%i];\n", target, postive, omp_get_thread_num());
-                nSampling_<T>(syn0, syn1Neg, expTable, neu1e, alpha, vectorLength, 1, expLength, false);
-            }
+                struct Update {
+                    T *row;
+                    const T *delta;
+                };
 
-            template <typename T>
-            static void do_negative(int target, int positive, T* syn0, T* syn1Neg, T* expTable, T* negTable, T* neu1e, int *sStarters, const double alpha, const unsigned long long rv, const int vocabSize, const int vectorLength, const int expLength, const int negLength, const int nsRounds, const int numThreads, const int numTargets) {
-                int irow = 0;
-                unsigned long long randomValue = rv;
-                for (int r = 0; r < nsRounds; r++) {
-                    randomValue = sd::math::nd4j_abs<Nd4jLong>(randomValue * (unsigned long long) 25214903917 + 11);
-                    auto idx = sd::math::nd4j_abs<Nd4jLong>((randomValue >> 16) % negLength);
-                    irow = idx >= negLength ? -1 : static_cast<int>(negTable[idx]);
+                const int _vectorLength;
+                const T *_expTable;
+                const int _expLength;
+                const int _numThreads;
+
+                // per target: input vector, its delta, learning rate and rows of syn0 the delta goes to
+                std::vector<T> _inputs;
+                std::vector<T> _inputDeltas;
+                // learning rates stay double, as single-row functions get them
+                std::vector<double> _alphas;
+                std::vector<Nd4jLong> _rowsOffsets;
+                std::vector<T*> _rows;
+
+                std::vector<Output> _outputs;
+                std::vector<T> _outputDeltas;
+                std::vector<Group> _groups;
+                std::vector<Update> _updates;
+
+                static FORCEINLINE T dot(const T *x, const T *y, int length) {
+                    T sum0 = (T) 0.f, sum1 = (T) 0.f, sum2 = (T) 0.f, sum3 = (T) 0.f;
+
+                    int e = 0;
+                    for (; e + 4 <= length; e += 4) {
+                        sum0 += x[e] * y[e];
+                        sum1 += x[e + 1] * y[e + 1];
+                        sum2 += x[e + 2] * y[e + 2];
+                        sum3 += x[e + 3] * y[e + 3];
+                    }
 
-                    if (irow < 0 || irow >= vocabSize)
-                        irow = randomValue % (vocabSize - 1) + 1;
+                    for (; e < length; e++)
+                        sum0 += x[e] * y[e];
 
-                    if (irow == positive)
-                        continue;
+                    return (sum0 + sum1) + (sum2 + sum3);
+                }
 
-                    // we shift irow here to guarantee independence
+                static FORCEINLINE void axpy(T alpha, const T *x, T *y, int length) {
+                    PRAGMA_OMP_SIMD
+                    for (int e = 0; e < length; e++)
+                        y[e] += alpha * x[e];
+                }
 
-                    int dim = irow % numThreads;
-                    if (dim != omp_get_thread_num()) {
-                        irow += (numThreads - dim + omp_get_thread_num());
+                void processGroup(const Group &group, std::vector<T> &o, std::vector<T> &g) {
+                    const auto G = group.size;
+                    const auto R = group.numOutputs;
+                    const auto V = _vectorLength;
+
+                    // output rows are gathered once, and then used by all targets of the group
+                    o.resize(R * V);
+                    for (Nd4jLong r = 0; r < R; r++)
+                        memcpy(o.data() + r * V, _outputs[group.outputs + r].row, V * sizeof(T));
+
+                    g.resize(G * R);
+                    for (Nd4jLong i = 0; i < G; i++) {
+                        auto h = _inputs.data() + (group.first + i) * V;
+                        for (Nd4jLong r = 0; r < R; r++)
+                            g[i * R + r] = dot(h, o.data() + r * V, V);
+                    }
+
+                    // gradients for the whole G x R block. expressions are the same as in hSoftmax_ and nSampling_,
+                    // including types of intermediate values, so batched results match single-row ones
+                    const auto outputs = _outputs.data() + group.outputs;
+                    for (Nd4jLong i = 0; i < G; i++) {
+                        const auto alpha = _alphas[group.first + i];
+                        auto gi = g.data() + i * R;
+
+                        for (Nd4jLong r = 0; r < R; r++) {
+                            const T dot = gi[r];
+                            const auto label = outputs[r].label;
+
+                            if (outputs[r].hs != 0) {
+                                // saturated dots and out of range indices are skipped
+                                gi[r] = (T) 0.f;
+                                if (dot < (T) - HS_MAX_EXP || dot >= (T) HS_MAX_EXP)
+                                    continue;
+
+                                int idx = static_cast<int>((dot + HS_MAX_EXP) * ((float) _expLength / HS_MAX_EXP / 2.0f));
+                                if (idx >= _expLength || idx < 0)
+                                    continue;
+
+                                gi[r] = (label - _expTable[idx]) * (T) alpha;
+                            } else {
+                                // saturated dots use saturated gradient, out of range indices are skipped
+                                const int code = static_cast<int>(label);
+                                if (dot > HS_MAX_EXP)
+                                    gi[r] = (code - 1) * alpha;
+                                else if (dot < (T) - HS_MAX_EXP)
+                                    gi[r] = (code - 0) * alpha;
+                                else {
+                                    int idx = (int) ((dot + (T) HS_MAX_EXP) * ((T) _expLength / HS_MAX_EXP / 2.0));
+                                    gi[r] = idx >= _expLength || idx < 0 ? (T) 0.f : ((T) code - _expTable[idx]) * alpha;
+                                }
+                            }
+                        }
+                    }
+
+                    // dH = g * O
+                    for (Nd4jLong i = 0; i < G; i++) {
+                        auto dh = _inputDeltas.data() + (group.first + i) * V;
+                        memset(dh, 0, V * sizeof(T));
+                        for (Nd4jLong r = 0; r < R; r++)
+                            axpy(g[i * R + r], o.data() + r * V, dh, V);
+                    }
+
+                    // dO = g^T * H
+                    for (Nd4jLong r = 0; r < R; r++) {
+                        auto dout = _outputDeltas.data() + (group.outputs + r) * V;
+                        memset(dout, 0, V * sizeof(T));
+                        for (Nd4jLong i = 0; i < G; i++)
+                            axpy(g[i * R + r], _inputs.data() + (group.first + i) * V, dout, V);
+                    }
+                }
 
-                        // roll back to nearest affilated word
-                        while (irow >= vocabSize)
-                            irow -= numThreads;
+                void applyUpdates() {
+                    _updates.clear();
 
-                        // if this row was processed as first step somewhere - skip it
-                        if (binarySearch(sStarters, irow, numTargets) > 0) {
-                            r--;
+                    for (const auto &group : _groups) {
+                        if (group.numOutputs == 0)
                             continue;
+
+                        for (auto t = group.first; t < group.first + group.size; t++)
+                            for (auto r = _rowsOffsets[t]; r < _rowsOffsets[t + 1]; r++)
+                                _updates.push_back({_rows[r], _inputDeltas.data() + t * _vectorLength});
+
+                        for (auto r = group.outputs; r < group.outputs + group.numOutputs; r++)
+                            _updates.push_back({_outputs[r].row, _outputDeltas.data() + r * _vectorLength});
+                    }
+
+                    // stable sort keeps order of targets for deltas of the same row
+                    std::stable_sort(_updates.begin(), _updates.end(), [](const Update &a, const Update &b) -> bool { return a.row < b.row; });
+
+                    const Nd4jLong numUpdates = _updates.size();
+                    const Nd4jLong numShards = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(_numThreads, numUpdates / 16));
+                    std::vector<Nd4jLong> bounds(numShards + 1, numUpdates);
+                    bounds[0] = 0;
+                    for (Nd4jLong s = 1; s < numShards; s++) {
+                        // shard boundaries are moved to the next row, so each row belongs to exactly one shard
+                        auto b = sd::math::nd4j_max<Nd4jLong>(bounds[s - 1], s * numUpdates / numShards);
+                        while (b > 0 && b < numUpdates && _updates[b].row == _updates[b - 1].row)
+                            b++;
+
+                        bounds[s] = b;
+                    }
+
+                    auto func = PRAGMA_THREADS_FOR {
+                        for (auto s = start; s < stop; s++)
+                            for (auto u = bounds[s]; u < bounds[s + 1]; u++)
+                                axpy((T) 1.f, _updates[u].delta, _updates[u].row, _vectorLength);
+                    };
+
+                    if (numShards > 1)
+                        samediff::Threads::parallel_tad(func, 0, numShards, 1, _numThreads);
+                    else
+                        func(0, 0, numShards, 1);
+                }
+
+            public:
+                Word2VecBatch(int vectorLength, const T *expTable, int expLength, int numThreads) : _vectorLength(vectorLength), _expTable(expTable), _expLength(expLength), _numThreads(sd::math::nd4j_max<int>(1, numThreads)) {
+                    _rowsOffsets.push_back(0);
+                }
+
+                static int window() {
+                    return WINDOW;
+                }
+
+                /**
+                 * Adds target and returns its input vector to be filled in. Target either joins current group, or starts a new one
+                 */
+                T* addTarget(double alpha, bool newGroup) {
+                    const Nd4jLong t = _alphas.size();
+                    if (newGroup || _groups.empty() || _groups.back().size >= GROUP_LIMIT) {
+                        const Nd4jLong outputs = _outputs.size();
+                        const Nd4jLong numOutputs = _groups.empty() || newGroup ? 0 : _groups.back().numOutputs;
+
+                        // group without new outputs continues to use outputs of the previous one
+                        if (!newGroup && !_groups.empty()) {
+                            for (Nd4jLong r = 0; r < numOutputs; r++)
+                                _outputs.push_back(_outputs[_groups.back().outputs + r]);
                         }
+
+                        _groups.push_back({t, 0, outputs, numOutputs});
                     }
 
+                    _groups.back().size++;
+                    _alphas.push_back(alpha);
+                    _rowsOffsets.push_back(_rows.size());
+                    _inputs.resize(_inputs.size() + _vectorLength, (T) 0.f);
 
-                    nSampling_<T>(syn0, syn1Neg + (irow * vectorLength), expTable, neu1e, alpha, vectorLength,  0, expLength, false);
+                    return _inputs.data() + t * _vectorLength;
                 }
-            }
 
-            template <typename T>
-            void skipgramBatchExec_(NDArray &s0, NDArray &s1, NDArray &s1n, void *vexpTable, void *vnegTable, void *vinfVector, NDArray &targets, NDArray &negStarters, NDArray &indices, NDArray &codes, NDArray &lr, NDArray &nextRandom, const int nsRounds, const int vocabSize, const int vectorLength, const int expLength, const int negLength, const bool preciseMode, const int numThreads) {
-                //auto syn0 = reinterpret_cast<T*>(vsyn0);
-                //auto syn1 = reinterpret_cast<T*>(vsyn1);
-                //auto syn1Neg = reinterpret_cast<T*>(vsyn1Neg);
-                const auto expTable = reinterpret_cast<T*>(vexpTable);
-                const auto negTable = reinterpret_cast<T*>(vnegTable);
-                const auto infVector = reinterpret_cast<T*>(vinfVector);
+                /**
+                 * Row of syn0 which gets delta of the last target's input
+                 */
+                void addInputRow(T *row) {
+                    _rows.push_back(row);
+                    _rowsOffsets.back() = _rows.size();
+                }
 
-                //const auto numThreads = omp_get_max_threads();
-                const auto idxShift = indices.isEmpty() ? 0 : indices.sizeAt(1);
-                const auto hsRounds = codes.isEmpty() ? 0 : codes.sizeAt(1);
+                /**
+                 * Adds output row to the current group. Label is 1 for positive word, 0 for negative one, and 1 - code for hierarchic softmax
+                 */
+                void addOutput(T *row, int label, bool hs) {
+                    _outputs.push_back({row, static_cast<T>(label), hs ? 1 : 0});
+                    _groups.back().numOutputs++;
+                }
+
+                Nd4jLong size() const {
+                    return _alphas.size();
+                }
 
-                    // regular mode provides 0 guarantees for reproducibility
-                    auto numTargets = targets.lengthOf();
-                    auto bTarget = targets.bufferAsT<int>();
-                    auto bIndices = indices.bufferAsT<int>();
-                    auto bCodes = codes.bufferAsT<int8_t>();
+                void run() {
+                    _inputDeltas.resize(_inputs.size());
+                    _outputDeltas.resize(_outputs.size() * _vectorLength);
 
+                    const Nd4jLong numGroups = _groups.size();
                     auto func = PRAGMA_THREADS_FOR {
-                        T sneu1e[600];
+                        std::vector<T> o;
+                        std::vector<T> g;
+                        for (auto e = start; e < stop; e++)
+                            if (_groups[e].numOutputs > 0)
+                                processGroup(_groups[e], o, g);
+                    };
 
-                        for (auto t = start; t < stop; t++) {
-                            T *neu1e = vectorLength <= 600 ? sneu1e : new T[vectorLength];
-                            memset(neu1e, 0, vectorLength * sizeof(T));
+                    if (numGroups > 1 && _numThreads > 1)
+                        samediff::Threads::parallel_tad(func, 0, numGroups, 1, _numThreads);
+                    else
+                        func(0, 0, numGroups, 1);
 
-                            auto target = bTarget[t];
-                            auto alpha = lr.e<double>(t);
-                            unsigned long long randomValue = nextRandom.e<Nd4jLong>(t);
+                    applyUpdates();
 
-                            auto syn0row = reinterpret_cast<T *>(s0.bufferWithOffset(target * vectorLength));
+                    _inputs.clear();
+                    _alphas.clear();
+                    _rows.clear();
+                    _rowsOffsets.resize(1);
+                    _outputs.clear();
+                    _groups.clear();
+                }
+            };
 
-                            if (hsRounds > 0) {
-                                int irow = 0;
-                                auto cShift = t * idxShift;
+            /**
+             * Adds negative sampling rounds for target, with the same sampling as single-row skipgram and cbow use
+             */
+            template <typename T>
+            static void addNegatives(Word2VecBatch<T> &batch, T *syn1Neg, const T *negTable, int nsStarter, unsigned long long randomValue, const int nsRounds, const int vocabSize, const int vectorLength, const int negLength) {
+                batch.addOutput(syn1Neg + (static_cast<Nd4jLong>(nsStarter) * vectorLength), 1, false);
 
-                                for (Nd4jLong e = 0; e < hsRounds; e++) {
-                                    irow = bIndices[e + cShift];
-                                    if (irow < 0 || irow >= vocabSize)
-                                        continue;
+                for (int r = 1; r < nsRounds + 1; r++) {
+                    randomValue = randomValue * (unsigned long long) 25214903917 + 11;
+                    auto idx = sd::math::nd4j_abs<Nd4jLong>((randomValue >> 16) % negLength);
+                    int irow = idx >= negLength ? -1 : static_cast<int>(negTable[idx]);
 
-                                    auto syn1row = s1.bufferWithOffset(irow * vectorLength);
-                                    auto code = bCodes[e + cShift];
+                    if (irow < 0 || irow >= vocabSize)
+                        irow = randomValue % (vocabSize - 1) + 1;
 
-                                    //nd4j_printf("syn0: [%i]; syn1: [%i]; code: [%i]\n", target, irow, code);
-                                    hSoftmax_<T>(syn0row, syn1row, expTable, neu1e, alpha, vectorLength, code,
-                                                 expLength, false);
-                                }
-                            }
+                    if (irow == nsStarter)
+                        continue;
 
+                    batch.addOutput(syn1Neg + (static_cast<Nd4jLong>(irow) * vectorLength), 0, false);
+                }
+            }
 
-                            if (nsRounds > 0) {
-                                int irow = negStarters.e<int>(t);
-                                int nsStarter = irow;
-                                for (int r = 0; r < nsRounds + 1; r++) {
-                                    if (r == 0) {
-                                        // target is known in advance
-                                    } else {
-                                        randomValue = randomValue * (unsigned long long) 25214903917 + 11;
-                                        auto idx = sd::math::nd4j_abs<Nd4jLong>((randomValue >> 16) % negLength);
-                                        irow = idx >= negLength ? -1 : static_cast<int>(negTable[idx]);
+            template <typename T>
+            void skipgramBatchExec_(NDArray &s0, NDArray &s1, NDArray &s1n, void *vexpTable, void *vnegTable, void *vinfVector, NDArray &targets, NDArray &negStarters, NDArray &indices, NDArray &codes, NDArray &lr, NDArray &nextRandom, const int nsRounds, const int vocabSize, const int vectorLength, const int expLength, const int negLength, const bool preciseMode, const int numThreads) {
+                const auto syn0 = s0.bufferAsT<T>();
+                const auto syn1 = s1.isEmpty() ? nullptr : s1.bufferAsT<T>();
+                const auto syn1Neg = s1n.isEmpty() ? nullptr : s1n.bufferAsT<T>();
+                const auto expTable = reinterpret_cast<T*>(vexpTable);
+                const auto negTable = reinterpret_cast<T*>(vnegTable);
 
-                                        if (irow < 0 || irow >= vocabSize)
-                                            irow = randomValue % (vocabSize - 1) + 1;
+                const auto idxShift = indices.isEmpty() ? 0 : indices.sizeAt(1);
+                const auto hsRounds = codes.isEmpty() ? 0 : codes.sizeAt(1);
+                const bool useNegatives = nsRounds > 0 && !negStarters.isEmpty();
 
-                                        if (irow == nsStarter)
-                                            continue;
-                                    }
+                const auto numTargets = targets.lengthOf();
+                const auto bTarget = targets.bufferAsT<int>();
+                const auto bIndices = indices.isEmpty() ? nullptr : indices.bufferAsT<int>();
+                const auto bCodes = codes.isEmpty() ? nullptr : codes.bufferAsT<int8_t>();
+                const auto bStarters = useNegatives ? negStarters.bufferAsT<int>() : nullptr;
 
-                                    nSampling_<T>(syn0row, s1n.bufferWithOffset(irow * vectorLength), expTable, neu1e,
-                                                  alpha, vectorLength, r == 0 ? 1 : 0, expLength, infVector != nullptr);
-                                }
-                            }
+                Word2VecBatch<T> batch(vectorLength, expTable, expLength, numThreads);
+
+                for (Nd4jLong t = 0; t < numTargets; t++) {
+                    const auto cShift = t * idxShift;
+
+                    // rows with the same positive word and Huffman path share outputs: that's the same center word
+                    bool newGroup = t == 0 || batch.size() == 0;
+                    if (!newGroup && useNegatives)
+                        newGroup = bStarters[t] != bStarters[t - 1];
 
-                            for (int e = 0; e < vectorLength; e++)
-                                syn0row[e] += neu1e[e];
+                    if (!newGroup && hsRounds > 0)
+                        for (Nd4jLong e = 0; e < hsRounds && !newGroup; e++)
+                            newGroup = bIndices[e + cShift] != bIndices[e + cShift - idxShift] || bCodes[e + cShift] != bCodes[e + cShift - idxShift];
 
-                            // optionally release temp arrays
-                            if (vectorLength > 600)
-                                delete[] neu1e;
+                    auto syn0row = syn0 + (static_cast<Nd4jLong>(bTarget[t]) * vectorLength);
+                    auto input = batch.addTarget(lr.e<double>(t), newGroup);
+                    memcpy(input, syn0row, vectorLength * sizeof(T));
+                    batch.addInputRow(syn0row);
+
+                    if (newGroup) {
+                        for (Nd4jLong e = 0; e < hsRounds; e++) {
+                            // Huffman path ends at the first invalid index, same as in skipgram_
+                            auto irow = bIndices[e + cShift];
+                            if (irow < 0 || irow >= vocabSize)
+                                break;
+
+                            batch.addOutput(syn1 + (static_cast<Nd4jLong>(irow) * vectorLength), 1 - bCodes[e + cShift], true);
                         }
-                    };
 
-                    samediff::Threads::parallel_tad(func, 0, numTargets, 1, numThreads);
+                        if (useNegatives)
+                            addNegatives<T>(batch, syn1Neg, negTable, bStarters[t], nextRandom.e<Nd4jLong>(t), nsRounds, vocabSize, vectorLength, negLength);
+                    }
+
+                    if (batch.size() >= Word2VecBatch<T>::window())
+                        batch.run();
+                }
+
+                if (batch.size() > 0)
+                    batch.run();
             }
             BUILD_SINGLE_TEMPLATE(template void skipgramBatchExec_, (NDArray &s0, NDArray &s1, NDArray &s1n, void *vexpTable, void *vnegTable, void *vinfVector, NDArray &targets, NDArray &negStarters, NDArray &indices, NDArray &codes, NDArray &lr, NDArray &nextRandom, const int nsRounds, const int vocabSize, const int vectorLength, const int expLength, const int negLength, const bool preciseMode, const int numThreads), FLOAT_TYPES);
 
@@ -433,151 +656,104 @@ namespace sd {
             template <typename T>
             void cbowBatchExec_(NDArray &s0, NDArray &s1, NDArray &s1n, void *vexpTable, void *vnegTable, void *vinfVector, NDArray &context, NDArray &lockedWords, NDArray &targets, NDArray &negStarters, NDArray &indices, NDArray &codes, NDArray &lr, NDArray &nextRandom, NDArray &nLabels, const int nsRounds, const int vocabSize, const int vectorLength, const int expLength, const int negLength, const bool trainWords, const int numThreads) {
                 const auto syn0 = s0.bufferAsT<T>();
-                const auto syn1 = s1.bufferAsT<T>();
-                const auto syn1Neg = s1n.bufferAsT<T>();
+                const auto syn1 = s1.isEmpty() ? nullptr : s1.bufferAsT<T>();
+                const auto syn1Neg = s1n.isEmpty() ? nullptr : s1n.bufferAsT<T>();
 
                 const auto expTable = reinterpret_cast<T*>(vexpTable);
                 const auto negTable = reinterpret_cast<T*>(vnegTable);
-                const auto infVector = reinterpret_cast<T*>(vinfVector);
 
-                //const auto numThreads = omp_get_max_threads();
-                const auto idxShift = indices.isEmpty() ? 0 : indices.sizeAt(1);
-                const auto hsRounds = codes.isEmpty() ? 0 : codes.sizeAt(1);
                 const auto numTargets = context.sizeAt(0);
                 const int contextWidth = context.sizeAt(1);
+                const bool useNegatives = nsRounds > 0 && !negStarters.isEmpty();
 
                 const auto bContext = context.bufferAsT<int>();
                 const auto bLocker = lockedWords.bufferAsT<int>();
-                const auto bIndices = indices.bufferAsT<int>();
-                const auto bCodes = codes.bufferAsT<int8_t>();
-                const auto bStarters = negStarters.bufferAsT<int>();
+                const auto bIndices = indices.isEmpty() ? nullptr : indices.bufferAsT<int>();
+                const auto bCodes = codes.isEmpty() ? nullptr : codes.bufferAsT<int8_t>();
+                const auto bStarters = useNegatives ? negStarters.bufferAsT<int>() : nullptr;
                 const auto numIndices = indices.isEmpty() ? 0 : indices.sizeAt(1);
 
-                auto func = PRAGMA_THREADS_FOR {
-                    T sneu1[600];
-                    T sneu1e[600];
-
-                    for (auto e = start; e < stop; e++) {
-                        T *neu1 = vectorLength <= 600 ? sneu1 : new T[vectorLength];
-                        T *neu1e = vectorLength <= 600 ? sneu1e : new T[vectorLength];
-
-                        // optionally we nullify temp arrays after successful (and on first) cycle
-                        memset(neu1, 0, sizeof(T) * vectorLength);
-                        memset(neu1e, 0, sizeof(T) * vectorLength);
+                Word2VecBatch<T> batch(vectorLength, expTable, expLength, numThreads);
 
-                        auto alpha = lr.e<double>(e);
-                        auto numLabels = nLabels.isEmpty() ? 0 : nLabels.e<int>(e);
+                for (Nd4jLong e = 0; e < numTargets; e++) {
+                    const auto numLabels = nLabels.isEmpty() ? 0 : nLabels.e<int>(e);
 
-                        int actualContext = 0;
+                    // windows sharing the same predicted word share its outputs
+                    bool newGroup = e == 0 || batch.size() == 0;
+                    if (!newGroup && useNegatives)
+                        newGroup = bStarters[e] != bStarters[e - 1];
 
-                        // building neu1 for current window
-                        for (int c = 0; c < contextWidth; c++) {
-                            // getting next context word
-                            auto cContext = bContext[c + (e * contextWidth)];
+                    if (!newGroup)
+                        for (Nd4jLong i = 0; i < numIndices && !newGroup; i++)
+                            newGroup = bIndices[(e * numIndices) + i] != bIndices[((e - 1) * numIndices) + i] || bCodes[(e * numIndices) + i] != bCodes[((e - 1) * numIndices) + i];
 
-                            // skipping padded values
-                            if (cContext < 0)
-                                continue;
-
-                            if (cContext >= vocabSize)
-                                throw std::runtime_error("ContextID can't be >= vocab size");
+                    auto neu1 = batch.addTarget(lr.e<double>(e), newGroup);
 
-                            T *syn0word = syn0 + (cContext * vectorLength);
+                    // building neu1 for current window
+                    int actualContext = 0;
+                    for (int c = 0; c < contextWidth; c++) {
+                        auto cContext = bContext[c + (e * contextWidth)];
 
-                            for (int i = 0; i < vectorLength; i++)
-                                neu1[i] += syn0word[i];
-
-                            actualContext++;
-                        }
-
-                        if (infVector != nullptr)
-                            actualContext++;
+                        // skipping padded values
+                        if (cContext < 0)
+                            continue;
 
-                        if (actualContext > 1) {
-                            for (int i = 0; i < vectorLength; i++)
-                                neu1[i] /= actualContext;
-                        }
+                        if (cContext >= vocabSize)
+                            throw std::runtime_error("ContextID can't be >= vocab size");
 
-                        // hierarchic softmax step
-                        if (!indices.isEmpty()) {
-                            for (Nd4jLong i = 0; i < numIndices; i++) {
-                                const int cIndex = bIndices[(e * numIndices) + i];
-                                const int cCode = bCodes[(e * numIndices) + i];
+                        T *syn0word = syn0 + (static_cast<Nd4jLong>(cContext) * vectorLength);
 
-                                // we're skipping padded values
-                                if (cIndex < 0)
-                                    continue;
+                        PRAGMA_OMP_SIMD
+                        for (int i = 0; i < vectorLength; i++)
+                            neu1[i] += syn0word[i];
 
-                                if (cIndex >= vocabSize)
-                                    throw std::runtime_error("Index can't be > vocab size");
-
-                                hSoftmax_<T>(neu1, syn1 + (cIndex * vectorLength), expTable, neu1e, alpha, vectorLength,
-                                             cCode, expLength, false);
-                            }
-                        }
+                        actualContext++;
+                    }
 
-                        // negative sampling step
-                        if (!negStarters.isEmpty() && nsRounds > 0) {
-                            int irow = bStarters[e];
-                            const int nsStarter = irow;
-                            unsigned long long randomValue = nextRandom.e<Nd4jLong>(e);
-
-                            for (int r = 0; r < nsRounds + 1; r++) {
-                                // we're skipping rng on 0 step
-                                if (r != 0) {
-                                    randomValue = randomValue * (unsigned long long) 25214903917 + 11;
-                                    auto idx = sd::math::nd4j_abs<Nd4jLong>((randomValue >> 16) % negLength);
-                                    irow = idx >= negLength ? -1 : static_cast<int>(negTable[idx]);
-
-                                    if (irow < 0 || irow >= vocabSize) irow = randomValue % (vocabSize - 1) + 1;
-                                    if (irow == nsStarter)
-                                        continue;
-
-                                    nSampling_<T>(neu1, s1n.bufferWithOffset(irow * vectorLength), expTable, neu1e,
-                                                  alpha, vectorLength, r == 0 ? 1 : 0, expLength, infVector != nullptr);
-                                } else {
-                                    nSampling_<T>(neu1, s1n.bufferWithOffset(irow * vectorLength), expTable, neu1e,
-                                                  alpha, vectorLength, r == 0 ? 1 : 0, expLength, infVector != nullptr);
-                                }
+                    if (actualContext > 1) {
+                        PRAGMA_OMP_SIMD
+                        for (int i = 0; i < vectorLength; i++)
+                            neu1[i] /= actualContext;
+                    }
 
-                                //nd4j_printf("Thread <%i>: syn0: [%i]; s1n: [%i];\n", omp_get_thread_num(), 0, irow);
-                            }
-                        }
+                    // if we're skipping labels
+                    int starter = trainWords == 1 ? 0 : contextWidth - numLabels;
+                    for (int c = starter; c < contextWidth; c++) {
+                        auto cContext = bContext[c + (e * contextWidth)];
+                        auto cLock = bLocker[c + (e * contextWidth)];
 
+                        // skipping padded values
+                        if (cContext < 0 || cLock == 1)
+                            continue;
 
-                        // if we're skipping labels
-                        int starter = trainWords == 1 ? 0 : contextWidth - numLabels;
+                        batch.addInputRow(syn0 + (static_cast<Nd4jLong>(cContext) * vectorLength));
+                    }
 
-                        // applying previously averaged results
-                        for (int c = starter; c < contextWidth; c++) {
-                            // getting context
-                            auto cContext = bContext[c + (e * contextWidth)];
-                            auto cLock = bLocker[c + (e * contextWidth)];
+                    if (newGroup) {
+                        for (Nd4jLong i = 0; i < numIndices; i++) {
+                            const int cIndex = bIndices[(e * numIndices) + i];
+                            const int cCode = bCodes[(e * numIndices) + i];
 
-                            // skipping padded values
-                            if (cContext < 0 || cLock == 1)
+                            // we're skipping padded values
+                            if (cIndex < 0)
                                 continue;
 
-                            if (cContext >= vocabSize)
-                                throw std::runtime_error("ContextID can't be > vocab size");
-
-                            // one word from context
-                            T *syn0word = syn0 + (cContext * vectorLength);
-
-                            for (int i = 0; i < vectorLength; i++)
-                                syn0word[i] += neu1e[i];
+                            if (cIndex >= vocabSize)
+                                throw std::runtime_error("Index can't be > vocab size");
 
+                            batch.addOutput(syn1 + (static_cast<Nd4jLong>(cIndex) * vectorLength), 1 - cCode, true);
                         }
 
-                        // optionally release temp arrays
-                        if (vectorLength > 600) {
-                            delete[] neu1;
-                            delete[] neu1e;
-                        }
+                        if (useNegatives)
+                            addNegatives<T>(batch, syn1Neg, negTable, bStarters[e], nextRandom.e<Nd4jLong>(e), nsRounds, vocabSize, vectorLength, negLength);
                     }
-                };
 
-                samediff::Threads::parallel_tad(func, 0, numTargets, 1, numThreads);
+                    if (batch.size() >= Word2VecBatch<T>::window())
+                        batch.run();
+                }
+
+                if (batch.size() > 0)
+                    batch.run();
             }
             BUILD_SINGLE_TEMPLATE(template void cbowBatchExec_, (NDArray &s0, NDArray &s1, NDArray &s1n, void *vexpTable, void *vnegTable, void *vinfVector, NDArray &context, NDArray &lockedWords, NDArray &targets, NDArray &negStarters, NDArray &indices, NDArray &codes, NDArray &lr, NDArray &nextRandom, NDArray &nLabels, const int nsRounds, const int vocabSize, const int vectorLength, const int expLength, const int negLength,  const bool trainWords, const int numThreads), FLOAT_TYPES);
 
@@ -21,118 +21,66 @@
 #include <ops/declarable/helpers/top_k.h>
 #include <ops/declarable/headers/parity_ops.h>
 #include <array/NDArrayFactory.h>
+#include <helpers/ConstantTadHelper.h>
+#include <helpers/SelectionEngine.h>
 #include <execution/Threads.h>
 
 namespace sd {
 namespace ops {
 namespace helpers {
 
-    template <typename T>
+    template <typename T, typename I>
     static int topKFunctor_(const NDArray* input, NDArray* values, NDArray* indices, const uint k, bool needSort) {
-        Nd4jLong width = input->sizeAt(-1);
-        int lastDim = input->rankOf() - 1;
-// ----------------------------------------------------------------------------------------------- //
-// this assumption is right:
-//        if (values->lengthOf() != k * lastDimList->size()) {
-//            nd4j_printf("top_k: something is wrong. %i expected, but %i given.\n",
-//                values->lengthOf(), k * lastDimList->size());
-//        }
-// ----------------------------------------------------------------------------------------------- //
-        std::vector<int> dimsToExclude(input->rankOf() - 1);
-        for (size_t d = 0; d < dimsToExclude.size(); ++d)
-            dimsToExclude[d] = d;
-
-        const Nd4jLong numOfSubArrs = ShapeUtils::getNumOfSubArrs(input->shapeInfo(), dimsToExclude);
-
-            if (k == 1) {
-                for (Nd4jLong e = 0; e < numOfSubArrs; ++e) {
-                    auto trial = (*input)(e, dimsToExclude);
-                    //int maxPos = //lastDimList->at(e)->argMax();
-                    Nd4jLong maxPos = 0;
-                    //trial.printIndexedBuffer("TRIAL:");
-                    T maxVal = trial.e<T>(0);
-                    for (Nd4jLong pos = 1; pos < trial.lengthOf(); pos++)
-                        if (maxVal < trial.e<T>(pos)) {
-                            maxPos = pos;
-                            maxVal = trial.e<T>(pos);
-                        }
-                    if (indices)
-                        indices->p(e, maxPos); //topIndex;
-                    if (values)
-                        values->p(e, maxVal);
-                }
+        const Nd4jLong width = input->sizeAt(-1);
+        const std::vector<int> lastDim({input->rankOf() - 1});
+
+        auto packX = ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), lastDim);
+        const Nd4jLong numOfSubArrs = packX.numberOfTads();
+        const Nd4jLong xStride = input->strideAt(-1);
+
+        const Nd4jLong *vOffsets = values != nullptr ? ConstantTadHelper::getInstance().tadForDimensions(values->shapeInfo(), lastDim).primaryOffsets() : nullptr;
+        const Nd4jLong *iOffsets = indices != nullptr ? ConstantTadHelper::getInstance().tadForDimensions(indices->shapeInfo(), lastDim).primaryOffsets() : nullptr;
+        const Nd4jLong vStride = values != nullptr ? values->strideAt(-1) : 0;
+        const Nd4jLong iStride = indices != nullptr ? indices->strideAt(-1) : 0;
+
+        auto x = input->bufferAsT<T>();
+        auto v = values != nullptr ? values->bufferAsT<T>() : nullptr;
+        auto i = indices != nullptr ? indices->bufferAsT<I>() : nullptr;
+
+        auto row = [&](Nd4jLong e, int numThreads, std::vector<typename SelectionEngine<T>::Item> &items) {
+            auto xRow = x + packX.primaryOffsets()[e];
+            SelectionEngine<T>::select(xRow, width, xStride, k, true, numThreads, items);
+
+            // sorted output goes in descending order, unsorted one keeps order of elements in the row
+            if (needSort)
+                std::sort(items.begin(), items.end(), SelectionEngine<T>::better);
+            else
+                std::sort(items.begin(), items.end(), SelectionEngine<T>::lowerIndex);
+
+            for (uint pos = 0; pos < k; ++pos) {
+                if (v != nullptr)
+                    v[vOffsets[e] + pos * vStride] = xRow[items[pos].index * xStride];
+                if (i != nullptr)
+                    i[iOffsets[e] + pos * iStride] = static_cast<I>(items[pos].index);
             }
-            else {
-                int nextPos = 0;
-
-                for (Nd4jLong e = 0; e < numOfSubArrs; ++e) {
-                    auto trial = (*input)(e, dimsToExclude);
-
-                    // fill up the first k elements
-                    NDArray topValues = NDArrayFactory::create<T>('c', {k}, input->getContext());
-                    NDArray sortedVals = NDArrayFactory::create<T>('c', {k}, input->getContext());
-                    NDArray topIndices = NDArrayFactory::create<Nd4jLong>('c', {k}, input->getContext());
-                    for (uint pos = 0; pos < k; ++pos) {
-                        topIndices.r<Nd4jLong>(pos) = pos;
-                        topValues.r<T>(pos) = trial.t<T>(pos);
-                    }
-                    //std::vector<T> sortedVals(topValues);
-                    sortedVals.assign(topValues);// = NDArrayFactory::create<T>('c', {k});
-                    //std::sort(sortedVals.begin(), sortedVals.end()); // sorted in ascending order
-                    SpecialMethods<T>::sortGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), false);
-                    for (Nd4jLong i = static_cast<Nd4jLong>(k); i < width; ++i) {
-                        T val = trial.e<T>(i);
-                        T minTopVal = sortedVals.t<T>(0);
-                        if (minTopVal < val) { // value should be inserted to top k
-                            // only if it is not contained in
-                            T* begin = reinterpret_cast<T*>(sortedVals.buffer());
-                            T* end = begin + k;
-                            bool exists = std::binary_search(begin, end, val);
-                            if (!exists) {
-                                //exchangePos - a distance between begin and minimal existed to be suppressed by val
-                                T* topBegin = reinterpret_cast<T*>(topValues.buffer());
-                                T* topEnd = topBegin + k;
-                                auto exchangePos = std::distance(topBegin, std::find(topBegin, topEnd, sortedVals.t<T>(0)));
-                                topValues.r<T>(exchangePos) = val; //*exchangeIt = val;
-                                topIndices.r<Nd4jLong>(exchangePos) = i;
-                                sortedVals.r<T>(0) = val; // suppress in sorted
-                                //std::sort(sortedVals.begin(), sortedVals.end()); // sorted in ascending order
-                                SpecialMethods<T>::sortGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), false);
-                            }
-                        }
-                    }
-                    if (needSort) {
-                        SpecialMethods<T>::sortGeneric(topValues.buffer(), topValues.shapeInfo(), true);
-
-                        for (Nd4jLong j = 0; j < width; j++)
-                            for (uint pos = 0; pos < k; ++pos)
-                                if (topValues.t<T>(pos) == trial.t<T>(j))
-                                    topIndices.r<Nd4jLong>(pos) = j;
-                    }
-                    else { // else sort by indices
-                        std::map<Nd4jLong, T> sortValsMap;
-                        //std::vector<std::pair<int, T>> data(topValues.lengthOf());
-                        for (Nd4jLong e = 0; e < topValues.lengthOf(); ++e) {
-                            sortValsMap[topIndices.t<Nd4jLong>(e)] = topValues.t<T>(e);
-                        }
-
-                        //std::sort(data.begin(), data.end(), [](std::pair<int, T> const& a, std::pair<int, T> const& b) {
-                        //    return a.first < b.first;
-                        //});
-                        Nd4jLong e = 0;
-                        for (auto it = sortValsMap.begin(); it != sortValsMap.end(); ++it, e++) {
-                            topIndices.r<Nd4jLong>(e) = it->first;
-                            topValues.r<T>(e) = it->second;
-                        }
-
-                    }
-                    if (values)
-                    (*values)(e, dimsToExclude).assign(topValues);
-                    if (indices)
-                    (*indices)(e, dimsToExclude).assign(topIndices);
-                }
-                //indices->printIndexedBuffer("Indices as is");
+        };
+
+        // rows are split between threads, unless there are too few of them: then each row is split
+        const int maxThreads = sd::Environment::getInstance().maxMasterThreads();
+        if (numOfSubArrs >= maxThreads) {
+            auto func = PRAGMA_THREADS_FOR {
+                std::vector<typename SelectionEngine<T>::Item> items;
+                for (auto e = start; e < stop; e++)
+                    row(e, 1, items);
+            };
+
+            samediff::Threads::parallel_tad(func, 0, numOfSubArrs);
+        } else {
+            std::vector<typename SelectionEngine<T>::Item> items;
+            for (Nd4jLong e = 0; e < numOfSubArrs; e++)
+                row(e, maxThreads, items);
         }
+
         return Status::OK();
     }
 // ----------------------------------------------------------------------------------------------- //
@@ -170,14 +118,14 @@ namespace helpers {
     }
 
         int topKFunctor(sd::LaunchContext * context, const NDArray* input, NDArray* values, NDArray* indices, const uint k, bool needSort) {
-            BUILD_SINGLE_SELECTOR(input->dataType(), return topKFunctor_, (input, values, indices, k, needSort), NUMERIC_TYPES);
+            auto indicesType = indices != nullptr ? indices->dataType() : sd::DataType::INT64;
+            BUILD_DOUBLE_SELECTOR(input->dataType(), indicesType, return topKFunctor_, (input, values, indices, k, needSort), NUMERIC_TYPES, INDEXING_TYPES);
         }
 
         int inTopKFunctor(sd::LaunchContext * context, const NDArray* input, const NDArray* target, NDArray* result, const uint k) {
             BUILD_SINGLE_SELECTOR(input->dataType(), return inTopKFunctor_, (context, input, target, result, k), NUMERIC_TYPES);
         }
 
-        BUILD_SINGLE_TEMPLATE(template int topKFunctor_, (const NDArray* input, NDArray* values, NDArray* indices, const uint k, bool needSort), NUMERIC_TYPES);
         BUILD_SINGLE_TEMPLATE(template int inTopKFunctor_, (sd::LaunchContext * context, const NDArray* input, const NDArray* target, NDArray* result, const uint k), NUMERIC_TYPES);
 }
 }
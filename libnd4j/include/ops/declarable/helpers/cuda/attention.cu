@@ -0,0 +1,296 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/attention.h>
+#include <helpers/ConstantTadHelper.h>
+#include <helpers/PointersManager.h>
+
+namespace sd    {
+namespace ops     {
+namespace helpers {
+
+///////////////////////////////////////////////////////////////////
+// g-th [features, time] matrix of rank 3 or 4 array on device, element (f, t) is at offsets[g] + f * fStride + t * tStride
+struct AttentionOperandCuda {
+    const Nd4jLong *offsets;
+    Nd4jLong fStride;
+    Nd4jLong tStride;
+
+    static AttentionOperandCuda of(const NDArray &array) {
+        auto pack = ConstantTadHelper::getInstance().tadForDimensions(array.shapeInfo(), {array.rankOf() - 2, array.rankOf() - 1});
+        return {pack.specialOffsets(), array.strideAt(-2), array.strideAt(-1)};
+    }
+
+    __device__ Nd4jLong at(const Nd4jLong g, const Nd4jLong f, const Nd4jLong t) const {
+        return offsets[g] + f * fStride + t * tStride;
+    }
+};
+
+///////////////////////////////////////////////////////////////////
+// scale * (Q_i . K_j) plus mask term of key j, in float
+template <typename T>
+static __device__ float attentionScore(const T *q, const AttentionOperandCuda &qo, const T *k, const AttentionOperandCuda &ko, const float *mask,
+                                       const Nd4jLong g, const Nd4jLong heads, const Nd4jLong i, const Nd4jLong j, const Nd4jLong dK, const Nd4jLong tk, const float scale) {
+    float sum = 0.f;
+    for (Nd4jLong f = 0; f < dK; f++)
+        sum += static_cast<float>(q[qo.at(g, f, i)]) * static_cast<float>(k[ko.at(g, f, j)]);
+
+    return scale * sum + (mask == nullptr ? 0.f : (mask[(g / heads) * tk + j] - 1.f) * 1e9f);
+}
+
+///////////////////////////////////////////////////////////////////
+// one thread per output element, streaming softmax over keys, so weights are never stored
+template <typename T>
+static void _CUDA_G dotProductAttentionCuda(const void *vq, const AttentionOperandCuda qo, const void *vk, const AttentionOperandCuda ko, const void *vv, const AttentionOperandCuda vo,
+                                            const float *mask, void *vz, const AttentionOperandCuda zo,
+                                            const Nd4jLong numMatrices, const Nd4jLong heads, const Nd4jLong dK, const Nd4jLong dV, const Nd4jLong tq, const Nd4jLong tk, const float scale) {
+
+    const auto q = reinterpret_cast<const T*>(vq);
+    const auto k = reinterpret_cast<const T*>(vk);
+    const auto v = reinterpret_cast<const T*>(vv);
+          auto z = reinterpret_cast<T*>(vz);
+
+    const auto tid = blockIdx.x * blockDim.x + threadIdx.x;
+
+    for (Nd4jLong e = tid; e < numMatrices * tq * dV; e += gridDim.x * blockDim.x) {
+        const auto g = e / (tq * dV);
+        const auto i = (e / dV) % tq;
+        const auto d = e % dV;
+
+        float m = -1e38f, l = 0.f, o = 0.f;
+        for (Nd4jLong j = 0; j < tk; j++) {
+            const float s = attentionScore<T>(q, qo, k, ko, mask, g, heads, i, j, dK, tk, scale);
+            const float mx = s > m ? s : m;
+            const float correction = sd::math::nd4j_exp<float, float>(m - mx);
+            const float p = sd::math::nd4j_exp<float, float>(s - mx);
+
+            l = l * correction + p;
+            o = o * correction + p * static_cast<float>(v[vo.at(g, d, j)]);
+            m = mx;
+        }
+
+        z[zo.at(g, d, i)] = static_cast<T>(o / l);
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// one thread per query: L = log of softmax denominator, D = sum of weights times their gradients
+template <typename T>
+static void _CUDA_G attentionStatisticsCuda(const void *vq, const AttentionOperandCuda qo, const void *vk, const AttentionOperandCuda ko, const void *vv, const AttentionOperandCuda vo,
+                                            const void *veps, const AttentionOperandCuda eo, const float *mask, float *L, float *D,
+                                            const Nd4jLong numMatrices, const Nd4jLong heads, const Nd4jLong dK, const Nd4jLong dV, const Nd4jLong tq, const Nd4jLong tk, const float scale) {
+
+    const auto q = reinterpret_cast<const T*>(vq);
+    const auto k = reinterpret_cast<const T*>(vk);
+    const auto v = reinterpret_cast<const T*>(vv);
+    const auto eps = reinterpret_cast<const T*>(veps);
+
+    const auto tid = blockIdx.x * blockDim.x + threadIdx.x;
+
+    for (Nd4jLong e = tid; e < numMatrices * tq; e += gridDim.x * blockDim.x) {
+        const auto g = e / tq;
+        const auto i = e % tq;
+
+        float m = -1e38f, l = 0.f;
+        for (Nd4jLong j = 0; j < tk; j++) {
+            const float s = attentionScore<T>(q, qo, k, ko, mask, g, heads, i, j, dK, tk, scale);
+            const float mx = s > m ? s : m;
+            l = l * sd::math::nd4j_exp<float, float>(m - mx) + sd::math::nd4j_exp<float, float>(s - mx);
+            m = mx;
+        }
+
+        const float lse = m + sd::math::nd4j_log<float, float>(l);
+
+        float sum = 0.f;
+        for (Nd4jLong j = 0; j < tk; j++) {
+            float dP = 0.f;
+            for (Nd4jLong c = 0; c < dV; c++)
+                dP += static_cast<float>(eps[eo.at(g, c, i)]) * static_cast<float>(v[vo.at(g, c, j)]);
+
+            sum += sd::math::nd4j_exp<float, float>(attentionScore<T>(q, qo, k, ko, mask, g, heads, i, j, dK, tk, scale) - lse) * dP;
+        }
+
+        L[e] = lse;
+        D[e] = sum;
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// one thread per element of dLdq, dLdk or dLdv: gradient is summed over keys (dLdq) or over queries (dLdk, dLdv)
+template <typename T>
+static void _CUDA_G dotProductAttentionBpCuda(const void *vq, const AttentionOperandCuda qo, const void *vk, const AttentionOperandCuda ko, const void *vv, const AttentionOperandCuda vo,
+                                              const void *veps, const AttentionOperandCuda eo, const float *mask, const float *L, const float *D,
+                                              void *vdq, const AttentionOperandCuda dqo, void *vdk, const AttentionOperandCuda dko, void *vdv, const AttentionOperandCuda dvo,
+                                              const Nd4jLong numMatrices, const Nd4jLong heads, const Nd4jLong dK, const Nd4jLong dV, const Nd4jLong tq, const Nd4jLong tk, const float scale) {
+
+    const auto q = reinterpret_cast<const T*>(vq);
+    const auto k = reinterpret_cast<const T*>(vk);
+    const auto v = reinterpret_cast<const T*>(vv);
+    const auto eps = reinterpret_cast<const T*>(veps);
+          auto dq = reinterpret_cast<T*>(vdq);
+          auto dk = reinterpret_cast<T*>(vdk);
+          auto dv = reinterpret_cast<T*>(vdv);
+
+    const auto numQ = numMatrices * tq * dK;
+    const auto numK = numMatrices * tk * dK;
+    const auto numV = numMatrices * tk * dV;
+
+    const auto tid = blockIdx.x * blockDim.x + threadIdx.x;
+
+    for (Nd4jLong e = tid; e < numQ + numK + numV; e += gridDim.x * blockDim.x) {
+        if (e < numQ) {
+            const auto g = e / (tq * dK);
+            const auto i = (e / dK) % tq;
+            const auto f = e % dK;
+
+            float sum = 0.f;
+            for (Nd4jLong j = 0; j < tk; j++) {
+                float dP = 0.f;
+                for (Nd4jLong c = 0; c < dV; c++)
+                    dP += static_cast<float>(eps[eo.at(g, c, i)]) * static_cast<float>(v[vo.at(g, c, j)]);
+
+                const float p = sd::math::nd4j_exp<float, float>(attentionScore<T>(q, qo, k, ko, mask, g, heads, i, j, dK, tk, scale) - L[g * tq + i]);
+                sum += p * (dP - D[g * tq + i]) * static_cast<float>(k[ko.at(g, f, j)]);
+            }
+
+            dq[dqo.at(g, f, i)] = static_cast<T>(scale * sum);
+        }
+        else if (e < numQ + numK) {
+            const auto r = e - numQ;
+            const auto g = r / (tk * dK);
+            const auto j = (r / dK) % tk;
+            const auto f = r % dK;
+
+            float sum = 0.f;
+            for (Nd4jLong i = 0; i < tq; i++) {
+                float dP = 0.f;
+                for (Nd4jLong c = 0; c < dV; c++)
+                    dP += static_cast<float>(eps[eo.at(g, c, i)]) * static_cast<float>(v[vo.at(g, c, j)]);
+
+                const float p = sd::math::nd4j_exp<float, float>(attentionScore<T>(q, qo, k, ko, mask, g, heads, i, j, dK, tk, scale) - L[g * tq + i]);
+                sum += p * (dP - D[g * tq + i]) * static_cast<float>(q[qo.at(g, f, i)]);
+            }
+
+            dk[dko.at(g, f, j)] = static_cast<T>(scale * sum);
+        }
+        else {
+            const auto r = e - numQ - numK;
+            const auto g = r / (tk * dV);
+            const auto j = (r / dV) % tk;
+            const auto d = r % dV;
+
+            float sum = 0.f;
+            for (Nd4jLong i = 0; i < tq; i++)
+                sum += sd::math::nd4j_exp<float, float>(attentionScore<T>(q, qo, k, ko, mask, g, heads, i, j, dK, tk, scale) - L[g * tq + i]) * static_cast<float>(eps[eo.at(g, d, i)]);
+
+            dv[dvo.at(g, d, j)] = static_cast<T>(sum);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename T>
+static _CUDA_H void dotProductAttentionCudaLauncher(const int blocksPerGrid, const int threadsPerBlock, const cudaStream_t *stream,
+                                                    const void *vq, const AttentionOperandCuda qo, const void *vk, const AttentionOperandCuda ko, const void *vv, const AttentionOperandCuda vo,
+                                                    const float *mask, void *vz, const AttentionOperandCuda zo,
+                                                    const Nd4jLong numMatrices, const Nd4jLong heads, const Nd4jLong dK, const Nd4jLong dV, const Nd4jLong tq, const Nd4jLong tk, const float scale) {
+
+    dotProductAttentionCuda<T><<<blocksPerGrid, threadsPerBlock, 256, *stream>>>(vq, qo, vk, ko, vv, vo, mask, vz, zo, numMatrices, heads, dK, dV, tq, tk, scale);
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename T>
+static _CUDA_H void dotProductAttentionBpCudaLauncher(const int blocksPerGrid, const int threadsPerBlock, const cudaStream_t *stream,
+                                                      const void *vq, const AttentionOperandCuda qo, const void *vk, const AttentionOperandCuda ko, const void *vv, const AttentionOperandCuda vo,
+                                                      const void *veps, const AttentionOperandCuda eo, const float *mask, float *L, float *D,
+                                                      void *vdq, const AttentionOperandCuda dqo, void *vdk, const AttentionOperandCuda dko, void *vdv, const AttentionOperandCuda dvo,
+                                                      const Nd4jLong numMatrices, const Nd4jLong heads, const Nd4jLong dK, const Nd4jLong dV, const Nd4jLong tq, const Nd4jLong tk, const float scale) {
+
+    attentionStatisticsCuda<T><<<blocksPerGrid, threadsPerBlock, 256, *stream>>>(vq, qo, vk, ko, vv, vo, veps, eo, mask, L, D, numMatrices, heads, dK, dV, tq, tk, scale);
+    dotProductAttentionBpCuda<T><<<blocksPerGrid, threadsPerBlock, 256, *stream>>>(vq, qo, vk, ko, vv, vo, veps, eo, mask, L, D, vdq, dqo, vdk, dko, vdv, dvo, numMatrices, heads, dK, dV, tq, tk, scale);
+}
+
+///////////////////////////////////////////////////////////////////
+static float attentionScale(const NDArray &queries, const bool normalization) {
+    return normalization ? static_cast<float>(1.0 / sd::math::nd4j_sqrt<double, double>(static_cast<double>(queries.sizeAt(-2)))) : 1.f;
+}
+
+///////////////////////////////////////////////////////////////////
+void dotProductAttention(sd::LaunchContext *context, const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray *mask,
+                         bool normalization, NDArray &output) {
+
+    // mask goes to kernels as c-ordered float [bS, timesteps], placeholder keeps special use bookkeeping uniform
+    NDArray maskF = mask == nullptr ? NDArray('c', {1}, sd::DataType::FLOAT32, context) : mask->cast(sd::DataType::FLOAT32).dup('c');
+
+    const Nd4jLong heads = queries.rankOf() == 4 ? queries.sizeAt(1) : 1;
+    const Nd4jLong numMatrices = queries.lengthOf() / (queries.sizeAt(-2) * queries.sizeAt(-1));
+    const Nd4jLong dV = values.sizeAt(-2);
+    const Nd4jLong tq = queries.sizeAt(-1);
+
+    const int threadsPerBlock = MAX_NUM_THREADS / 2;
+    const int blocksPerGrid = (numMatrices * tq * dV + threadsPerBlock - 1) / threadsPerBlock;
+
+    PointersManager manager(context, "dotProductAttention");
+
+    NDArray::prepareSpecialUse({&output}, {&queries, &keys, &values, &maskF});
+    BUILD_SINGLE_SELECTOR(output.dataType(), dotProductAttentionCudaLauncher, (blocksPerGrid, threadsPerBlock, context->getCudaStream(),
+                          queries.specialBuffer(), AttentionOperandCuda::of(queries), keys.specialBuffer(), AttentionOperandCuda::of(keys), values.specialBuffer(), AttentionOperandCuda::of(values),
+                          mask == nullptr ? nullptr : reinterpret_cast<const float*>(maskF.specialBuffer()), output.specialBuffer(), AttentionOperandCuda::of(output),
+                          numMatrices, heads, queries.sizeAt(-2), dV, tq, keys.sizeAt(-1), attentionScale(queries, normalization)), FLOAT_TYPES);
+    NDArray::registerSpecialUse({&output}, {&queries, &keys, &values, &maskF});
+
+    manager.synchronize();
+}
+
+///////////////////////////////////////////////////////////////////
+void dotProductAttentionBp(sd::LaunchContext *context, const NDArray &queries, const NDArray &keys, const NDArray &values, const NDArray &eps, const NDArray *mask,
+                           bool normalization, NDArray &dLdq, NDArray &dLdk, NDArray &dLdv) {
+
+    // mask goes to kernels as c-ordered float [bS, timesteps], placeholder keeps special use bookkeeping uniform
+    NDArray maskF = mask == nullptr ? NDArray('c', {1}, sd::DataType::FLOAT32, context) : mask->cast(sd::DataType::FLOAT32).dup('c');
+
+    const Nd4jLong heads = queries.rankOf() == 4 ? queries.sizeAt(1) : 1;
+    const Nd4jLong numMatrices = queries.lengthOf() / (queries.sizeAt(-2) * queries.sizeAt(-1));
+    const Nd4jLong tq = queries.sizeAt(-1);
+
+    // per query softmax statistics, linear in sequence length
+    NDArray L('c', {numMatrices, tq}, sd::DataType::FLOAT32, context);
+    NDArray D('c', {numMatrices, tq}, sd::DataType::FLOAT32, context);
+
+    const int threadsPerBlock = MAX_NUM_THREADS / 2;
+    const int blocksPerGrid = (dLdq.lengthOf() + dLdk.lengthOf() + dLdv.lengthOf() + threadsPerBlock - 1) / threadsPerBlock;
+
+    PointersManager manager(context, "dotProductAttentionBp");
+
+    NDArray::prepareSpecialUse({&dLdq, &dLdk, &dLdv, &L, &D}, {&queries, &keys, &values, &eps, &maskF});
+    BUILD_SINGLE_SELECTOR(dLdq.dataType(), dotProductAttentionBpCudaLauncher, (blocksPerGrid, threadsPerBlock, context->getCudaStream(),
+                          queries.specialBuffer(), AttentionOperandCuda::of(queries), keys.specialBuffer(), AttentionOperandCuda::of(keys), values.specialBuffer(), AttentionOperandCuda::of(values),
+                          eps.specialBuffer(), AttentionOperandCuda::of(eps), mask == nullptr ? nullptr : reinterpret_cast<const float*>(maskF.specialBuffer()),
+                          reinterpret_cast<float*>(L.specialBuffer()), reinterpret_cast<float*>(D.specialBuffer()),
+                          dLdq.specialBuffer(), AttentionOperandCuda::of(dLdq), dLdk.specialBuffer(), AttentionOperandCuda::of(dLdk), dLdv.specialBuffer(), AttentionOperandCuda::of(dLdv),
+                          numMatrices, heads, queries.sizeAt(-2), values.sizeAt(-2), tq, keys.sizeAt(-1), attentionScale(queries, normalization)), FLOAT_TYPES);
+    NDArray::registerSpecialUse({&dLdq, &dLdk, &dLdv, &L, &D}, {&queries, &keys, &values, &eps, &maskF});
+
+    manager.synchronize();
+}
+
+}
+}
+}
@@ -145,7 +145,7 @@ namespace sd {
                 return std::move(tmp);
             }
 
-            int32_t thresholdEstimate(const NDArray &updates, const float threshold) {
+            Nd4jLong thresholdEstimate(const NDArray &updates, const float threshold) {
                 return thresholdEstimate_(updates, threshold).e<int>(0);
             }
 
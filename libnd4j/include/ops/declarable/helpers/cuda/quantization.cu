@@ -0,0 +1,313 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/quantization.h>
+#include <array/NDArrayFactory.h>
+#include <helpers/PointersManager.h>
+#include <vector>
+
+namespace sd    {
+namespace ops     {
+namespace helpers {
+
+///////////////////////////////////////////////////////////////////
+template <typename X, typename Q>
+static void _CUDA_G quantizeLinearCuda(const void* vx, const Nd4jLong* xShapeInfo, const float* scales, const int* zeroPoints, const Nd4jLong channels,
+                                       const int quantMin, const int quantMax, void* vz, const Nd4jLong* zShapeInfo) {
+
+    const auto x = reinterpret_cast<const X*>(vx);
+          auto z = reinterpret_cast<Q*>(vz);
+
+    const auto length = shape::length(xShapeInfo);
+    const auto tid = blockIdx.x * blockDim.x + threadIdx.x;
+
+    for (Nd4jLong i = tid; i < length; i += gridDim.x * blockDim.x) {
+        const auto c = channels == 1 ? 0 : i % channels;
+
+        auto value = sd::math::nd4j_floor<float, float>(static_cast<float>(x[shape::getIndexOffset(i, xShapeInfo)]) / scales[c] + 0.5f) + static_cast<float>(zeroPoints[c]);
+        if (!(value >= static_cast<float>(quantMin)))
+            value = static_cast<float>(quantMin);
+        else if (value > static_cast<float>(quantMax))
+            value = static_cast<float>(quantMax);
+
+        z[shape::getIndexOffset(i, zShapeInfo)] = static_cast<Q>(static_cast<int>(value));
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename X, typename Q>
+static _CUDA_H void quantizeLinearCudaLauncher(const int blocksPerGrid, const int threadsPerBlock, const cudaStream_t *stream,
+                                               const void* vx, const Nd4jLong* xShapeInfo, const float* scales, const int* zeroPoints, const Nd4jLong channels,
+                                               const int quantMin, const int quantMax, void* vz, const Nd4jLong* zShapeInfo) {
+
+    quantizeLinearCuda<X, Q><<<blocksPerGrid, threadsPerBlock, 256, *stream>>>(vx, xShapeInfo, scales, zeroPoints, channels, quantMin, quantMax, vz, zShapeInfo);
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename Q, typename Z>
+static void _CUDA_G dequantizeLinearCuda(const void* vx, const Nd4jLong* xShapeInfo, const float* scales, const int* zeroPoints, const Nd4jLong channels,
+                                         void* vz, const Nd4jLong* zShapeInfo) {
+
+    const auto x = reinterpret_cast<const Q*>(vx);
+          auto z = reinterpret_cast<Z*>(vz);
+
+    const auto length = shape::length(xShapeInfo);
+    const auto tid = blockIdx.x * blockDim.x + threadIdx.x;
+
+    for (Nd4jLong i = tid; i < length; i += gridDim.x * blockDim.x) {
+        const auto c = channels == 1 ? 0 : i % channels;
+        z[shape::getIndexOffset(i, zShapeInfo)] = static_cast<Z>(static_cast<float>(static_cast<int>(x[shape::getIndexOffset(i, xShapeInfo)]) - zeroPoints[c]) * scales[c]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename Q, typename Z>
+static _CUDA_H void dequantizeLinearCudaLauncher(const int blocksPerGrid, const int threadsPerBlock, const cudaStream_t *stream,
+                                                 const void* vx, const Nd4jLong* xShapeInfo, const float* scales, const int* zeroPoints, const Nd4jLong channels,
+                                                 void* vz, const Nd4jLong* zShapeInfo) {
+
+    dequantizeLinearCuda<Q, Z><<<blocksPerGrid, threadsPerBlock, 256, *stream>>>(vx, xShapeInfo, scales, zeroPoints, channels, vz, zShapeInfo);
+}
+
+///////////////////////////////////////////////////////////////////
+// one thread per element of [M, N] float32 output, zero point of column n is bZeroPoints[n * bZeroPointStride]
+template <typename TA, typename TB>
+static void _CUDA_G quantizedMatmulCuda(const void* va, const Nd4jLong aRowStride, const Nd4jLong aColStride, const int aZeroPoint,
+                                        const void* vb, const Nd4jLong bRowStride, const Nd4jLong bColStride, const int* bZeroPoints, const Nd4jLong bZeroPointStride,
+                                        const float* multipliers, const float* biases, const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, float* z) {
+
+    const auto a = reinterpret_cast<const TA*>(va);
+    const auto b = reinterpret_cast<const TB*>(vb);
+
+    const auto tid = blockIdx.x * blockDim.x + threadIdx.x;
+
+    for (Nd4jLong i = tid; i < M * N; i += gridDim.x * blockDim.x) {
+        const auto m = i / N;
+        const auto n = i % N;
+        const int bZeroPoint = bZeroPoints[n * bZeroPointStride];
+
+        int acc = 0;
+        for (Nd4jLong k = 0; k < K; k++)
+            acc += (static_cast<int>(a[m * aRowStride + k * aColStride]) - aZeroPoint) * (static_cast<int>(b[k * bRowStride + n * bColStride]) - bZeroPoint);
+
+        z[i] = multipliers[n] * static_cast<float>(acc) + biases[n];
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename TA, typename TB>
+static _CUDA_H void quantizedMatmulCudaLauncher(const int blocksPerGrid, const int threadsPerBlock, const cudaStream_t *stream,
+                                                const void* va, const Nd4jLong aRowStride, const Nd4jLong aColStride, const int aZeroPoint,
+                                                const void* vb, const Nd4jLong bRowStride, const Nd4jLong bColStride, const int* bZeroPoints, const Nd4jLong bZeroPointStride,
+                                                const float* multipliers, const float* biases, const Nd4jLong M, const Nd4jLong N, const Nd4jLong K, float* z) {
+
+    quantizedMatmulCuda<TA, TB><<<blocksPerGrid, threadsPerBlock, 256, *stream>>>(va, aRowStride, aColStride, aZeroPoint, vb, bRowStride, bColStride, bZeroPoints, bZeroPointStride,
+                                                                                  multipliers, biases, M, N, K, z);
+}
+
+///////////////////////////////////////////////////////////////////
+// one thread per element of [bS, oH, oW, oC] float32 output, padded positions are skipped since they equal input zero point
+template <typename TI, typename TW>
+static void _CUDA_G quantizedConv2dCuda(const void* vx, const Nd4jLong* xShapeInfo, const int inZeroPoint,
+                                        const void* vw, const Nd4jLong* wShapeInfo, const int* wZeroPoints, const Nd4jLong wZeroPointStride,
+                                        const float* multipliers, const float* biases, float* z, const int oH, const int oW,
+                                        const int kH, const int kW, const int sH, const int sW, const int pH, const int pW, const int dH, const int dW) {
+
+    const auto x = reinterpret_cast<const TI*>(vx);
+    const auto w = reinterpret_cast<const TW*>(vw);
+
+    __shared__ Nd4jLong bS, iH, iW, iC, oC, xStrides[4], wStrides[4];
+
+    if (threadIdx.x == 0) {
+        bS = shape::sizeAt(xShapeInfo, 0);
+        iH = shape::sizeAt(xShapeInfo, 1);
+        iW = shape::sizeAt(xShapeInfo, 2);
+        iC = shape::sizeAt(xShapeInfo, 3);
+        oC = shape::sizeAt(wShapeInfo, 3);
+
+        for (int e = 0; e < 4; e++) {
+            xStrides[e] = shape::stride(xShapeInfo)[e];
+            wStrides[e] = shape::stride(wShapeInfo)[e];
+        }
+    }
+    __syncthreads();
+
+    const auto tid = blockIdx.x * blockDim.x + threadIdx.x;
+    const auto length = bS * oH * oW * oC;
+
+    for (Nd4jLong i = tid; i < length; i += gridDim.x * blockDim.x) {
+        const auto n = i % oC;
+        const auto row = i / oC;
+        const auto b = row / (oH * oW);
+        const int oh = (row / oW) % oH;
+        const int ow = row % oW;
+        const int wZeroPoint = wZeroPoints[n * wZeroPointStride];
+
+        int acc = 0;
+        for (int kh = 0; kh < kH; kh++) {
+            const int ih = oh * sH - pH + kh * dH;
+            if (ih < 0 || ih >= iH)
+                continue;
+
+            for (int kw = 0; kw < kW; kw++) {
+                const int iw = ow * sW - pW + kw * dW;
+                if (iw < 0 || iw >= iW)
+                    continue;
+
+                for (Nd4jLong c = 0; c < iC; c++)
+                    acc += (static_cast<int>(x[b * xStrides[0] + ih * xStrides[1] + iw * xStrides[2] + c * xStrides[3]]) - inZeroPoint) *
+                           (static_cast<int>(w[kh * wStrides[0] + kw * wStrides[1] + c * wStrides[2] + n * wStrides[3]]) - wZeroPoint);
+            }
+        }
+
+        z[i] = multipliers[n] * static_cast<float>(acc) + biases[n];
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename TI, typename TW>
+static _CUDA_H void quantizedConv2dCudaLauncher(const int blocksPerGrid, const int threadsPerBlock, const cudaStream_t *stream,
+                                                const void* vx, const Nd4jLong* xShapeInfo, const int inZeroPoint,
+                                                const void* vw, const Nd4jLong* wShapeInfo, const int* wZeroPoints, const Nd4jLong wZeroPointStride,
+                                                const float* multipliers, const float* biases, float* z, const int oH, const int oW,
+                                                const int kH, const int kW, const int sH, const int sW, const int pH, const int pW, const int dH, const int dW) {
+
+    quantizedConv2dCuda<TI, TW><<<blocksPerGrid, threadsPerBlock, 256, *stream>>>(vx, xShapeInfo, inZeroPoint, vw, wShapeInfo, wZeroPoints, wZeroPointStride,
+                                                                                  multipliers, biases, z, oH, oW, kH, kW, sH, sW, pH, pW, dH, dW);
+}
+
+///////////////////////////////////////////////////////////////////
+// scale of a times per-channel scales of b, computed on host since there are just N of them
+static NDArray outputMultipliers(sd::LaunchContext *context, const NDArray &aScale, const NDArray &bScale, const Nd4jLong N) {
+    std::vector<float> values(N);
+    for (Nd4jLong n = 0; n < N; n++)
+        values[n] = aScale.e<float>(0) * bScale.e<float>(bScale.lengthOf() == 1 ? 0 : n);
+
+    return NDArrayFactory::create<float>('c', {N}, values, context);
+}
+
+static NDArray outputBiases(sd::LaunchContext *context, const NDArray *bias, const Nd4jLong N) {
+    std::vector<float> values(N, 0.f);
+    if (bias != nullptr)
+        for (Nd4jLong n = 0; n < N; n++)
+            values[n] = bias->e<float>(n);
+
+    return NDArrayFactory::create<float>('c', {N}, values, context);
+}
+
+///////////////////////////////////////////////////////////////////
+void quantizeLinear(sd::LaunchContext *context, const NDArray &input, const NDArray &scale, const NDArray &zeroPoint, int quantMin, int quantMax, NDArray &output) {
+
+    auto scales = scale.cast(sd::DataType::FLOAT32);
+    auto zeroPoints = zeroPoint.cast(sd::DataType::INT32);
+    const Nd4jLong channels = scale.lengthOf() == 1 ? 1 : input.sizeAt(-1);
+
+    const int threadsPerBlock = MAX_NUM_THREADS / 2;
+    const int blocksPerGrid = (input.lengthOf() + threadsPerBlock - 1) / threadsPerBlock;
+
+    PointersManager manager(context, "quantizeLinear");
+
+    NDArray::prepareSpecialUse({&output}, {&input, &scales, &zeroPoints});
+    BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), quantizeLinearCudaLauncher, (blocksPerGrid, threadsPerBlock, context->getCudaStream(), input.specialBuffer(), input.specialShapeInfo(), reinterpret_cast<const float*>(scales.specialBuffer()), reinterpret_cast<const int*>(zeroPoints.specialBuffer()), channels, quantMin, quantMax, output.specialBuffer(), output.specialShapeInfo()), FLOAT_TYPES, QUANTIZED_TYPES);
+    NDArray::registerSpecialUse({&output}, {&input, &scales, &zeroPoints});
+
+    manager.synchronize();
+}
+
+///////////////////////////////////////////////////////////////////
+void dequantizeLinear(sd::LaunchContext *context, const NDArray &input, const NDArray &scale, const NDArray &zeroPoint, NDArray &output) {
+
+    auto scales = scale.cast(sd::DataType::FLOAT32);
+    auto zeroPoints = zeroPoint.cast(sd::DataType::INT32);
+    const Nd4jLong channels = scale.lengthOf() == 1 ? 1 : input.sizeAt(-1);
+
+    const int threadsPerBlock = MAX_NUM_THREADS / 2;
+    const int blocksPerGrid = (input.lengthOf() + threadsPerBlock - 1) / threadsPerBlock;
+
+    PointersManager manager(context, "dequantizeLinear");
+
+    NDArray::prepareSpecialUse({&output}, {&input, &scales, &zeroPoints});
+    BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), dequantizeLinearCudaLauncher, (blocksPerGrid, threadsPerBlock, context->getCudaStream(), input.specialBuffer(), input.specialShapeInfo(), reinterpret_cast<const float*>(scales.specialBuffer()), reinterpret_cast<const int*>(zeroPoints.specialBuffer()), channels, output.specialBuffer(), output.specialShapeInfo()), QUANTIZED_TYPES, FLOAT_TYPES);
+    NDArray::registerSpecialUse({&output}, {&input, &scales, &zeroPoints});
+
+    manager.synchronize();
+}
+
+///////////////////////////////////////////////////////////////////
+void quantizedMatmul(sd::LaunchContext *context, const NDArray &a, const NDArray &aScale, const NDArray &aZeroPoint,
+                     const NDArray &b, const NDArray &bScale, const NDArray &bZeroPoint, const NDArray *bias, NDArray &output) {
+
+    const Nd4jLong M = a.sizeAt(0);
+    const Nd4jLong K = a.sizeAt(1);
+    const Nd4jLong N = b.sizeAt(1);
+
+    auto multipliers = outputMultipliers(context, aScale, bScale, N);
+    auto biases = outputBiases(context, bias, N);
+    auto bZeroPoints = bZeroPoint.cast(sd::DataType::INT32);
+
+    // kernel writes float32, conversion to output type is done by assign
+    NDArray result('c', {M, N}, sd::DataType::FLOAT32, context);
+
+    const int threadsPerBlock = MAX_NUM_THREADS / 2;
+    const int blocksPerGrid = (M * N + threadsPerBlock - 1) / threadsPerBlock;
+
+    PointersManager manager(context, "quantizedMatmul");
+
+    NDArray::prepareSpecialUse({&result}, {&a, &b, &bZeroPoints, &multipliers, &biases});
+    BUILD_DOUBLE_SELECTOR(a.dataType(), b.dataType(), quantizedMatmulCudaLauncher, (blocksPerGrid, threadsPerBlock, context->getCudaStream(), a.specialBuffer(), a.strideAt(0), a.strideAt(1), aZeroPoint.e<int>(0), b.specialBuffer(), b.strideAt(0), b.strideAt(1), reinterpret_cast<const int*>(bZeroPoints.specialBuffer()), bZeroPoints.lengthOf() == 1 ? 0 : 1, reinterpret_cast<const float*>(multipliers.specialBuffer()), reinterpret_cast<const float*>(biases.specialBuffer()), M, N, K, reinterpret_cast<float*>(result.specialBuffer())), QUANTIZED_TYPES, QUANTIZED_TYPES);
+    NDArray::registerSpecialUse({&result}, {&a, &b, &bZeroPoints, &multipliers, &biases});
+
+    manager.synchronize();
+
+    output.assign(result);
+}
+
+///////////////////////////////////////////////////////////////////
+void quantizedConv2d(sd::LaunchContext *context, const NDArray &input, const NDArray &inScale, const NDArray &inZeroPoint,
+                     const NDArray &weights, const NDArray &wScale, const NDArray &wZeroPoint, const NDArray *bias, NDArray &output,
+                     int kH, int kW, int sH, int sW, int pH, int pW, int dH, int dW) {
+
+    const int oH = output.sizeAt(1);
+    const int oW = output.sizeAt(2);
+    const Nd4jLong oC = output.sizeAt(3);
+
+    auto multipliers = outputMultipliers(context, inScale, wScale, oC);
+    auto biases = outputBiases(context, bias, oC);
+    auto wZeroPoints = wZeroPoint.cast(sd::DataType::INT32);
+
+    NDArray result('c', {output.sizeAt(0), (Nd4jLong) oH, (Nd4jLong) oW, oC}, sd::DataType::FLOAT32, context);
+
+    const int threadsPerBlock = MAX_NUM_THREADS / 2;
+    const int blocksPerGrid = (result.lengthOf() + threadsPerBlock - 1) / threadsPerBlock;
+
+    PointersManager manager(context, "quantizedConv2d");
+
+    NDArray::prepareSpecialUse({&result}, {&input, &weights, &wZeroPoints, &multipliers, &biases});
+    BUILD_DOUBLE_SELECTOR(input.dataType(), weights.dataType(), quantizedConv2dCudaLauncher, (blocksPerGrid, threadsPerBlock, context->getCudaStream(), input.specialBuffer(), input.specialShapeInfo(), inZeroPoint.e<int>(0), weights.specialBuffer(), weights.specialShapeInfo(), reinterpret_cast<const int*>(wZeroPoints.specialBuffer()), wZeroPoints.lengthOf() == 1 ? 0 : 1, reinterpret_cast<const float*>(multipliers.specialBuffer()), reinterpret_cast<const float*>(biases.specialBuffer()), reinterpret_cast<float*>(result.specialBuffer()), oH, oW, kH, kW, sH, sW, pH, pW, dH, dW), QUANTIZED_TYPES, QUANTIZED_TYPES);
+    NDArray::registerSpecialUse({&result}, {&input, &weights, &wZeroPoints, &multipliers, &biases});
+
+    manager.synchronize();
+
+    output.assign(result);
+}
+
+}
+}
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_FUSED_ELEMENTWISE_H
+#define SD_FUSED_ELEMENTWISE_H
+
+#include <ops/declarable/helpers/helpers.h>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+    enum class FusedStepType {
+        TRANSFORM_SAME,
+        TRANSFORM_FLOAT,
+        TRANSFORM_STRICT,
+        SCALAR,
+        PAIRWISE,
+        BROADCASTABLE,
+    };
+
+    /**
+     * One op of fused elementwise chain. First step reads input 0 of the chain,
+     * each next step reads result of previous one as its X operand.
+     */
+    struct FusedStep {
+        FusedStepType type = FusedStepType::TRANSFORM_SAME;
+
+        // transform, scalar or pairwise op number. for broadcastables - pairwise one
+        int opNum = 0;
+
+        // scalar and broadcast op numbers of broadcastable step
+        int scalarOp = 0;
+        int broadcastOp = 0;
+
+        // index of chain input used as Y operand, -1 if step has none
+        int operand = -1;
+
+        // scalar value used by scalar step without Y operand
+        double scalar = 0.0;
+
+        // result gets data type of Y operand, i.e. biasadd
+        bool operandType = false;
+
+        std::vector<double> extras;
+    };
+
+    /**
+     * This method applies all steps to output in one tiled pass: each tile of output is produced by the whole chain
+     * while it stays in cache, so intermediate results never go to memory. This helper is available on CPU only.
+     *
+     * @return false if arrays can't be processed this way (data types, orders, unsupported broadcast),
+     * output is left untouched then
+     */
+    bool fusedElementwise(sd::LaunchContext *context, const std::vector<FusedStep> &steps, const std::vector<NDArray*> &inputs, NDArray &output);
+
+}
+}
+}
+
+#endif //SD_FUSED_ELEMENTWISE_H
@@ -0,0 +1,340 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/compression.h>
+#include <execution/Threads.h>
+#include <cstring>
+#include <vector>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+            /*
+             * Encoded array layout, all elements are int32:
+             *   [0] number of elements after first 4 ones
+             *   [1] length of original array
+             *   [2] threshold bits
+             *   [3] 2, flag for ADAPTIVE_ENCODING
+             *   [4] chunk length
+             *   [5] number of chunks
+             *   3 elements per chunk: payload type, number of updates, payload length
+             *   payloads of all chunks, one after another
+             *
+             * Payload types:
+             *   bitmap  - 2 bits per element of chunk, 01 stands for +threshold and 10 for -threshold
+             *   indices - signed 1-based indices within chunk, negative ones stand for -threshold
+             *   varint  - LEB128 bytes of (distance to previous update - 1) << 1 | sign, packed into int32 elements
+             */
+            static const int ADAPTIVE_EMPTY = 0;
+            static const int ADAPTIVE_BITMAP = 1;
+            static const int ADAPTIVE_INDICES = 2;
+            static const int ADAPTIVE_VARINT = 3;
+
+            static const int ADAPTIVE_FLAG = 2;
+            static const int ADAPTIVE_HEADER = 6;
+            static const Nd4jLong ADAPTIVE_CHUNK = 65536;
+
+            struct ChunkPlan {
+                int type;
+                int updates;
+                int length;
+            };
+
+            static FORCEINLINE int varintLength(uint32_t value) {
+                return 1 + (value >= (1u << 7)) + (value >= (1u << 14)) + (value >= (1u << 21)) + (value >= (1u << 28));
+            }
+
+            static FORCEINLINE void run(const FUNC_1D &func, Nd4jLong numChunks) {
+                if (numChunks > 1)
+                    samediff::Threads::parallel_tad(func, 0, numChunks);
+                else
+                    func(0, 0, numChunks, 1);
+            }
+
+            /**
+             * Counts updates of each chunk and picks the smallest payload type for it
+             */
+            template <typename T>
+            static void planChunks_(const NDArray &input, float threshold, std::vector<ChunkPlan> &plans) {
+                const auto x = input.bufferAsT<T>();
+                const auto N = input.lengthOf();
+                const auto numChunks = (N + ADAPTIVE_CHUNK - 1) / ADAPTIVE_CHUNK;
+                const auto tt = static_cast<T>(threshold);
+                const auto mtt = -tt;
+
+                plans.resize(numChunks);
+
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++) {
+                        const auto first = c * ADAPTIVE_CHUNK;
+                        const auto last = sd::math::nd4j_min<Nd4jLong>(N, first + ADAPTIVE_CHUNK);
+
+                        int updates = 0;
+                        Nd4jLong varintBytes = 0;
+                        Nd4jLong previous = -1;
+                        for (auto e = first; e < last; e++) {
+                            const auto v = x[e];
+                            const bool negative = v <= mtt;
+                            if (v >= tt || negative) {
+                                const auto l = e - first;
+                                varintBytes += varintLength(static_cast<uint32_t>(l - previous - 1) << 1 | (negative ? 1 : 0));
+                                previous = l;
+                                updates++;
+                            }
+                        }
+
+                        auto &plan = plans[c];
+                        plan.updates = updates;
+                        if (updates == 0) {
+                            plan.type = ADAPTIVE_EMPTY;
+                            plan.length = 0;
+                            continue;
+                        }
+
+                        // varint is used only if it saves at least a quarter, plain indices are cheaper to encode and decode
+                        const auto varintInts = static_cast<int>((varintBytes + 3) / 4);
+                        plan.type = varintInts * 4 <= updates * 3 ? ADAPTIVE_VARINT : ADAPTIVE_INDICES;
+                        plan.length = plan.type == ADAPTIVE_VARINT ? varintInts : updates;
+
+                        const auto bitmapLength = static_cast<int>((last - first + 15) / 16);
+                        if (bitmapLength < plan.length) {
+                            plan.type = ADAPTIVE_BITMAP;
+                            plan.length = bitmapLength;
+                        }
+                    }
+                };
+
+                run(func, numChunks);
+            }
+
+            template <typename T>
+            static Nd4jLong adaptiveEncodedLength_(const NDArray &input, float threshold) {
+                std::vector<ChunkPlan> plans;
+                planChunks_<T>(input, threshold, plans);
+
+                Nd4jLong length = ADAPTIVE_HEADER + 3 * static_cast<Nd4jLong>(plans.size());
+                for (const auto &plan : plans)
+                    length += plan.length;
+
+                return length;
+            }
+
+            template <typename T>
+            static void encodeAdaptive_(NDArray &input, NDArray &output, float threshold) {
+                std::vector<ChunkPlan> plans;
+                planChunks_<T>(input, threshold, plans);
+
+                const auto x = input.bufferAsT<T>();
+                const auto N = input.lengthOf();
+                const auto numChunks = static_cast<Nd4jLong>(plans.size());
+                const auto tt = static_cast<T>(threshold);
+                const auto mtt = -tt;
+
+                auto z = output.bufferAsT<int>();
+                std::vector<Nd4jLong> offsets(numChunks + 1);
+                offsets[0] = ADAPTIVE_HEADER + 3 * numChunks;
+                for (Nd4jLong c = 0; c < numChunks; c++) {
+                    z[ADAPTIVE_HEADER + 3 * c] = plans[c].type;
+                    z[ADAPTIVE_HEADER + 3 * c + 1] = plans[c].updates;
+                    z[ADAPTIVE_HEADER + 3 * c + 2] = plans[c].length;
+                    offsets[c + 1] = offsets[c] + plans[c].length;
+                }
+
+                if (offsets[numChunks] > output.lengthOf())
+                    throw std::runtime_error("encodeAdaptive: output array is too small for encoded updates");
+
+                z[0] = static_cast<int>(output.lengthOf() - 4);
+                z[1] = static_cast<int>(N);
+                std::memcpy(z + 2, &threshold, sizeof(float));
+                z[3] = ADAPTIVE_FLAG;
+                z[4] = static_cast<int>(ADAPTIVE_CHUNK);
+                z[5] = static_cast<int>(numChunks);
+
+                // each chunk writes its own part of output, so chunks are processed independently
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++) {
+                        const auto &plan = plans[c];
+                        if (plan.type == ADAPTIVE_EMPTY)
+                            continue;
+
+                        const auto first = c * ADAPTIVE_CHUNK;
+                        const auto last = sd::math::nd4j_min<Nd4jLong>(N, first + ADAPTIVE_CHUNK);
+                        auto payload = z + offsets[c];
+
+                        if (plan.type == ADAPTIVE_BITMAP) {
+                            auto bitmap = reinterpret_cast<uint32_t *>(payload);
+                            for (int i = 0; i < plan.length; i++)
+                                bitmap[i] = 0;
+
+                            for (auto e = first; e < last; e++) {
+                                const auto v = x[e];
+                                const auto l = e - first;
+                                if (v >= tt) {
+                                    bitmap[l / 16] |= 1u << ((l % 16) * 2);
+                                    x[e] = v - tt;
+                                } else if (v <= mtt) {
+                                    bitmap[l / 16] |= 2u << ((l % 16) * 2);
+                                    x[e] = v + tt;
+                                }
+                            }
+                        } else if (plan.type == ADAPTIVE_INDICES) {
+                            int pos = 0;
+                            for (auto e = first; e < last; e++) {
+                                const auto v = x[e];
+                                const auto l = static_cast<int>(e - first);
+                                if (v >= tt) {
+                                    payload[pos++] = l + 1;
+                                    x[e] = v - tt;
+                                } else if (v <= mtt) {
+                                    payload[pos++] = -l - 1;
+                                    x[e] = v + tt;
+                                }
+                            }
+                        } else {
+                            // padding bytes of the last element must be zero as well
+                            payload[plan.length - 1] = 0;
+
+                            auto bytes = reinterpret_cast<uint8_t *>(payload);
+                            Nd4jLong pos = 0;
+                            Nd4jLong previous = -1;
+                            for (auto e = first; e < last; e++) {
+                                const auto v = x[e];
+                                const bool negative = v <= mtt;
+                                if (v >= tt || negative) {
+                                    const auto l = e - first;
+                                    auto value = static_cast<uint32_t>(l - previous - 1) << 1 | (negative ? 1 : 0);
+                                    while (value >= 0x80) {
+                                        bytes[pos++] = static_cast<uint8_t>(value | 0x80);
+                                        value >>= 7;
+                                    }
+                                    bytes[pos++] = static_cast<uint8_t>(value);
+
+                                    previous = l;
+                                    x[e] = negative ? v + tt : v - tt;
+                                }
+                            }
+                        }
+                    }
+                };
+
+                run(func, numChunks);
+            }
+
+            template <typename T>
+            static void decodeAdaptive_(const NDArray &input, NDArray &output) {
+                const auto z = input.bufferAsT<int>();
+                auto x = output.bufferAsT<T>();
+
+                float threshold;
+                std::memcpy(&threshold, z + 2, sizeof(float));
+                const auto tt = static_cast<T>(threshold);
+                const auto mtt = -tt;
+
+                const Nd4jLong N = z[1];
+                const Nd4jLong chunk = z[4];
+                const Nd4jLong numChunks = z[5];
+
+                std::vector<Nd4jLong> offsets(numChunks + 1);
+                offsets[0] = ADAPTIVE_HEADER + 3 * numChunks;
+                for (Nd4jLong c = 0; c < numChunks; c++)
+                    offsets[c + 1] = offsets[c] + z[ADAPTIVE_HEADER + 3 * c + 2];
+
+                if (offsets[numChunks] > input.lengthOf())
+                    throw std::runtime_error("decodeAdaptive: encoded array is truncated");
+
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto c = start; c < stop; c++) {
+                        const auto type = z[ADAPTIVE_HEADER + 3 * c];
+                        const auto updates = z[ADAPTIVE_HEADER + 3 * c + 1];
+                        const auto length = z[ADAPTIVE_HEADER + 3 * c + 2];
+                        const auto first = c * chunk;
+                        const auto last = sd::math::nd4j_min<Nd4jLong>(N, first + chunk);
+                        const auto payload = z + offsets[c];
+
+                        if (type == ADAPTIVE_BITMAP) {
+                            const auto bitmap = reinterpret_cast<const uint32_t *>(payload);
+                            for (int i = 0; i < length; i++) {
+                                auto word = bitmap[i];
+                                if (word == 0)
+                                    continue;
+
+                                for (int b = 0; b < 16 && first + i * 16 + b < last; b++) {
+                                    const auto bits = (word >> (b * 2)) & 3;
+                                    if (bits == 1)
+                                        x[first + i * 16 + b] += tt;
+                                    else if (bits == 2)
+                                        x[first + i * 16 + b] += mtt;
+                                }
+                            }
+                        } else if (type == ADAPTIVE_INDICES) {
+                            for (int i = 0; i < length; i++) {
+                                const auto el = payload[i];
+                                x[first + sd::math::nd4j_abs<int>(el) - 1] += el > 0 ? tt : mtt;
+                            }
+                        } else if (type == ADAPTIVE_VARINT) {
+                            const auto bytes = reinterpret_cast<const uint8_t *>(payload);
+                            Nd4jLong pos = 0;
+                            Nd4jLong previous = -1;
+                            for (int i = 0; i < updates; i++) {
+                                uint32_t value = 0;
+                                int shift = 0;
+                                uint8_t byte;
+                                do {
+                                    byte = bytes[pos++];
+                                    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                                    shift += 7;
+                                } while (byte & 0x80);
+
+                                previous += (value >> 1) + 1;
+                                x[first + previous] += (value & 1) ? mtt : tt;
+                            }
+                        }
+                    }
+                };
+
+                run(func, numChunks);
+            }
+
+            Nd4jLong adaptiveEncodedLength(sd::LaunchContext* context, const NDArray* input, float threshold) {
+                input->syncToHost();
+                BUILD_SINGLE_SELECTOR(input->dataType(), return adaptiveEncodedLength_, (*input, threshold), FLOAT_TYPES);
+            }
+
+            void encodeAdaptive(sd::LaunchContext* context, NDArray* input, NDArray* output, float threshold) {
+                input->syncToHost();
+                output->syncToHost();
+
+                BUILD_SINGLE_SELECTOR(input->dataType(), encodeAdaptive_, (*input, *output, threshold), FLOAT_TYPES);
+
+                input->tickWriteHost();
+                output->tickWriteHost();
+            }
+
+            void decodeAdaptive(sd::LaunchContext* context, const NDArray* input, NDArray* output) {
+                input->syncToHost();
+                output->syncToHost();
+
+                BUILD_SINGLE_SELECTOR(output->dataType(), decodeAdaptive_, (*input, *output), FLOAT_TYPES);
+
+                output->tickWriteHost();
+            }
+        }
+    }
+}
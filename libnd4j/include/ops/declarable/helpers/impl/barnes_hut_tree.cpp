@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/BarnesHutTsne.h>
+#include <helpers/BarnesHutTree.h>
+#include <memory>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+            template <typename T>
+            static void repulsiveForces_(const NDArray &data, double theta, NDArray &output, NDArray &sumQ) {
+                const auto numPoints = data.sizeAt(0);
+                const auto dims = static_cast<int>(data.sizeAt(1));
+
+                BarnesHutTree<T> tree(data.bufferAsT<T>(), numPoints, dims);
+                auto sum = tree.repulsiveForces(theta, output.bufferAsT<T>());
+
+                sumQ.bufferAsT<T>()[0] = static_cast<T>(sum);
+            }
+
+            void barnes_repulsive_forces(const NDArray &data, double theta, NDArray &output, NDArray &sumQ) {
+                // tree is built on host, and input rows are expected to be contiguous
+                std::unique_ptr<NDArray> dataCopy;
+                auto input = &data;
+                if (data.ordering() != 'c' || data.ews() != 1) {
+                    dataCopy.reset(new NDArray(data.dup('c')));
+                    input = dataCopy.get();
+                }
+
+                // forces are written row by row as well, other outputs get them via temporary array
+                std::unique_ptr<NDArray> outputCopy;
+                auto forces = &output;
+                if (output.ordering() != 'c' || output.ews() != 1) {
+                    outputCopy.reset(new NDArray('c', output.getShapeAsVector(), output.dataType(), output.getContext()));
+                    forces = outputCopy.get();
+                }
+
+                NDArray::preparePrimaryUse({forces, &sumQ}, {input});
+
+                BUILD_SINGLE_SELECTOR(input->dataType(), repulsiveForces_, (*input, theta, *forces, sumQ), FLOAT_TYPES);
+
+                NDArray::registerPrimaryUse({forces, &sumQ}, {input});
+
+                if (outputCopy != nullptr)
+                    output.assign(forces);
+            }
+        }
+    }
+}
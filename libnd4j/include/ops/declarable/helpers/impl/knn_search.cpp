@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/knn.h>
+#include <helpers/KnnIndex.h>
+#include <memory>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+            // index is built on host, so both data and queries are expected to be c-ordered and contiguous
+            static const NDArray* contiguous(const NDArray &array, std::unique_ptr<NDArray> &copy) {
+                if (array.ordering() == 'c' && array.ews() == 1)
+                    return &array;
+
+                copy.reset(new NDArray(array.dup('c')));
+                return copy.get();
+            }
+
+            void knn_search(const NDArray &data, const NDArray &queries, int k, int distance, NDArray &indices, NDArray &distances) {
+                std::unique_ptr<NDArray> dataCopy, queriesCopy;
+                auto x = contiguous(data, dataCopy);
+                auto q = contiguous(queries, queriesCopy);
+
+                NDArray::preparePrimaryUse({&indices, &distances}, {x, q});
+
+                std::unique_ptr<KnnIndex> index(KnnIndex::build(x->buffer(), x->dataType(), x->sizeAt(0), static_cast<int>(x->sizeAt(1)), static_cast<KnnDistance>(distance)));
+                index->search(q->buffer(), q->sizeAt(0), k, indices.bufferAsT<Nd4jLong>(), distances.buffer());
+
+                NDArray::registerPrimaryUse({&indices, &distances}, {x, q});
+            }
+
+            void knn_radius_search(const NDArray &data, const NDArray &queries, double radius, int maxResults, int distance, NDArray &indices, NDArray &distances, NDArray &counts) {
+                std::unique_ptr<NDArray> dataCopy, queriesCopy;
+                auto x = contiguous(data, dataCopy);
+                auto q = contiguous(queries, queriesCopy);
+
+                NDArray::preparePrimaryUse({&indices, &distances, &counts}, {x, q});
+
+                std::unique_ptr<KnnIndex> index(KnnIndex::build(x->buffer(), x->dataType(), x->sizeAt(0), static_cast<int>(x->sizeAt(1)), static_cast<KnnDistance>(distance)));
+                index->searchRadius(q->buffer(), q->sizeAt(0), radius, maxResults, indices.bufferAsT<Nd4jLong>(), distances.buffer(), counts.bufferAsT<Nd4jLong>());
+
+                NDArray::registerPrimaryUse({&indices, &distances, &counts}, {x, q});
+            }
+        }
+    }
+}
@@ -27,6 +27,13 @@ namespace sd {
     namespace ops {
         namespace helpers {
             void knn_mindistance(const NDArray &input, const NDArray &lowest, const NDArray &highest, NDArray &output);
+
+            /**
+             * These methods build VP-tree over rows of data and run batched queries against it,
+             * distance is one of KnnDistance values
+             */
+            void knn_search(const NDArray &data, const NDArray &queries, int k, int distance, NDArray &indices, NDArray &distances);
+            void knn_radius_search(const NDArray &data, const NDArray &queries, double radius, int maxResults, int distance, NDArray &indices, NDArray &distances, NDArray &counts);
         }
     }
 }
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#ifndef SD_QUANTIZATION_H
+#define SD_QUANTIZATION_H
+
+#include <ops/declarable/helpers/helpers.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+    /**
+     * Quantized arrays are INT8 or UINT8 arrays, accompanied by scale and zero point: real value = (q - zeroPoint) * scale.
+     * Scale and zero point are either scalars, or vectors with one value per channel of last dimension
+     */
+
+    /**
+     * q = clamp(floor(x / scale + 0.5) + zeroPoint, quantMin, quantMax). Halves are rounded up, as fake_quant ops do
+     */
+    void quantizeLinear(sd::LaunchContext *context, const NDArray &input, const NDArray &scale, const NDArray &zeroPoint, int quantMin, int quantMax, NDArray &output);
+
+    /**
+     * x = (q - zeroPoint) * scale
+     */
+    void dequantizeLinear(sd::LaunchContext *context, const NDArray &input, const NDArray &scale, const NDArray &zeroPoint, NDArray &output);
+
+    /**
+     * output = aScale * bScale * ((a - aZeroPoint) x (b - bZeroPoint)) + bias, products are accumulated in int32
+     *
+     * @param a - [M, K] array, with single scale and zero point
+     * @param b - [K, N] array, scale and zero point are either scalars or [N] vectors
+     * @param bias - optional [N] vector
+     * @param output - [M, N] floating point array
+     */
+    void quantizedMatmul(sd::LaunchContext *context, const NDArray &a, const NDArray &aScale, const NDArray &aZeroPoint,
+                         const NDArray &b, const NDArray &bScale, const NDArray &bZeroPoint, const NDArray *bias, NDArray &output);
+
+    /**
+     * 2D convolution of quantized input and weights. Padded positions are filled with input zero point, so they add nothing
+     *
+     * @param input - [bS, iH, iW, iC] array, with single scale and zero point
+     * @param weights - [kH, kW, iC, oC] array, scale and zero point are either scalars or [oC] vectors
+     * @param bias - optional [oC] vector
+     * @param output - [bS, oH, oW, oC] floating point array
+     */
+    void quantizedConv2d(sd::LaunchContext *context, const NDArray &input, const NDArray &inScale, const NDArray &inZeroPoint,
+                         const NDArray &weights, const NDArray &wScale, const NDArray &wZeroPoint, const NDArray *bias, NDArray &output,
+                         int kH, int kW, int sH, int sW, int pH, int pW, int dH, int dW);
+}
+}
+}
+
+#endif //SD_QUANTIZATION_H
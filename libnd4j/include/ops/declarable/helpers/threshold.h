@@ -26,7 +26,7 @@
 namespace sd {
     namespace ops {
         namespace helpers {
-            int32_t thresholdEstimate(const NDArray &updates, float threshold);
+            Nd4jLong thresholdEstimate(const NDArray &updates, float threshold);
 
             void thresholdEncode(NDArray &updates, NDArray &encoded, float threshold);
             void thresholdDecode(const NDArray &encoded, NDArray &updates);
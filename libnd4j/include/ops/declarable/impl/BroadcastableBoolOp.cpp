@@ -68,5 +68,9 @@ namespace sd {
 
             return shapeList;
         }
+
+        bool BroadcastableBoolOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
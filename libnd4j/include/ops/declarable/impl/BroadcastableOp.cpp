@@ -82,5 +82,9 @@ namespace sd {
 
             return shapeList;
         }
+
+        bool BroadcastableOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
@@ -275,7 +275,28 @@ namespace sd {
                     shapeStart = std::chrono::system_clock::now();
                 }
 
-                auto outSha = this->calculateOutputShape(&inSha, ctx);
+                // shape function results are memoized per Context/Node, so repeated calls with the same shapes and args skip it
+                static thread_local std::vector<Nd4jLong> memoKey;
+                ShapeList memoized;
+                ShapeList *outSha = nullptr;
+                ShapeMemo *memo = nullptr;
+
+                if (this->hasPureShapeFunction()) {
+                    memo = ctx.shapeMemo().get();
+
+                    // op instance is a part of the key: legacy ops share the same name
+                    ShapeMemo::buildKey(memoKey, reinterpret_cast<Nd4jLong>(this), inSha, ctx);
+                    if (memo->lookup(memoKey, memoized))
+                        outSha = &memoized;
+                }
+
+                if (outSha == nullptr) {
+                    outSha = this->calculateOutputShape(&inSha, ctx);
+
+                    if (memo != nullptr)
+                        memo->store(memoKey, *outSha);
+                }
+
                 results = outSha->size();
 
                 // optionally saving shapeTime
@@ -323,7 +344,8 @@ namespace sd {
                                 auto eShapeInfoString = ShapeUtils::shapeInfoAsString(out);
                                 auto aShapeInfoString = ShapeUtils::shapeInfoAsString(shape);
                                 //outSha->destroy();
-                                delete outSha;
+                                if (outSha != &memoized)
+                                    delete outSha;
 
                                 nd4j_printf("Expected vs provided shapes mismatch %s vs %s at index %i with expected shape info %s and output shape info %s\n", eShape.c_str(), aShape.c_str(), pair.second,eShapeInfoString.c_str(),aShapeInfoString.c_str());
 
@@ -355,7 +377,8 @@ namespace sd {
                                 auto aShapeInfoString = ShapeUtils::shapeInfoAsString(array->shapeInfo());
                                 if(eShapeInfoString != aShapeInfoString) {
                                     //outSha->destroy();
-                                    delete outSha;
+                                    if (outSha != &memoized)
+                                        delete outSha;
 
                                     nd4j_printf("Expected vs provided shapes mismatch %s vs %s at index %i with expected shape info %s and output shape info %s. Conditions, shapeEquals: %d, array empty: %d\n", eShape.c_str(), aShape.c_str(), idx,eShapeInfoString.c_str(),aShapeInfoString.c_str(),shapeEquals,arrayEmpty);
                                     throw std::runtime_error("Output array did not match expected shape.");
@@ -369,7 +392,8 @@ namespace sd {
                 if (!canUseFastPath)
                     ctx.forbidFastPath(true);
 
-                delete outSha;
+                if (outSha != &memoized)
+                    delete outSha;
 
                 // saving arrayTime
                 if (Environment::getInstance().isProfiling() && node != nullptr) {
@@ -1125,6 +1149,10 @@ namespace sd {
             return samediff::EmptyHandling::EMPTY_SKIP;
         }
 
+        bool DeclarableOp::hasPureShapeFunction() {
+            return false;
+        }
+
         void DeclarableOp::registerTypes() {
             this->getOpDescriptor()->setSameMode(true);
         }
@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <ops/declarable/FusedElementwiseOp.h>
+#include <ops/BroadcastOpsTuple.h>
+#include <helpers/ShapeUtils.h>
+#include <helpers/ConstantShapeHelper.h>
+#include <array/NDArrayFactory.h>
+#include <memory>
+
+namespace sd {
+    namespace ops {
+        FusedElementwiseOp::FusedElementwiseOp(const std::vector<helpers::FusedStep> &steps, int numInputs) : DeclarableOp::DeclarableOp(numInputs, 1, "fused_elementwise", false) {
+            _steps = steps;
+        }
+
+        const std::vector<helpers::FusedStep>& FusedElementwiseOp::steps() const {
+            return _steps;
+        }
+
+        void FusedElementwiseOp::registerTypes() {
+            // data types were validated by original ops when graph was imported
+            this->getOpDescriptor()
+                    ->setAllowedInputTypes(sd::DataType::ANY)
+                    ->setAllowedOutputTypes(sd::DataType::ANY);
+        }
+
+        bool FusedElementwiseOp::hasPureShapeFunction() {
+            return true;
+        }
+
+        const Nd4jLong* FusedElementwiseOp::stepShapeInfo(const helpers::FusedStep &step, const Nd4jLong *xShapeInfo, const Nd4jLong *yShapeInfo, sd::memory::Workspace *workspace) {
+            auto dtype = step.operandType ? ArrayOptions::dataType(yShapeInfo) : ArrayOptions::dataType(xShapeInfo);
+
+            // same as NDArray::transform() for FloatOps: integer inputs give outputs of default floating type
+            if (step.type == helpers::FusedStepType::TRANSFORM_FLOAT)
+                dtype = DataTypeUtils::pickFloatingType(dtype);
+            auto shapeInfo = xShapeInfo;
+
+            // only broadcastables may change shape of the chain
+            if (step.type == helpers::FusedStepType::BROADCASTABLE && !shape::isScalar(yShapeInfo) && !shape::equalsSoft(xShapeInfo, yShapeInfo)) {
+                const Nd4jLong *newShape = nullptr;
+                ShapeUtils::evalBroadcastShapeInfo(xShapeInfo, yShapeInfo, true, newShape, workspace);
+                shapeInfo = newShape;
+            }
+
+            return ConstantShapeHelper::getInstance().createShapeInfo(ShapeDescriptor(shapeInfo, dtype));
+        }
+
+        ShapeList *FusedElementwiseOp::calculateOutputShape(ShapeList *inputShape, sd::graph::Context &block) {
+            auto shapeInfo = inputShape->at(0);
+            for (auto &step: _steps)
+                shapeInfo = stepShapeInfo(step, shapeInfo, step.operand >= 0 ? inputShape->at(step.operand) : shapeInfo, block.workspace());
+
+            return SHAPELIST(shapeInfo);
+        }
+
+        Nd4jStatus FusedElementwiseOp::validateAndExecute(Context &block) {
+            std::vector<NDArray*> inputs;
+            for (int e = 0; e < block.width(); e++)
+                inputs.emplace_back(INPUT_VARIABLE(e));
+
+            auto z = OUTPUT_VARIABLE(0);
+
+#ifndef __CUDABLAS__
+            if (helpers::fusedElementwise(block.launchContext(), _steps, inputs, *z)) {
+                STORE_RESULT(*z);
+                return Status::OK();
+            }
+#endif
+
+            // fallback: steps are executed one by one, intermediate results go to temporary arrays
+            NDArray *x = inputs[0];
+            std::unique_ptr<NDArray> current;
+            for (size_t e = 0; e < _steps.size(); e++) {
+                auto &step = _steps[e];
+                auto y = step.operand >= 0 ? inputs[step.operand] : nullptr;
+
+                std::unique_ptr<NDArray> temp;
+                auto target = z;
+                if (e < _steps.size() - 1) {
+                    temp.reset(new NDArray(stepShapeInfo(step, x->shapeInfo(), y != nullptr ? y->shapeInfo() : x->shapeInfo(), block.workspace()), false, block.launchContext()));
+                    target = temp.get();
+                }
+
+                ExtraArguments extras(step.extras);
+                switch (step.type) {
+                    case helpers::FusedStepType::TRANSFORM_SAME:
+                        x->applyTransform(static_cast<sd::transform::SameOps>(step.opNum), *target, &extras);
+                        break;
+                    case helpers::FusedStepType::TRANSFORM_FLOAT:
+                        x->applyTransform(static_cast<sd::transform::FloatOps>(step.opNum), *target, &extras);
+                        break;
+                    case helpers::FusedStepType::TRANSFORM_STRICT:
+                        x->applyTransform(static_cast<sd::transform::StrictOps>(step.opNum), *target, &extras);
+                        break;
+                    case helpers::FusedStepType::SCALAR: {
+                        if (y != nullptr) {
+                            x->applyScalarArr(static_cast<sd::scalar::Ops>(step.opNum), *y, *target, &extras);
+                        } else {
+                            auto scalar = NDArrayFactory::create(x->dataType(), step.scalar, block.launchContext());
+                            x->applyScalarArr(static_cast<sd::scalar::Ops>(step.opNum), scalar, *target, &extras);
+                        }
+                    }
+                    break;
+                    case helpers::FusedStepType::PAIRWISE:
+                        x->applyPairwiseTransform(static_cast<sd::pairwise::Ops>(step.opNum), *y, *target, &extras);
+                        break;
+                    case helpers::FusedStepType::BROADCASTABLE: {
+                        auto tuple = BroadcastOpsTuple::custom(static_cast<sd::scalar::Ops>(step.scalarOp), static_cast<sd::pairwise::Ops>(step.opNum), static_cast<sd::broadcast::Ops>(step.broadcastOp));
+                        x->applyTrueBroadcast(tuple, *y, *target);
+                    }
+                    break;
+                    default:
+                        throw std::runtime_error("FusedElementwiseOp: unknown step type");
+                }
+
+                // previous intermediate result isn't needed anymore
+                x = target;
+                current = std::move(temp);
+            }
+
+            STORE_RESULT(*z);
+
+            return Status::OK();
+        }
+    }
+}
@@ -69,5 +69,9 @@ namespace sd {
             auto inShape = inputShape->at(0);
             return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ShapeDescriptor(inShape, DataType::BOOL)));
         }
+
+        bool LegacyPairwiseTransformBoolOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
@@ -73,5 +73,9 @@ namespace sd {
 
             return SHAPELIST(CONSTANT(newShape));
         }
+
+        bool LegacyPairwiseTransformOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
@@ -83,5 +83,9 @@ namespace sd {
 
             return Status::OK();
         }
+
+        bool LegacyScalarBoolOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
@@ -85,5 +85,9 @@ namespace sd {
 
             return Status::OK();
         }
+
+        bool LegacyScalarOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
@@ -70,5 +70,9 @@ namespace sd {
 
             return SHAPELIST(CONSTANT(newShape));
         }
+
+        bool LegacyTransformAnyOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
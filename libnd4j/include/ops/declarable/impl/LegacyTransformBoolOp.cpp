@@ -67,5 +67,9 @@ namespace sd {
             auto inShape = inputShape->at(0);
             return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ShapeDescriptor(inShape, DataType::BOOL)));
         }
+
+        bool LegacyTransformBoolOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
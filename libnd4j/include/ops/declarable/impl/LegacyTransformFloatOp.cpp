@@ -70,5 +70,9 @@ namespace sd {
 
             return SHAPELIST(CONSTANT(newShape));
         }
+
+        bool LegacyTransformFloatOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
@@ -69,5 +69,9 @@ namespace sd {
 
             return SHAPELIST(CONSTANT(newShape));
         }
+
+        bool LegacyTransformStrictOp::hasPureShapeFunction() {
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
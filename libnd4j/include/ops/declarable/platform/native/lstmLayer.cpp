@@ -0,0 +1,234 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#include <ops/declarable/PlatformHelper.h>
+#include <ops/declarable/OpRegistrator.h>
+#include <system/platform_boilerplate.h>
+#include "nativeUtils.h"
+
+namespace sd      {
+namespace ops       {
+namespace platforms {
+
+//////////////////////////////////////////////////////////////////////
+PLATFORM_IMPL(lstmLayer, ENGINE_CPU) {
+
+    const auto dataFormat    = INT_ARG(0);    // for unidirectional: 0 = [sL, bS, nIn], 1 = [bS, sL ,nIn], 2 = [bS, nIn, sL], for bidirectional: 3 = [sL, bS, nIn] && [sL, 2, bS, nOut] (for ONNX)
+    const auto directionMode = INT_ARG(1);    // direction: 0 = fwd, 1 = bwd, 2 = bidirectional sum, 3 = bidirectional concat, 4 = bidirectional extra output dim (in conjunction with format dataFormat = 3)
+
+    // integer numbers corresponding to activations: 0=tanh, 1=relu, 2=sigmoid, 3=affine, 4=leaky relu, 5= thresholded relu, 6=scaled tanh, 7=hard sigmoid, 8=ELU, 9=softsign, 10=softplus
+    const auto gateAct       = INT_ARG(2);    // activation for input (i), forget (f) and output (o) gates
+    const auto cellAct       = INT_ARG(3);    // activation for cell state (c)
+    const auto outAct        = INT_ARG(4);    // activation for output (h)
+
+    const auto hasBiases  = B_ARG(0);   // indicates whether biases array is provided
+    const auto hasSeqLen  = B_ARG(1);   // indicates whether seqLen array is provided
+    const auto hasInitH   = B_ARG(2);   // indicates whether initial output is provided
+    const auto hasInitC   = B_ARG(3);   // indicates whether initial cell state is provided
+    const auto hasPH      = B_ARG(4);   // indicates whether peephole connections are present
+    const auto retFullSeq = B_ARG(5);   // indicates whether to return whole time sequence h {h_0, h_1, ... , h_sL-1}
+    const auto retLastH   = B_ARG(6);   // indicates whether to return output at last time step only
+    const auto retLastC   = B_ARG(7);   // indicates whether to return cells state at last time step only
+
+    const auto gateActHasAlpha = gateAct == 3 || gateAct == 4 || gateAct == 5 || gateAct == 6 || gateAct == 8;
+    const auto cellActHasAlpha = cellAct == 3 || cellAct == 4 || cellAct == 5 || cellAct == 6 || cellAct == 8;
+    const auto outActHasAlpha  = outAct  == 3 || outAct  == 4 || outAct  == 5 || outAct  == 6 || outAct  == 8;
+    const auto gateActHasBeta  = gateAct == 3 || gateAct == 6;
+    const auto cellActHasBeta  = cellAct == 3 || cellAct == 6;
+    const auto outActHasBeta   = outAct  == 3 || outAct  == 6;
+
+    uint count = 1;
+    const auto cellClip = T_ARG(0);                                     // cell clipping value, if it = 0 then do not apply clipping
+    const auto gateAlpha = gateActHasAlpha ? T_ARG(count++) : 0;
+    const auto gateBeta  = gateActHasBeta  ? T_ARG(count++) : 0;
+    const auto cellAlpha = cellActHasAlpha ? T_ARG(count++) : 0;
+    const auto cellBeta  = cellActHasBeta  ? T_ARG(count++) : 0;
+    const auto outAlpha  = outActHasAlpha  ? T_ARG(count++) : 0;
+    const auto outBeta   = outActHasBeta   ? T_ARG(count++) : 0;
+
+    const auto x  = INPUT_VARIABLE(0);          // input
+    const auto Wx = INPUT_VARIABLE(1);          // input weights
+    const auto Wr = INPUT_VARIABLE(2);          // recurrent weights
+
+    count = 3;
+    const auto b      = hasBiases ? INPUT_VARIABLE(count++) : nullptr;  // biases
+    const auto seqLen = hasSeqLen ? INPUT_VARIABLE(count++) : nullptr;  // seqLen vector
+    const auto hI     = hasInitH  ? INPUT_VARIABLE(count++) : nullptr;  // initial output
+    const auto cI     = hasInitC  ? INPUT_VARIABLE(count++) : nullptr;  // initial cell state
+    const auto Wp     = hasPH     ? INPUT_VARIABLE(count++) : nullptr;  // peephole weights
+
+    REQUIRE_TRUE(dataFormat < 3 || (dataFormat == 3 && directionMode == 4), 0, "LSTM_LAYER_NATIVE operation: if argument dataFormat = 3, then directionMode = 4, but got dataFormat = %i and directionMode = %i instead !", dataFormat, directionMode);
+    REQUIRE_TRUE(cellClip >= 0 , 0, "LSTM_LAYER_NATIVE operation: cell clipping value should be nonnegative (>=0) !");
+    REQUIRE_TRUE(retFullSeq || retLastH || retLastC, 0, "LSTM_LAYER_NATIVE operation: please specify what output arrays to produce !");
+
+    count = 0;
+    auto h  = retFullSeq ? OUTPUT_VARIABLE(count++) : nullptr;           // output
+    auto hL = retLastH   ? OUTPUT_VARIABLE(count++) : nullptr;           // output at last step
+    auto cL = retLastC   ? OUTPUT_VARIABLE(count++) : nullptr;           // cell state at last step
+
+    // evaluate dimensions
+    const Nd4jLong sL   = dataFormat == 3 ?  x->sizeAt(0) : x->sizeAt(dataFormat);
+    const Nd4jLong bS   = dataFormat == 1 || dataFormat == 2 ? x->sizeAt(0) : x->sizeAt(1);
+    const Nd4jLong nIn  = dataFormat == 2 ? x->sizeAt(1) : x->sizeAt(2);
+    const Nd4jLong nOut = Wx->sizeAt(-1) / 4;
+
+    // inputs validations
+    if(directionMode < 2) {     // no bidirectional
+
+        // Wx validation
+        if(Wx->rankOf() != 2 || Wx->sizeAt(0) != nIn)
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of input weights, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({nIn, 4*nOut}).c_str(), ShapeUtils::shapeAsString(Wx).c_str());
+        // Wr validation
+        if(Wr->rankOf() != 2 || Wr->sizeAt(0) != nOut || Wr->sizeAt(1) != 4*nOut)
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of recurrent weights, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({nOut, 4*nOut}).c_str(), ShapeUtils::shapeAsString(Wr).c_str());
+        // biases validation
+        if(b != nullptr && (b->rankOf() != 1 || b->sizeAt(0) != 4*nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of biases, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({4*nOut}).c_str(), ShapeUtils::shapeAsString(b).c_str());
+        // initial output validation
+        if(hI != nullptr && (hI->rankOf() != 2 || hI->sizeAt(0) != bS || hI->sizeAt(1) != nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of initial output, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({bS, nOut}).c_str(), ShapeUtils::shapeAsString(hI).c_str());
+        // initial cell  validation
+        if(cI != nullptr && (cI->rankOf() != 2 || cI->sizeAt(0) != bS || cI->sizeAt(1) != nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of initial cell state, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({bS, nOut}).c_str(), ShapeUtils::shapeAsString(cI).c_str());
+        // peephole weights validation
+        if(Wp != nullptr && (Wp->rankOf() != 1 || Wp->sizeAt(0) != 3*nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong peephole weights, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({3*nOut}).c_str(), ShapeUtils::shapeAsString(Wp).c_str());
+    }
+    else {                  // bidirectional
+         // Wx validation
+        if(Wx->rankOf() != 3 || Wx->sizeAt(0) != 2 || Wx->sizeAt(1) != nIn)
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of input weights, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({2, nIn, 4*nOut}).c_str(), ShapeUtils::shapeAsString(Wx).c_str());
+        // Wr validation
+        if(Wr->rankOf() != 3 || Wr->sizeAt(0) != 2 || Wr->sizeAt(1) != nOut || Wr->sizeAt(2) != 4*nOut)
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of recurrent weights, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({2, nOut, 4*nOut}).c_str(), ShapeUtils::shapeAsString(Wr).c_str());
+        // biases validation
+        if(b != nullptr && (b->rankOf() != 2 || b->sizeAt(0) != 2 || b->sizeAt(1) != 4*nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of biases, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({2, 4*nOut}).c_str(), ShapeUtils::shapeAsString(b).c_str());
+        // initial output validation
+        if(hI != nullptr && (hI->rankOf() != 3 || hI->sizeAt(0) != 2 || hI->sizeAt(1) != bS || hI->sizeAt(2) != nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of initial output, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({2, bS, nOut}).c_str(), ShapeUtils::shapeAsString(hI).c_str());
+        // initial cell  validation
+        if(cI != nullptr && (cI->rankOf() != 3 || cI->sizeAt(0) != 2 || cI->sizeAt(1) != bS || cI->sizeAt(2) != nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong shape of initial cell state, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({2, bS, nOut}).c_str(), ShapeUtils::shapeAsString(cI).c_str());
+        // peephole weights validation
+        if(Wp != nullptr && (Wp->rankOf() != 2 || Wp->sizeAt(0) != 2 || Wp->sizeAt(1) != 3*nOut))
+            REQUIRE_TRUE(false, 0, "LSTM_LAYER_NATIVE operation: wrong peephole weights, expected is %s, but got %s instead !", ShapeUtils::shapeAsString({2, 3*nOut}).c_str(), ShapeUtils::shapeAsString(Wp).c_str());
+    }
+
+    std::vector<float> params = {static_cast<float>(dataFormat), static_cast<float>(directionMode), static_cast<float>(cellClip),
+                                 static_cast<float>(gateAct), static_cast<float>(gateAlpha), static_cast<float>(gateBeta),
+                                 static_cast<float>(cellAct), static_cast<float>(cellAlpha), static_cast<float>(cellBeta),
+                                 static_cast<float>(outAct), static_cast<float>(outAlpha), static_cast<float>(outBeta)};
+
+    if(directionMode < 2) {
+
+        nativeUtils::lstmLayerTimeLoop(x, Wx, Wr, b, seqLen, hI, cI, Wp, params, directionMode == 0, h, hL, cL);
+        return Status::OK();
+    }
+
+    // bidirectional: each direction works on its own sub-arrays, outputs are written through views
+    NDArray WxFwd = (*Wx)({0,1, 0,0, 0,0}).reshape(Wx->ordering(), {nIn, 4*nOut});
+    NDArray WxBwd = (*Wx)({1,2, 0,0, 0,0}).reshape(Wx->ordering(), {nIn, 4*nOut});
+    NDArray WrFwd = (*Wr)({0,1, 0,0, 0,0}).reshape(Wr->ordering(), {nOut, 4*nOut});
+    NDArray WrBwd = (*Wr)({1,2, 0,0, 0,0}).reshape(Wr->ordering(), {nOut, 4*nOut});
+
+    NDArray bFwd, bBwd, WpFwd, WpBwd, hIFwd, hIBwd, cIFwd, cIBwd, hLFwd, hLBwd, cLFwd, cLBwd, hFwd, hBwd;
+
+    if(b) {
+        bFwd = (*b)({0,1, 0,0});
+        bBwd = (*b)({1,2, 0,0});
+    }
+    if(Wp) {
+        WpFwd = (*Wp)({0,1, 0,0});
+        WpBwd = (*Wp)({1,2, 0,0});
+    }
+    if(hI) {
+        hIFwd = (*hI)({0,1, 0,0, 0,0});
+        hIBwd = (*hI)({1,2, 0,0, 0,0});
+    }
+    if(cI) {
+        cIFwd = (*cI)({0,1, 0,0, 0,0});
+        cIBwd = (*cI)({1,2, 0,0, 0,0});
+    }
+    if(hL) {
+        hLFwd = (*hL)({0,1, 0,0, 0,0});
+        hLBwd = (*hL)({1,2, 0,0, 0,0});
+    }
+    if(cL) {
+        cLFwd = (*cL)({0,1, 0,0, 0,0});
+        cLBwd = (*cL)({1,2, 0,0, 0,0});
+    }
+    if(h) {
+        if(directionMode == 2) {        // sum, forward direction writes directly to h
+            hBwd = NDArray(h->ordering(), h->getShapeAsVector(), h->dataType(), h->getContext());
+        }
+        else if(directionMode == 3) {   // concat
+            hFwd = dataFormat <= 1 ? (*h)({0,0, 0,0,    0,nOut})   : (*h)({0,0,    0,nOut,   0,0});
+            hBwd = dataFormat <= 1 ? (*h)({0,0, 0,0, nOut,2*nOut}) : (*h)({0,0, nOut,2*nOut, 0,0});
+        }
+        else {                          // directionMode == 4
+            hFwd = (*h)({0,0, 0,1, 0,0, 0,0});
+            hBwd = (*h)({0,0, 1,2, 0,0, 0,0});
+        }
+    }
+
+    nativeUtils::lstmLayerTimeLoop(x, &WxFwd, &WrFwd, b ? &bFwd : nullptr, seqLen, hI ? &hIFwd : nullptr, cI ? &cIFwd : nullptr, Wp ? &WpFwd : nullptr, params, true,
+                                   h ? (directionMode == 2 ? h : &hFwd) : nullptr, hL ? &hLFwd : nullptr, cL ? &cLFwd : nullptr);
+    nativeUtils::lstmLayerTimeLoop(x, &WxBwd, &WrBwd, b ? &bBwd : nullptr, seqLen, hI ? &hIBwd : nullptr, cI ? &cIBwd : nullptr, Wp ? &WpBwd : nullptr, params, false,
+                                   h ? &hBwd : nullptr, hL ? &hLBwd : nullptr, cL ? &cLBwd : nullptr);
+
+    if(h && directionMode == 2)
+        *h += hBwd;
+
+    return Status::OK();
+}
+
+PLATFORM_CHECK(lstmLayer, ENGINE_CPU) {
+
+    const auto gateAct = INT_ARG(2);
+    const auto cellAct = INT_ARG(3);
+    const auto outAct  = INT_ARG(4);
+
+    // unknown activations are reported by generic implementation
+    if (gateAct < 0 || gateAct > 10 || cellAct < 0 || cellAct > 10 || outAct < 0 || outAct > 10)
+        return false;
+
+    // lstmLayer is only available for float32 and double dtypes, all arrays of the same type
+    const auto dtype = INPUT_VARIABLE(0)->dataType();
+    if (dtype != sd::DataType::FLOAT32 && dtype != sd::DataType::DOUBLE)
+        return false;
+
+    const int seqLenIndex = B_ARG(0) ? 4 : 3;
+    for (int i = 1; i < static_cast<int>(block.width()); i++)
+        if (!(B_ARG(1) && i == seqLenIndex) && INPUT_VARIABLE(i)->dataType() != dtype)
+            return false;
+
+    const int numOutputs = static_cast<int>(B_ARG(5)) + static_cast<int>(B_ARG(6)) + static_cast<int>(B_ARG(7));
+    for (int i = 0; i < numOutputs; i++)
+        if (OUTPUT_VARIABLE(i)->dataType() != dtype)
+            return false;
+
+    return true;
+}
+
+}
+}
+}
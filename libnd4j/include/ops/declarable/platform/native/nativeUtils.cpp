@@ -0,0 +1,648 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#include "nativeUtils.h"
+#include <ops/declarable/helpers/convolutions.h>
+#include <helpers/MmulHelper.h>
+#include <execution/Threads.h>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace platforms {
+namespace nativeUtils {
+
+//////////////////////////////////////////////////////////////////////
+// strides of image arrays along batch, channels, height and width, for both NCHW and NHWC
+struct ImageStrides {
+    Nd4jLong b, c, h, w;
+};
+
+static ImageStrides imageStrides(const NDArray *array, const int isNCHW) {
+    if (isNCHW)
+        return {array->strideAt(0), array->strideAt(1), array->strideAt(2), array->strideAt(3)};
+
+    return {array->strideAt(0), array->strideAt(3), array->strideAt(1), array->strideAt(2)};
+}
+
+//////////////////////////////////////////////////////////////////////
+// weights of any format are packed to contiguous [kH, kW, iC, oC], so rows of output channels are contiguous
+template <typename T>
+static std::vector<T> packWeights(const NDArray *weights, const int wFormat, const int kH, const int kW, const int iC, const int oC) {
+    Nd4jLong sKh, sKw, sIc, sOc;
+    if (0 == wFormat) {                     // [kH, kW, iC, oC]
+        sKh = weights->strideAt(0); sKw = weights->strideAt(1); sIc = weights->strideAt(2); sOc = weights->strideAt(3);
+    } else if (1 == wFormat) {              // [oC, iC, kH, kW]
+        sOc = weights->strideAt(0); sIc = weights->strideAt(1); sKh = weights->strideAt(2); sKw = weights->strideAt(3);
+    } else {                                // [oC, kH, kW, iC]
+        sOc = weights->strideAt(0); sKh = weights->strideAt(1); sKw = weights->strideAt(2); sIc = weights->strideAt(3);
+    }
+
+    auto w = weights->bufferAsT<T>();
+    std::vector<T> packed(static_cast<size_t>(kH) * kW * iC * oC);
+
+    for (int kh = 0; kh < kH; kh++)
+        for (int kw = 0; kw < kW; kw++)
+            for (int ic = 0; ic < iC; ic++) {
+                auto row = packed.data() + ((static_cast<Nd4jLong>(kh) * kW + kw) * iC + ic) * oC;
+                for (int oc = 0; oc < oC; oc++)
+                    row[oc] = w[kh * sKh + kw * sKw + ic * sIc + oc * sOc];
+            }
+
+    return packed;
+}
+
+template <typename T>
+static std::vector<T> biasVector(const NDArray *bias, const int oC) {
+    std::vector<T> result(oC, static_cast<T>(0));
+    if (bias != nullptr)
+        for (int oc = 0; oc < oC; oc++)
+            result[oc] = bias->e<T>(oc);
+
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////
+// c = a * b
+template <typename T, int R, int C, int K>
+static FORCEINLINE void matMul(const T (&a)[R][K], const T (&b)[K][C], T (&c)[R][C]) {
+    for (int r = 0; r < R; r++)
+        for (int j = 0; j < C; j++) {
+            T sum = 0;
+            for (int k = 0; k < K; k++)
+                sum += a[r][k] * b[k][j];
+            c[r][j] = sum;
+        }
+}
+
+// c = a * b^T
+template <typename T, int R, int C, int K>
+static FORCEINLINE void matMulT(const T (&a)[R][K], const T (&b)[C][K], T (&c)[R][C]) {
+    for (int r = 0; r < R; r++)
+        for (int j = 0; j < C; j++) {
+            T sum = 0;
+            for (int k = 0; k < K; k++)
+                sum += a[r][k] * b[j][k];
+            c[r][j] = sum;
+        }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Winograd F(m x m, 3 x 3) transforms: V = BT * d * B, U = G * g * GT, Y = AT * M * A
+template <typename T, int M>
+struct WinogradTransform { };
+
+template <typename T>
+struct WinogradTransform<T, 2> {
+    static const int A = 4;
+
+    static FORCEINLINE void input(const T (&d)[A][A], T (&v)[A][A]) {
+        static const T BT[A][A] = {{1,  0, -1,  0},
+                                   {0,  1,  1,  0},
+                                   {0, -1,  1,  0},
+                                   {0,  1,  0, -1}};
+        T tmp[A][A];
+        matMul(BT, d, tmp);
+        matMulT(tmp, BT, v);
+    }
+
+    static FORCEINLINE void filter(const T (&g)[3][3], T (&u)[A][A]) {
+        static const T G[A][3] = {{1,                  0,                  0},
+                                  {static_cast<T>(0.5),  static_cast<T>(0.5), static_cast<T>(0.5)},
+                                  {static_cast<T>(0.5), static_cast<T>(-0.5), static_cast<T>(0.5)},
+                                  {0,                  0,                  1}};
+        T tmp[A][3];
+        matMul(G, g, tmp);
+        matMulT(tmp, G, u);
+    }
+
+    static FORCEINLINE void output(const T (&m)[A][A], T (&y)[2][2]) {
+        static const T AT[2][A] = {{1, 1,  1,  0},
+                                   {0, 1, -1, -1}};
+        T tmp[2][A];
+        matMul(AT, m, tmp);
+        matMulT(tmp, AT, y);
+    }
+};
+
+template <typename T>
+struct WinogradTransform<T, 4> {
+    static const int A = 6;
+
+    static FORCEINLINE void input(const T (&d)[A][A], T (&v)[A][A]) {
+        static const T BT[A][A] = {{4,  0, -5,  0, 1, 0},
+                                   {0, -4, -4,  1, 1, 0},
+                                   {0,  4, -4, -1, 1, 0},
+                                   {0, -2, -1,  2, 1, 0},
+                                   {0,  2, -1, -2, 1, 0},
+                                   {0,  4,  0, -5, 0, 1}};
+        T tmp[A][A];
+        matMul(BT, d, tmp);
+        matMulT(tmp, BT, v);
+    }
+
+    static FORCEINLINE void filter(const T (&g)[3][3], T (&u)[A][A]) {
+        static const T G[A][3] = {{ static_cast<T>(1) / 4,                       0,                      0},
+                                  {-static_cast<T>(1) / 6,  -static_cast<T>(1) / 6, -static_cast<T>(1) / 6},
+                                  {-static_cast<T>(1) / 6,   static_cast<T>(1) / 6, -static_cast<T>(1) / 6},
+                                  { static_cast<T>(1) / 24,  static_cast<T>(1) / 12, static_cast<T>(1) / 6},
+                                  { static_cast<T>(1) / 24, -static_cast<T>(1) / 12, static_cast<T>(1) / 6},
+                                  {                      0,                       0,                      1}};
+        T tmp[A][3];
+        matMul(G, g, tmp);
+        matMulT(tmp, G, u);
+    }
+
+    static FORCEINLINE void output(const T (&m)[A][A], T (&y)[4][4]) {
+        static const T AT[4][A] = {{1, 1,  1, 1,  1, 0},
+                                   {0, 1, -1, 2, -2, 0},
+                                   {0, 1,  1, 4,  4, 0},
+                                   {0, 1, -1, 8, -8, 1}};
+        T tmp[4][A];
+        matMul(AT, m, tmp);
+        matMulT(tmp, AT, y);
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+template <typename T, int M>
+static void conv2dWinograd_(const NDArray *input, const NDArray *weights, const NDArray *bias, NDArray *output, const int pH, const int pW, const int isNCHW, const int wFormat) {
+    typedef WinogradTransform<T, M> Transform;
+    const int A = Transform::A;
+    const int AA = A * A;
+
+    int bS, iC, iH, iW, oC, oH, oW;                             // batch size, input channels, input height/width, output channels, output height/width;
+    int indIOioC, indIiH, indWoC, indWiC, indWkH, indOoH;       // corresponding indexes
+    ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, *input, *output, bS, iC, iH, iW, oC, oH, oW, indIOioC, indIiH, indWiC, indWoC, indWkH, indOoH);
+
+    const auto xS = imageStrides(input, isNCHW);
+    const auto zS = imageStrides(output, isNCHW);
+    const auto x = input->bufferAsT<T>();
+    auto z = output->bufferAsT<T>();
+
+    const auto packed = packWeights<T>(weights, wFormat, 3, 3, iC, oC);
+    const auto biases = biasVector<T>(bias, oC);
+
+    //----- transformed weights [A*A, oC, iC] -----//
+    NDArray U('c', {AA, oC, iC}, input->dataType(), input->getContext());
+    auto u = U.bufferAsT<T>();
+
+    auto transformWeights = PRAGMA_THREADS_FOR {
+        for (auto e = start; e < stop; e++) {
+            const auto oc = e / iC;
+            const auto ic = e % iC;
+
+            T g[3][3], t[A][A];
+            for (int kh = 0; kh < 3; kh++)
+                for (int kw = 0; kw < 3; kw++)
+                    g[kh][kw] = packed[((kh * 3 + kw) * iC + ic) * oC + oc];
+
+            Transform::filter(g, t);
+
+            for (int i = 0; i < AA; i++)
+                u[(i * oC + oc) * iC + ic] = t[i / A][i % A];
+        }
+    };
+    samediff::Threads::parallel_for(transformWeights, 0, static_cast<Nd4jLong>(oC) * iC);
+
+    //----- images are processed in chunks, so temporary arrays stay within budget -----//
+    const Nd4jLong tilesH = (oH + M - 1) / M;
+    const Nd4jLong tilesW = (oW + M - 1) / M;
+    const Nd4jLong tilesPerImage = tilesH * tilesW;
+    const Nd4jLong budget = 1 << 24;
+    const int imagesPerChunk = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(bS, budget / (AA * (iC + oC) * tilesPerImage)));
+
+    for (int b0 = 0; b0 < bS; b0 += imagesPerChunk) {
+        const int numImages = sd::math::nd4j_min<int>(imagesPerChunk, bS - b0);
+        const Nd4jLong P = numImages * tilesPerImage;
+
+        NDArray V('c', {AA, iC, P}, input->dataType(), input->getContext());
+        NDArray Mm('c', {AA, oC, P}, input->dataType(), input->getContext());
+        auto v = V.bufferAsT<T>();
+        auto m = Mm.bufferAsT<T>();
+
+        //----- input tiles [A*A, iC, P], out of bounds elements are zero padding -----//
+        auto transformInput = PRAGMA_THREADS_FOR {
+            for (auto e = start; e < stop; e++) {
+                const auto ic = e / P;
+                const auto p = e % P;
+                const auto b = b0 + p / tilesPerImage;
+                const auto ih0 = ((p % tilesPerImage) / tilesW) * M - pH;
+                const auto iw0 = (p % tilesW) * M - pW;
+
+                T d[A][A], t[A][A];
+                for (int r = 0; r < A; r++)
+                    for (int c = 0; c < A; c++) {
+                        const auto ih = ih0 + r;
+                        const auto iw = iw0 + c;
+                        d[r][c] = ih >= 0 && ih < iH && iw >= 0 && iw < iW ? x[b * xS.b + ic * xS.c + ih * xS.h + iw * xS.w] : static_cast<T>(0);
+                    }
+
+                Transform::input(d, t);
+
+                for (int i = 0; i < AA; i++)
+                    v[(i * iC + ic) * P + p] = t[i / A][i % A];
+            }
+        };
+        samediff::Threads::parallel_for(transformInput, 0, static_cast<Nd4jLong>(iC) * P);
+
+        //----- one GEMM per tile element: [oC, iC] x [iC, P] = [oC, P] -----//
+        for (int i = 0; i < AA; i++) {
+            auto uSub = U(i, {1, 2});
+            auto vSub = V(i, {1, 2});
+            auto mSub = Mm(i, {1, 2});
+            MmulHelper::mmul(&uSub, &vSub, &mSub, 1.0, 0.0);
+        }
+
+        //----- inverse transform of tiles, with biases -----//
+        auto transformOutput = PRAGMA_THREADS_FOR {
+            for (auto e = start; e < stop; e++) {
+                const auto oc = e / P;
+                const auto p = e % P;
+                const auto b = b0 + p / tilesPerImage;
+                const auto oh0 = ((p % tilesPerImage) / tilesW) * M;
+                const auto ow0 = (p % tilesW) * M;
+
+                T t[A][A], y[M][M];
+                for (int i = 0; i < AA; i++)
+                    t[i / A][i % A] = m[(i * oC + oc) * P + p];
+
+                Transform::output(t, y);
+
+                for (int r = 0; r < M && oh0 + r < oH; r++)
+                    for (int c = 0; c < M && ow0 + c < oW; c++)
+                        z[b * zS.b + oc * zS.c + (oh0 + r) * zS.h + (ow0 + c) * zS.w] = y[r][c] + biases[oc];
+            }
+        };
+        samediff::Threads::parallel_for(transformOutput, 0, static_cast<Nd4jLong>(oC) * P);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+static void conv2dDirect_(const NDArray *input, const NDArray *weights, const NDArray *bias, NDArray *output, const int kH, const int kW, const int sH, const int sW, const int pH, const int pW, const int dH, const int dW, const int isNCHW, const int wFormat) {
+    // number of output pixels along width which share weights rows
+    const int PIXELS = 8;
+
+    int bS, iC, iH, iW, oC, oH, oW;                             // batch size, input channels, input height/width, output channels, output height/width;
+    int indIOioC, indIiH, indWoC, indWiC, indWkH, indOoH;       // corresponding indexes
+    ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, *input, *output, bS, iC, iH, iW, oC, oH, oW, indIOioC, indIiH, indWiC, indWoC, indWkH, indOoH);
+
+    const auto xS = imageStrides(input, isNCHW);
+    const auto zS = imageStrides(output, isNCHW);
+    const auto x = input->bufferAsT<T>();
+    auto z = output->bufferAsT<T>();
+
+    const auto packed = packWeights<T>(weights, wFormat, kH, kW, iC, oC);
+    const auto biases = biasVector<T>(bias, oC);
+
+    const Nd4jLong blocksW = (oW + PIXELS - 1) / PIXELS;
+
+    auto func = PRAGMA_THREADS_FOR {
+        std::vector<T> acc(PIXELS * oC);
+        Nd4jLong offsets[PIXELS];
+
+        for (auto e = start; e < stop; e++) {
+            const auto b = e / (oH * blocksW);
+            const auto oh = (e / blocksW) % oH;
+            const auto ow0 = (e % blocksW) * PIXELS;
+            const int numPixels = sd::math::nd4j_min<Nd4jLong>(PIXELS, oW - ow0);
+
+            for (int p = 0; p < numPixels; p++)
+                std::copy(biases.begin(), biases.end(), acc.begin() + p * oC);
+
+            for (int kh = 0; kh < kH; kh++) {
+                const auto ih = oh * sH - pH + kh * dH;
+                if (ih < 0 || ih >= iH)
+                    continue;
+
+                for (int kw = 0; kw < kW; kw++) {
+                    // pixels in padding area are skipped
+                    int numValid = 0;
+                    int valid[PIXELS];
+                    for (int p = 0; p < numPixels; p++) {
+                        const auto iw = (ow0 + p) * sW - pW + kw * dW;
+                        if (iw >= 0 && iw < iW) {
+                            offsets[numValid] = b * xS.b + ih * xS.h + iw * xS.w;
+                            valid[numValid++] = p;
+                        }
+                    }
+
+                    const auto wk = packed.data() + (static_cast<Nd4jLong>(kh) * kW + kw) * iC * oC;
+                    for (int ic = 0; ic < iC; ic++) {
+                        const auto row = wk + static_cast<Nd4jLong>(ic) * oC;
+
+                        for (int p = 0; p < numValid; p++) {
+                            const auto value = x[offsets[p] + ic * xS.c];
+                            auto a = acc.data() + valid[p] * oC;
+
+                            PRAGMA_OMP_SIMD
+                            for (int oc = 0; oc < oC; oc++)
+                                a[oc] += value * row[oc];
+                        }
+                    }
+                }
+            }
+
+            for (int p = 0; p < numPixels; p++) {
+                auto zp = z + b * zS.b + oh * zS.h + (ow0 + p) * zS.w;
+                const auto a = acc.data() + p * oC;
+                for (int oc = 0; oc < oC; oc++)
+                    zp[oc * zS.c] = a[oc];
+            }
+        }
+    };
+
+    samediff::Threads::parallel_for(func, 0, static_cast<Nd4jLong>(bS) * oH * blocksW);
+}
+
+//////////////////////////////////////////////////////////////////////
+// activations of lstmLayer applied to contiguous row, ids and formulas are the same as helpers::lstmLayerCell has
+template <typename T>
+static void lstmActivation(T *z, const Nd4jLong length, const int opId, const T alpha, const T beta) {
+    switch (opId) {
+        case 0:
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = sd::math::nd4j_tanh<T, T>(z[i]);
+            break;
+        case 1:
+            PRAGMA_OMP_SIMD
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = z[i] > static_cast<T>(0) ? z[i] : static_cast<T>(0);
+            break;
+        case 2:
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = sd::math::nd4j_sigmoid<T, T>(z[i]);
+            break;
+        case 3:
+            PRAGMA_OMP_SIMD
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = alpha * z[i] + beta;
+            break;
+        case 4:
+            PRAGMA_OMP_SIMD
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = z[i] < static_cast<T>(0) ? alpha * z[i] : z[i];
+            break;
+        case 5:
+            PRAGMA_OMP_SIMD
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = z[i] > alpha ? z[i] : static_cast<T>(0);
+            break;
+        case 6:
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = alpha * sd::math::nd4j_tanh<T, T>(beta * z[i]);
+            break;
+        case 7:
+            PRAGMA_OMP_SIMD
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = sd::math::nd4j_min<T>(static_cast<T>(1), sd::math::nd4j_max<T>(static_cast<T>(0), static_cast<T>(0.2f) * z[i] + static_cast<T>(0.5f)));
+            break;
+        case 8:
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = sd::math::nd4j_elu<T, T>(z[i], alpha);
+            break;
+        case 9:
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = sd::math::nd4j_softsign<T, T>(z[i]);
+            break;
+        default:
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = sd::math::nd4j_softplus<T, T>(z[i]);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// strides of [bS, nOut] states and of h along time, batch and features; h may be [sL, bS, nOut], [bS, sL, nOut], [bS, nOut, sL] or [sL, 1, bS, nOut] view
+struct SequenceStrides {
+    Nd4jLong t, b, f;
+};
+
+static SequenceStrides sequenceStrides(const NDArray *array, const int dataFormat) {
+    if (array->rankOf() == 4)
+        return {array->strideAt(0), array->strideAt(2), array->strideAt(3)};
+    if (dataFormat == 1)
+        return {array->strideAt(1), array->strideAt(0), array->strideAt(2)};
+    if (dataFormat == 2)
+        return {array->strideAt(2), array->strideAt(0), array->strideAt(1)};
+
+    return {array->strideAt(0), array->strideAt(1), array->strideAt(2)};
+}
+
+template <typename T>
+static void lastState(const T *state, const std::vector<Nd4jLong> &limits, const Nd4jLong nOut, NDArray *z) {
+    auto buffer = z->bufferAsT<T>();
+    const auto sB = z->strideAt(-2);
+    const auto sF = z->strideAt(-1);
+
+    for (Nd4jLong e = 0; e < static_cast<Nd4jLong>(limits.size()); e++)
+        for (Nd4jLong j = 0; j < nOut; j++)
+            buffer[e * sB + j * sF] = limits[e] == 0 ? static_cast<T>(0) : state[e * nOut + j];
+}
+
+template <typename T>
+static void lstmLayerTimeLoop_(const NDArray *x, const NDArray *Wx, const NDArray *Wr, const NDArray *b, const NDArray *seqLen, const NDArray *hI, const NDArray *cI, const NDArray *Wp,
+                               const std::vector<float> &params, const bool forward, NDArray *h, NDArray *hL, NDArray *cL) {
+    const int dataFormat    = params[0];
+    const int directionMode = params[1];
+    const T cellClip        = params[2];
+    const int gateAct = params[3], cellAct = params[6], outAct = params[9];
+    const T gateAlpha = params[4], gateBeta = params[5], cellAlpha = params[7], cellBeta = params[8], outAlpha = params[10], outBeta = params[11];
+
+    const Nd4jLong sL   = dataFormat == 3 ? x->sizeAt(0) : x->sizeAt(dataFormat);
+    const Nd4jLong bS   = dataFormat == 1 || dataFormat == 2 ? x->sizeAt(0) : x->sizeAt(1);
+    const Nd4jLong nIn  = dataFormat == 2 ? x->sizeAt(1) : x->sizeAt(2);
+    const Nd4jLong nOut = Wx->sizeAt(-1) / 4;
+    const Nd4jLong nGates = 4 * nOut;
+    auto context = x->getContext();
+
+    // input projections of all time steps by one GEMM, x is packed to time major [sL * bS, nIn] first: zx[t * bS + e] = x[t, e] * Wx
+    NDArray xT('c', {sL, bS, nIn}, x->dataType(), context);
+    if (dataFormat == 1)
+        xT.assign(x->permute({1, 0, 2}));
+    else if (dataFormat == 2)
+        xT.assign(x->permute({2, 0, 1}));
+    else
+        xT.assign(x);
+
+    NDArray xR = xT.reshape('c', {sL * bS, nIn}, false);
+    NDArray zx('c', {sL * bS, nGates}, x->dataType(), context);
+    MmulHelper::mmul(&xR, Wx, &zx, 1.0, 0.0);
+
+    // recurrent weights are packed once and reused by GEMM of every step
+    NDArray WrP = Wr->dup('c');
+
+    // preallocated states and gates, everything inside the loop is done in place
+    NDArray hState('c', {bS, nOut}, x->dataType(), context);
+    NDArray cState('c', {bS, nOut}, x->dataType(), context);
+    NDArray gates('c', {bS, nGates}, x->dataType(), context);
+
+    auto hs = hState.bufferAsT<T>();
+    auto cs = cState.bufferAsT<T>();
+    auto zr = gates.bufferAsT<T>();
+    auto zxb = zx.bufferAsT<T>();
+
+    for (Nd4jLong e = 0; e < bS; e++)
+        for (Nd4jLong j = 0; j < nOut; j++) {
+            hs[e * nOut + j] = hI == nullptr ? static_cast<T>(0) : hI->bufferAsT<T>()[e * hI->strideAt(-2) + j * hI->strideAt(-1)];
+            cs[e * nOut + j] = cI == nullptr ? static_cast<T>(0) : cI->bufferAsT<T>()[e * cI->strideAt(-2) + j * cI->strideAt(-1)];
+        }
+
+    std::vector<T> bias(nGates, static_cast<T>(0)), peephole(3 * nOut, static_cast<T>(0));
+    if (b != nullptr)
+        for (Nd4jLong k = 0; k < nGates; k++)
+            bias[k] = b->e<T>(k);
+    if (Wp != nullptr)
+        for (Nd4jLong k = 0; k < 3 * nOut; k++)
+            peephole[k] = Wp->e<T>(k);
+
+    std::vector<Nd4jLong> limits(bS, sL);
+    Nd4jLong maxLimit = seqLen == nullptr ? sL : 0;
+    if (seqLen != nullptr)
+        for (Nd4jLong e = 0; e < bS; e++) {
+            limits[e] = seqLen->e<Nd4jLong>(e);
+            maxLimit = sd::math::nd4j_max<Nd4jLong>(maxLimit, limits[e]);
+        }
+
+    // time steps beyond sequence length are zeros in h
+    if (h != nullptr && seqLen != nullptr)
+        h->nullify();
+
+    const auto hStrides = h == nullptr ? SequenceStrides{0, 0, 0} : sequenceStrides(h, dataFormat);
+    auto hb = h == nullptr ? nullptr : h->bufferAsT<T>();
+
+    for (Nd4jLong s = 0; s < maxLimit; s++) {
+        MmulHelper::mmul(&hState, &WrP, &gates, 1.0, 0.0);
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto e = start; e < stop; e++) {
+                if (s >= limits[e])
+                    continue;
+
+                // step s of backward pass is time sL-1-s, or limit-1-s for backward half of bidirectional mode
+                const Nd4jLong t = forward ? s : (seqLen == nullptr || directionMode == 1 ? sL - 1 - s : limits[e] - 1 - s);
+
+                auto z = zr + e * nGates;
+                auto zxt = zxb + (t * bS + e) * nGates;
+                auto hp = hs + e * nOut;
+                auto cp = cs + e * nOut;
+
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong k = 0; k < nGates; k++)
+                    z[k] += zxt[k] + bias[k];
+
+                // gates order is i, f, c', o; peephole order is i, f, o
+                if (Wp != nullptr) {
+                    PRAGMA_OMP_SIMD
+                    for (Nd4jLong j = 0; j < nOut; j++) {
+                        z[j] += cp[j] * peephole[j];
+                        z[nOut + j] += cp[j] * peephole[nOut + j];
+                    }
+                }
+
+                lstmActivation<T>(z, 2 * nOut, gateAct, gateAlpha, gateBeta);
+                lstmActivation<T>(z + 2 * nOut, nOut, cellAct, cellAlpha, cellBeta);
+
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong j = 0; j < nOut; j++) {
+                    T c = z[nOut + j] * cp[j] + z[j] * z[2 * nOut + j];
+                    if (cellClip != static_cast<T>(0))
+                        c = c > cellClip ? cellClip : (c < -cellClip ? -cellClip : c);
+                    cp[j] = c;
+                }
+
+                if (Wp != nullptr) {
+                    PRAGMA_OMP_SIMD
+                    for (Nd4jLong j = 0; j < nOut; j++)
+                        z[3 * nOut + j] += cp[j] * peephole[2 * nOut + j];
+                }
+
+                lstmActivation<T>(z + 3 * nOut, nOut, gateAct, gateAlpha, gateBeta);
+
+                // input gate isn't needed anymore, its place holds activated cell state
+                for (Nd4jLong j = 0; j < nOut; j++)
+                    z[j] = cp[j];
+                lstmActivation<T>(z, nOut, outAct, outAlpha, outBeta);
+
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong j = 0; j < nOut; j++)
+                    hp[j] = z[3 * nOut + j] * z[j];
+
+                if (hb != nullptr) {
+                    auto ht = hb + t * hStrides.t + e * hStrides.b;
+                    for (Nd4jLong j = 0; j < nOut; j++)
+                        ht[j * hStrides.f] = hp[j];
+                }
+            }
+        };
+
+        samediff::Threads::parallel_for(func, 0, bS);
+    }
+
+    // states at last step, examples of zero length get zeros
+    if (hL != nullptr)
+        lastState<T>(hs, limits, nOut, hL);
+    if (cL != nullptr)
+        lastState<T>(cs, limits, nOut, cL);
+}
+
+//////////////////////////////////////////////////////////////////////
+bool isWinogradApplicable(const int kH, const int kW, const int sH, const int sW, const int dH, const int dW, const int iC, const int oC) {
+    // with few channels GEMMs are too small to pay for transforms
+    return kH == 3 && kW == 3 && sH == 1 && sW == 1 && dH == 1 && dW == 1 && iC >= 8 && oC >= 8;
+}
+
+void conv2dWinograd(const NDArray *input, const NDArray *weights, const NDArray *bias, NDArray *output, const int pH, const int pW, const int isNCHW, const int wFormat) {
+    // F(4x4, 3x3) needs 4 times less GEMMs per output pixel, but wastes more on edges of small images
+    const bool large = output->sizeAt(isNCHW ? 2 : 1) >= 8 && output->sizeAt(isNCHW ? 3 : 2) >= 8;
+
+    if (input->dataType() == sd::DataType::DOUBLE) {
+        if (large)
+            conv2dWinograd_<double, 4>(input, weights, bias, output, pH, pW, isNCHW, wFormat);
+        else
+            conv2dWinograd_<double, 2>(input, weights, bias, output, pH, pW, isNCHW, wFormat);
+    } else {
+        if (large)
+            conv2dWinograd_<float, 4>(input, weights, bias, output, pH, pW, isNCHW, wFormat);
+        else
+            conv2dWinograd_<float, 2>(input, weights, bias, output, pH, pW, isNCHW, wFormat);
+    }
+}
+
+void conv2dDirect(const NDArray *input, const NDArray *weights, const NDArray *bias, NDArray *output, const int kH, const int kW, const int sH, const int sW, const int pH, const int pW, const int dH, const int dW, const int isNCHW, const int wFormat) {
+    if (input->dataType() == sd::DataType::DOUBLE)
+        conv2dDirect_<double>(input, weights, bias, output, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+    else
+        conv2dDirect_<float>(input, weights, bias, output, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+}
+
+void lstmLayerTimeLoop(const NDArray *x, const NDArray *Wx, const NDArray *Wr, const NDArray *b, const NDArray *seqLen, const NDArray *hI, const NDArray *cI, const NDArray *Wp,
+                       const std::vector<float> &params, const bool forward, NDArray *h, NDArray *hL, NDArray *cL) {
+    if (x->dataType() == sd::DataType::DOUBLE)
+        lstmLayerTimeLoop_<double>(x, Wx, Wr, b, seqLen, hI, cI, Wp, params, forward, h, hL, cL);
+    else
+        lstmLayerTimeLoop_<float>(x, Wx, Wr, b, seqLen, hI, cI, Wp, params, forward, h, hL, cL);
+}
+
+}
+}
+}
+}
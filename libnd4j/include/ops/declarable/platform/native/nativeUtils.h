@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+
+#ifndef SD_NATIVEUTILS_H
+#define SD_NATIVEUTILS_H
+
+#include <array/NDArray.h>
+#include <graph/Context.h>
+#include <ops/declarable/PlatformHelper.h>
+#include <system/platform_boilerplate.h>
+
+using namespace samediff;
+
+namespace sd {
+    namespace ops {
+        namespace platforms {
+            /**
+             * Platform helpers of native CPU engine. They're built only if there's no MKL-DNN, which has its own ones
+             */
+            DECLARE_PLATFORM(conv2d, ENGINE_CPU);
+
+            DECLARE_PLATFORM(lstmLayer, ENGINE_CPU);
+
+            namespace nativeUtils {
+                /**
+                 * Winograd F(2x2, 3x3)/F(4x4, 3x3) is used for 3x3 stride-1 non-dilated kernels with enough channels
+                 */
+                bool isWinogradApplicable(int kH, int kW, int sH, int sW, int dH, int dW, int iC, int oC);
+
+                /**
+                 * Winograd convolution, input is split into overlapping tiles which are multiplied by transformed weights
+                 * with one GEMM per tile element. Temporary memory is proportional to input, not to input * kH * kW
+                 */
+                void conv2dWinograd(const NDArray *input, const NDArray *weights, const NDArray *bias, NDArray *output, int pH, int pW, int isNCHW, int wFormat);
+
+                /**
+                 * Direct (im2col-free) convolution: blocks of output pixels accumulate all output channels at once,
+                 * each row of packed weights is reused by the whole block. Any kernel size, stride, dilation and padding
+                 */
+                void conv2dDirect(const NDArray *input, const NDArray *weights, const NDArray *bias, NDArray *output, int kH, int kW, int sH, int sW, int pH, int pW, int dH, int dW, int isNCHW, int wFormat);
+
+                /**
+                 * LSTM time loop of one direction, with the same arguments as helpers::lstmLayerTimeLoop. Input projections of all
+                 * time steps are done by one GEMM up front, recurrent weights are packed once, then every step is one GEMM of
+                 * [bS, nOut] x [nOut, 4*nOut] followed by single pass computing gates, peepholes, activations and states in place
+                 */
+                void lstmLayerTimeLoop(const NDArray *x, const NDArray *Wx, const NDArray *Wr, const NDArray *b, const NDArray *seqLen, const NDArray *hI, const NDArray *cI, const NDArray *Wp,
+                                       const std::vector<float> &params, bool forward, NDArray *h, NDArray *hL, NDArray *cL);
+            }
+        }
+    }
+}
+
+#endif //SD_NATIVEUTILS_H
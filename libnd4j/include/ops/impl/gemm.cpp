@@ -23,6 +23,9 @@
 #include <types/types.h>
 #include <system/Environment.h>
 #include <execution/Threads.h>
+#include <helpers/PackedGemm.h>
+#include <array/DataTypeUtils.h>
+#include <type_traits>
 
 namespace sd {
     namespace blas {
@@ -65,6 +68,18 @@ namespace sd {
             bool transAFlag = TransA == CblasTrans;
             bool transBFlag = TransB == CblasTrans;
 
+            // same types go to packed gemm, which honors order and leading dimensions
+            if (std::is_same<X, Y>::value && std::is_same<X, Z>::value) {
+                const bool colMajor = Order == CblasColMajor;
+                const Nd4jLong aRowStride = colMajor != transAFlag ? 1 : lda;
+                const Nd4jLong aColStride = colMajor != transAFlag ? lda : 1;
+                const Nd4jLong bRowStride = colMajor != transBFlag ? 1 : ldb;
+                const Nd4jLong bColStride = colMajor != transBFlag ? ldb : 1;
+
+                PackedGemm::gemm(DataTypeUtils::fromT<X>(), M, N, K, alpha, A, aRowStride, aColStride, B, bRowStride, bColStride, beta, C, colMajor ? 1 : ldc, colMajor ? ldc : 1);
+                return;
+            }
+
             if (beta == 0.0) {
                 Z z = 0.f;
                 int length = M*N;
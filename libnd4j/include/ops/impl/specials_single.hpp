@@ -29,6 +29,7 @@
 #include <ops/declarable/CustomOperations.h>
 #include <types/types.h>
 #include <helpers/Loops.h>
+#include <helpers/SortEngine.h>
 
 namespace sd {
 /**
@@ -543,26 +544,35 @@ PRAGMA_OMP_SINGLE_ARGS(nowait)
     void SpecialMethods<T>::sortGeneric(void *vx, Nd4jLong const* xShapeInfo, bool descending) {
         auto x = reinterpret_cast<T *>(vx);
 
-        quickSort_parallel(x, xShapeInfo, shape::length(xShapeInfo), omp_get_max_threads(), descending);
+        SortEngine::sort<T>(x, xShapeInfo, descending);
     }
 
     template<typename T>
     void SpecialMethods<T>::sortTadGeneric(void *vx, Nd4jLong const* xShapeInfo, int *dimension, int dimensionLength, Nd4jLong const* tadShapeInfo, Nd4jLong const* tadOffsets, bool descending) {
         auto x = reinterpret_cast<T *>(vx);
 
-        //quickSort_parallel(x, xShapeInfo, shape::length(xShapeInfo), omp_get_max_threads(), descending);
         Nd4jLong xLength = shape::length(xShapeInfo);
         Nd4jLong xTadLength = shape::tadLength(xShapeInfo, dimension, dimensionLength);
         int numTads = xLength / xTadLength;
 
+        // few long TADs are sorted one by one, each of them in parallel
+        if (numTads < sd::Environment::getInstance().maxMasterThreads()) {
+            for (int r = 0; r < numTads; r++)
+                SortEngine::sort<T>(x + tadOffsets[r], tadShapeInfo, descending);
+
+            return;
+        }
+
         auto func = PRAGMA_THREADS_FOR {
             for (auto r = start; r < stop; r++) {
                 T *dx = x + tadOffsets[r];
 
-                quickSort_parallel(dx, tadShapeInfo, xTadLength, 1, descending);
+                SortEngine::sort<T>(dx, tadShapeInfo, descending, 1);
             }
         };
-        samediff::Threads::parallel_tad(func, 0, numTads);
+
+        // sorting time depends on data, so TADs are distributed with work stealing
+        samediff::Threads::parallel_stealing(func, 0, numTads);
     }
 
 
@@ -24,6 +24,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <helpers/shape.h>
+#include <helpers/SortEngine.h>
+#include <execution/Threads.h>
+#include <vector>
+#include <mutex>
+#include <memory>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -210,9 +215,102 @@ PRAGMA_OMP_SINGLE_ARGS(nowait)
 
         }
 
+        /**
+         * If all indices fit into 64 bits together, they're packed into single keys with the same lexicographic order,
+         * keys are sorted with radix sort, and indices and values are permuted afterwards
+         *
+         * @return false if indices can't be packed, nothing is changed then
+         */
+        template <typename T>
+        static bool cooRadixSort(Nd4jLong *indices, T *values, Nd4jLong length, int rank) {
+            if (length < 2 || rank < 1)
+                return false;
+
+            // bits needed by each dimension
+            std::vector<Nd4jLong> maxima(rank, 0);
+            std::mutex lock;
+            auto findMaxima = PRAGMA_THREADS_FOR {
+                std::vector<Nd4jLong> local(rank, 0);
+                for (auto i = start; i < stop; i++) {
+                    for (int e = 0; e < rank; e++) {
+                        auto v = indices[i * rank + e];
+
+                        // negative indices can't be packed, -1 marks such dimension
+                        if (v < 0 || local[e] < 0)
+                            local[e] = -1;
+                        else if (v > local[e])
+                            local[e] = v;
+                    }
+                }
+
+                std::lock_guard<std::mutex> guard(lock);
+                for (int e = 0; e < rank; e++)
+                    maxima[e] = maxima[e] < 0 || local[e] < 0 ? -1 : sd::math::nd4j_max<Nd4jLong>(maxima[e], local[e]);
+            };
+            samediff::Threads::parallel_for(findMaxima, 0, length);
+
+            // shift is -1 for dimensions that are always zero: they add nothing to the key, and with the
+            // other dimensions taking all 64 bits their shift would equal the key width
+            std::vector<int> shifts(rank, 0);
+            int totalBits = 0;
+            for (int e = rank - 1; e >= 0; e--) {
+                if (maxima[e] < 0)
+                    return false;
+
+                int bits = 0;
+                while (bits < 63 && (maxima[e] >> bits) > 0)
+                    bits++;
+
+                shifts[e] = bits > 0 ? totalBits : -1;
+                totalBits += bits;
+            }
+
+            if (totalBits > 64)
+                return false;
+
+            std::vector<uint64_t> keys(length);
+            std::vector<Nd4jLong> permutation(length);
+            auto pack = PRAGMA_THREADS_FOR {
+                for (auto i = start; i < stop; i++) {
+                    uint64_t key = 0;
+                    for (int e = 0; e < rank; e++)
+                        if (shifts[e] >= 0)
+                            key |= static_cast<uint64_t>(indices[i * rank + e]) << shifts[e];
+
+                    keys[i] = key;
+                    permutation[i] = i;
+                }
+            };
+            samediff::Threads::parallel_for(pack, 0, length);
+
+            SortEngine::radixSort<uint64_t, Nd4jLong>(keys.data(), permutation.data(), length, false);
+
+            std::vector<Nd4jLong> sortedIndices(length * rank);
+            std::unique_ptr<T[]> sortedValues(new T[length]);
+            auto gather = PRAGMA_THREADS_FOR {
+                for (auto i = start; i < stop; i++) {
+                    auto p = permutation[i];
+                    for (int e = 0; e < rank; e++)
+                        sortedIndices[i * rank + e] = indices[p * rank + e];
+
+                    sortedValues[i] = values[p];
+                }
+            };
+            samediff::Threads::parallel_for(gather, 0, length);
+
+            std::copy(sortedIndices.begin(), sortedIndices.end(), indices);
+            std::copy(sortedValues.get(), sortedValues.get() + length, values);
+
+            return true;
+        }
+
         template <typename T>
         void SparseUtils<T>::sortCooIndicesGeneric(Nd4jLong *indices, void *vx, Nd4jLong length, int rank) {
         auto values = reinterpret_cast<T *>(vx);
+
+            if (cooRadixSort(indices, values, length, rank))
+                return;
+
 #ifdef _OPENMP
             coo_quickSort_parallel(indices, values, length, omp_get_max_threads(), rank);
 #else
@@ -1281,6 +1281,7 @@
                                                 public:\
                                                     NAME(); \
                                                     sd::ShapeList* calculateOutputShape(sd::ShapeList* inputShape, sd::graph::Context& block); \
+                                                    bool hasPureShapeFunction() override { return true; } \
                                                 protected: \
                                                     void registerTypes(); \
                                                     Nd4jStatus validateAndExecute(sd::graph::Context& block); \
@@ -1382,6 +1383,7 @@
                                                                                 public:\
                                                                                     NAME(); \
                                                                                     sd::ShapeList* calculateOutputShape(sd::ShapeList* inputShape, sd::graph::Context& block); \
+                                                                                    bool hasPureShapeFunction() override { return true; } \
                                                                                 protected: \
                                                                                     void registerTypes(); \
                                                                                     Nd4jStatus validateAndExecute(sd::graph::Context& block); \
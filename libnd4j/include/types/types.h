@@ -85,6 +85,10 @@
         (sd::DataType::INT32, int32_t), \
         (sd::DataType::INT64, Nd4jLong)
 
+#define QUANTIZED_TYPES \
+        (sd::DataType::INT8, int8_t), \
+        (sd::DataType::UINT8, uint8_t)
+
 #define FLOAT_NATIVE \
         (sd::DataType::FLOAT32, float), \
         (sd::DataType::DOUBLE, double), \
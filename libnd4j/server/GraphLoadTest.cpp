@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Load generator for GraphServer: registers graph (optionally), and fires concurrent inference requests
+//
+// @author raver119@gmail.com
+//
+
+#include <grpc++/grpc++.h>
+#include <graph/generated/graph.grpc.fb.h>
+#include <graph/Graph.h>
+#include <graph/InferenceRequest.h>
+#include <array/NDArrayFactory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using namespace sd;
+using namespace sd::graph;
+
+char* getCmdOption(char **begin, char **end, const std::string & option) {
+    auto itr = std::find(begin, end, option);
+    if (itr != end && ++itr != end)
+        return *itr;
+
+    return 0;
+}
+
+bool cmdOptionExists(char** begin, char** end, const std::string& option) {
+    return std::find(begin, end, option) != end;
+}
+
+static bool registerGraph(GraphInferenceServer::Stub &stub, const std::vector<char> &bytes) {
+    auto slice = grpc_slice_from_copied_buffer(bytes.data(), bytes.size());
+    flatbuffers::grpc::Message<FlatGraph> request(slice, false);
+    flatbuffers::grpc::Message<FlatResponse> response;
+
+    grpc::ClientContext context;
+    auto status = stub.RegisterGraph(&context, request, &response);
+    if (!status.ok())
+        std::cerr << "RegisterGraph failed: " << status.error_message() << std::endl;
+
+    return status.ok();
+}
+
+/**
+ * This function builds serialized inference request, with synthetic inputs for all placeholders of the graph
+ */
+static flatbuffers::grpc::Message<FlatInferenceRequest> buildRequest(Graph *graph, Nd4jLong graphId) {
+    InferenceRequest request(graphId);
+
+    for (auto placeholder: *graph->getPlaceholders()) {
+        // unknown dimensions are replaced with 1
+        std::vector<Nd4jLong> shape(placeholder->shape());
+        for (auto &v: shape)
+            if (v < 1)
+                v = 1;
+
+        auto array = NDArrayFactory::create_<float>('c', shape);
+        array->linspace(0.01, 0.01);
+
+        request.appendVariable(placeholder->id(), placeholder->index(), array);
+    }
+
+    flatbuffers::grpc::MessageBuilder builder;
+    builder.Finish(request.asFlatInferenceRequest(builder));
+
+    return builder.ReleaseMessage<FlatInferenceRequest>();
+}
+
+int main(int argc, char *argv[]) {
+    std::string address("localhost:40123");
+    if (cmdOptionExists(argv, argv + argc, "-h"))
+        address = getCmdOption(argv, argv + argc, "-h");
+
+    if (!cmdOptionExists(argv, argv + argc, "-f")) {
+        std::cerr << "Usage: GraphLoadTest -f graph.fb [-h host:port] [-r] [-n requests] [-c clients]" << std::endl;
+        return 1;
+    }
+
+    auto file = getCmdOption(argv, argv + argc, "-f");
+
+    int numRequests = 1000;
+    if (cmdOptionExists(argv, argv + argc, "-n"))
+        numRequests = atoi(getCmdOption(argv, argv + argc, "-n"));
+
+    int numClients = 4;
+    if (cmdOptionExists(argv, argv + argc, "-c"))
+        numClients = std::max(1, atoi(getCmdOption(argv, argv + argc, "-c")));
+
+    std::ifstream stream(file, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (bytes.empty()) {
+        std::cerr << "Unable to read graph from " << file << std::endl;
+        return 1;
+    }
+
+    // graph is parsed locally only to discover its id and placeholders
+    auto flatGraph = GetFlatGraph(bytes.data());
+    auto graphId = flatGraph->id();
+    std::unique_ptr<Graph> graph(new Graph(flatGraph));
+
+    auto channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+    auto stub = GraphInferenceServer::NewStub(channel);
+
+    if (cmdOptionExists(argv, argv + argc, "-r") && !registerGraph(*stub, bytes))
+        return 1;
+
+    auto request = buildRequest(graph.get(), graphId);
+
+    std::atomic<int> counter{0};
+    std::atomic<int> failures{0};
+    std::vector<std::vector<Nd4jLong>> latencies(numClients);
+    std::vector<std::thread> clients;
+
+    auto timeStart = std::chrono::steady_clock::now();
+
+    for (int c = 0; c < numClients; c++) {
+        clients.emplace_back([&, c] {
+            // stubs are thread-safe, but separate ones keep clients independent
+            auto local = GraphInferenceServer::NewStub(channel);
+
+            while (counter++ < numRequests) {
+                grpc::ClientContext context;
+                flatbuffers::grpc::Message<FlatResult> response;
+
+                auto callStart = std::chrono::steady_clock::now();
+                auto status = local->InferenceRequest(&context, request, &response);
+                auto callEnd = std::chrono::steady_clock::now();
+
+                // call counts as failed unless server returned well-formed result with outputs
+                if (!status.ok() || !response.Verify() || response.GetRoot()->variables() == nullptr || response.GetRoot()->variables()->size() == 0)
+                    failures++;
+
+                latencies[c].emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(callEnd - callStart).count());
+            }
+        });
+    }
+
+    for (auto &client: clients)
+        client.join();
+
+    auto timeEnd = std::chrono::steady_clock::now();
+    auto seconds = std::chrono::duration_cast<std::chrono::microseconds>(timeEnd - timeStart).count() / 1e6;
+
+    std::vector<Nd4jLong> all;
+    for (auto &l: latencies)
+        all.insert(all.end(), l.begin(), l.end());
+
+    std::sort(all.begin(), all.end());
+
+    if (all.empty()) {
+        std::cerr << "No requests were sent" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Requests: [" << all.size() << "]; failures: [" << failures.load() << "]; clients: [" << numClients << "]" << std::endl;
+    std::cout << "Throughput: [" << all.size() / seconds << " req/s]" << std::endl;
+    std::cout << "Latency p50: [" << all[all.size() / 2] << " us]; p99: [" << all[std::min(all.size() - 1, all.size() * 99 / 100)] << " us]; max: [" << all.back() << " us]" << std::endl;
+
+    if (failures.load() > 0) {
+        std::cerr << "Load test failed: [" << failures.load() << "] of [" << all.size() << "] requests didn't return results" << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
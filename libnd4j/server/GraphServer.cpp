@@ -23,134 +23,381 @@
 #include <graph/GraphExecutioner.h>
 #include <graph/generated/result_generated.h>
 #include <helpers/StringUtils.h>
+#include <system/Environment.h>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <stdexcept>
 
-#include <graph/exceptions/unknown_graph_exception.h>
-#include <graph/exceptions/graph_exists_exception.h>
-#include <graph/exceptions/no_results_exception.h>
-#include <graph/exceptions/graph_execution_exception.h>
+#include <exceptions/unknown_graph_exception.h>
+#include <exceptions/graph_exists_exception.h>
+#include <exceptions/no_results_exception.h>
+#include <exceptions/graph_execution_exception.h>
 
 
 
 namespace sd {
     namespace graph {
-            grpc::Status GraphInferenceServerImpl::RegisterGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatGraph> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg) {
-                auto flat_graph = request_msg->GetRoot();
+        void ServerStatistics::record(Nd4jLong nanos, bool successful) {
+            _requests++;
+            if (!successful)
+                _failures++;
+
+            _totalNanos += nanos;
+
+            auto current = _maxNanos.load();
+            while (nanos > current && !_maxNanos.compare_exchange_weak(current, nanos));
+        }
+
+        Nd4jLong ServerStatistics::requests() const {
+            return _requests.load();
+        }
+
+        Nd4jLong ServerStatistics::failures() const {
+            return _failures.load();
+        }
+
+        Nd4jLong ServerStatistics::averageLatency() const {
+            auto requests = _requests.load();
+            return requests > 0 ? _totalNanos.load() / requests / 1000 : 0;
+        }
+
+        Nd4jLong ServerStatistics::maxLatency() const {
+            return _maxNanos.load() / 1000;
+        }
+
+        std::string ServerStatistics::asString() const {
+            std::string result("requests: [");
+            result += StringUtils::valueToString<Nd4jLong>(requests());
+            result += "]; failures: [";
+            result += StringUtils::valueToString<Nd4jLong>(failures());
+            result += "]; avg latency: [";
+            result += StringUtils::valueToString<Nd4jLong>(averageLatency());
+            result += " us]; max latency: [";
+            result += StringUtils::valueToString<Nd4jLong>(maxLatency());
+            result += " us]";
+
+            return result;
+        }
+
+        /**
+         * Base class for completion queue tags
+         */
+        class ServerCall {
+        public:
+            virtual ~ServerCall() = default;
+
+            virtual void proceed(bool ok) = 0;
+        };
+
+        /**
+         * Single in-flight unary call. Lifecycle is: requested -> handled & finished -> deleted
+         */
+        template <typename REQ, typename RES>
+        class AsyncCall : public ServerCall {
+        protected:
+            GraphInferenceServer::AsyncService *_service;
+            grpc::ServerCompletionQueue *_queue;
+            ServerStatistics *_statistics;
+
+            grpc::ServerContext _context;
+            flatbuffers::grpc::Message<REQ> _request;
+            flatbuffers::grpc::Message<RES> _response;
+            grpc::ServerAsyncResponseWriter<flatbuffers::grpc::Message<RES>> _responder;
+
+            // each call has its own builder, so there's no shared serialization state
+            flatbuffers::grpc::MessageBuilder _builder;
+
+            bool _finished = false;
+
+            // subscribes this call to the next incoming request
+            virtual void request() = 0;
+
+            // creates fresh call of the same kind
+            virtual AsyncCall<REQ, RES>* spawn() = 0;
+
+            // produces _response out of _request
+            virtual void handle() = 0;
+
+            void respondOk() {
+                _builder.Finish(CreateFlatResponse(_builder, 0));
+                _response = _builder.ReleaseMessage<RES>();
+            }
+        public:
+            AsyncCall(GraphInferenceServer::AsyncService *service, grpc::ServerCompletionQueue *queue, ServerStatistics *statistics) : _responder(&_context) {
+                _service = service;
+                _queue = queue;
+                _statistics = statistics;
+            }
 
+            void start() {
+                request();
+            }
+
+            void proceed(bool ok) override {
+                // either response was sent, or queue is shutting down
+                if (_finished || !ok) {
+                    delete this;
+                    return;
+                }
+
+                // keep queue subscribed while this request is processed
+                spawn()->start();
+
+                auto timeStart = std::chrono::steady_clock::now();
+
+                grpc::Status status = grpc::Status::OK;
                 try {
-                    // building our graph
-                    auto graph = new Graph<float>(flat_graph);
-
-                    // single data type for now
-                    GraphHolder::getInstance().registerGraph<float>(flat_graph->id(), graph);
-
-                    // sending out OK response
-                    auto response_offset = CreateFlatResponse(mb_, 0);
-                    mb_.Finish(response_offset);
-                    *response_msg = mb_.ReleaseMessage<FlatResponse>();
-                    assert(response_msg->Verify());
-
-                    return grpc::Status::OK;
-                } catch (std::runtime_error &e) {
-                    grpc::string gmsg("Caught runtime_error exception");
-                    return grpc::Status(grpc::StatusCode::UNKNOWN, gmsg);
+                    handle();
+                } catch (sd::unknown_graph_exception &e) {
+                    status = grpc::Status(grpc::StatusCode::NOT_FOUND, e.message());
+                } catch (sd::graph_exists_exception &e) {
+                    status = grpc::Status(grpc::StatusCode::ALREADY_EXISTS, e.message());
+                } catch (sd::graph_exception &e) {
+                    status = grpc::Status(grpc::StatusCode::INTERNAL, e.message());
+                } catch (std::exception &e) {
+                    status = grpc::Status(grpc::StatusCode::UNKNOWN, e.what());
                 }
+
+                auto timeEnd = std::chrono::steady_clock::now();
+                _statistics->record(std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count(), status.ok());
+
+                _finished = true;
+                if (status.ok())
+                    _responder.Finish(_response, status, this);
+                else
+                    _responder.FinishWithError(status, this);
+            }
+        };
+
+        class RegisterGraphCall : public AsyncCall<FlatGraph, FlatResponse> {
+        protected:
+            void request() override {
+                _service->RequestRegisterGraph(&_context, &_request, &_responder, _queue, _queue, this);
+            }
+
+            AsyncCall<FlatGraph, FlatResponse>* spawn() override {
+                return new RegisterGraphCall(_service, _queue, _statistics);
             }
 
-            grpc::Status GraphInferenceServerImpl::ReplaceGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatGraph> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg) {
-                auto flat_graph = request_msg->GetRoot();
+            void handle() override {
+                auto flatGraph = _request.GetRoot();
+                auto graph = new Graph(flatGraph);
 
                 try {
-                    // building our graph
-                    auto graph = new Graph<float>(flat_graph);
-
-                    // single data type for now
-                    GraphHolder::getInstance().replaceGraph(flat_graph->id(), graph);
-
-                    // sending out OK response
-                    auto response_offset = CreateFlatResponse(mb_, 0);
-                    mb_.Finish(response_offset);
-                    *response_msg = mb_.ReleaseMessage<FlatResponse>();
-                    assert(response_msg->Verify());
-
-                    return grpc::Status::OK;
-                } catch (sd::graph::unknown_graph_exception &e) {
-                    grpc::string gmsg(e.message());
-                    return grpc::Status(grpc::StatusCode::NOT_FOUND, gmsg);
-                } catch (std::runtime_error &e) {
-                    grpc::string gmsg("Caught runtime_error exception");
-                    return grpc::Status(grpc::StatusCode::UNKNOWN, gmsg);
+                    GraphHolder::getInstance().registerGraph(flatGraph->id(), graph);
+                } catch (...) {
+                    delete graph;
+                    throw;
                 }
+
+                respondOk();
+            }
+        public:
+            using AsyncCall<FlatGraph, FlatResponse>::AsyncCall;
+        };
+
+        class ReplaceGraphCall : public AsyncCall<FlatGraph, FlatResponse> {
+        protected:
+            void request() override {
+                _service->RequestReplaceGraph(&_context, &_request, &_responder, _queue, _queue, this);
             }
 
-            grpc::Status GraphInferenceServerImpl::ForgetGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatDropRequest> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg) {
+            AsyncCall<FlatGraph, FlatResponse>* spawn() override {
+                return new ReplaceGraphCall(_service, _queue, _statistics);
+            }
+
+            void handle() override {
+                auto flatGraph = _request.GetRoot();
+                auto graph = new Graph(flatGraph);
+
                 try {
+                    GraphHolder::getInstance().replaceGraph(flatGraph->id(), graph);
+                } catch (...) {
+                    delete graph;
+                    throw;
+                }
 
-                    // getting drop request
-                    auto request = request_msg->GetRoot();
+                respondOk();
+            }
+        public:
+            using AsyncCall<FlatGraph, FlatResponse>::AsyncCall;
+        };
+
+        class ForgetGraphCall : public AsyncCall<FlatDropRequest, FlatResponse> {
+        protected:
+            void request() override {
+                _service->RequestForgetGraph(&_context, &_request, &_responder, _queue, _queue, this);
+            }
 
-                    // dropping out graph (any datatype)
-                    GraphHolder::getInstance().dropGraphAny(request->id());
+            AsyncCall<FlatDropRequest, FlatResponse>* spawn() override {
+                return new ForgetGraphCall(_service, _queue, _statistics);
+            }
 
-                    // sending out OK response
-                    auto response_offset = CreateFlatResponse(mb_, 0);
-                    mb_.Finish(response_offset);
-                    *response_msg = mb_.ReleaseMessage<FlatResponse>();
-                    assert(response_msg->Verify());
+            void handle() override {
+                GraphHolder::getInstance().dropGraphAny(_request.GetRoot()->id());
 
-                    return grpc::Status::OK;
-                } catch (sd::graph::unknown_graph_exception &e) {
-                    grpc::string gmsg(e.message());
-                    return grpc::Status(grpc::StatusCode::NOT_FOUND, gmsg);
-                }
+                respondOk();
             }
+        public:
+            using AsyncCall<FlatDropRequest, FlatResponse>::AsyncCall;
+        };
 
-            grpc::Status GraphInferenceServerImpl::InferenceRequest( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatInferenceRequest> *request_msg, flatbuffers::grpc::Message<FlatResult> *response_msg) {
-                auto request = request_msg->GetRoot();
+        class InferenceRequestCall : public AsyncCall<FlatInferenceRequest, FlatResult> {
+        protected:
+            RequestBatcher *_batcher;
 
-                try {
-                    // GraphHolder
-                    auto response_offset = GraphHolder::getInstance().execute(request->id(), mb_, request);
-
-                    mb_.Finish(response_offset);
-                    *response_msg = mb_.ReleaseMessage<FlatResult>();
-                    assert(response_msg->Verify());
-
-                    return grpc::Status::OK;
-                } catch (sd::graph::no_results_exception &e) {
-                    grpc::string gmsg(e.message());
-                    return grpc::Status(grpc::StatusCode::INTERNAL, gmsg);
-                } catch (sd::graph::unknown_graph_exception &e) {
-                    grpc::string gmsg(e.message());
-                    return grpc::Status(grpc::StatusCode::NOT_FOUND, gmsg);
-                } catch (sd::graph::graph_execution_exception &e) {
-                    grpc::string gmsg(e.message());
-                    return grpc::Status(grpc::StatusCode::INTERNAL, gmsg);
-                } catch (std::runtime_error &e) {
-                    grpc::string gmsg("Caught runtime_error exception");
-                    return grpc::Status(grpc::StatusCode::UNKNOWN, gmsg);
-                }
+            void request() override {
+                _service->RequestInferenceRequest(&_context, &_request, &_responder, _queue, _queue, this);
+            }
+
+            AsyncCall<FlatInferenceRequest, FlatResult>* spawn() override {
+                return new InferenceRequestCall(_service, _queue, _statistics, _batcher);
+            }
+
+            void handle() override {
+                auto request = _request.GetRoot();
+
+                // execution happens on pooled clone, and results are serialized straight into this call's builder
+                auto offset = _batcher != nullptr ? _batcher->execute(request->id(), _builder, request)
+                                                  : GraphHolder::getInstance().execute(request->id(), _builder, request);
+
+                _builder.Finish(offset);
+                _response = _builder.ReleaseMessage<FlatResult>();
+            }
+        public:
+            InferenceRequestCall(GraphInferenceServer::AsyncService *service, grpc::ServerCompletionQueue *queue, ServerStatistics *statistics, RequestBatcher *batcher) : AsyncCall<FlatInferenceRequest, FlatResult>(service, queue, statistics) {
+                _batcher = batcher;
             }
+        };
+
+
+        GraphInferenceServerImpl::~GraphInferenceServerImpl() {
+            shutdown();
+        }
+
+        void GraphInferenceServerImpl::enableBatching(int maxBatchSize, Nd4jLong maxWait) {
+            _batcher.reset(new RequestBatcher(maxBatchSize, maxWait));
+        }
+
+        RequestBatcher* GraphInferenceServerImpl::batcher() {
+            return _batcher.get();
+        }
+
+        void GraphInferenceServerImpl::run(const std::string &address, int numThreads) {
+            if (numThreads < 1)
+                numThreads = 1;
+
+            grpc::ServerBuilder builder;
+            builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+            builder.RegisterService(&_service);
+
+            for (int e = 0; e < numThreads; e++)
+                _queues.emplace_back(builder.AddCompletionQueue());
+
+            _server = builder.BuildAndStart();
+            if (_server == nullptr)
+                throw std::runtime_error("GraphServer: unable to start server on " + address);
+
+            for (auto &queue : _queues) {
+                (new RegisterGraphCall(&_service, queue.get(), &_management))->start();
+                (new ReplaceGraphCall(&_service, queue.get(), &_management))->start();
+                (new ForgetGraphCall(&_service, queue.get(), &_management))->start();
+                (new InferenceRequestCall(&_service, queue.get(), &_inference, _batcher.get()))->start();
+            }
+
+            for (auto &queue : _queues)
+                _threads.emplace_back(&GraphInferenceServerImpl::serve, this, queue.get());
+        }
+
+        void GraphInferenceServerImpl::serve(grpc::ServerCompletionQueue *queue) {
+            void *tag = nullptr;
+            bool ok = false;
+
+            while (queue->Next(&tag, &ok))
+                static_cast<ServerCall*>(tag)->proceed(ok);
+        }
+
+        void GraphInferenceServerImpl::wait() {
+            if (_server != nullptr)
+                _server->Wait();
+        }
+
+        void GraphInferenceServerImpl::shutdown() {
+            if (_server == nullptr)
+                return;
+
+            _server->Shutdown();
+
+            // queues must be drained after server shutdown, pending calls are deleted with ok == false
+            for (auto &queue : _queues)
+                queue->Shutdown();
+
+            for (auto &thread : _threads)
+                thread.join();
+
+            _threads.clear();
+            _queues.clear();
+            _server.reset();
+        }
+
+        ServerStatistics& GraphInferenceServerImpl::inferenceStatistics() {
+            return _inference;
+        }
+
+        ServerStatistics& GraphInferenceServerImpl::managementStatistics() {
+            return _management;
+        }
     }
 }
 
-void RunServer(int port) {
+void RunServer(int port, int numThreads, int reportInterval, int maxBatchSize, int maxWait) {
   assert(port > 0 && port < 65535);
 
   std::string server_address("0.0.0.0:");
   server_address += sd::StringUtils::valueToString<int>(port);
 
   sd::graph::GraphInferenceServerImpl service;
-  auto registrator = sd::ops::OpRegistrator::getInstance();
-
-  grpc::ServerBuilder builder;
-  builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
-  builder.RegisterService(&service);
-  std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
-  std::cerr << "Server listening on: [" << server_address << "]; Number of operations: [" <<  registrator->numberOfOperations()  << "]"<< std::endl;
-
-  server->Wait();
+  auto &registrator = sd::ops::OpRegistrator::getInstance();
+
+  if (maxBatchSize > 1)
+      service.enableBatching(maxBatchSize, maxWait);
+
+  service.run(server_address, numThreads);
+  std::cerr << "Server listening on: [" << server_address << "]; Number of operations: [" <<  registrator.numberOfOperations()  << "]; Threads: [" << numThreads << "]" << std::endl;
+
+  // reporter is stopped and joined before service goes out of scope
+  std::mutex reporterLock;
+  std::condition_variable reporterCondition;
+  bool reporterStop = false;
+  std::thread reporter;
+
+  if (reportInterval > 0) {
+      reporter = std::thread([&service, &reporterLock, &reporterCondition, &reporterStop, reportInterval] {
+          std::unique_lock<std::mutex> lock(reporterLock);
+          while (!reporterCondition.wait_for(lock, std::chrono::seconds(reportInterval), [&reporterStop] { return reporterStop; })) {
+              std::cerr << "Inference " << service.inferenceStatistics().asString() << std::endl;
+              if (service.batcher() != nullptr)
+                  std::cerr << "Batching: requests: [" << service.batcher()->requests() << "]; executions: [" << service.batcher()->batches() << "]" << std::endl;
+          }
+      });
+  }
+
+  service.wait();
+
+  if (reporter.joinable()) {
+      {
+          std::lock_guard<std::mutex> lock(reporterLock);
+          reporterStop = true;
+      }
+      reporterCondition.notify_all();
+      reporter.join();
+  }
+
+  std::cerr << "Inference " << service.inferenceStatistics().asString() << std::endl;
+  std::cerr << "Management " << service.managementStatistics().asString() << std::endl;
 }
 
 char* getCmdOption(char **begin, char **end, const std::string & option) {
@@ -169,8 +416,10 @@ int main(int argc, char *argv[]) {
     /**
      * basically we only care about few things here:
      * 1) port number
-     * 2) if we should use gprc, json, or both
+     * 2) number of threads serving completion queues
      * 3) if there's any graph(s) provided at startup
+     * 4) if statistics should be reported periodically
+     * 5) if inference requests should be batched
      */
      int port = 40123;
      if(cmdOptionExists(argv, argv+argc, "-p")) {
@@ -178,13 +427,38 @@ int main(int argc, char *argv[]) {
         port = atoi(sPort);
      }
 
+    int numThreads = sd::Environment::getInstance().maxMasterThreads();
+    if(cmdOptionExists(argv, argv+argc, "-t")) {
+        auto sThreads = getCmdOption(argv, argv + argc, "-t");
+        numThreads = atoi(sThreads);
+    }
+
+    int reportInterval = 0;
+    if(cmdOptionExists(argv, argv+argc, "-s")) {
+        auto sInterval = getCmdOption(argv, argv + argc, "-s");
+        reportInterval = atoi(sInterval);
+    }
+
+    // batching is off by default
+    int maxBatchSize = 0;
+    if(cmdOptionExists(argv, argv+argc, "-b")) {
+        auto sBatch = getCmdOption(argv, argv + argc, "-b");
+        maxBatchSize = atoi(sBatch);
+    }
+
+    int maxWait = 500;
+    if(cmdOptionExists(argv, argv+argc, "-w")) {
+        auto sWait = getCmdOption(argv, argv + argc, "-w");
+        maxWait = atoi(sWait);
+    }
+
     if(cmdOptionExists(argv, argv+argc, "-f")) {
         auto file = getCmdOption(argv, argv + argc, "-f");
-        auto graph = GraphExecutioner<float>::importFromFlatBuffers(file);
-        sd::graph::GraphHolder::getInstance().registerGraph<float>(0L, graph);
+        auto graph = sd::graph::GraphExecutioner::importFromFlatBuffers(file);
+        sd::graph::GraphHolder::getInstance().registerGraph(0L, graph);
     }
 
-    RunServer(port);
+    RunServer(port, numThreads, reportInterval, maxBatchSize, maxWait);
 
     return 0;
-}
\ No newline at end of file
+}
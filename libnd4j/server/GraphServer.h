@@ -22,23 +22,90 @@
 #include <grpc++/grpc++.h>
 #include <array/NDArray.h>
 #include <graph/Graph.h>
+#include <graph/RequestBatcher.h>
 #include <ops/declarable/CustomOperations.h>
 
 #include <graph/generated/graph.grpc.fb.h>
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace sd {
     namespace graph {
-        class GraphInferenceServerImpl final : public GraphInferenceServer::Service {
+        /**
+         * Lock-free counters, updated by every completed call
+         */
+        class ServerStatistics {
         private:
-            flatbuffers::grpc::MessageBuilder mb_;
+            std::atomic<Nd4jLong> _requests{0};
+            std::atomic<Nd4jLong> _failures{0};
+            std::atomic<Nd4jLong> _totalNanos{0};
+            std::atomic<Nd4jLong> _maxNanos{0};
         public:
-            virtual grpc::Status RegisterGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatGraph> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg);
+            ServerStatistics() = default;
+            ~ServerStatistics() = default;
+
+            void record(Nd4jLong nanos, bool successful);
+
+            Nd4jLong requests() const;
+            Nd4jLong failures() const;
+
+            // average and max call latency, in microseconds
+            Nd4jLong averageLatency() const;
+            Nd4jLong maxLatency() const;
+
+            std::string asString() const;
+        };
+
+        /**
+         * Asynchronous gRPC server: calls are served from completion queues by a fixed pool of threads.
+         * Each call owns its own MessageBuilder, so concurrent calls never share serialization state,
+         * and inference runs on pooled graph clones provided by GraphHolder
+         */
+        class GraphInferenceServerImpl {
+        private:
+            GraphInferenceServer::AsyncService _service;
+            std::unique_ptr<grpc::Server> _server;
+            std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> _queues;
+            std::vector<std::thread> _threads;
+
+            ServerStatistics _inference;
+            ServerStatistics _management;
+
+            // optional dynamic batching of inference requests
+            std::unique_ptr<RequestBatcher> _batcher;
+
+            void serve(grpc::ServerCompletionQueue *queue);
+        public:
+            GraphInferenceServerImpl() = default;
+            ~GraphInferenceServerImpl();
+
+            /**
+             * This method enables dynamic batching of inference requests. Must be called before run()
+             * @param maxBatchSize - max total batch size of merged request
+             * @param maxWait - max time in microseconds request waits for others
+             */
+            void enableBatching(int maxBatchSize, Nd4jLong maxWait);
+
+            RequestBatcher* batcher();
+
+            /**
+             * This method starts server on given address, with one completion queue per thread
+             */
+            void run(const std::string &address, int numThreads);
 
-            virtual grpc::Status ForgetGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatDropRequest> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg);
+            /**
+             * This method blocks until server is shut down
+             */
+            void wait();
 
-            virtual grpc::Status ReplaceGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatGraph> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg);
+            void shutdown();
 
-            virtual grpc::Status InferenceRequest( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatInferenceRequest> *request_msg, flatbuffers::grpc::Message<FlatResult> *response_msg);
+            ServerStatistics& inferenceStatistics();
+            ServerStatistics& managementStatistics();
         };
     }
-}
\ No newline at end of file
+}
@@ -216,3 +216,45 @@ TEST_F(AttentionTests, basic_multi_head_dot_product_bp_attention_with_mask) {
     delete result;
 }
  */
+
+TEST_F(AttentionTests, fused_dot_product_attention_with_mask) {
+    // more than one block of keys and queries, output without weights goes through fused kernel
+    auto keys = NDArrayFactory::create<float>('c', {2, 3, 4, 150});
+    auto values = NDArrayFactory::create<float>('c', {2, 3, 5, 150});
+    auto queries = NDArrayFactory::create<float>('c', {2, 3, 4, 40});
+    auto mask = NDArrayFactory::create<float>('c', {2, 150});
+    keys.linspace(-1., 0.001);
+    values.linspace(1., -0.001);
+    queries.linspace(0.5, -0.002);
+    mask.assign(1.);
+    for (int j = 0; j < 150; j += 3)
+        mask.p(1, j, 0.f);
+
+    sd::ops::dot_product_attention op;
+    auto fused = op.evaluate({&queries, &keys, &values, &mask}, {1, 0});
+    auto unfused = op.evaluate({&queries, &keys, &values, &mask}, {1, 1});
+    ASSERT_EQ(Status::OK(), fused.status());
+    ASSERT_EQ(Status::OK(), unfused.status());
+
+    ASSERT_TRUE(unfused.at(0)->isSameShape(fused.at(0)));
+    ASSERT_TRUE(unfused.at(0)->equalsTo(fused.at(0), 1e-4));
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_bp) {
+    auto keys = NDArrayFactory::create<double>('c', {2, 3, 70});
+    auto values = NDArrayFactory::create<double>('c', {2, 4, 70});
+    auto queries = NDArrayFactory::create<double>('c', {2, 3, 35});
+    auto eps = NDArrayFactory::create<double>('c', {2, 4, 35});
+    keys.linspace(-1., 0.005);
+    values.linspace(1., -0.003);
+    queries.linspace(0.5, -0.004);
+
+    const OpArgsHolder argsHolderFF({&queries, &keys, &values}, {}, {1, 0});
+    const OpArgsHolder argsHolderBP({&queries, &keys, &values, &eps}, {}, {1});
+
+    sd::ops::dot_product_attention opFF;
+    sd::ops::dot_product_attention_bp opBP;
+
+    const bool isGradCorrect = GradCheck::checkGrad(opFF, opBP, argsHolderFF, argsHolderBP);
+    ASSERT_TRUE(isGradCorrect);
+}
@@ -19,6 +19,8 @@
 //
 
 #include "testlayers.h"
+#include <thread>
+#include <atomic>
 #include <ops/declarable/CustomOperations.h>
 #include <helpers/ConstantShapeHelper.h>
 #include <array/ShapeDescriptor.h>
@@ -75,6 +77,66 @@ TEST_F(ConstantTadHelperTests, test_cachedAmount_1) {
     ASSERT_EQ(ttlMiddle, ttlAfter);
 }
 
+TEST_F(ConstantTadHelperTests, test_cache_limit_1) {
+    auto limit = ConstantTadHelper::getInstance().cacheLimit();
+    ConstantTadHelper::getInstance().setCacheLimit(32);
+
+    for (int e = 1; e < 200; e++) {
+        auto array = NDArrayFactory::create<float>('c', {3, e, 5});
+        auto pack = ConstantTadHelper::getInstance().tadForDimensions(array.shapeInfo(), {1, 2});
+
+        ASSERT_EQ(3, pack.numberOfTads());
+        ASSERT_EQ(e * 5, shape::length(pack.primaryShapeInfo()));
+    }
+
+    ASSERT_TRUE(ConstantTadHelper::getInstance().totalCachedEntries() <= 32);
+
+    ConstantTadHelper::getInstance().setCacheLimit(limit);
+}
+
+TEST_F(ConstantTadHelperTests, test_cache_limit_2) {
+    auto limit = ConstantTadHelper::getInstance().cacheLimit();
+
+    // limits below number of shards must hold as well
+    for (int l = 1; l < 20; l++) {
+        ConstantTadHelper::getInstance().setCacheLimit(l);
+
+        for (int e = 1; e < 50; e++) {
+            auto array = NDArrayFactory::create<float>('c', {2, e, 3});
+            auto pack = ConstantTadHelper::getInstance().tadForDimensions(array.shapeInfo(), {1, 2});
+
+            ASSERT_EQ(2, pack.numberOfTads());
+            ASSERT_TRUE(ConstantTadHelper::getInstance().totalCachedEntries() <= l);
+        }
+    }
+
+    ConstantTadHelper::getInstance().setCacheLimit(limit);
+}
+
+TEST_F(ConstantTadHelperTests, test_concurrent_access_1) {
+    std::vector<std::thread> threads(8);
+
+    // gtest assertions can't be used within threads, so failures are just counted
+    std::atomic<int> failures(0);
+
+    for (int t = 0; t < threads.size(); t++) {
+        threads[t] = std::thread([t, &failures] () {
+            for (int e = 1; e < 100; e++) {
+                auto shapeInfo = ConstantShapeHelper::getInstance().createShapeInfo(sd::DataType::FLOAT32, 'c', {4, e % 10 + 1, t + 1});
+                auto pack = ConstantTadHelper::getInstance().tadForDimensions(shapeInfo, {0});
+
+                if (pack.numberOfTads() != (e % 10 + 1) * (t + 1) || shape::length(pack.primaryShapeInfo()) != 4)
+                    failures++;
+            }
+        });
+    }
+
+    for (auto &t: threads)
+        t.join();
+
+    ASSERT_EQ(0, failures.load());
+}
+
 TEST_F(ConstantShapeHelperTests, basic_test_1) {
     auto ptr = ShapeBuilders::createShapeInfo(sd::DataType::BFLOAT16, 'f', {5, 10, 15});
     ShapeDescriptor descriptor(ptr);
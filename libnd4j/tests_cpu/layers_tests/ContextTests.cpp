@@ -353,4 +353,36 @@ TEST_F(ContextTests, test_short_context_3) {
     auto z = ctx.fastpath_out()[0];
 
     ASSERT_EQ(exp, *z);
-}
\ No newline at end of file
+}
+TEST_F(ContextTests, test_shape_memo_1) {
+    auto x = NDArrayFactory::create<float>('c', {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    auto y = NDArrayFactory::create<float>('c', {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    auto u = NDArrayFactory::create<float>('c', {1, 2}, {1.f, 1.f});
+    auto z = NDArrayFactory::create<float>('c', {3, 2});
+
+    auto exp0 = NDArrayFactory::create<float>('c', {3, 2}, {2.f, 4.f, 6.f, 8.f, 10.f, 12.f});
+    auto exp1 = NDArrayFactory::create<float>('c', {3, 2}, {2.f, 3.f, 4.f, 5.f, 6.f, 7.f});
+
+    Context ctx(1);
+    ctx.setInputArray(0, &x);
+    ctx.setInputArray(1, &y);
+    ctx.setOutputArray(0, &z);
+
+    sd::ops::add op;
+    ASSERT_EQ(Status::OK(), op.execute(&ctx));
+    ASSERT_EQ(Status::OK(), op.execute(&ctx));
+    ASSERT_EQ(exp0, z);
+
+    // second call has the same shapes and args, so shape function is skipped
+    auto memo = ctx.shapeMemo();
+    ASSERT_EQ(1, memo->misses());
+    ASSERT_EQ(1, memo->hits());
+
+    // new input shape invalidates memo
+    ctx.setInputArray(1, &u);
+    ASSERT_EQ(Status::OK(), op.execute(&ctx));
+    ASSERT_EQ(exp1, z);
+
+    ASSERT_EQ(2, memo->misses());
+    ASSERT_EQ(1, memo->hits());
+}
@@ -707,6 +707,57 @@ TEST_F(DeclarableOpsTests10, top_k_permuted_test2) {
     ASSERT_TRUE(expSorted.equalsTo(z));
 }
 
+//////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, top_k_long_row_test1) {
+
+    const int width = 100000;
+    auto x = NDArrayFactory::create<float>('c', {2, width});
+
+    // both rows are permutations of 0..width-1
+    for (int e = 0; e < width; e++) {
+        x.p(0, e, static_cast<float>((static_cast<Nd4jLong>(e) * 7919) % width));
+        x.p(1, e, static_cast<float>(width - 1 - e));
+    }
+
+    sd::ops::top_k op;
+    for (int k : {100, 2000}) {
+        auto result = op.evaluate({&x}, {}, {k}, {true});
+        ASSERT_EQ(ND4J_STATUS_OK, result.status());
+
+        auto v = result.at(0);
+        auto i = result.at(1);
+
+        ASSERT_EQ(k, v->sizeAt(1));
+        for (int r = 0; r < 2; r++)
+            for (int j = 0; j < k; j++) {
+                ASSERT_EQ(static_cast<float>(width - 1 - j), v->e<float>(r, j));
+                ASSERT_EQ(v->e<float>(r, j), x.e<float>(r, i->e<Nd4jLong>(r, j)));
+            }
+
+        auto unsorted = op.evaluate({&x}, {}, {k}, {false});
+        ASSERT_EQ(ND4J_STATUS_OK, unsorted.status());
+
+        // second row is descending, so its top k are the first k elements
+        for (int j = 0; j < k; j++)
+            ASSERT_EQ(j, unsorted.at(1)->e<Nd4jLong>(1, j));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, top_k_ties_test1) {
+
+    auto x = NDArrayFactory::create<double>({3., 5., 1., 5., 3., 5., 0.});
+    auto expV = NDArrayFactory::create<double>({5., 5., 5., 3.});
+    auto expI = NDArrayFactory::create<Nd4jLong>({1, 3, 5, 0});
+
+    sd::ops::top_k op;
+    auto result = op.evaluate({&x}, {}, {4}, {true});
+
+    ASSERT_EQ(ND4J_STATUS_OK, result.status());
+    ASSERT_TRUE(expV.equalsTo(result.at(0)));
+    ASSERT_TRUE(expI.equalsTo(result.at(1)));
+}
+
 ///////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests10, sparse_softmax_cross_entropy_loss_with_logits_test1) {
 
@@ -1116,6 +1167,28 @@ TEST_F(DeclarableOpsTests10, NTH_Element_Test_8) {
     ASSERT_TRUE(exp.equalsTo(output));
 }
 
+///////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, NTH_Element_Test_9) {
+
+    const int width = 100000;
+    NDArray input = NDArrayFactory::create<float>('c', {width});
+    for (int e = 0; e < width; e++)
+        input.p(e, static_cast<float>((static_cast<Nd4jLong>(e) * 7919) % width));
+
+    sd::ops::nth_element op;
+    for (int n : {0, 17, 54321, width - 1}) {
+        NDArray nArr = NDArrayFactory::create<int>(n);
+
+        auto results = op.evaluate({&input, &nArr}, {}, {});
+        ASSERT_EQ(ND4J_STATUS_OK, results.status());
+        ASSERT_EQ(static_cast<float>(n), results.at(0)->e<float>(0));
+
+        auto reversed = op.evaluate({&input, &nArr}, {}, {1});
+        ASSERT_EQ(ND4J_STATUS_OK, reversed.status());
+        ASSERT_EQ(static_cast<float>(width - 1 - n), reversed.at(0)->e<float>(0));
+    }
+}
+
 ///////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests10, broadcast_to_test1) {
 
@@ -423,6 +423,80 @@ TEST_F(DeclarableOpsTests13, CellContains_test_1) {
 
 }
 
+TEST_F(DeclarableOpsTests13, BarnesHutTsne_symmetrized_5) {
+    auto rows = NDArrayFactory::create<int>('c', {4}, {0, 2, 2, 3});
+    auto cols = NDArrayFactory::create<int>('c', {3}, {0, 1, 1});
+    auto vals = NDArrayFactory::create<double>('c', {3}, {20., 30., 40.});
+    auto expRows = NDArrayFactory::create<int>('c', {1, 4}, {0, 2, 4, 5});
+    auto expCols = NDArrayFactory::create<int>('c', {1, 5}, {0, 1, 0, 2, 1});
+    auto expVals = NDArrayFactory::create<double>('c', {1, 5}, {20., 15., 15., 20., 20.});
+
+    sd::ops::barnes_symmetrized op;
+    auto result = op.evaluate({&rows, &cols, &vals}, {}, {3});
+    ASSERT_EQ(result.status(), Status::OK());
+    ASSERT_TRUE(expRows.equalsTo(result.at(0)));
+    ASSERT_TRUE(expCols.equalsTo(result.at(1)));
+    ASSERT_TRUE(expVals.equalsTo(result.at(2)));
+}
+
+TEST_F(DeclarableOpsTests13, BarnesHutTsne_RepulsiveForces_1) {
+    auto data = NDArrayFactory::create<double>('c', {4, 2}, {0., 0., 1., 0., 0., 2., 1., 1.});
+    auto expForces = NDArrayFactory::create<double>('c', {4, 2}, {-0.361111, -0.191111, 0.277778, -0.305556, -0.138889, 0.246667, 0.222222, 0.250000});
+    auto expSum = NDArrayFactory::create<double>(4.066667);
+
+    // theta = 0 means exact computation
+    sd::ops::barnes_repulsive_forces op;
+    auto result = op.evaluate({&data}, {0.}, {});
+    ASSERT_EQ(result.status(), Status::OK());
+    ASSERT_TRUE(expForces.equalsTo(result.at(0)));
+    ASSERT_TRUE(expSum.equalsTo(result.at(1)));
+}
+
+TEST_F(DeclarableOpsTests13, BarnesHutTsne_RepulsiveForces_3) {
+    auto data = NDArrayFactory::create<double>('f', {4, 2}, {0., 1., 0., 1., 0., 0., 2., 1.});
+    auto expForces = NDArrayFactory::create<double>('c', {4, 2}, {-0.361111, -0.191111, 0.277778, -0.305556, -0.138889, 0.246667, 0.222222, 0.250000});
+    auto expSum = NDArrayFactory::create<double>(4.066667);
+
+    // 'f' input gives 'c' output
+    sd::ops::barnes_repulsive_forces op;
+    auto result = op.evaluate({&data}, {0.}, {});
+    ASSERT_EQ(result.status(), Status::OK());
+    ASSERT_EQ('c', result.at(0)->ordering());
+    ASSERT_TRUE(expForces.equalsTo(result.at(0)));
+    ASSERT_TRUE(expSum.equalsTo(result.at(1)));
+
+    // and 'f' output provided by caller gets the same values
+    auto forces = NDArrayFactory::create<double>('f', {4, 2});
+    auto sum = NDArrayFactory::create<double>(0.);
+    ASSERT_EQ(Status::OK(), op.execute({&data}, {&forces, &sum}, {0.}, {}));
+    ASSERT_TRUE(expForces.equalsTo(forces));
+    ASSERT_TRUE(expSum.equalsTo(sum));
+}
+
+TEST_F(DeclarableOpsTests13, BarnesHutTsne_RepulsiveForces_2) {
+    auto data = NDArrayFactory::create<double>('c', {500, 3});
+    for (int i = 0; i < 500; i++) {
+        data.p(i, 0, 10. * std::sin(0.37 * i));
+        data.p(i, 1, 10. * std::cos(0.11 * i * i));
+        data.p(i, 2, (i % 17) * 0.5);
+    }
+
+    sd::ops::barnes_repulsive_forces op;
+    auto exact = op.evaluate({&data}, {0.}, {});
+    auto approx = op.evaluate({&data}, {0.5}, {});
+    ASSERT_EQ(exact.status(), Status::OK());
+    ASSERT_EQ(approx.status(), Status::OK());
+
+    auto exactSum = exact.at(1)->e<double>(0);
+    auto approxSum = approx.at(1)->e<double>(0);
+    ASSERT_NEAR(exactSum, approxSum, 0.05 * exactSum);
+
+    // forces are normalized the same way the gradient does it
+    auto diff = (*exact.at(0) / exactSum - *approx.at(0) / approxSum).reduceNumber(reduce::AMax).e<double>(0);
+    auto scale = (*exact.at(0) / exactSum).reduceNumber(reduce::AMax).e<double>(0);
+    ASSERT_TRUE(diff < 0.1 * scale);
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests13, adjustHue_1) {
 
@@ -2065,6 +2139,129 @@ TEST_F(DeclarableOpsTests13, lstmLayer_12) {
     #endif
 }
 
+////////////////////////////////////////////////////////////////////
+// platform helper (fused time loop) vs generic implementation
+TEST_F(DeclarableOpsTests13, lstmLayer_13) {
+
+    const int sL   = 7;
+    const int bS   = 4;
+    const int nIn  = 5;
+    const int nOut = 6;
+
+    const int dataFormat = 2;       // [bS,nIn,sL]
+    const int directionMode = 1;    // backward
+    const int gateAct = 7;          // hard sigmoid activation for input (i), forget (f) and output (o) gates
+    const int cellAct = 6;          // scaled tanh activation for cell state
+    const int outAct = 0;           // tanh activation for output
+
+    const bool hasBiases  = true;
+    const bool hasSeqLen  = true;
+    const auto hasInitH   = true;
+    const auto hasInitC   = false;
+    const auto hasPH      = true;
+    const auto retFullSeq = true;
+    const auto retLastH   = true;
+    const auto retLastC   = true;
+
+    const double cellClip = 0.7;
+    const double cellAlpha = 1.2;
+    const double cellBeta = 0.8;
+
+    NDArray x('c', {bS, nIn, sL}, sd::DataType::DOUBLE);
+    NDArray Wx('c', {nIn, 4*nOut}, sd::DataType::DOUBLE);
+    NDArray Wr('c', {nOut, 4*nOut}, sd::DataType::DOUBLE);
+    NDArray b('c', {4*nOut}, sd::DataType::DOUBLE);
+    NDArray seqLen('c', {bS}, {7,0,3,5}, sd::DataType::INT32);
+    NDArray hI('c', {bS, nOut}, sd::DataType::DOUBLE);
+    NDArray Wp('c', {3*nOut}, sd::DataType::DOUBLE);
+
+    x.linspace(-1., 0.01);
+    Wx.linspace(0.3, -0.005);
+    Wr.linspace(-0.2, 0.004);
+    b.linspace(0.1, -0.01);
+    hI.linspace(-0.5, 0.03);
+    Wp.linspace(-0.1, 0.02);
+
+    std::initializer_list<double>   tArgs = {cellClip, cellAlpha, cellBeta};
+    std::initializer_list<Nd4jLong> iArgs = {dataFormat, directionMode, gateAct, cellAct, outAct};
+    std::initializer_list<bool>     bArgs = {hasBiases, hasSeqLen, hasInitH, hasInitC, hasPH, retFullSeq, retLastH, retLastC};
+
+    sd::ops::lstmLayer op;
+    auto results = op.evaluate({&x, &Wx, &Wr, &b, &seqLen, &hI, &Wp}, tArgs, iArgs, bArgs);
+    ASSERT_EQ(ND4J_STATUS_OK, results.status());
+
+    sd::Environment::getInstance().allowHelpers(false);
+    auto expected = op.evaluate({&x, &Wx, &Wr, &b, &seqLen, &hI, &Wp}, tArgs, iArgs, bArgs);
+    sd::Environment::getInstance().allowHelpers(true);
+    ASSERT_EQ(ND4J_STATUS_OK, expected.status());
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(expected.at(i)->isSameShape(results.at(i)));
+        ASSERT_TRUE(expected.at(i)->equalsTo(results.at(i)));
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// platform helper vs generic implementation, bidirectional sum
+TEST_F(DeclarableOpsTests13, lstmLayer_14) {
+
+    const int sL   = 9;
+    const int bS   = 3;
+    const int nIn  = 4;
+    const int nOut = 5;
+
+    const int dataFormat = 1;       // [bS,sL,nIn]
+    const int directionMode = 2;    // bidirectional sum
+    const int gateAct = 2;          // sigmoid activation for input (i), forget (f) and output (o) gates
+    const int cellAct = 0;          // tanh activation for cell state
+    const int outAct = 8;           // ELU activation for output
+
+    const bool hasBiases  = true;
+    const bool hasSeqLen  = true;
+    const auto hasInitH   = true;
+    const auto hasInitC   = true;
+    const auto hasPH      = false;
+    const auto retFullSeq = true;
+    const auto retLastH   = true;
+    const auto retLastC   = false;
+
+    const double cellClip = 0;
+    const double outAlpha = 0.5;
+
+    NDArray x('c', {bS, sL, nIn}, sd::DataType::FLOAT32);
+    NDArray Wx('c', {2, nIn, 4*nOut}, sd::DataType::FLOAT32);
+    NDArray Wr('c', {2, nOut, 4*nOut}, sd::DataType::FLOAT32);
+    NDArray b('c', {2, 4*nOut}, sd::DataType::FLOAT32);
+    NDArray seqLen('c', {bS}, {9,4,6}, sd::DataType::FLOAT32);
+    NDArray hI('c', {2, bS, nOut}, sd::DataType::FLOAT32);
+    NDArray cI('c', {2, bS, nOut}, sd::DataType::FLOAT32);
+
+    x.linspace(0.5, -0.01);
+    Wx.linspace(-0.3, 0.004);
+    Wr.linspace(0.2, -0.003);
+    b.linspace(-0.1, 0.01);
+    hI.linspace(0.4, -0.02);
+    cI.linspace(-1., 0.05);
+
+    std::initializer_list<double>   tArgs = {cellClip, outAlpha};
+    std::initializer_list<Nd4jLong> iArgs = {dataFormat, directionMode, gateAct, cellAct, outAct};
+    std::initializer_list<bool>     bArgs = {hasBiases, hasSeqLen, hasInitH, hasInitC, hasPH, retFullSeq, retLastH, retLastC};
+
+    sd::ops::lstmLayer op;
+    auto results = op.evaluate({&x, &Wx, &Wr, &b, &seqLen, &hI, &cI}, tArgs, iArgs, bArgs);
+    ASSERT_EQ(ND4J_STATUS_OK, results.status());
+
+    sd::Environment::getInstance().allowHelpers(false);
+    auto expected = op.evaluate({&x, &Wx, &Wr, &b, &seqLen, &hI, &cI}, tArgs, iArgs, bArgs);
+    sd::Environment::getInstance().allowHelpers(true);
+    ASSERT_EQ(ND4J_STATUS_OK, expected.status());
+
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TRUE(expected.at(i)->isSameShape(results.at(i)));
+        ASSERT_TRUE(expected.at(i)->equalsTo(results.at(i), 1e-5));
+    }
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests13, batchnorm_test1) {
 
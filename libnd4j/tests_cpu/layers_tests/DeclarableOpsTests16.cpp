@@ -155,6 +155,78 @@ TEST_F(DeclarableOpsTests16, test_knn_mindistance_1) {
     ASSERT_EQ(Status::OK(), result);
 }
 
+TEST_F(DeclarableOpsTests16, test_knn_search_1) {
+    auto data = NDArrayFactory::create<double>('c', {6, 2}, {0., 0., 1., 0., 0., 1., 5., 5., 6., 5., 10., 10.});
+    auto queries = NDArrayFactory::create<double>('c', {2, 2}, {0.1, 0.1, 5.5, 5.});
+
+    // ties are resolved in favour of lower index
+    auto expIndices = NDArrayFactory::create<Nd4jLong>('c', {2, 3}, {0, 1, 2, 3, 4, 1});
+    auto expDistances = NDArrayFactory::create<double>('c', {2, 3}, {0.141421, 0.905539, 0.905539, 0.5, 0.5, 6.726812});
+
+    sd::ops::knn_search op;
+    auto result = op.evaluate({&data, &queries}, {}, {3});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_EQ(expIndices, *result.at(0));
+    ASSERT_TRUE(expDistances.equalsTo(result.at(1)));
+}
+
+TEST_F(DeclarableOpsTests16, test_knn_search_2) {
+    const int numPoints = 300, numQueries = 20, dims = 5, k = 7;
+    auto data = NDArrayFactory::create<double>('c', {numPoints, dims});
+    auto queries = NDArrayFactory::create<double>('c', {numQueries, dims});
+    for (int e = 0; e < numPoints * dims; e++)
+        data.p(e, std::sin(0.7 * e) + 0.3 * std::cos(0.013 * e * e));
+
+    for (int e = 0; e < numQueries * dims; e++)
+        queries.p(e, std::cos(1.3 * e));
+
+    sd::ops::knn_search op;
+    for (int distance = 0; distance < 3; distance++) {
+        auto result = op.evaluate({&data, &queries}, {}, {k, distance});
+        ASSERT_EQ(Status::OK(), result.status());
+
+        for (int q = 0; q < numQueries; q++) {
+            std::vector<std::pair<double, Nd4jLong>> expected;
+            for (int p = 0; p < numPoints; p++) {
+                double sum = 0., dot = 0., qNorm = 0., pNorm = 0.;
+                for (int e = 0; e < dims; e++) {
+                    auto a = queries.e<double>(q, e);
+                    auto b = data.e<double>(p, e);
+                    sum += distance == 2 ? std::fabs(a - b) : (a - b) * (a - b);
+                    dot += a * b;
+                    qNorm += a * a;
+                    pNorm += b * b;
+                }
+
+                auto d = distance == 0 ? std::sqrt(sum) : distance == 1 ? 1. - dot / std::sqrt(qNorm * pNorm) : sum;
+                expected.emplace_back(d, p);
+            }
+
+            std::sort(expected.begin(), expected.end());
+            for (int r = 0; r < k; r++) {
+                ASSERT_EQ(expected[r].second, result.at(0)->e<Nd4jLong>(q, r));
+                ASSERT_NEAR(expected[r].first, result.at(1)->e<double>(q, r), 1e-6);
+            }
+        }
+    }
+}
+
+TEST_F(DeclarableOpsTests16, test_knn_radius_search_1) {
+    auto data = NDArrayFactory::create<double>('c', {6, 2}, {0., 0., 1., 0., 0., 1., 5., 5., 6., 5., 10., 10.});
+    auto queries = NDArrayFactory::create<double>('c', {2, 2}, {0.1, 0.1, 5.5, 5.});
+
+    auto expIndices = NDArrayFactory::create<Nd4jLong>('c', {2, 4}, {0, 1, 2, -1, 3, 4, -1, -1});
+    auto expCounts = NDArrayFactory::create<Nd4jLong>('c', {2}, {3, 2});
+
+    sd::ops::knn_radius_search op;
+    auto result = op.evaluate({&data, &queries}, {1.0}, {4});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_EQ(expIndices, *result.at(0));
+    ASSERT_EQ(expCounts, *result.at(2));
+    ASSERT_NEAR(0.905539, result.at(1)->e<double>(0, 2), 1e-5);
+    ASSERT_TRUE(std::isinf(result.at(1)->e<double>(1, 3)));
+}
+
 TEST_F(DeclarableOpsTests16, test_empty_cast_1) {
     auto x = NDArrayFactory::create<bool>('c', { 1, 0, 2 });
     auto e = NDArrayFactory::create<Nd4jLong>('c', { 1, 0, 2 });
@@ -20,6 +20,7 @@
 //
 
 #include "testlayers.h"
+#include <loops/type_conversions.h>
 #include <ops/declarable/CustomOperations.h>
 #include <array/NDArray.h>
 #include <ops/ops.h>
@@ -122,6 +123,34 @@ TEST_F(DeclarableOpsTests19, test_threshold_encode_boundary_2) {
     ASSERT_EQ(900, x.sumNumber().e<int>(0));
 }
 
+TEST_F(DeclarableOpsTests19, test_threshold_encode_order_1) {
+    const int length = 300000;
+    const int boundary = 100000;
+    auto x = NDArrayFactory::create<float>('c', {length});
+    for (int e = 0; e < length; e++)
+        x.p(e, e % 3 == 0 ? 1.0f : e % 3 == 1 ? -1.0f : 0.25f);
+
+    sd::ops::encode_threshold op;
+    auto result = op.evaluate({&x}, {1.0}, {boundary});
+    auto encoded = result.at(1);
+
+    ASSERT_EQ(boundary + 4, encoded->lengthOf());
+
+    // updates are stored in order of indices, and only the first ones fitting into boundary are applied
+    int e = 0;
+    for (int i = 0; i < boundary; i++, e++) {
+        if (e % 3 == 2)
+            e++;
+
+        ASSERT_EQ(e % 3 == 0 ? e + 1 : -e - 1, encoded->e<int>(i + 4));
+    }
+
+    for (int i = 0; i < length; i++) {
+        auto expected = i % 3 == 2 ? 0.25f : i < e ? 0.0f : i % 3 == 0 ? 1.0f : -1.0f;
+        ASSERT_EQ(expected, x.e<float>(i));
+    }
+}
+
 TEST_F(DeclarableOpsTests19, test_threshold_decode_1) {
     auto x = NDArrayFactory::create<double>('c', {3}, {1.0, 2.0, -3.0});
     auto y = NDArrayFactory::create<int>('c', {7}, {3, 3, 1056964608, 0, 1, 2, -3});
@@ -241,6 +270,85 @@ TEST_F(DeclarableOpsTests19, test_threshold_encode_decode) {
     ASSERT_EQ(exp, initial);
 }
 
+TEST_F(DeclarableOpsTests19, test_threshold_encode_decode_long_1) {
+#ifndef __CUDABLAS__
+    // int64 indices are used for arrays longer than MAX_INT, here they're requested explicitly
+    const int length = 1000;
+    auto initial = NDArrayFactory::create<float>('c', {length});
+    auto residual = initial.like();
+    for (int e = 0; e < length; e++) {
+        initial.p(e, e % 10 == 0 ? 1.0f : e % 10 == 5 ? -0.75f : 0.25f);
+        residual.p(e, e % 10 == 0 ? 0.5f : e % 10 == 5 ? -0.25f : 0.25f);
+    }
+    auto exp = initial.dup();
+
+    sd::ops::encode_threshold enc;
+    auto enc_result = enc.evaluate({&initial}, {0.5f}, {}, {true});
+    ASSERT_EQ(Status::OK(), enc_result.status());
+    auto encoded = enc_result.at(1);
+
+    // 6 int32 elements of header, and 200 int64 indices
+    ASSERT_EQ(DataType::INT64, encoded->dataType());
+    ASSERT_EQ(3 + 200, encoded->lengthOf());
+    ASSERT_EQ(residual, initial);
+
+    auto header = encoded->bufferAsT<int>();
+    ASSERT_EQ(2 * 200 + 2, header[0]);
+    ASSERT_EQ(length, header[1]);
+    ASSERT_EQ(THRESHOLD_LONG_FLAG, header[3]);
+    ASSERT_EQ(length, encoded->e<Nd4jLong>(2));
+    ASSERT_EQ(1, encoded->e<Nd4jLong>(3));
+    ASSERT_EQ(-6, encoded->e<Nd4jLong>(4));
+
+    sd::ops::decode_threshold dec;
+    auto status = dec.execute({&initial, encoded}, {&initial});
+    ASSERT_EQ(Status::OK(), status);
+
+    ASSERT_EQ(exp, initial);
+#endif
+}
+
+TEST_F(DeclarableOpsTests19, test_adaptive_encode_decode_1) {
+    // dense, sparse and empty chunks
+    const int length = 300000;
+    auto initial = NDArrayFactory::create<float>('c', {length});
+    for (int e = 0; e < length; e++) {
+        if (e < 70000)
+            initial.p(e, e % 3 == 0 ? 1.5f : e % 3 == 1 ? -1.25f : 0.5f);
+        else if (e < 200000)
+            initial.p(e, e % 97 == 0 ? -2.0f : e % 89 == 0 ? 1.0f : 0.75f);
+        else
+            initial.p(e, -0.5f);
+    }
+
+    auto exp = initial.dup();
+    auto residual = initial.dup();
+    for (int e = 0; e < length; e++) {
+        auto v = residual.e<float>(e);
+        if (v >= 1.0f)
+            residual.p(e, v - 1.0f);
+        else if (v <= -1.0f)
+            residual.p(e, v + 1.0f);
+    }
+
+    sd::ops::encode_adaptive enc;
+    auto enc_result = enc.evaluate({&initial}, {1.0f});
+    ASSERT_EQ(Status::OK(), enc_result.status());
+    auto encoded = enc_result.at(1);
+
+    ASSERT_EQ(residual, initial);
+
+    // 3 ints per chunk, 2 bits per element for dense chunk, and varints for sparse ones
+    ASSERT_EQ(2, encoded->e<int>(3));
+    ASSERT_TRUE(encoded->lengthOf() < 6 + 3 * 5 + 65536 / 16 + 70000 / 3 + 2500);
+
+    sd::ops::decode_adaptive dec;
+    auto status = dec.execute({&initial, encoded}, {&initial});
+    ASSERT_EQ(Status::OK(), status);
+
+    ASSERT_EQ(exp, initial);
+}
+
 #ifdef _RELEASE
 TEST_F(DeclarableOpsTests19, test_threshold_encode_decode_2) {
   // [2,1,135079944,1,1,8192,1,99]
@@ -421,3 +529,195 @@ TEST_F(DeclarableOpsTests19, test_squeeze_1) {
     ASSERT_EQ(Status::OK(), status);
 }
 
+
+TEST_F(DeclarableOpsTests19, test_quantize_linear_1) {
+    auto x = NDArrayFactory::create<float>('c', {2, 3}, {-1.f, -0.5f, 0.f, 1.f, 1.5f, 100.f});
+    auto scale = NDArrayFactory::create<float>(0.5f);
+    auto zeroPoint = NDArrayFactory::create<int8_t>(0);
+
+    auto eq = NDArrayFactory::create<int8_t>('c', {2, 3}, {-2, -1, 0, 2, 3, 127});
+    auto ez = NDArrayFactory::create<float>('c', {2, 3}, {-1.f, -0.5f, 0.f, 1.f, 1.5f, 63.5f});
+
+    sd::ops::quantize_linear opQ;
+    auto resultQ = opQ.evaluate({&x, &scale, &zeroPoint});
+    ASSERT_EQ(Status::OK(), resultQ.status());
+    ASSERT_EQ(eq, *resultQ.at(0));
+
+    sd::ops::dequantize_linear opD;
+    auto resultD = opD.evaluate({resultQ.at(0), &scale, &zeroPoint});
+    ASSERT_EQ(Status::OK(), resultD.status());
+    ASSERT_EQ(ez, *resultD.at(0));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantize_with_min_max_vars_1) {
+    auto x = NDArrayFactory::create<float>('c', {2, 3}, {-1.3f, -0.7f, 0.1f, 0.9f, 1.7f, 2.5f});
+    auto min = NDArrayFactory::create<float>(-1.f);
+    auto max = NDArrayFactory::create<float>(2.f);
+
+    sd::ops::fake_quant_with_min_max_vars opF;
+    auto expected = opF.evaluate({&x, &min, &max});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantize_with_min_max_vars opQ;
+    auto quantized = opQ.evaluate({&x, &min, &max});
+    ASSERT_EQ(Status::OK(), quantized.status());
+    ASSERT_EQ(sd::DataType::UINT8, quantized.at(0)->dataType());
+
+    sd::ops::dequantize_linear opD;
+    auto result = opD.evaluate({quantized.at(0), quantized.at(1), quantized.at(2)});
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-5));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantize_with_min_max_vars_2) {
+    auto x = NDArrayFactory::create<float>('c', {2, 3}, {-1.3f, -0.7f, 0.1f, 0.9f, 1.7f, 2.5f});
+    auto min = NDArrayFactory::create<float>(-1.f);
+    auto max = NDArrayFactory::create<float>(2.f);
+
+    // narrow range gives signed values
+    sd::ops::fake_quant_with_min_max_vars opF;
+    auto expected = opF.evaluate({&x, &min, &max}, {}, {8}, {true});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantize_with_min_max_vars opQ;
+    auto quantized = opQ.evaluate({&x, &min, &max}, {}, {8}, {true});
+    ASSERT_EQ(Status::OK(), quantized.status());
+    ASSERT_EQ(sd::DataType::INT8, quantized.at(0)->dataType());
+    ASSERT_EQ(sd::DataType::INT8, quantized.at(2)->dataType());
+    ASSERT_EQ(-127, quantized.at(0)->reduceNumber(reduce::Min).e<int>(0));
+    ASSERT_EQ(127, quantized.at(0)->reduceNumber(reduce::Max).e<int>(0));
+
+    sd::ops::dequantize_linear opD;
+    auto result = opD.evaluate({quantized.at(0), quantized.at(1), quantized.at(2)});
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-5));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_matmul_1) {
+    auto a = NDArrayFactory::create<uint8_t>('c', {3, 4});
+    auto b = NDArrayFactory::create<int8_t>('c', {4, 2});
+    for (int e = 0; e < a.lengthOf(); e++)
+        a.p(e, (e * 37) % 256);
+
+    for (int e = 0; e < b.lengthOf(); e++)
+        b.p(e, (e * 29) % 255 - 127);
+
+    auto aScale = NDArrayFactory::create<float>(0.1f);
+    auto aZeroPoint = NDArrayFactory::create<uint8_t>(128);
+    auto bScale = NDArrayFactory::create<float>('c', {2}, {0.05f, 0.02f});
+    auto bZeroPoint = NDArrayFactory::create<int8_t>('c', {2}, {0, -3});
+
+    sd::ops::dequantize_linear opD;
+    auto da = opD.evaluate({&a, &aScale, &aZeroPoint});
+    auto db = opD.evaluate({&b, &bScale, &bZeroPoint});
+
+    sd::ops::matmul opM;
+    auto expected = opM.evaluate({da.at(0), db.at(0)});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantized_matmul op;
+    auto result = op.evaluate({&a, &aScale, &aZeroPoint, &b, &bScale, &bZeroPoint});
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-4));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_xw_plus_b_1) {
+    auto x = NDArrayFactory::create<uint8_t>('c', {3, 5});
+    auto w = NDArrayFactory::create<int8_t>('c', {5, 4});
+    auto b = NDArrayFactory::create<float>('c', {4}, {0.5f, -1.f, 0.f, 2.f});
+    for (int e = 0; e < x.lengthOf(); e++)
+        x.p(e, (e * 41) % 256);
+
+    for (int e = 0; e < w.lengthOf(); e++)
+        w.p(e, (e * 23) % 255 - 127);
+
+    auto xScale = NDArrayFactory::create<float>(0.05f);
+    auto xZeroPoint = NDArrayFactory::create<uint8_t>(100);
+    auto wScale = NDArrayFactory::create<float>('c', {4}, {0.01f, 0.02f, 0.005f, 0.03f});
+    auto wZeroPoint = NDArrayFactory::create<int8_t>('c', {4}, {0, 4, -2, 1});
+
+    sd::ops::dequantize_linear opD;
+    auto dx = opD.evaluate({&x, &xScale, &xZeroPoint});
+    auto dw = opD.evaluate({&w, &wScale, &wZeroPoint});
+
+    sd::ops::xw_plus_b opX;
+    auto expected = opX.evaluate({dx.at(0), dw.at(0), &b});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantized_xw_plus_b op;
+    auto result = op.evaluate({&x, &xScale, &xZeroPoint, &w, &wScale, &wZeroPoint, &b});
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-4));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_xw_plus_b_2) {
+    auto x = NDArrayFactory::create<int8_t>('c', {2, 3});
+    auto w = NDArrayFactory::create<int8_t>('c', {4, 3});
+    auto b = NDArrayFactory::create<float>('c', {4}, {1.f, 2.f, 3.f, 4.f});
+    for (int e = 0; e < x.lengthOf(); e++)
+        x.p(e, (e * 19) % 200 - 100);
+
+    for (int e = 0; e < w.lengthOf(); e++)
+        w.p(e, (e * 31) % 160 - 80);
+
+    auto xScale = NDArrayFactory::create<float>(0.1f);
+    auto xZeroPoint = NDArrayFactory::create<int8_t>(-3);
+    auto wScale = NDArrayFactory::create<float>(0.02f);
+    auto wZeroPoint = NDArrayFactory::create<int8_t>(2);
+
+    sd::ops::dequantize_linear opD;
+    auto dx = opD.evaluate({&x, &xScale, &xZeroPoint});
+    auto dw = opD.evaluate({&w, &wScale, &wZeroPoint});
+
+    // weights are transposed
+    sd::ops::xw_plus_b opX;
+    auto expected = opX.evaluate({dx.at(0), dw.at(0), &b}, {}, {1});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantized_xw_plus_b op;
+    auto result = op.evaluate({&x, &xScale, &xZeroPoint, &w, &wScale, &wZeroPoint, &b}, {}, {1});
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-4));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_conv2d_1) {
+    auto input = NDArrayFactory::create<int8_t>('c', {1, 4, 4, 2});
+    auto weights = NDArrayFactory::create<int8_t>('c', {2, 2, 2, 3});
+    auto bias = NDArrayFactory::create<float>('c', {3}, {0.5f, -0.25f, 1.f});
+    for (int e = 0; e < input.lengthOf(); e++)
+        input.p(e, (e * 13) % 200 - 100);
+
+    for (int e = 0; e < weights.lengthOf(); e++)
+        weights.p(e, (e * 17) % 120 - 60);
+
+    auto inScale = NDArrayFactory::create<float>(0.02f);
+    auto inZeroPoint = NDArrayFactory::create<int8_t>(5);
+    auto wScale = NDArrayFactory::create<float>('c', {3}, {0.01f, 0.03f, 0.02f});
+    auto wZeroPoint = NDArrayFactory::create<int8_t>('c', {3}, {0, 2, -1});
+
+    sd::ops::dequantize_linear opD;
+    auto di = opD.evaluate({&input, &inScale, &inZeroPoint});
+    auto dw = opD.evaluate({&weights, &wScale, &wZeroPoint});
+
+    // 2x2 kernel, SAME padding, NHWC
+    sd::ops::conv2d opC;
+    auto expected = opC.evaluate({di.at(0), dw.at(0), &bias}, {2, 2, 1, 1, 0, 0, 1, 1, 1, 1});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantized_conv2d op;
+    auto result = op.evaluate({&input, &inScale, &inZeroPoint, &weights, &wScale, &wZeroPoint, &bias}, {2, 2, 1, 1, 0, 0, 1, 1, 1, 1});
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-4));
+}
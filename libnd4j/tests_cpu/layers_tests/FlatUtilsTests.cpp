@@ -97,4 +97,24 @@ TEST_F(FlatUtilsTests, flat_string_serde_1) {
     ASSERT_EQ(array, *restored);
 
     delete restored;
-}
\ No newline at end of file
+}
+TEST_F(FlatUtilsTests, flat_view_serde_1) {
+    auto source = NDArrayFactory::create<float>('c', {3, 4});
+    source.linspace(1);
+
+    // column of c-ordered matrix isn't contiguous, so it's packed before serialization
+    auto array = source({0,0, 1,2});
+
+    flatbuffers::FlatBufferBuilder builder(1024);
+    auto flatArray = FlatUtils::toFlatArray(builder, array);
+    builder.Finish(flatArray);
+
+
+    auto pfArray = GetFlatArray(builder.GetBufferPointer());
+
+    auto restored = FlatUtils::fromFlatArray(pfArray);
+
+    ASSERT_EQ(array, *restored);
+
+    delete restored;
+}
@@ -20,6 +20,10 @@
 
 #include "testlayers.h"
 #include <graph/GraphHolder.h>
+#include <graph/GraphExecutioner.h>
+#include <ops/declarable/CustomOperations.h>
+#include <graph/FlatUtils.h>
+#include <graph/generated/graph_generated.h>
 
 using namespace sd;
 using namespace sd::ops;
@@ -83,4 +87,258 @@ TEST_F(GraphHolderTests, SimpleTests_3) {
 
 
     delete graph2;
-}
\ No newline at end of file
+}
+TEST_F(GraphHolderTests, Pool_Test_1) {
+    auto graph = new Graph;
+    Nd4jLong graphId = 118;
+    GraphHolder::getInstance().registerGraph(graphId, graph);
+
+    auto graph1 = GraphHolder::getInstance().acquireGraph(graphId);
+    auto graph2 = GraphHolder::getInstance().acquireGraph(graphId);
+
+    ASSERT_TRUE(graph1 != nullptr);
+    ASSERT_TRUE(graph2 != nullptr);
+    ASSERT_TRUE(graph1 != graph2);
+    ASSERT_TRUE(graph1 != graph);
+
+    GraphHolder::getInstance().releaseGraph(graphId, graph1);
+    GraphHolder::getInstance().releaseGraph(graphId, graph2);
+
+    // clones are reused
+    auto graph3 = GraphHolder::getInstance().acquireGraph(graphId);
+    ASSERT_TRUE(graph3 == graph1 || graph3 == graph2);
+
+    GraphHolder::getInstance().releaseGraph(graphId, graph3);
+
+    GraphHolder::getInstance().dropGraph(graphId);
+
+    ASSERT_FALSE(GraphHolder::getInstance().hasGraph(graphId));
+}
+
+TEST_F(GraphHolderTests, MemoryPlan_Test_1) {
+    auto graph = new Graph;
+    Nd4jLong graphId = 121;
+
+    auto x = NDArrayFactory::create_<float>('c', {2, 3});
+    x->assign(-2.0);
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+
+    // graph is planned on registration
+    GraphHolder::getInstance().registerGraph(graphId, graph);
+    ASSERT_TRUE(graph->memoryPlan() != nullptr);
+    ASSERT_TRUE(graph->memoryPlan()->peakMemory() > 0);
+
+    // pooled clone writes into its own arena
+    auto clone = GraphHolder::getInstance().acquireGraph(graphId);
+    auto z = clone->getVariableSpace()->getVariable(2)->getNDArray();
+    ASSERT_TRUE(z != nullptr);
+    ASSERT_TRUE(z != graph->getVariableSpace()->getVariable(2)->getNDArray());
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(clone));
+    ASSERT_EQ(z, clone->getVariableSpace()->getVariable(2)->getNDArray());
+    ASSERT_NEAR(-2.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+    GraphHolder::getInstance().releaseGraph(graphId, clone);
+
+    // input of other shape: outputs are allocated as usual
+    clone = GraphHolder::getInstance().acquireGraph(graphId);
+
+    auto y = NDArrayFactory::create_<float>('c', {4, 3});
+    y->assign(3.0);
+    clone->getVariableSpace()->replaceVariable(new Variable(y, nullptr, -1, 0));
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(clone));
+
+    z = clone->getVariableSpace()->getVariable(2)->getNDArray();
+    ASSERT_EQ(std::vector<Nd4jLong>({4, 3}), z->getShapeAsVector());
+    ASSERT_NEAR(-3.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+    GraphHolder::getInstance().releaseGraph(graphId, clone);
+
+    GraphHolder::getInstance().dropGraph(graphId);
+}
+
+TEST_F(GraphHolderTests, MemoryPlan_Test_2) {
+    auto graph = new Graph;
+    Nd4jLong graphId = 124;
+
+    auto x = NDArrayFactory::create_<float>('c', {2, 3});
+    x->assign(-2.0);
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    auto shape = NDArrayFactory::create_<int>('c', {2}, {-3, -2});
+    graph->getVariableSpace()->putVariable(-2, shape);
+
+    // shape function of reshape reads values of its second input, which doesn't exist before execution
+    sd::ops::reshape opR;
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-2}, {2}));
+    graph->addNode(new Node(&opR, 2, {-1, 1}, {3}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 3, {2}, {}));
+
+    // only abs node is planned, reshape and its consumer allocate outputs as usual
+    GraphHolder::getInstance().registerGraph(graphId, graph);
+    ASSERT_TRUE(graph->memoryPlan() != nullptr);
+    ASSERT_EQ(1, graph->memoryPlan()->tensors().size());
+
+    auto clone = GraphHolder::getInstance().acquireGraph(graphId);
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(clone));
+
+    auto z = clone->getVariableSpace()->getVariable(3)->getNDArray();
+    ASSERT_EQ(std::vector<Nd4jLong>({3, 2}), z->getShapeAsVector());
+    ASSERT_NEAR(2.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+    GraphHolder::getInstance().releaseGraph(graphId, clone);
+
+    GraphHolder::getInstance().dropGraph(graphId);
+}
+
+TEST_F(GraphHolderTests, MemoryPlan_Test_3) {
+    Graph graph;
+
+    auto x = NDArrayFactory::create_<float>('c', {2, 3});
+    x->assign(-2.0);
+    graph.getVariableSpace()->putVariable(-1, x);
+
+    graph.addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2}));
+    graph.addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+
+    ASSERT_EQ(Status::OK(), graph.planMemory());
+    auto plan = graph.memoryPlan();
+    auto z = graph.getVariableSpace()->getVariable(2)->getNDArray();
+
+    // input of other shape detaches the plan
+    auto y = NDArrayFactory::create_<float>('c', {4, 3});
+    y->assign(3.0);
+    graph.getVariableSpace()->replaceVariable(new Variable(y, nullptr, -1, 0));
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(&graph));
+    ASSERT_FALSE(plan->isBound());
+    ASSERT_EQ(std::vector<Nd4jLong>({4, 3}), graph.getVariableSpace()->getVariable(2)->getNDArray()->getShapeAsVector());
+
+    // input of planned shape attaches it back, even though graph isn't pooled
+    auto w = NDArrayFactory::create_<float>('c', {2, 3});
+    w->assign(-5.0);
+    graph.getVariableSpace()->replaceVariable(new Variable(w, nullptr, -1, 0));
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(&graph));
+    ASSERT_TRUE(plan->isBound());
+    ASSERT_EQ(z, graph.getVariableSpace()->getVariable(2)->getNDArray());
+    ASSERT_NEAR(-5.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+}
+
+TEST_F(GraphHolderTests, Fusion_Test_1) {
+    flatbuffers::FlatBufferBuilder builder(4096);
+    Nd4jLong graphId = 122;
+
+    auto x = NDArrayFactory::create<float>('c', {5, 5});
+    x.assign(-2.0);
+
+    auto fArray = FlatUtils::toFlatArray(builder, x);
+    auto fVar = CreateFlatVariable(builder, CreateIntPair(builder, -1), 0, DType_FLOAT, 0, fArray);
+
+    // abs -> cos -> neg
+    std::vector<flatbuffers::Offset<FlatNode>> nodes;
+    nodes.emplace_back(CreateFlatNode(builder, 1, builder.CreateString("abs"), OpType_TRANSFORM_SAME, transform::Abs, 0, builder.CreateVector(std::vector<int>({-1})), 0, builder.CreateVector(std::vector<int>({2}))));
+    nodes.emplace_back(CreateFlatNode(builder, 2, builder.CreateString("cos"), OpType_TRANSFORM_STRICT, transform::Cosine, 0, builder.CreateVector(std::vector<int>({1})), 0, builder.CreateVector(std::vector<int>({3}))));
+    nodes.emplace_back(CreateFlatNode(builder, 3, builder.CreateString("neg"), OpType_TRANSFORM_SAME, transform::Neg, 0, builder.CreateVector(std::vector<int>({2}))));
+
+    std::vector<flatbuffers::Offset<FlatVariable>> variables = {fVar};
+
+    auto fNodes = builder.CreateVector(nodes);
+    auto fVariables = builder.CreateVector(variables);
+
+    FlatGraphBuilder graphBuilder(builder);
+    graphBuilder.add_id(graphId);
+    graphBuilder.add_variables(fVariables);
+    graphBuilder.add_nodes(fNodes);
+    builder.Finish(graphBuilder.Finish());
+
+    auto graph = GraphExecutioner::importFromFlatPointer(reinterpret_cast<Nd4jPointer>(builder.GetBufferPointer()));
+    ASSERT_EQ(3, graph->totalNodes());
+
+    // chain is fused on registration, fused node keeps id of the last node
+    GraphHolder::getInstance().registerGraph(graphId, graph);
+    ASSERT_EQ(1, graph->totalNodes());
+    ASSERT_TRUE(graph->hasNode(3));
+
+    auto clone = GraphHolder::getInstance().acquireGraph(graphId);
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(clone));
+
+    auto z = clone->getVariableSpace()->getVariable(3)->getNDArray();
+    ASSERT_NEAR(0.4161468, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+    GraphHolder::getInstance().releaseGraph(graphId, clone);
+
+    GraphHolder::getInstance().dropGraph(graphId);
+}
+
+TEST_F(GraphHolderTests, FoldFakeQuantization_Test_1) {
+    auto graph = new Graph;
+    Nd4jLong graphId = 123;
+
+    auto x = NDArrayFactory::create_<float>('c', {3, 4});
+    x->linspace(-1.1, 0.27);
+
+    auto w = NDArrayFactory::create_<float>('c', {4, 2});
+    w->linspace(-0.43, 0.11);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, w);
+
+    sd::ops::fake_quant_with_min_max_vars opF;
+    sd::ops::matmul opM;
+
+    auto fx = opF.evaluate({x}, {-1.0, 2.0}, {});
+    auto fw = opF.evaluate({w}, {-0.5, 0.5}, {});
+    auto exp = opM.evaluate({fx.at(0), fw.at(0)});
+
+    graph->addNode(new Node(&opF, 1, {-1}, {}, {}, 0.0f, {-1.0, 2.0}));
+    graph->addNode(new Node(&opF, 2, {-2}, {}, {}, 0.0f, {-0.5, 0.5}));
+    graph->addNode(new Node(&opM, 3, {1, 2}));
+
+    // fake quantization is folded on registration, if requested
+    graph->getExecutorConfiguration()->_foldFakeQuantization = true;
+    GraphHolder::getInstance().registerGraph(graphId, graph);
+    ASSERT_EQ(std::string("quantized_matmul"), *graph->nodeById(3)->getCustomOp()->getOpName());
+
+    auto clone = GraphHolder::getInstance().acquireGraph(graphId);
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(clone));
+
+    auto z = clone->getVariableSpace()->getVariable(3)->getNDArray();
+    ASSERT_TRUE(exp.at(0)->isSameShape(z));
+    ASSERT_TRUE(exp.at(0)->equalsTo(z, 1e-4));
+
+    GraphHolder::getInstance().releaseGraph(graphId, clone);
+
+    GraphHolder::getInstance().dropGraph(graphId);
+}
+
+TEST_F(GraphHolderTests, FoldFakeQuantization_Test_2) {
+    auto graph = new Graph;
+    Nd4jLong graphId = 125;
+
+    auto x = NDArrayFactory::create_<float>('c', {3, 4});
+    x->linspace(-1.1, 0.27);
+
+    auto w = NDArrayFactory::create_<float>('c', {4, 2});
+    w->linspace(-0.43, 0.11);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, w);
+
+    sd::ops::fake_quant_with_min_max_vars opF;
+    sd::ops::matmul opM;
+
+    graph->addNode(new Node(&opF, 1, {-1}, {}, {}, 0.0f, {-1.0, 2.0}));
+    graph->addNode(new Node(&opF, 2, {-2}, {}, {}, 0.0f, {-0.5, 0.5}));
+    graph->addNode(new Node(&opM, 3, {1, 2}));
+
+    // folding isn't requested, so graph is registered as is
+    GraphHolder::getInstance().registerGraph(graphId, graph);
+    ASSERT_EQ(std::string("matmul"), *graph->nodeById(3)->getCustomOp()->getOpName());
+
+    GraphHolder::getInstance().dropGraph(graphId);
+}
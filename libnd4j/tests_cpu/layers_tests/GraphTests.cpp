@@ -25,9 +25,12 @@
 #include <graph/Node.h>
 #include <graph/Graph.h>
 #include <graph/GraphUtils.h>
+#include <graph/GraphPool.h>
 #include <array/NDArray.h>
 #include <ops/declarable/DeclarableOp.h>
 #include <ops/declarable/generic/parity_ops.cpp>
+#include <thread>
+#include <atomic>
 
 using namespace sd;
 using namespace sd::graph;
@@ -330,6 +333,365 @@ TEST_F(GraphTests, QuadInput1) {
     delete graph;
 }
 
+TEST_F(GraphTests, QuadInput_Parallel_1) {
+    auto graph = new Graph();
+    graph->getExecutorConfiguration()->_executionMode = ExecutionMode_AUTO;
+    graph->getExecutorConfiguration()->_interOpThreads = 4;
+
+    auto x0 = NDArrayFactory::create_<float>('c', {5, 5});
+    x0->assign(0.0);
+
+    auto x1 = NDArrayFactory::create_<float>('c', {5, 5});
+    x1->assign(-1.0);
+
+    auto x2 = NDArrayFactory::create_<float>('c', {5, 5});
+    x2->assign(-2.0);
+
+    auto x3 = NDArrayFactory::create_<float>('c', {5, 5});
+    x3->assign(-3.0);
+
+    auto z = NDArrayFactory::create_<float>('c', {5, 5});
+    z->assign(119.0);
+
+    graph->getVariableSpace()->putVariable(-1, x0);
+    graph->getVariableSpace()->putVariable(-2, x1);
+    graph->getVariableSpace()->putVariable(-3, x2);
+    graph->getVariableSpace()->putVariable(-4, x3);
+    graph->getVariableSpace()->putVariable(-5, z);
+
+    auto nodeA = new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {11});
+    auto nodeB = new Node(OpType_TRANSFORM_SAME, transform::Abs, 2, {-2}, {11});
+    auto nodeC = new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {-3}, {21});
+    auto nodeD = new Node(OpType_TRANSFORM_SAME, transform::Abs, 4, {-4}, {21});
+
+    auto nodeP1 = new Node(OpType_PAIRWISE, pairwise::Add, 11, {1, 2}, {31});
+    auto nodeP2 = new Node(OpType_PAIRWISE, pairwise::Add, 21, {3, 4}, {31});
+
+    auto nodeZ = new Node(OpType_PAIRWISE, pairwise::Add, 31, {11, 21}, {-5});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+    graph->addNode(nodeC);
+    graph->addNode(nodeD);
+    graph->addNode(nodeP1);
+    graph->addNode(nodeP2);
+    graph->addNode(nodeZ);
+
+    ASSERT_EQ(4, graph->rootNodes());
+    ASSERT_EQ(7, graph->totalNodes());
+
+    for (int e = 0; e < 10; e++) {
+        auto status = GraphExecutioner::execute(graph);
+        ASSERT_EQ(Status::OK(), status);
+
+        ASSERT_NEAR(6.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+    }
+
+    delete graph;
+}
+
+TEST_F(GraphTests, MemoryPlan_1) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    // simple chain: every output dies right after next layer, so memory can be reused
+    auto nodeA = new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2});
+    auto nodeB = new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {3});
+    auto nodeC = new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {4});
+    auto nodeD = new Node(OpType_TRANSFORM_SAME, transform::Neg, 4, {3}, {});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+    graph->addNode(nodeC);
+    graph->addNode(nodeD);
+
+    ASSERT_EQ(Status::OK(), graph->planMemory());
+
+    auto plan = graph->memoryPlan();
+    ASSERT_TRUE(plan != nullptr);
+    ASSERT_TRUE(plan->peakMemory() > 0);
+    ASSERT_TRUE(plan->peakMemory() < plan->naiveMemory());
+
+    auto z = graph->getVariableSpace()->getVariable(4)->getNDArray();
+    ASSERT_TRUE(z != nullptr);
+
+    for (int e = 0; e < 3; e++) {
+        auto status = GraphExecutioner::execute(graph);
+        ASSERT_EQ(Status::OK(), status);
+
+        // output stays in the arena
+        ASSERT_EQ(z, graph->getVariableSpace()->getVariable(4)->getNDArray());
+        ASSERT_NEAR(-2.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+    }
+
+    delete graph;
+}
+
+TEST_F(GraphTests, Fusion_1) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+
+    auto y = NDArrayFactory::create_<float>('c', {5, 5});
+    y->assign(1.0);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, y);
+
+    // transform -> transform -> scalar -> pairwise
+    auto nodeA = new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2});
+    auto nodeB = new Node(OpType_TRANSFORM_STRICT, transform::Cosine, 2, {1}, {3});
+    auto nodeC = new Node(OpType_SCALAR, scalar::Multiply, 3, {2}, {4}, {}, 2.0f);
+    auto nodeD = new Node(OpType_PAIRWISE, pairwise::Add, 4, {3, -2}, {});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+    graph->addNode(nodeC);
+    graph->addNode(nodeD);
+
+    ASSERT_EQ(1, graph->fuseElementwise());
+    ASSERT_EQ(1, graph->totalNodes());
+    ASSERT_TRUE(graph->hasNode(4));
+    ASSERT_FALSE(graph->hasNode(1));
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+    auto z = graph->getVariableSpace()->getVariable(4)->getNDArray();
+    ASSERT_NEAR(0.1677064, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+    delete graph;
+}
+
+TEST_F(GraphTests, Fusion_2) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {4, 3});
+    x->linspace(-6.0);
+
+    auto b = NDArrayFactory::create_<float>('c', {3}, {1.f, 2.f, 3.f});
+    auto y = NDArrayFactory::create_<float>(3.f);
+
+    auto exp = NDArrayFactory::create<float>('c', {4, 3}, {0.f, 0.f, 0.f, 0.f, 0.f, 6.f, 3.f, 9.f, 15.f, 12.f, 18.f, 24.f});
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, b);
+    graph->getVariableSpace()->putVariable(-3, y);
+
+    // bias_add -> relu -> multiply
+    sd::ops::biasadd opA;
+    sd::ops::relu opB;
+    sd::ops::multiply opC;
+
+    auto nodeA = new Node(&opA, 1, {-1, -2});
+    auto nodeB = new Node(&opB, 2, {1}, {}, {}, 0.0f, {0.0});
+    auto nodeC = new Node(&opC, 3, {2, -3});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+    graph->addNode(nodeC);
+
+    ASSERT_EQ(1, graph->fuseElementwise());
+    ASSERT_EQ(1, graph->totalNodes());
+
+    // clones share fused op
+    auto clone = graph->cloneWithProxy();
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(clone));
+
+    auto z = graph->getVariableSpace()->getVariable(3)->getNDArray();
+    ASSERT_EQ(exp, *z);
+
+    z = clone->getVariableSpace()->getVariable(3)->getNDArray();
+    ASSERT_EQ(exp, *z);
+
+    delete clone;
+    delete graph;
+}
+
+TEST_F(GraphTests, Fusion_3) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    // output of node 1 is used twice, and both consumers are graph outputs: nothing to fuse
+    auto nodeA = new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2, 3});
+    auto nodeB = new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {});
+    auto nodeC = new Node(OpType_TRANSFORM_SAME, transform::Square, 3, {1}, {});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+    graph->addNode(nodeC);
+
+    ASSERT_EQ(0, graph->fuseElementwise());
+    ASSERT_EQ(3, graph->totalNodes());
+
+    delete graph;
+}
+
+TEST_F(GraphTests, Fusion_4) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<int>('c', {2, 2}, {-4, 0, 1, 9});
+    auto exp = NDArrayFactory::create<float>('c', {2, 2}, {4.f, 0.f, 2.f, 6.f});
+
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    // abs keeps integer type, and sqrt gives floating point output
+    auto nodeA = new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2});
+    auto nodeB = new Node(OpType_TRANSFORM_FLOAT, transform::Sqrt, 2, {1}, {3});
+    auto nodeC = new Node(OpType_SCALAR, scalar::Multiply, 3, {2}, {}, {}, 2.0f);
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+    graph->addNode(nodeC);
+
+    ASSERT_EQ(1, graph->fuseElementwise());
+    ASSERT_EQ(1, graph->totalNodes());
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+    auto z = graph->getVariableSpace()->getVariable(3)->getNDArray();
+    ASSERT_EQ(sd::Environment::getInstance().defaultFloatDataType(), z->dataType());
+    ASSERT_TRUE(exp.equalsTo(z));
+
+    delete graph;
+}
+
+TEST_F(GraphTests, FoldFakeQuantization_1) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {3, 4});
+    x->linspace(-1.1, 0.27);
+
+    auto w = NDArrayFactory::create_<float>('c', {4, 2});
+    w->linspace(-0.43, 0.11);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, w);
+
+    // expected result is the one of fake quantized graph
+    sd::ops::fake_quant_with_min_max_vars opF;
+    sd::ops::matmul opM;
+
+    auto fx = opF.evaluate({x}, {-1.0, 2.0}, {});
+    auto fw = opF.evaluate({w}, {-0.5, 0.5}, {});
+    auto exp = opM.evaluate({fx.at(0), fw.at(0)});
+
+    auto nodeA = new Node(&opF, 1, {-1}, {}, {}, 0.0f, {-1.0, 2.0});
+    auto nodeB = new Node(&opF, 2, {-2}, {}, {}, 0.0f, {-0.5, 0.5});
+    auto nodeC = new Node(&opM, 3, {1, 2});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+    graph->addNode(nodeC);
+
+    ASSERT_EQ(1, graph->foldFakeQuantization());
+    ASSERT_EQ(3, graph->totalNodes());
+    ASSERT_TRUE(graph->hasNode(3));
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+    auto z = graph->getVariableSpace()->getVariable(3)->getNDArray();
+    ASSERT_TRUE(exp.at(0)->isSameShape(z));
+    ASSERT_TRUE(exp.at(0)->equalsTo(z, 1e-4));
+
+    delete graph;
+}
+
+TEST_F(GraphTests, FoldFakeQuantization_2) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {3, 4});
+    auto w = NDArrayFactory::create_<float>('c', {4, 2});
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, w);
+
+    sd::ops::fake_quant_with_min_max_vars opF;
+    sd::ops::matmul opM;
+
+    // weights are not fake quantized: nothing to fold
+    auto nodeA = new Node(&opF, 1, {-1}, {}, {}, 0.0f, {-1.0, 2.0});
+    auto nodeB = new Node(&opM, 2, {1, -2});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+
+    ASSERT_EQ(0, graph->foldFakeQuantization());
+    ASSERT_EQ(2, graph->totalNodes());
+
+    delete graph;
+}
+
+TEST_F(GraphTests, Parallel_Layers_Stress_1) {
+    const int width = 64;
+    const int numThreads = 4;
+    const int iterations = 25;
+
+    auto graph = new Graph();
+    graph->getExecutorConfiguration()->_executionMode = ExecutionMode_AUTO;
+    graph->getExecutorConfiguration()->_interOpThreads = 8;
+
+    auto x = NDArrayFactory::create_<float>('c', {8, 8});
+    x->assign(-3.0);
+
+    auto y = NDArrayFactory::create_<float>('c', {8, 8});
+    y->assign(2.0);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, y);
+
+    // two wide layers: every node of second layer reads output of first layer, while its neighbours put theirs
+    for (int e = 1; e <= width; e++) {
+        graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, e, {-1}, {width + e}));
+        graph->addNode(new Node(OpType_PAIRWISE, pairwise::Add, width + e, {e, -2}, {}));
+    }
+
+    ASSERT_EQ(Status::OK(), graph->buildGraph());
+    ASSERT_EQ(width, graph->rootNodes());
+
+    // pooled clones are executed concurrently as well, so this test is meant to be run under -fsanitize=thread too
+    GraphPool pool(graph, numThreads);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < iterations; i++) {
+                auto clone = pool.acquire();
+
+                if (GraphExecutioner::execute(clone) != Status::OK()) {
+                    failures++;
+                } else {
+                    for (int e = 1; e <= width; e++) {
+                        auto z = clone->getVariableSpace()->getVariable(width + e)->getNDArray();
+                        if (z == nullptr || sd::math::nd4j_abs<float>(z->reduceNumber(reduce::Mean).e<float>(0) - 5.0f) > 1e-5f)
+                            failures++;
+                    }
+                }
+
+                pool.release(clone);
+            }
+        });
+    }
+
+    for (auto &t: threads)
+        t.join();
+
+    ASSERT_EQ(0, failures.load());
+
+    delete graph;
+}
+
 TEST_F(GraphTests, InternalBranching1) {
     auto graph = new Graph();
 
@@ -1541,6 +1541,81 @@ TEST_F(HelpersTests1, mmulHelper_test_7) {
 
 }
 
+////////////////////////////////////////////////////////////////////
+// types without BLAS, several K blocks and transposed operand
+TEST_F(HelpersTests1, mmulHelper_test_8) {
+
+    NDArray x('c', {67, 300}, sd::DataType::INT32);
+    NDArray y('c', {129, 300}, sd::DataType::INT32);
+    for (int i = 0; i < 67; i++)
+        for (int k = 0; k < 300; k++)
+            x.p(i, k, (i * 7 + k * 3) % 19 - 9);
+    for (int j = 0; j < 129; j++)
+        for (int k = 0; k < 300; k++)
+            y.p(j, k, (j * 5 + k) % 23 - 11);
+
+    auto yT = y.transpose();
+    NDArray result('f', {67, 129}, sd::DataType::INT32);
+    MmulHelper::mmul(&x, &yT, &result, 1., 0.);
+
+    auto xD = x.cast(sd::DataType::DOUBLE);
+    auto yD = yT.cast(sd::DataType::DOUBLE);
+    NDArray expected('c', {67, 129}, sd::DataType::DOUBLE);
+    for (int i = 0; i < 67; i++)
+        for (int j = 0; j < 129; j++) {
+            double sum = 0;
+            for (int k = 0; k < 300; k++)
+                sum += xD.e<double>(i, k) * yD.e<double>(k, j);
+            expected.p(i, j, sum);
+        }
+
+    ASSERT_TRUE(expected.cast(sd::DataType::INT32).equalsTo(&result));
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_test_9) {
+
+    NDArray x('c', {33, 17}, sd::DataType::BFLOAT16);
+    NDArray y('c', {17, 40}, sd::DataType::BFLOAT16);
+    x.linspace(-2, 0.25);
+    y.linspace(1, -0.125);
+
+    auto xF = x.cast(sd::DataType::FLOAT32);
+    auto yF = y.cast(sd::DataType::FLOAT32);
+    auto expected = MmulHelper::mmul(&xF, &yF, nullptr, 1., 0.);
+    NDArray result('c', {33, 40}, sd::DataType::BFLOAT16);
+    MmulHelper::mmul(&x, &y, &result, 1., 0.);
+
+    ASSERT_TRUE(expected->cast(sd::DataType::BFLOAT16).equalsTo(&result, 1e-2));
+    delete expected;
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_test_10) {
+
+    // batch of small products, y is transposed view and z is 'f' ordered
+    NDArray x('c', {2, 9, 5, 7}, sd::DataType::FLOAT32);
+    NDArray y('c', {2, 9, 3, 7}, sd::DataType::FLOAT32);
+    x.linspace(-3, 0.01);
+    y.linspace(2, -0.02);
+
+    NDArray z('f', {2, 9, 5, 3}, sd::DataType::FLOAT32);
+    z.assign(1.f);
+    MmulHelper::matmul(&x, &y, &z, false, true, 2., 0.5);
+
+    for (int e = 0; e < 18; e++) {
+        auto xSub = x(e, {0, 1});
+        auto ySub = y(e, {0, 1}).transpose();
+        auto zSub = z(e, {0, 1});
+
+        auto expected = MmulHelper::mmul(&xSub, &ySub, nullptr, 2., 0.);
+        *expected += 0.5f;
+
+        ASSERT_TRUE(expected->equalsTo(&zSub, 1e-4));
+        delete expected;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(HelpersTests1, tensordot_test_1) {
 
@@ -31,6 +31,7 @@
 #include <ops/declarable/LegacyBroadcastOp.h>
 #include <helpers/TAD.h>
 #include <helpers/ConstantTadHelper.h>
+#include <helpers/SimdKernels.h>
 
 using namespace sd;
 using namespace sd::ops;
@@ -766,3 +767,54 @@ TEST_F(LegacyOpsTests, test_legacy_transform_float_1) {
 
     NativeOpExecutioner::execTransformFloat(LaunchContext::defaultContext(), transform::FloatOps::RSqrt, x.buffer(), x.shapeInfo(), x.specialBuffer(), x.specialShapeInfo(), x.buffer(), x.shapeInfo(), x.specialBuffer(), x.specialShapeInfo(), nullptr, nullptr, nullptr);
 }
+
+#ifndef __CUDABLAS__
+// puts the process-wide SIMD level back even if an assertion returns early
+class SimdLevelGuard {
+private:
+    sd::simd::SimdLevel _level;
+public:
+    SimdLevelGuard() : _level(sd::simd::SimdKernels::getInstance().level()) { }
+    ~SimdLevelGuard() { sd::simd::SimdKernels::getInstance().setLevel(_level); }
+};
+
+TEST_F(LegacyOpsTests, test_simd_kernels_1) {
+    auto &kernels = sd::simd::SimdKernels::getInstance();
+    SimdLevelGuard guard;
+
+    // odd length, so vector loops and tails are both used
+    auto x = NDArrayFactory::create<float>('c', {1037});
+    auto y = NDArrayFactory::create<float>('c', {1037});
+    x.linspace(-5.f, 0.01f);
+    y.linspace(1.f, 0.5f);
+
+    ASSERT_TRUE(kernels.setLevel(sd::simd::SIMD_GENERIC));
+    auto expPairwise = x.ulike();
+    auto expScalar = x.ulike();
+    auto expTransform = x.ulike();
+    x.applyPairwiseTransform(pairwise::Divide, y, expPairwise);
+    x.applyScalar(scalar::RELU, 0.5f, expScalar);
+    x.applyTransform(transform::Neg, expTransform);
+    auto expSum = x.reduceNumber(reduce::Sum);
+    auto expNorm = x.reduceNumber(reduce::Norm2);
+
+    for (int e = sd::simd::SIMD_SSE4; e < sd::simd::SIMD_LEVELS; e++) {
+        auto level = static_cast<sd::simd::SimdLevel>(e);
+        if (!kernels.setLevel(level))
+            continue;
+
+        auto zPairwise = x.ulike();
+        auto zScalar = x.ulike();
+        auto zTransform = x.ulike();
+        x.applyPairwiseTransform(pairwise::Divide, y, zPairwise);
+        x.applyScalar(scalar::RELU, 0.5f, zScalar);
+        x.applyTransform(transform::Neg, zTransform);
+
+        ASSERT_EQ(expPairwise, zPairwise);
+        ASSERT_EQ(expScalar, zScalar);
+        ASSERT_EQ(expTransform, zTransform);
+        ASSERT_NEAR(expSum.e<float>(0), x.reduceNumber(reduce::Sum).e<float>(0), 1e-3);
+        ASSERT_NEAR(expNorm.e<float>(0), x.reduceNumber(reduce::Norm2).e<float>(0), 1e-3);
+    }
+}
+#endif
@@ -675,6 +675,36 @@ TEST_F(NDArrayTest2, permute_test4) {
     delete []arr2Buffer;
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(NDArrayTest2, permute_dup_1) {
+    NDArray x('c', {70, 90}, sd::DataType::FLOAT32);
+    x.linspace(1.);
+
+    auto p = x.permute({1, 0});
+    auto z = p.dup('c');
+
+    ASSERT_TRUE(z.isSameShape(p));
+    for (Nd4jLong i = 0; i < 90; i++)
+        for (Nd4jLong j = 0; j < 70; j++)
+            ASSERT_EQ(x.e<float>(j, i), z.e<float>(i, j));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(NDArrayTest2, permute_dup_2) {
+    NDArray x('c', {3, 37, 5, 70}, sd::DataType::DOUBLE);
+    x.linspace(1.);
+
+    auto p = x.permute({0, 3, 1, 2});
+    NDArray z('c', {3, 70, 37, 5}, sd::DataType::DOUBLE);
+    z.assign(p);
+
+    for (Nd4jLong a = 0; a < 3; a++)
+        for (Nd4jLong b = 0; b < 70; b++)
+            for (Nd4jLong c = 0; c < 37; c++)
+                for (Nd4jLong d = 0; d < 5; d++)
+                    ASSERT_EQ(x.e<double>(a, c, d, b), z.e<double>(a, b, c, d));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 TEST_F(NDArrayTest2, TestStdDev3) {
 
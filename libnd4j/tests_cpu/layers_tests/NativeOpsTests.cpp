@@ -1602,6 +1602,34 @@ TEST_F(NativeOpsTests, interop_databuffer_tests_1) {
     ::deleteDataBuffer(idb);
 }
 
+TEST_F(NativeOpsTests, knn_index_tests_1) {
+#ifdef __CUDABLAS__
+    printf("Unsupported for cuda now.\n");
+#else
+    auto data = NDArrayFactory::create<float>('c', {100, 3});
+    auto queries = NDArrayFactory::create<float>('c', {10, 3});
+    data.linspace(1.0);
+    queries.linspace(0.5, 3.0);
+
+    auto indices = NDArrayFactory::create<Nd4jLong>('c', {10, 4});
+    auto distances = NDArrayFactory::create<float>('c', {10, 4});
+
+    auto index = ::createKnnIndex(data.buffer(), data.shapeInfo(), 2);
+    ASSERT_TRUE(index != nullptr);
+    ASSERT_EQ(100, ::knnIndexSize(index));
+
+    ::knnSearch(index, queries.buffer(), queries.shapeInfo(), 4, indices.bufferAsT<Nd4jLong>(), distances.buffer());
+    ::deleteKnnIndex(index);
+
+    // results of the index kept between calls are the same as results of the op
+    sd::ops::knn_search op;
+    auto result = op.evaluate({&data, &queries}, {}, {4, 2});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_EQ(*result.at(0), indices);
+    ASSERT_EQ(*result.at(1), distances);
+#endif
+}
+
 //Uncomment when needed only - massive calculations
 //TEST_F(NativeOpsTests, BenchmarkTests_1) {
 //
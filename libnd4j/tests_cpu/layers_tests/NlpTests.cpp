@@ -418,6 +418,187 @@ TEST_F(NlpTests, test_sg_ns_batch_1) {
     
 }
 
+TEST_F(NlpTests, test_sg_ns_batch_2) {
+    // center words are repeated for consecutive rows, so rows are grouped and share negative samples
+    const int numTargets = 600;
+    auto target = NDArrayFactory::create<int>('c', {numTargets});
+    auto ngStarter = NDArrayFactory::create<int>('c', {numTargets});
+    auto alpha = NDArrayFactory::create<double>('c', {numTargets});
+    auto randomValue = NDArrayFactory::create<Nd4jLong>('c', {numTargets});
+    for (int e = 0; e < numTargets; e++) {
+        target.p(e, (e * 7) % 100);
+        ngStarter.p(e, (e / 4) % 100);
+        alpha.p(e, 0.025);
+        randomValue.p(e, (Nd4jLong) e * 31 + 1);
+    }
+
+    auto indices = NDArrayFactory::empty<int>();
+    auto codes = NDArrayFactory::empty<int8_t>();
+    auto syn1 = NDArrayFactory::empty<float>();
+    auto expTable = NDArrayFactory::create<float>('c', {1000});
+    auto negTable = NDArrayFactory::create<float>('c', {1000});
+    auto inferenceVector = NDArrayFactory::empty<float>();
+    auto neu1e = NDArrayFactory::create<float>('c', {numTargets, 16});
+
+    for (int e = 0; e < 1000; e++) {
+        auto x = std::exp((e / 1000.0 * 2 - 1) * 6.0);
+        expTable.p(e, x / (x + 1.0));
+        negTable.p(e, e % 100);
+    }
+
+    NDArray syn0[2] = {NDArrayFactory::create<float>('c', {100, 16}), NDArrayFactory::create<float>('c', {100, 16})};
+    NDArray syn1Neg[2] = {NDArrayFactory::create<float>('c', {100, 16}), NDArrayFactory::create<float>('c', {100, 16})};
+
+    // results must not depend on number of threads
+    sd::ops::skipgram op;
+    for (int i = 0; i < 2; i++) {
+        syn0[i].linspace(-0.5, 0.001);
+        syn1Neg[i].linspace(0.3, -0.0005);
+
+        Nd4jLong numWorkers = i == 0 ? 1 : 4;
+        auto result = op.evaluate({&target, &ngStarter, &indices, &codes, &syn0[i], &syn1, &syn1Neg[i], &expTable, &negTable, &alpha, &randomValue, &inferenceVector, &neu1e}, {}, {numWorkers, 5}, {false, true}, {}, true);
+        ASSERT_EQ(Status::OK(), result.status());
+    }
+
+    auto initial = syn0[0].ulike();
+    initial.linspace(-0.5, 0.001);
+    ASSERT_FALSE(initial.equalsTo(syn0[0]));
+
+    ASSERT_EQ(syn0[0], syn0[1]);
+    ASSERT_EQ(syn1Neg[0], syn1Neg[1]);
+}
+
+TEST_F(NlpTests, test_sg_ns_batch_3) {
+    // negative starters are distinct, so each row is a group of its own, and gets the same update as single-row skipgram
+    // applied to weights as they were before the batch. One round of negative sampling can't pick the same row twice
+    const int numTargets = 8;
+    auto target = NDArrayFactory::create<int>('c', {numTargets}, {0, 3, 6, 9, 12, 15, 3, 6});
+    auto ngStarter = NDArrayFactory::create<int>('c', {numTargets}, {10, 11, 12, 13, 14, 15, 16, 17});
+    auto alpha = NDArrayFactory::create<double>('c', {numTargets});
+    auto randomValue = NDArrayFactory::create<Nd4jLong>('c', {numTargets});
+    for (int e = 0; e < numTargets; e++) {
+        alpha.p(e, 0.025 - e * 0.001);
+        randomValue.p(e, (Nd4jLong) e * 31 + 1);
+    }
+
+    auto indices = NDArrayFactory::empty<int>();
+    auto codes = NDArrayFactory::empty<int8_t>();
+    auto syn1 = NDArrayFactory::empty<float>();
+    auto expTable = NDArrayFactory::create<float>('c', {1000});
+    auto negTable = NDArrayFactory::create<float>('c', {1000});
+    auto inferenceVector = NDArrayFactory::empty<float>();
+
+    for (int e = 0; e < 1000; e++) {
+        auto x = std::exp((e / 1000.0 * 2 - 1) * 6.0);
+        expTable.p(e, x / (x + 1.0));
+        negTable.p(e, e % 20);
+    }
+
+    auto initial0 = NDArrayFactory::create<float>('c', {20, 16});
+    auto initial1 = NDArrayFactory::create<float>('c', {20, 16});
+    initial0.linspace(-0.5, 0.003);
+    initial1.linspace(0.3, -0.002);
+
+    // expected weights are initial ones plus deltas of single-row skipgram for each row
+    auto exp0 = initial0.dup();
+    auto exp1 = initial1.dup();
+
+    sd::ops::skipgram op;
+    for (int e = 0; e < numTargets; e++) {
+        auto syn0 = initial0.dup();
+        auto syn1Neg = initial1.dup();
+
+        auto t = NDArrayFactory::create<int>(target.e<int>(e));
+        auto s = NDArrayFactory::create<int>(ngStarter.e<int>(e));
+        auto a = NDArrayFactory::create<double>(alpha.e<double>(e));
+        auto r = NDArrayFactory::create<Nd4jLong>(randomValue.e<Nd4jLong>(e));
+        auto neu1e = NDArrayFactory::create<float>('c', {16});
+
+        auto result = op.evaluate({&t, &s, &indices, &codes, &syn0, &syn1, &syn1Neg, &expTable, &negTable, &a, &r, &inferenceVector, &neu1e}, {}, {1, 1}, {false}, {}, true);
+        ASSERT_EQ(Status::OK(), result.status());
+
+        exp0 += syn0 - initial0;
+        exp1 += syn1Neg - initial1;
+    }
+
+    auto syn0 = initial0.dup();
+    auto syn1Neg = initial1.dup();
+    auto neu1e = NDArrayFactory::create<float>('c', {numTargets, 16});
+
+    auto result = op.evaluate({&target, &ngStarter, &indices, &codes, &syn0, &syn1, &syn1Neg, &expTable, &negTable, &alpha, &randomValue, &inferenceVector, &neu1e}, {}, {4, 1}, {false, true}, {}, true);
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_FALSE(initial0.equalsTo(syn0));
+    ASSERT_TRUE(exp0.equalsTo(syn0, 1e-5));
+    ASSERT_TRUE(exp1.equalsTo(syn1Neg, 1e-5));
+}
+
+TEST_F(NlpTests, test_sg_hs_batch_2) {
+    // Huffman paths are distinct, so each row is a group of its own, and gets the same update as single-row skipgram
+    // applied to weights as they were before the batch. Paths end at the first invalid index, rows after it stay intact
+    const int numTargets = 4;
+    const int hsRounds = 3;
+    auto target = NDArrayFactory::create<int>('c', {numTargets}, {0, 3, 6, 9});
+    auto ngStarter = NDArrayFactory::empty<int>();
+    auto indices = NDArrayFactory::create<int>('c', {numTargets, hsRounds}, {1, 2, 3,  4, -1, 5,  6, 7, 8,  9, 25, 11});
+    auto codes = NDArrayFactory::create<int8_t>('c', {numTargets, hsRounds}, {0, 1, 1,  1, 0, 1,  0, 0, 1,  1, 1, 0});
+    auto alpha = NDArrayFactory::create<double>('c', {numTargets}, {0.025, 0.024, 0.023, 0.022});
+    auto randomValue = NDArrayFactory::create<Nd4jLong>('c', {numTargets}, {1L, 2L, 3L, 4L});
+
+    auto syn1Neg = NDArrayFactory::empty<float>();
+    auto expTable = NDArrayFactory::create<float>('c', {1000});
+    auto negTable = NDArrayFactory::empty<float>();
+    auto inferenceVector = NDArrayFactory::empty<float>();
+
+    for (int e = 0; e < 1000; e++) {
+        auto x = std::exp((e / 1000.0 * 2 - 1) * 6.0);
+        expTable.p(e, x / (x + 1.0));
+    }
+
+    auto initial0 = NDArrayFactory::create<float>('c', {20, 16});
+    auto initial1 = NDArrayFactory::create<float>('c', {20, 16});
+    initial0.linspace(-0.5, 0.003);
+    initial1.linspace(0.3, -0.002);
+
+    // expected weights are initial ones plus deltas of single-row skipgram for each row
+    auto exp0 = initial0.dup();
+    auto exp1 = initial1.dup();
+
+    sd::ops::skipgram op;
+    for (int e = 0; e < numTargets; e++) {
+        auto syn0 = initial0.dup();
+        auto syn1 = initial1.dup();
+
+        auto t = NDArrayFactory::create<int>(target.e<int>(e));
+        auto i = indices({e, e + 1, 0, 0}, true).reshape('c', {hsRounds});
+        auto c = codes({e, e + 1, 0, 0}, true).reshape('c', {hsRounds});
+        auto a = NDArrayFactory::create<double>(alpha.e<double>(e));
+        auto r = NDArrayFactory::create<Nd4jLong>(randomValue.e<Nd4jLong>(e));
+        auto neu1e = NDArrayFactory::create<float>('c', {16});
+
+        auto result = op.evaluate({&t, &ngStarter, &i, &c, &syn0, &syn1, &syn1Neg, &expTable, &negTable, &a, &r, &inferenceVector, &neu1e}, {}, {}, {false}, {}, true);
+        ASSERT_EQ(Status::OK(), result.status());
+
+        exp0 += syn0 - initial0;
+        exp1 += syn1 - initial1;
+    }
+
+    auto syn0 = initial0.dup();
+    auto syn1 = initial1.dup();
+    auto neu1e = NDArrayFactory::create<float>('c', {numTargets, 16});
+
+    auto result = op.evaluate({&target, &ngStarter, &indices, &codes, &syn0, &syn1, &syn1Neg, &expTable, &negTable, &alpha, &randomValue, &inferenceVector, &neu1e}, {}, {}, {false, true}, {}, true);
+    ASSERT_EQ(Status::OK(), result.status());
+
+    ASSERT_FALSE(initial0.equalsTo(syn0));
+    ASSERT_TRUE(exp0.equalsTo(syn0, 1e-5));
+    ASSERT_TRUE(exp1.equalsTo(syn1, 1e-5));
+
+    // rows 5 and 11 follow invalid indices only
+    ASSERT_TRUE(initial1({5, 6, 0, 0}, true).equalsTo(syn1({5, 6, 0, 0}, true)));
+    ASSERT_TRUE(initial1({11, 12, 0, 0}, true).equalsTo(syn1({11, 12, 0, 0}, true)));
+}
+
 TEST_F(NlpTests, test_cbow_hs_batch_1) {
 #ifdef __CUDABLAS__
     return ;
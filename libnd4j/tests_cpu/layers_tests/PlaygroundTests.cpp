@@ -94,6 +94,50 @@ TEST_F(PlaygroundTests, test_biasAdd_1) {
 }
 
 
+TEST_F(PlaygroundTests, test_fused_elementwise_1) {
+    sd::ops::biasadd opA;
+    sd::ops::relu opB;
+    sd::ops::multiply opC;
+
+    // bias_add -> relu -> multiply, executed as 3 ops and as one fused op
+    auto build = [&] (bool fused) -> Graph* {
+        auto graph = new Graph();
+        graph->getVariableSpace()->putVariable(-1, NDArrayFactory::create_<float>('c', {512, 3072}));
+        graph->getVariableSpace()->putVariable(-2, NDArrayFactory::create_<float>('c', {3072}));
+        graph->getVariableSpace()->putVariable(-3, NDArrayFactory::create_<float>('c', {512, 3072}));
+
+        graph->addNode(new Node(&opA, 1, {-1, -2}));
+        graph->addNode(new Node(&opB, 2, {1}, {}, {}, 0.0f, {0.0}));
+        graph->addNode(new Node(&opC, 3, {2, -3}));
+
+        if (fused)
+            graph->fuseElementwise();
+
+        return graph;
+    };
+
+    for (auto fused: {false, true}) {
+        auto graph = build(fused);
+        std::vector<Nd4jLong> values;
+
+        for (int e = 0; e < 100; e++) {
+            auto timeStart = std::chrono::system_clock::now();
+
+            GraphExecutioner::execute(graph);
+
+            auto timeEnd = std::chrono::system_clock::now();
+            auto outerTime = std::chrono::duration_cast<std::chrono::microseconds>(timeEnd - timeStart).count();
+            values.emplace_back(outerTime);
+        }
+
+        std::sort(values.begin(), values.end());
+
+        nd4j_printf("Fused: %i; Time: %lld us;\n", (int) fused, values[values.size() / 2]);
+
+        delete graph;
+    }
+}
+
 TEST_F(PlaygroundTests, test_bert_full_1) {
 #ifdef _RELEASE
 
@@ -22,6 +22,9 @@
 #include <graph/GraphExecutioner.h>
 #include <graph/GraphHolder.h>
 #include <graph/InferenceRequest.h>
+#include <graph/RequestBatcher.h>
+#include <ops/declarable/CustomOperations.h>
+#include <thread>
 
 using namespace sd;
 using namespace sd::graph;
@@ -185,4 +188,212 @@ TEST_F(ServerRelatedTests, BasicExecutionTests_3) {
 
     GraphHolder::getInstance().dropGraphAny(11903L);
 }
+TEST_F(ServerRelatedTests, BasicExecutionTests_4) {
+    auto oGraph = GraphExecutioner::importFromFlatBuffers("./resources/reduce_dim_false.fb");
+
+    GraphHolder::getInstance().registerGraph(11904L, oGraph);
+
+    // pooled clones are reused between requests, so each request must only see its own inputs
+    for (int e = 1; e < 4; e++) {
+        flatbuffers::FlatBufferBuilder builder(4096);
+        flatbuffers::FlatBufferBuilder otherBuilder(4096);
+
+        auto input0 = NDArrayFactory::create<float>('c', {3, 3});
+        input0.assign((float) e);
+        auto exp = NDArrayFactory::create<float>('c', {3});
+        exp.assign(3.f * e);
+
+        InferenceRequest ir(11904L);
+        ir.appendVariable(1, 0, &input0);
+
+        auto af = ir.asFlatInferenceRequest(otherBuilder);
+        otherBuilder.Finish(af);
+        auto fir = GetFlatInferenceRequest(otherBuilder.GetBufferPointer());
+
+        auto flatResult = GraphHolder::getInstance().execute(fir->id(), builder, fir);
+
+        builder.Finish(flatResult);
+        auto received = GetFlatResult(builder.GetBufferPointer());
+
+        ExecutionResult restored(received);
+        ASSERT_EQ(1, restored.size());
+
+        ASSERT_EQ(exp, *restored.at(0)->getNDArray());
+    }
+
+    GraphHolder::getInstance().dropGraphAny(11904L);
+}
 #endif
+
+TEST_F(ServerRelatedTests, Batching_Test_1) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {1, 3});
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+
+    GraphHolder::getInstance().registerGraph(11905L, graph);
+
+    // long wait, so concurrent requests have a chance to be merged
+    RequestBatcher batcher(8, 200000);
+
+    const int numThreads = 4;
+    std::vector<std::thread> threads;
+    std::vector<int> results(numThreads, 0);
+
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            flatbuffers::FlatBufferBuilder builder(4096);
+            flatbuffers::FlatBufferBuilder otherBuilder(4096);
+
+            // requests have different batch sizes
+            Nd4jLong size = t % 2 + 1;
+            auto input = NDArrayFactory::create<float>('c', {size, 3});
+            input.assign(-(t + 1.f));
+
+            auto exp = NDArrayFactory::create<float>('c', {size, 3});
+            exp.assign(-(t + 1.f));
+
+            InferenceRequest ir(11905L);
+            ir.appendVariable(-1, 0, &input);
+
+            otherBuilder.Finish(ir.asFlatInferenceRequest(otherBuilder));
+            auto fir = GetFlatInferenceRequest(otherBuilder.GetBufferPointer());
+
+            builder.Finish(batcher.execute(fir->id(), builder, fir));
+            auto received = GetFlatResult(builder.GetBufferPointer());
+
+            ExecutionResult restored(received);
+            results[t] = restored.size() == 1 && exp.equalsTo(restored.at(0)->getNDArray()) ? 1 : 0;
+        });
+    }
+
+    for (auto &t: threads)
+        t.join();
+
+    for (int t = 0; t < numThreads; t++)
+        ASSERT_EQ(1, results[t]);
+
+    ASSERT_EQ(numThreads, batcher.requests());
+    ASSERT_TRUE(batcher.batches() >= 1);
+
+    GraphHolder::getInstance().dropGraphAny(11905L);
+}
+
+TEST_F(ServerRelatedTests, Batching_Test_2) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {1, 3});
+    auto w = NDArrayFactory::create_<float>('c', {3, 2}, {1.f, -2.f, 3.f, -4.f, 5.f, -6.f});
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, w);
+
+    sd::ops::matmul opM;
+    graph->addNode(new Node(&opM, 1, {-1, -2}, {2}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+
+    GraphHolder::getInstance().registerGraph(11906L, graph);
+
+    // batch is closed only once all requests joined it: 1 + 2 + 1 + 2 rows
+    const int numThreads = 4;
+    RequestBatcher batcher(6, 10000000);
+
+    std::vector<std::thread> threads;
+    std::vector<int> results(numThreads, 0);
+
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            flatbuffers::FlatBufferBuilder builder(4096);
+            flatbuffers::FlatBufferBuilder expBuilder(4096);
+            flatbuffers::FlatBufferBuilder otherBuilder(4096);
+
+            // each request has its own rows, so misplaced slices are caught
+            Nd4jLong size = t % 2 + 1;
+            auto input = NDArrayFactory::create<float>('c', {size, 3});
+            input.linspace(t * 10.f + 1.f);
+
+            InferenceRequest ir(11906L);
+            ir.appendVariable(-1, 0, &input);
+
+            otherBuilder.Finish(ir.asFlatInferenceRequest(otherBuilder));
+            auto fir = GetFlatInferenceRequest(otherBuilder.GetBufferPointer());
+
+            // unbatched execution of the same request is the reference
+            expBuilder.Finish(GraphHolder::getInstance().execute(fir->id(), expBuilder, fir));
+            ExecutionResult expected(GetFlatResult(expBuilder.GetBufferPointer()));
+
+            builder.Finish(batcher.execute(fir->id(), builder, fir));
+            ExecutionResult restored(GetFlatResult(builder.GetBufferPointer()));
+
+            results[t] = restored.size() == 1 && expected.size() == 1 && expected.at(0)->getNDArray()->isSameShape(restored.at(0)->getNDArray()) && expected.at(0)->getNDArray()->equalsTo(restored.at(0)->getNDArray()) ? 1 : 0;
+        });
+    }
+
+    for (auto &t: threads)
+        t.join();
+
+    for (int t = 0; t < numThreads; t++)
+        ASSERT_EQ(1, results[t]);
+
+    ASSERT_EQ(numThreads, batcher.requests());
+    ASSERT_EQ(1, batcher.batches());
+
+    GraphHolder::getInstance().dropGraphAny(11906L);
+}
+
+TEST_F(ServerRelatedTests, Batching_Test_3) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {1, 3});
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    // reduction over batch dimension mixes rows of merged requests
+    graph->addNode(new Node(OpType_REDUCE_SAME, reduce::Sum, 1, {-1}, {}, {0}));
+
+    GraphHolder::getInstance().registerGraph(11907L, graph);
+
+    const int numThreads = 2;
+    RequestBatcher batcher(3, 10000000);
+
+    std::vector<std::thread> threads;
+    std::vector<int> results(numThreads, 0);
+
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            flatbuffers::FlatBufferBuilder builder(4096);
+            flatbuffers::FlatBufferBuilder otherBuilder(4096);
+
+            Nd4jLong size = t + 1;
+            auto input = NDArrayFactory::create<float>('c', {size, 3});
+            input.assign(t + 1.f);
+
+            auto exp = NDArrayFactory::create<float>('c', {3});
+            exp.assign(size * (t + 1.f));
+
+            InferenceRequest ir(11907L);
+            ir.appendVariable(-1, 0, &input);
+
+            otherBuilder.Finish(ir.asFlatInferenceRequest(otherBuilder));
+            auto fir = GetFlatInferenceRequest(otherBuilder.GetBufferPointer());
+
+            builder.Finish(batcher.execute(fir->id(), builder, fir));
+            ExecutionResult restored(GetFlatResult(builder.GetBufferPointer()));
+
+            results[t] = restored.size() == 1 && exp.equalsTo(restored.at(0)->getNDArray()) ? 1 : 0;
+        });
+    }
+
+    for (auto &t: threads)
+        t.join();
+
+    for (int t = 0; t < numThreads; t++)
+        ASSERT_EQ(1, results[t]);
+
+    // requests are never merged for such graph
+    ASSERT_EQ(numThreads, batcher.requests());
+    ASSERT_EQ(numThreads, batcher.batches());
+
+    GraphHolder::getInstance().dropGraphAny(11907L);
+}
@@ -23,6 +23,7 @@
 #include <array/NDArray.h>
 #include <legacy/NativeOps.h>
 #include <helpers/BitwiseUtils.h>
+#include <helpers/ConstantTadHelper.h>
 
 using namespace sd;
 using namespace sd::graph;
@@ -102,3 +103,44 @@ TEST_F(SortCpuTests, test_tad_sort_by_val_1) {
     ASSERT_EQ(ek, k);
     ASSERT_EQ(ev, v);
 }
+
+TEST_F(SortCpuTests, test_linear_sort_by_key_2) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    // long enough for radix sort with multiple chunks, keys are shuffled [-50000, 50000) range
+    const int length = 100000;
+    auto k = NDArrayFactory::create<float>('c', {length});
+    auto v = NDArrayFactory::create<double>('c', {length});
+    for (int e = 0; e < length; e++) {
+        auto key = static_cast<float>((static_cast<Nd4jLong>(e) * 7919) % length - length / 2);
+        k.p(e, key);
+        v.p(e, key * 2.0);
+    }
+
+    sortByKey(nullptr, k.buffer(), k.shapeInfo(), k.specialBuffer(), k.specialShapeInfo(), v.buffer(), v.shapeInfo(), v.specialBuffer(), v.specialShapeInfo(), true);
+
+    for (int e = 0; e < length; e++) {
+        ASSERT_EQ(static_cast<float>(length / 2 - 1 - e), k.e<float>(e));
+        ASSERT_EQ(k.e<double>(e) * 2.0, v.e<double>(e));
+    }
+}
+
+TEST_F(SortCpuTests, test_tad_sort_2) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    // columns are strided TADs, so they go to merge sort
+    auto x = NDArrayFactory::create<int>('c', {100, 3});
+    for (int i = 0; i < 100; i++)
+        for (int j = 0; j < 3; j++)
+            x.p(i, j, ((i * 37) % 100) * (j + 1));
+
+    int axis = 0;
+    auto pack = ConstantTadHelper::getInstance().tadForDimensions(x.shapeInfo(), axis);
+    sortTad(nullptr, x.buffer(), x.shapeInfo(), x.specialBuffer(), x.specialShapeInfo(), &axis, 1, pack.primaryShapeInfo(), pack.primaryOffsets(), false);
+
+    for (int i = 0; i < 100; i++)
+        for (int j = 0; j < 3; j++)
+            ASSERT_EQ(i * (j + 1), x.e<int>(i, j));
+}
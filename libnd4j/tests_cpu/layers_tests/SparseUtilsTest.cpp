@@ -148,6 +148,43 @@ TEST_F(SparseUtilsTest, SortCOOindices_Test) {
 #endif
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(SparseUtilsTest, SortCOOindices_Test_2) {
+
+#ifndef __CUDABLAS__
+
+    // two trailing dimensions take all 64 bits of the packed key, leading one is always zero
+    const Nd4jLong full = 0xFFFFFFFFLL;
+    Nd4jLong indicesArr[] = {
+            0, full, 1,
+            0, 0, full,
+            0, full, 0,
+            0, 1, 1,
+            0, 0, 0,
+    };
+
+    Nd4jLong expIndicesArr[] = {
+            0, 0, 0,
+            0, 0, full,
+            0, 1, 1,
+            0, full, 0,
+            0, full, 1,
+    };
+
+    float values[] = {0, 1, 2, 3, 4};
+    float expValues[] = {4, 1, 3, 2, 0};
+
+    sd::sparse::SparseUtils<float>::sortCooIndicesGeneric(indicesArr, values, 5, 3);
+
+    for (int i = 0; i < 15; ++i)
+        ASSERT_EQ(expIndicesArr[i], indicesArr[i]);
+
+    for (int i = 0; i < 5; ++i)
+        ASSERT_EQ(expValues[i], values[i]);
+
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////
 TEST_F(SparseUtilsTest, RavelIndices_Test) {
 
@@ -208,6 +208,69 @@ TEST_F(ThreadsTests, reduction_test_1) {
     ASSERT_EQ(8192, sum);
 }
 
+TEST_F(ThreadsTests, stealing_test_1) {
+    for (int t = 1; t <= 8; t++) {
+        for (int64_t length: {1, 7, 64, 1000, 8193}) {
+            std::vector<std::atomic<int>> visits(length);
+            for (auto &v: visits)
+                v.store(0);
+
+            auto func = PRAGMA_THREADS_FOR {
+                for (auto e = start; e < stop; e += increment)
+                    visits[e]++;
+            };
+
+            samediff::Threads::parallel_stealing(func, 0, length, 1, t);
+
+            for (auto &v: visits)
+                ASSERT_EQ(1, v.load());
+        }
+    }
+}
+
+TEST_F(ThreadsTests, stealing_test_2) {
+    // skewed workload: first iterations are way heavier than the rest
+    std::atomic<int64_t> sum;
+    sum.store(0);
+
+    auto func = PRAGMA_THREADS_FOR_2D {
+        for (auto x = start_x; x < stop_x; x += inc_x) {
+            auto weight = x < 8 ? 1000 : 1;
+            for (int w = 0; w < weight; w++)
+                for (auto y = start_y; y < stop_y; y += inc_y)
+                    sum++;
+        }
+    };
+
+    auto &pool = samediff::ThreadPool::getInstance();
+    pool.resetStatistics();
+
+    auto numThreads = samediff::Threads::parallel_stealing(func, 0, 256, 1, 0, 16, 1, 4);
+
+    ASSERT_EQ((8 * 1000 + 248) * 16, sum.load());
+
+    // calling thread isn't a pool worker, every pool worker taken executes exactly one task
+    int64_t tasks = 0;
+    int active = 0;
+    for (int e = 0; e < pool.numberOfThreads(); e++) {
+        auto executed = pool.tasksExecuted(e);
+        tasks += executed;
+
+        if (executed > 0 || pool.busyTime(e) > 0)
+            active++;
+    }
+
+    ASSERT_EQ(numThreads - 1, tasks);
+    ASSERT_EQ(numThreads - 1, active);
+
+    // pool is idle here, so all requested threads are taken
+    if (pool.numberOfThreads() >= 3) {
+        ASSERT_EQ(4, numThreads);
+        ASSERT_TRUE(tasks > 0);
+        ASSERT_TRUE(active >= 2);
+    }
+}
+
 static void _code(int thread_id) {
   auto x = NDArrayFactory::create<float>('c', {65536 * 16});
   x.assign(1.1f);
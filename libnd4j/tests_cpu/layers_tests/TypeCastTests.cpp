@@ -70,3 +70,43 @@ TEST_F(TypeCastTests, Test_ConvertDtype_1) {
 
     #endif
 }
+
+TEST_F(TypeCastTests, Test_ConvertThreshold_Long_1) {
+#ifndef __CUDABLAS__
+    float src[] = {0.0f, 1.0f, -2.0f, 0.1f, 0.0f, -0.3f, 0.7f};
+    float exp[] = {0.0f, 0.5f, -1.5f, 0.1f, 0.0f, -0.3f, 0.2f};
+    float decoded[] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    float expDecoded[] = {0.0f, 0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 0.5f};
+    float threshold = 0.5f;
+
+    // 6 elements of extended header, and room for 4 int64 indices
+    int encoded[14];
+    std::memset(encoded, 0, sizeof(encoded));
+    encoded[0] = 10;
+    std::memcpy(encoded + 2, &threshold, sizeof(float));
+    encoded[3] = THRESHOLD_LONG_FLAG;
+
+    convertTypes(nullptr, ND4J_FLOAT32, src, 7, ND4J_THRESHOLD, encoded);
+
+    ASSERT_EQ(7, encoded[1]);
+    ASSERT_EQ(THRESHOLD_LONG_FLAG, encoded[3]);
+
+    Nd4jLong length;
+    std::memcpy(&length, encoded + 4, sizeof(Nd4jLong));
+    ASSERT_EQ(7, length);
+
+    Nd4jLong indices[3];
+    std::memcpy(indices, encoded + THRESHOLD_LONG_HEADER, sizeof(indices));
+    ASSERT_EQ(2, indices[0]);
+    ASSERT_EQ(-3, indices[1]);
+    ASSERT_EQ(7, indices[2]);
+
+    for (int e = 0; e < 7; e++)
+        ASSERT_NEAR(exp[e], src[e], 1e-5f);
+
+    convertTypes(nullptr, ND4J_THRESHOLD, encoded, 7, ND4J_FLOAT32, decoded);
+
+    for (int e = 0; e < 7; e++)
+        ASSERT_NEAR(expDecoded[e], decoded[e], 1e-5f);
+#endif
+}
@@ -277,6 +277,75 @@ TEST_F(WorkspaceTests, Test_Externalized_1) {
     ASSERT_NEAR(2.0f, m, 1e-5);
 }
 
+TEST_F(WorkspaceTests, AdaptiveTest_1) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    Workspace workspace(128);
+    workspace.setAdaptive(true);
+
+    for (int e = 0; e < 10; e++)
+        workspace.allocateBytes(128);
+
+    ASSERT_EQ(128 * 9, workspace.getSpilledSize());
+
+    // adaptive workspace grows as soon as cycle ends
+    workspace.scopeOut();
+
+    ASSERT_EQ(0, workspace.getSpilledSize());
+    ASSERT_EQ(1280, workspace.getCurrentSize());
+    ASSERT_EQ(1280, workspace.getPeakSize());
+
+    for (int i = 0; i < 3; i++) {
+        for (int e = 0; e < 10; e++)
+            workspace.allocateBytes(128);
+
+        ASSERT_EQ(0, workspace.getSpilledSize());
+        workspace.scopeOut();
+    }
+
+    auto report = workspace.getReport();
+    ASSERT_EQ(9, report.getSpills());
+    ASSERT_EQ(128 * 9, report.getSpilledBytes());
+    ASSERT_EQ(1, report.getReallocations());
+    ASSERT_EQ(1280, report.getPeak());
+}
+
+TEST_F(WorkspaceTests, NestedScopeTest_1) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    Workspace workspace(256);
+
+    workspace.allocateBytes(64);
+    ASSERT_EQ(64, workspace.getCurrentOffset());
+
+    workspace.pushScope();
+
+    workspace.allocateBytes(128);
+    workspace.allocateBytes(128);
+    ASSERT_EQ(192, workspace.getCurrentOffset());
+    ASSERT_EQ(128, workspace.getSpilledSize());
+
+    workspace.pushScope();
+    workspace.allocateBytes(32);
+    ASSERT_EQ(224, workspace.getCurrentOffset());
+    workspace.popScope();
+
+    ASSERT_EQ(192, workspace.getCurrentOffset());
+
+    workspace.popScope();
+
+    // everything allocated within scope is released, including spills
+    ASSERT_EQ(64, workspace.getCurrentOffset());
+    ASSERT_EQ(0, workspace.getSpilledSize());
+
+    // high-water mark survives nested scopes
+    ASSERT_EQ(352, workspace.getPeakSize());
+
+    ASSERT_ANY_THROW(workspace.popScope());
+}
+
 // TODO: uncomment this test once long shapes are introduced
 /*
 TEST_F(WorkspaceTests, Test_Big_Allocation_1) {
@@ -19,4 +19,10 @@ package org.nd4j.linalg.compression;
 public class ThresholdCompression {
     public static final int FLEXIBLE_ENCODING = 0;
     public static final int BITMAP_ENCODING = 1;
+
+    /**
+     * Threshold encoding with int64 indices, produced by native encode_threshold for arrays longer than Integer.MAX_VALUE.
+     * Such arrays can't be decoded by Java-side accumulators, they reject this flag as unknown encoding
+     */
+    public static final int LONG_FLEXIBLE_ENCODING = 3;
 }